@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBSBSParser.h"
+#include "QGCLoggingCategory.h"
+
+#include <cmath>
+#include <ctype.h>
+#include <limits>
+#include <string.h>
+
+bool ADSBSBSParser::parseLine(const char* line, int length, ADSBVehicle::ADSBVehicleInfo_t& adsbInfo)
+{
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        length--;
+    }
+    if (length < 5 || memcmp(line, "MSG", 3) != 0) {
+        return false;
+    }
+
+    char msgTypeChar = line[4];
+    if (msgTypeChar < '0' || msgTypeChar > '9') {
+        qCDebug(ADSBVehicleManagerLog) << "ADSB Invalid message type " << msgTypeChar;
+        return false;
+    }
+    // Skip unsupported mesg types to avoid parsing
+    int msgType = msgTypeChar - '0';
+    if (msgType == 2 || msgType > 6) {
+        return false;
+    }
+
+    // Split into field views without copying
+    Field_t fields[_fieldCount];
+    int     fieldCount  = 0;
+    int     fieldStart  = 0;
+    for (int i=0; i<=length && fieldCount<_fieldCount; i++) {
+        if (i == length || line[i] == ',') {
+            fields[fieldCount].data     = line + fieldStart;
+            fields[fieldCount].length   = i - fieldStart;
+            fieldCount++;
+            fieldStart = i + 1;
+        }
+    }
+
+    uint32_t icaoAddress;
+    if (fieldCount < 5 || !_toHex(fields[4], icaoAddress)) {
+        return false;
+    }
+
+    adsbInfo.icaoAddress    = icaoAddress;
+    adsbInfo.availableFlags = 0;
+
+    switch (msgType) {
+    case 1:
+    case 5:
+    case 6:
+    {
+        if (fieldCount < 11) {
+            return false;
+        }
+        Field_t callsign = _trimmed(fields[10]);
+        if (callsign.length == 0) {
+            return false;
+        }
+        adsbInfo.callsign       = QString::fromLatin1(callsign.data, callsign.length);
+        adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
+        return true;
+    }
+    case 3:
+    {
+        if (fieldCount < 20) {
+            return false;
+        }
+
+        // Altitude is either Barometric - based on pressure, in ft
+        // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
+        // If altitude ends with H, we have HAE
+        // There's a slight difference between Barometric alt and HAE, but it would require
+        // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
+        Field_t altitudeField = fields[11];
+        if (altitudeField.length > 0 && altitudeField.data[altitudeField.length - 1] == 'H') {
+            altitudeField.length--;
+        }
+
+        int     modeCAltitude;
+        double  lat;
+        double  lon;
+        int     alert;
+        if (!_toInt(altitudeField, modeCAltitude) || !_toDouble(fields[14], lat) || !_toDouble(fields[15], lon)) {
+            return false;
+        }
+        if (lat == 0 && lon == 0) {
+            return false;
+        }
+        if (!_toInt(fields[19], alert)) {
+            alert = 0;
+        }
+
+        adsbInfo.location       = QGeoCoordinate(lat, lon);
+        adsbInfo.altitude       = modeCAltitude * 0.3048;
+        adsbInfo.alert          = alert == 1;
+        adsbInfo.availableFlags = ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable | ADSBVehicle::AlertAvailable;
+        return true;
+    }
+    case 4:
+    {
+        double heading;
+        if (fieldCount < 14 || !_toDouble(fields[13], heading)) {
+            return false;
+        }
+        adsbInfo.heading        = heading;
+        adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+int ADSBSBSParser::parseBuffer(QByteArray& buffer, UpdateMap_t& updates)
+{
+    const char* data        = buffer.constData();
+    int         size        = buffer.size();
+    int         lineStart   = 0;
+    int         updateCount = 0;
+
+    ADSBVehicle::ADSBVehicleInfo_t adsbInfo;
+    for (int i=0; i<size; i++) {
+        if (data[i] != '\n') {
+            continue;
+        }
+        if (parseLine(data + lineStart, i - lineStart, adsbInfo)) {
+            auto iter = updates.find(adsbInfo.icaoAddress);
+            if (iter == updates.end()) {
+                updates.insert(adsbInfo.icaoAddress, adsbInfo);
+            } else {
+                mergeUpdate(iter.value(), adsbInfo);
+            }
+            updateCount++;
+        }
+        lineStart = i + 1;
+    }
+
+    // Consumed lines are removed in place, leaving any partial line at the start of the buffer
+    if (lineStart > 0) {
+        buffer.remove(0, lineStart);
+    }
+
+    return updateCount;
+}
+
+void ADSBSBSParser::mergeUpdate(ADSBVehicle::ADSBVehicleInfo_t& pending, const ADSBVehicle::ADSBVehicleInfo_t& update)
+{
+    if (update.availableFlags & ADSBVehicle::CallsignAvailable) {
+        pending.callsign = update.callsign;
+    }
+    if (update.availableFlags & ADSBVehicle::LocationAvailable) {
+        pending.location = update.location;
+    }
+    if (update.availableFlags & ADSBVehicle::AltitudeAvailable) {
+        pending.altitude = update.altitude;
+    }
+    if (update.availableFlags & ADSBVehicle::HeadingAvailable) {
+        pending.heading = update.heading;
+    }
+    if (update.availableFlags & ADSBVehicle::AlertAvailable) {
+        pending.alert = update.alert;
+    }
+    pending.availableFlags |= update.availableFlags;
+}
+
+ADSBSBSParser::Field_t ADSBSBSParser::_trimmed(Field_t field)
+{
+    while (field.length > 0 && isspace(static_cast<unsigned char>(field.data[0]))) {
+        field.data++;
+        field.length--;
+    }
+    while (field.length > 0 && isspace(static_cast<unsigned char>(field.data[field.length - 1]))) {
+        field.length--;
+    }
+    return field;
+}
+
+bool ADSBSBSParser::_toInt(Field_t field, int& value)
+{
+    field = _trimmed(field);
+
+    int     i           = 0;
+    bool    negative    = false;
+    if (i < field.length && (field.data[i] == '-' || field.data[i] == '+')) {
+        negative = field.data[i] == '-';
+        i++;
+    }
+    if (i == field.length) {
+        return false;
+    }
+
+    qint64 result = 0;
+    for (; i<field.length; i++) {
+        char c = field.data[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        result = (result * 10) + (c - '0');
+        if (result > std::numeric_limits<int>::max()) {
+            return false;
+        }
+    }
+
+    value = static_cast<int>(negative ? -result : result);
+    return true;
+}
+
+bool ADSBSBSParser::_toHex(Field_t field, uint32_t& value)
+{
+    field = _trimmed(field);
+    if (field.length == 0 || field.length > 8) {
+        return false;
+    }
+
+    uint32_t result = 0;
+    for (int i=0; i<field.length; i++) {
+        char c = field.data[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        result = (result << 4) | digit;
+    }
+
+    value = result;
+    return true;
+}
+
+/// Locale independent decimal parser. The mantissa is accumulated as an integer and scaled once by an exact power
+/// of ten, which gives the same result as strtod for the coordinate and heading precision used by SBS-1.
+bool ADSBSBSParser::_toDouble(Field_t field, double& value)
+{
+    field = _trimmed(field);
+
+    int     i               = 0;
+    bool    negative        = false;
+    if (i < field.length && (field.data[i] == '-' || field.data[i] == '+')) {
+        negative = field.data[i] == '-';
+        i++;
+    }
+
+    quint64 mantissa        = 0;
+    int     digitCount      = 0;
+    int     exponent        = 0;
+    bool    fraction        = false;
+    bool    haveDigits      = false;
+    for (; i<field.length; i++) {
+        char c = field.data[i];
+        if (c >= '0' && c <= '9') {
+            haveDigits = true;
+            if (digitCount < 18) {
+                mantissa = (mantissa * 10) + static_cast<quint64>(c - '0');
+                if (mantissa != 0) {
+                    digitCount++;
+                }
+                if (fraction) {
+                    exponent--;
+                }
+            } else if (!fraction) {
+                exponent++;
+            }
+        } else if (c == '.' && !fraction) {
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (!haveDigits) {
+        return false;
+    }
+
+    if (i < field.length) {
+        // Only an exponent may follow the number
+        if (field.data[i] != 'e' && field.data[i] != 'E') {
+            return false;
+        }
+        int explicitExponent;
+        Field_t exponentField = { field.data + i + 1, field.length - i - 1 };
+        if (!_toInt(exponentField, explicitExponent)) {
+            return false;
+        }
+        exponent += explicitExponent;
+    }
+
+    static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0 && exponent >= -22) {
+        result /= powersOf10[-exponent];
+    } else if (exponent > 0 && exponent <= 22) {
+        result *= powersOf10[exponent];
+    } else if (exponent != 0) {
+        result *= std::pow(10.0, exponent);
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "ADSBVehicle.h"
+
+#include <QByteArray>
+#include <QHash>
+
+/// Parser for SBS-1 (BaseStation) messages. Fields are parsed directly from the received bytes, the only
+/// allocation is the callsign string for identification messages.
+class ADSBSBSParser
+{
+public:
+    typedef QHash<uint32_t, ADSBVehicle::ADSBVehicleInfo_t> UpdateMap_t;
+
+    /// Parses a single message
+    ///     @param line Message bytes, line terminator is optional
+    ///     @param adsbInfo Filled in with the values from the message
+    /// @return true: message is supported and adsbInfo holds an update
+    static bool parseLine(const char* line, int length, ADSBVehicle::ADSBVehicleInfo_t& adsbInfo);
+
+    /// Parses all complete lines in the buffer and removes them from it. A trailing partial line is left in place
+    /// for the next call. Updates are merged into updates by ICAO address.
+    /// @return Number of updates parsed
+    static int parseBuffer(QByteArray& buffer, UpdateMap_t& updates);
+
+    /// Merges the values available from update into pending
+    static void mergeUpdate(ADSBVehicle::ADSBVehicleInfo_t& pending, const ADSBVehicle::ADSBVehicleInfo_t& update);
+
+private:
+    struct Field_t {
+        const char* data;
+        int         length;
+    };
+
+    static Field_t  _trimmed    (Field_t field);
+    static bool     _toInt      (Field_t field, int& value);
+    static bool     _toHex      (Field_t field, uint32_t& value);
+    static bool     _toDouble   (Field_t field, double& value);
+
+    static const int _fieldCount = 22;  ///< Number of fields in an SBS-1 message
+};
@@ -14,10 +14,15 @@
 #include "ADSBVehicleManagerSettings.h"
 
 #include <QDebug>
+#include <QSet>
+#include <QtMath>
 
 ADSBVehicleManager::ADSBVehicleManager(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
 {
+    _updateBatchTimer.setSingleShot(true);
+    _updateBatchTimer.setInterval(_updateBatchMs);
+    connect(&_updateBatchTimer, &QTimer::timeout, this, &ADSBVehicleManager::_applyPendingUpdates);
 }
 
 void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
@@ -30,7 +35,7 @@ void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
     ADSBVehicleManagerSettings* settings = qgcApp()->toolbox()->settingsManager()->adsbVehicleManagerSettings();
     if (settings->adsbServerConnectEnabled()->rawValue().toBool()) {
         _tcpLink = new ADSBTCPLink(settings->adsbServerHostAddress()->rawValue().toString(), settings->adsbServerPort()->rawValue().toInt(), this);
-        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdate,  this, &ADSBVehicleManager::adsbVehicleUpdate,   Qt::QueuedConnection);
+        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdates, this, &ADSBVehicleManager::adsbVehicleUpdates,  Qt::QueuedConnection);
         connect(_tcpLink, &ADSBTCPLink::error,              this, &ADSBVehicleManager::_tcpError,           Qt::QueuedConnection);
     }
 }
@@ -38,31 +43,210 @@ void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
 void ADSBVehicleManager::_cleanupStaleVehicles()
 {
     // Remove all expired ADSB vehicles
+    bool removed = false;
     for (int i=_adsbVehicles.count()-1; i>=0; i--) {
         ADSBVehicle* adsbVehicle = _adsbVehicles.value<ADSBVehicle*>(i);
         if (adsbVehicle->expired()) {
             qCDebug(ADSBVehicleManagerLog) << "Expired " << QStringLiteral("%1").arg(adsbVehicle->icaoAddress(), 0, 16);
             _adsbVehicles.removeAt(i);
-            _adsbICAOMap.remove(adsbVehicle->icaoAddress());
+            _adsbICAOMap.remove(static_cast<uint32_t>(adsbVehicle->icaoAddress()));
+            _removeFromGrid(adsbVehicle);
             adsbVehicle->deleteLater();
+            removed = true;
         }
     }
+    if (removed) {
+        _updateVehiclesInView();
+    }
 }
 
 void ADSBVehicleManager::adsbVehicleUpdate(const ADSBVehicle::ADSBVehicleInfo_t vehicleInfo)
 {
-    uint32_t icaoAddress = vehicleInfo.icaoAddress;
+    _queueUpdate(vehicleInfo);
+}
 
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
+void ADSBVehicleManager::adsbVehicleUpdates(const QList<ADSBVehicle::ADSBVehicleInfo_t> vehicleInfos)
+{
+    for (const ADSBVehicle::ADSBVehicleInfo_t& vehicleInfo: vehicleInfos) {
+        _queueUpdate(vehicleInfo);
+    }
+}
+
+void ADSBVehicleManager::_queueUpdate(const ADSBVehicle::ADSBVehicleInfo_t& vehicleInfo)
+{
+    auto iter = _pendingUpdates.find(vehicleInfo.icaoAddress);
+    if (iter == _pendingUpdates.end()) {
+        _pendingUpdates.insert(vehicleInfo.icaoAddress, vehicleInfo);
     } else {
-        if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
-            ADSBVehicle* adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-            _adsbICAOMap[icaoAddress] = adsbVehicle;
-            _adsbVehicles.append(adsbVehicle);
+        ADSBSBSParser::mergeUpdate(iter.value(), vehicleInfo);
+    }
+
+    if (!_updateBatchTimer.isActive()) {
+        _updateBatchTimer.start();
+    }
+}
+
+void ADSBVehicleManager::_applyPendingUpdates(void)
+{
+    QList<QObject*> newVehicles;
+
+    for (const ADSBVehicle::ADSBVehicleInfo_t& vehicleInfo: _pendingUpdates) {
+        ADSBVehicle* adsbVehicle = _adsbICAOMap.value(vehicleInfo.icaoAddress, nullptr);
+        if (adsbVehicle) {
+            adsbVehicle->update(vehicleInfo);
+            if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+                _updateGrid(adsbVehicle);
+            }
+        } else if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+            adsbVehicle = new ADSBVehicle(vehicleInfo, this);
+            _adsbICAOMap[vehicleInfo.icaoAddress] = adsbVehicle;
+            _updateGrid(adsbVehicle);
+            newVehicles.append(adsbVehicle);
             qCDebug(ADSBVehicleManagerLog) << "Added " << QStringLiteral("%1").arg(adsbVehicle->icaoAddress(), 0, 16);
         }
     }
+    _pendingUpdates.clear();
+
+    if (!newVehicles.isEmpty()) {
+        _adsbVehicles.append(newVehicles);
+    }
+    _updateVehiclesInView();
+}
+
+void ADSBVehicleManager::setViewRegion(const QGeoCoordinate& coordinateNW, const QGeoCoordinate& coordinateSE)
+{
+    QGeoRectangle viewRegion(coordinateNW, coordinateSE);
+    if (viewRegion != _viewRegion) {
+        _viewRegion = viewRegion;
+        _updateVehiclesInView();
+    }
+}
+
+QList<ADSBVehicle*> ADSBVehicleManager::vehiclesInRegion(const QGeoRectangle& region) const
+{
+    QList<ADSBVehicle*> vehicles;
+
+    if (!region.isValid()) {
+        return vehicles;
+    }
+
+    int latLow  = _gridLatIndex(region.bottomRight().latitude());
+    int latHigh = _gridLatIndex(region.topLeft().latitude());
+    int lonLow  = _gridLonIndex(region.topLeft().longitude());
+    int lonSpan;
+    if (region.width() >= 360.0 - (360.0 / _gridLonCells)) {
+        lonSpan = _gridLonCells - 1;
+    } else {
+        // Regions which cross the antimeridian wrap around to the start of the grid
+        lonSpan = _gridLonIndex(region.bottomRight().longitude()) - lonLow;
+        if (lonSpan < 0) {
+            lonSpan += _gridLonCells;
+        }
+    }
+
+    // Zoomed out views cover more cells than there are vehicles, a linear pass is cheaper then
+    qint64 cellCount = static_cast<qint64>(latHigh - latLow + 1) * (lonSpan + 1);
+    if (cellCount > _adsbICAOMap.count()) {
+        for (ADSBVehicle* adsbVehicle: _adsbICAOMap) {
+            if (region.contains(adsbVehicle->coordinate())) {
+                vehicles.append(adsbVehicle);
+            }
+        }
+        return vehicles;
+    }
+
+    for (int latIndex=latLow; latIndex<=latHigh; latIndex++) {
+        for (int i=0; i<=lonSpan; i++) {
+            GridCell_t cell = _gridCell(latIndex, (lonLow + i) % _gridLonCells);
+            for (auto iter = _grid.constFind(cell); iter != _grid.constEnd() && iter.key() == cell; ++iter) {
+                if (region.contains(iter.value()->coordinate())) {
+                    vehicles.append(iter.value());
+                }
+            }
+        }
+    }
+
+    return vehicles;
+}
+
+void ADSBVehicleManager::_updateVehiclesInView(void)
+{
+    QList<ADSBVehicle*> vehiclesInView;
+    if (_viewRegion.isValid()) {
+        vehiclesInView = vehiclesInRegion(_viewRegion);
+    } else {
+        for (int i=0; i<_adsbVehicles.count(); i++) {
+            vehiclesInView.append(_adsbVehicles.value<ADSBVehicle*>(i));
+        }
+    }
+
+    QSet<ADSBVehicle*> newInView;
+    for (ADSBVehicle* adsbVehicle: vehiclesInView) {
+        newInView.insert(adsbVehicle);
+    }
+
+    // Drop the vehicles which left the view, whatever remains in the set afterwards is new to the view
+    for (int i=_adsbVehiclesInView.count()-1; i>=0; i--) {
+        ADSBVehicle* adsbVehicle = _adsbVehiclesInView.value<ADSBVehicle*>(i);
+        if (!newInView.remove(adsbVehicle)) {
+            _adsbVehiclesInView.removeAt(i);
+        }
+    }
+
+    if (!newInView.isEmpty()) {
+        QList<QObject*> addedVehicles;
+        for (ADSBVehicle* adsbVehicle: vehiclesInView) {
+            if (newInView.contains(adsbVehicle)) {
+                addedVehicles.append(adsbVehicle);
+            }
+        }
+        _adsbVehiclesInView.append(addedVehicles);
+    }
+}
+
+void ADSBVehicleManager::_updateGrid(ADSBVehicle* adsbVehicle)
+{
+    QGeoCoordinate  coordinate  = adsbVehicle->coordinate();
+    bool            valid       = coordinate.isValid();
+    GridCell_t      cell        = valid ? _gridCell(_gridLatIndex(coordinate.latitude()), _gridLonIndex(coordinate.longitude())) : 0;
+
+    auto iter = _vehicleGridCells.find(adsbVehicle);
+    if (iter != _vehicleGridCells.end()) {
+        if (valid && iter.value() == cell) {
+            return;
+        }
+        _grid.remove(iter.value(), adsbVehicle);
+        _vehicleGridCells.erase(iter);
+    }
+    if (valid) {
+        _grid.insert(cell, adsbVehicle);
+        _vehicleGridCells.insert(adsbVehicle, cell);
+    }
+}
+
+void ADSBVehicleManager::_removeFromGrid(ADSBVehicle* adsbVehicle)
+{
+    auto iter = _vehicleGridCells.find(adsbVehicle);
+    if (iter != _vehicleGridCells.end()) {
+        _grid.remove(iter.value(), adsbVehicle);
+        _vehicleGridCells.erase(iter);
+    }
+}
+
+ADSBVehicleManager::GridCell_t ADSBVehicleManager::_gridCell(int latIndex, int lonIndex)
+{
+    return static_cast<GridCell_t>((latIndex * _gridLonCells) + lonIndex);
+}
+
+int ADSBVehicleManager::_gridLatIndex(double latitude)
+{
+    return qBound(0, static_cast<int>(qFloor((latitude + 90.0) * _gridLatCells / 180.0)), _gridLatCells - 1);
+}
+
+int ADSBVehicleManager::_gridLonIndex(double longitude)
+{
+    int lonIndex = static_cast<int>(qFloor((longitude + 180.0) * _gridLonCells / 360.0)) % _gridLonCells;
+    return lonIndex < 0 ? lonIndex + _gridLonCells : lonIndex;
 }
 
 void ADSBVehicleManager::_tcpError(const QString errorMsg)
@@ -76,6 +260,9 @@ ADSBTCPLink::ADSBTCPLink(const QString& hostAddress, int port, QObject* parent)
     , _hostAddress  (hostAddress)
     , _port         (port)
 {
+    // Reserved capacity is kept when the buffer is emptied, so steady state reads don't allocate
+    _lineBuffer.reserve(_maxLineBufferSize);
+
     moveToThread(this);
     start();
 }
@@ -94,6 +281,11 @@ ADSBTCPLink::~ADSBTCPLink(void)
 
 void ADSBTCPLink::run(void)
 {
+    // Parsed updates are forwarded in batches rather than per message
+    QTimer updateTimer;
+    connect(&updateTimer, &QTimer::timeout, this, &ADSBTCPLink::_sendUpdates);
+    updateTimer.start(_updateBatchMs);
+
     _hardwareConnect();
     exec();
 }
@@ -119,110 +311,29 @@ void ADSBTCPLink::_hardwareConnect()
 void ADSBTCPLink::_readBytes(void)
 {
     if (_socket) {
-        while(_socket->canReadLine()) {
-            QByteArray bytes = _socket->readLine();
-            _parseLine(QString::fromLocal8Bit(bytes));
-        }
-    }
-}
-
-void ADSBTCPLink::_parseLine(const QString &line)
-{
-    if (line.startsWith(QStringLiteral("MSG"))) {
-        bool icaoOk;
-        int msgType = line.at(4).digitValue();
-        if (msgType == -1) {
-            qCDebug(ADSBVehicleManagerLog) << "ADSB Invalid message type " << line.at(4);
-            return;
-        }
-        // Skip unsupported mesg types to avoid parsing
-        if (msgType == 2 || msgType > 6) {
+        // Read straight into the line buffer, which keeps its capacity between reads
+        qint64 bytesAvailable = _socket->bytesAvailable();
+        if (bytesAvailable <= 0) {
             return;
         }
-        qCDebug(ADSBVehicleManagerLog) << " ADSB SBS-1 " << line;
-        QStringList values = line.split(QChar(','));
-        uint32_t icaoAddress = values[4].toUInt(&icaoOk, 16);
+        int bufferSize = _lineBuffer.size();
+        _lineBuffer.resize(bufferSize + static_cast<int>(bytesAvailable));
+        qint64 bytesRead = _socket->read(_lineBuffer.data() + bufferSize, bytesAvailable);
+        _lineBuffer.resize(bufferSize + static_cast<int>(qMax(bytesRead, static_cast<qint64>(0))));
 
-        if (!icaoOk) {
-            return;
-        }
+        ADSBSBSParser::parseBuffer(_lineBuffer, _pendingUpdates);
 
-        ADSBVehicle::ADSBVehicleInfo_t adsbInfo;
-        adsbInfo.icaoAddress = icaoAddress;
-
-        switch (msgType) {
-        case 1:
-        case 5:
-        case 6:
-            _parseAndEmitCallsign(adsbInfo, values);
-            break;
-        case 3:
-            _parseAndEmitLocation(adsbInfo, values);
-            break;
-        case 4:
-            _parseAndEmitHeading(adsbInfo, values);
-            break;
+        if (_lineBuffer.size() > _maxLineBufferSize) {
+            qCDebug(ADSBVehicleManagerLog) << "ADSB discarding unterminated data" << _lineBuffer.size();
+            _lineBuffer.resize(0);
         }
     }
 }
 
-void ADSBTCPLink::_parseAndEmitCallsign(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values)
+void ADSBTCPLink::_sendUpdates(void)
 {
-    QString callsign = values[10].trimmed();
-    if (callsign.isEmpty()) {
-        return;
+    if (!_pendingUpdates.isEmpty()) {
+        emit adsbVehicleUpdates(_pendingUpdates.values());
+        _pendingUpdates.clear();
     }
-
-    adsbInfo.callsign = callsign;
-    adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
-    emit adsbVehicleUpdate(adsbInfo);
 }
-
-void ADSBTCPLink::_parseAndEmitLocation(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values)
-{
-    bool altOk, latOk, lonOk;
-    int modeCAltitude;
-
-    QString altitudeStr = values[11];
-    // Altitude is either Barometric - based on pressure, in ft
-    // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
-    // If altitude ends with H, we have HAE
-    // There's a slight difference between Barometric alt and HAE, but it would require
-    // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
-    if (altitudeStr.endsWith('H')) {
-        altitudeStr.chop(1);
-    }
-    modeCAltitude = altitudeStr.toInt(&altOk);
-
-    double lat = values[14].toDouble(&latOk);
-    double lon = values[15].toDouble(&lonOk);
-    int alert = values[19].toInt();
-
-    if (!altOk || !latOk || !lonOk) {
-        return;
-    }
-    if (lat == 0 && lon == 0) {
-        return;
-    }
-
-    double altitude = modeCAltitude * 0.3048;
-    QGeoCoordinate location(lat, lon);
-    adsbInfo.location = location;
-    adsbInfo.altitude = altitude;
-    adsbInfo.alert = alert == 1;
-    adsbInfo.availableFlags = ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable | ADSBVehicle::AlertAvailable;
-    emit adsbVehicleUpdate(adsbInfo);
-}
-
-void ADSBTCPLink::_parseAndEmitHeading(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values)
-{
-    bool headingOk;
-    double heading = values[13].toDouble(&headingOk);
-    if (!headingOk) {
-        return;
-    }
-
-    adsbInfo.heading = heading;
-    adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
-    emit adsbVehicleUpdate(adsbInfo);
-}
\ No newline at end of file
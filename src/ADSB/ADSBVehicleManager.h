@@ -12,11 +12,14 @@
 #include "QGCToolbox.h"
 #include "QmlObjectListModel.h"
 #include "ADSBVehicle.h"
+#include "ADSBSBSParser.h"
 
 #include <QThread>
 #include <QTcpSocket>
 #include <QTimer>
 #include <QGeoCoordinate>
+#include <QGeoRectangle>
+#include <QHash>
 
 class ADSBVehicleManagerSettings;
 
@@ -29,25 +32,28 @@ public:
     ~ADSBTCPLink();
 
 signals:
-    void adsbVehicleUpdate(const ADSBVehicle::ADSBVehicleInfo_t vehicleInfo);
+    /// Updates received since the last batch, merged by ICAO address
+    void adsbVehicleUpdates(const QList<ADSBVehicle::ADSBVehicleInfo_t> vehicleInfos);
     void error(const QString errorMsg);
 
 protected:
     void run(void) final;
 
 private slots:
-    void _readBytes(void);
+    void _readBytes     (void);
+    void _sendUpdates   (void);
 
 private:
     void _hardwareConnect(void);
-    void _parseLine(const QString& line);
-
-    QString         _hostAddress;
-    int             _port;
-    QTcpSocket*     _socket =   nullptr;
-    void _parseAndEmitCallsign(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values);
-    void _parseAndEmitLocation(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values);
-    void _parseAndEmitHeading(ADSBVehicle::ADSBVehicleInfo_t &adsbInfo, QStringList values);
+
+    QString                     _hostAddress;
+    int                         _port;
+    QTcpSocket*                 _socket =   nullptr;
+    QByteArray                  _lineBuffer;            ///< Received bytes not yet parsed, reused across reads
+    ADSBSBSParser::UpdateMap_t  _pendingUpdates;
+
+    static const int _maxLineBufferSize = 64 * 1024;    ///< Buffer is discarded if no line terminator shows up within this size
+    static const int _updateBatchMs     = 200;          ///< Parsed updates are sent to the manager at this rate
 };
 
 class ADSBVehicleManager : public QGCTool {
@@ -56,23 +62,55 @@ class ADSBVehicleManager : public QGCTool {
 public:
     ADSBVehicleManager(QGCApplication* app, QGCToolbox* toolbox);
 
-    Q_PROPERTY(QmlObjectListModel* adsbVehicles READ adsbVehicles CONSTANT)
+    Q_PROPERTY(QmlObjectListModel* adsbVehicles         READ adsbVehicles       CONSTANT)
+    Q_PROPERTY(QmlObjectListModel* adsbVehiclesInView   READ adsbVehiclesInView CONSTANT)   ///< Vehicles within the region set by setViewRegion
+
+    /// Sets the map region used to filter adsbVehiclesInView. An invalid region shows all vehicles.
+    Q_INVOKABLE void setViewRegion(const QGeoCoordinate& coordinateNW, const QGeoCoordinate& coordinateSE);
+
+    QmlObjectListModel* adsbVehicles        (void) { return &_adsbVehicles; }
+    QmlObjectListModel* adsbVehiclesInView  (void) { return &_adsbVehiclesInView; }
 
-    QmlObjectListModel* adsbVehicles(void) { return &_adsbVehicles; }
+    /// @return Vehicles with a location inside the specified region, found through the spatial index
+    QList<ADSBVehicle*> vehiclesInRegion(const QGeoRectangle& region) const;
 
     // QGCTool overrides
     void setToolbox(QGCToolbox* toolbox) final;
 
 public slots:
+    /// Updates are queued and applied to the vehicles at a fixed rate
     void adsbVehicleUpdate  (const ADSBVehicle::ADSBVehicleInfo_t vehicleInfo);
+    void adsbVehicleUpdates (const QList<ADSBVehicle::ADSBVehicleInfo_t> vehicleInfos);
     void _tcpError          (const QString errorMsg);
 
 private slots:
-    void _cleanupStaleVehicles(void);
+    void _cleanupStaleVehicles  (void);
+    void _applyPendingUpdates   (void);
 
 private:
-    QmlObjectListModel              _adsbVehicles;
-    QMap<uint32_t, ADSBVehicle*>    _adsbICAOMap;
-    QTimer                          _adsbVehicleCleanupTimer;
-    ADSBTCPLink*                    _tcpLink = nullptr;
+    typedef quint32 GridCell_t;
+
+    void _queueUpdate           (const ADSBVehicle::ADSBVehicleInfo_t& vehicleInfo);
+    void _updateGrid            (ADSBVehicle* adsbVehicle);
+    void _removeFromGrid        (ADSBVehicle* adsbVehicle);
+    void _updateVehiclesInView  (void);
+
+    static GridCell_t   _gridCell       (int latIndex, int lonIndex);
+    static int          _gridLatIndex   (double latitude);
+    static int          _gridLonIndex   (double longitude);
+
+    QmlObjectListModel                      _adsbVehicles;
+    QmlObjectListModel                      _adsbVehiclesInView;
+    QHash<uint32_t, ADSBVehicle*>           _adsbICAOMap;
+    QHash<ADSBVehicle*, GridCell_t>         _vehicleGridCells;  ///< Grid cell each vehicle is currently indexed in
+    QMultiHash<GridCell_t, ADSBVehicle*>    _grid;              ///< Spatial index of vehicle locations
+    QGeoRectangle                           _viewRegion;
+    ADSBSBSParser::UpdateMap_t              _pendingUpdates;
+    QTimer                                  _updateBatchTimer;
+    QTimer                                  _adsbVehicleCleanupTimer;
+    ADSBTCPLink*                            _tcpLink = nullptr;
+
+    static const int    _updateBatchMs  = 200;      ///< Queued updates are applied to the vehicles at most this often
+    static const int    _gridLatCells   = 720;      ///< Spatial index uses 0.25 degree cells
+    static const int    _gridLonCells   = 1440;
 };
@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBVehicleManagerTest.h"
+#include "ADSBVehicleManager.h"
+#include "QGCApplication.h"
+
+#include <QFile>
+
+#include <string.h>
+
+/// Feeds the replay file through the parser in chunks of the specified size, the same way bytes arrive from the socket
+ADSBSBSParser::UpdateMap_t ADSBVehicleManagerTest::_replayUpdates(int chunkSize)
+{
+    ADSBSBSParser::UpdateMap_t updates;
+
+    QFile replayFile(QStringLiteral(":/unittest/ADSBReplay.sbs"));
+    if (!replayFile.open(QIODevice::ReadOnly)) {
+        return updates;
+    }
+    QByteArray replayBytes = replayFile.readAll();
+
+    QByteArray  buffer;
+    int         updateCount = 0;
+    for (int i=0; i<replayBytes.size(); i+=chunkSize) {
+        buffer.append(replayBytes.mid(i, chunkSize));
+        updateCount += ADSBSBSParser::parseBuffer(buffer, updates);
+    }
+    if (updateCount != 9 || !buffer.isEmpty()) {
+        qWarning() << "Unexpected replay results updateCount:buffer" << updateCount << buffer;
+        updates.clear();
+    }
+
+    return updates;
+}
+
+void ADSBVehicleManagerTest::_parseLine_test(void)
+{
+    ADSBVehicle::ADSBVehicleInfo_t adsbInfo;
+
+    // Location with HAE altitude and alert set, with line terminator
+    QByteArray line("MSG,3,1,1,40621D,1,2008/11/28,23:48:18.623,2008/11/28,23:53:19.173,,2500H,,,51.50000,-0.12000,,,0,1,0,0\r\n");
+    QVERIFY(ADSBSBSParser::parseLine(line.constData(), line.length(), adsbInfo));
+    QCOMPARE(adsbInfo.icaoAddress, static_cast<uint32_t>(0x40621D));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable | ADSBVehicle::AlertAvailable));
+    QCOMPARE(adsbInfo.location, QGeoCoordinate(51.5, -0.12));
+    QCOMPARE(adsbInfo.altitude, 2500 * 0.3048);
+    QCOMPARE(adsbInfo.alert, true);
+
+    // Callsign is trimmed
+    line = "MSG,1,1,1,4CA2D6,1,2008/11/28,23:48:18.611,2008/11/28,23:53:19.161,EZY85MH ,,,,,,,,,,,";
+    QVERIFY(ADSBSBSParser::parseLine(line.constData(), line.length(), adsbInfo));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::CallsignAvailable));
+    QCOMPARE(adsbInfo.callsign, QStringLiteral("EZY85MH"));
+
+    line = "MSG,4,1,1,4CA2D6,1,2008/11/28,23:48:18.611,2008/11/28,23:53:19.161,,,420,271.5,,,0,,,,,";
+    QVERIFY(ADSBSBSParser::parseLine(line.constData(), line.length(), adsbInfo));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::HeadingAvailable));
+    QCOMPARE(adsbInfo.heading, 271.5);
+
+    // Unsupported or unusable messages
+    const char* rgInvalidLines[] = {
+        "MSG,2,1,1,40621D,1,2008/11/28,23:48:18.624,2008/11/28,23:53:19.174,,,0,76.4,51.50100,-0.12100,,,,,,-1",
+        "MSG,8,1,1,3C6444,1,2008/11/28,23:48:18.631,2008/11/28,23:53:19.181,,,,,,,,,,,,0",
+        "MSG,3,1,1,00BEEF,1,2008/11/28,23:48:18.660,2008/11/28,23:53:19.210,,12000,,,0,0,,,0,0,0,0",
+        "MSG,3,1,1,ZZZZZZ,1,2008/11/28,23:48:18.670,2008/11/28,23:53:19.220,,12000,,,45.00000,5.00000,,,0,0,0,0",
+        "MSG,3,1,1,4CA2D6,1,2008/11/28,23:48:18.611,2008/11/28,23:53:19.161,,36000,,,51.45735",
+        "MSG,1,1,1,4CA2D6,1,2008/11/28,23:48:18.611,2008/11/28,23:53:19.161,   ,,,,,,,,,,,",
+        "STA,,5,179,400AE7,10103,2008/11/28,14:58:51.153,2008/11/28,14:58:51.153,RM",
+        "MSG",
+        "",
+    };
+    for (const char* invalidLine: rgInvalidLines) {
+        QVERIFY2(!ADSBSBSParser::parseLine(invalidLine, static_cast<int>(strlen(invalidLine)), adsbInfo), invalidLine);
+    }
+}
+
+void ADSBVehicleManagerTest::_replay_test(void)
+{
+    // Results must not depend on how the stream is split up
+    ADSBSBSParser::UpdateMap_t updates = _replayUpdates(4096);
+    QCOMPARE(updates.count(), 5);
+    for (int chunkSize: { 1, 7, 64 }) {
+        ADSBSBSParser::UpdateMap_t chunkUpdates = _replayUpdates(chunkSize);
+        QCOMPARE(chunkUpdates.count(), updates.count());
+        for (const ADSBVehicle::ADSBVehicleInfo_t& adsbInfo: updates) {
+            QVERIFY(chunkUpdates.contains(adsbInfo.icaoAddress));
+            QCOMPARE(chunkUpdates[adsbInfo.icaoAddress].availableFlags, adsbInfo.availableFlags);
+            QCOMPARE(chunkUpdates[adsbInfo.icaoAddress].location, adsbInfo.location);
+        }
+    }
+
+    // Updates for the same aircraft are merged, with the latest values winning
+    const ADSBVehicle::ADSBVehicleInfo_t& merged = updates[0x4CA2D6];
+    QCOMPARE(merged.availableFlags, static_cast<uint32_t>(ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable | ADSBVehicle::HeadingAvailable | ADSBVehicle::AlertAvailable));
+    QCOMPARE(merged.callsign, QStringLiteral("EZY85MH"));
+    QCOMPARE(merged.location, QGeoCoordinate(51.46, -1.03));
+    QCOMPARE(merged.altitude, 36025 * 0.3048);
+    QCOMPARE(merged.heading, 271.5);
+
+    QCOMPARE(updates[0xA12345].callsign, QStringLiteral("DAL123"));
+    QVERIFY(!updates.contains(0x00BEEF));
+}
+
+void ADSBVehicleManagerTest::_viewRegion_test(void)
+{
+    ADSBVehicleManager adsbVehicleManager(qgcApp(), nullptr);
+    ADSBSBSParser::UpdateMap_t updates = _replayUpdates(4096);
+    QCOMPARE(updates.count(), 5);
+
+    // Updates are applied as a batch, not as they arrive
+    adsbVehicleManager.adsbVehicleUpdates(updates.values());
+    QCOMPARE(adsbVehicleManager.adsbVehicles()->count(), 0);
+    QTRY_COMPARE(adsbVehicleManager.adsbVehicles()->count(), 5);
+
+    // No view region shows everything
+    QCOMPARE(adsbVehicleManager.adsbVehiclesInView()->count(), 5);
+
+    // London area, covers more grid cells than there are vehicles so it is filtered linearly
+    adsbVehicleManager.setViewRegion(QGeoCoordinate(52, -2), QGeoCoordinate(51, 0));
+    QCOMPARE(adsbVehicleManager.adsbVehiclesInView()->count(), 2);
+
+    // Small regions go through the grid
+    QCOMPARE(adsbVehicleManager.vehiclesInRegion(QGeoRectangle(QGeoCoordinate(51.6, -0.2), QGeoCoordinate(51.4, -0.1))).count(), 1);
+
+    // Region crossing the antimeridian
+    adsbVehicleManager.setViewRegion(QGeoCoordinate(35.1, 179.8), QGeoCoordinate(34.9, -179.9));
+    QCOMPARE(adsbVehicleManager.adsbVehiclesInView()->count(), 1);
+    QCOMPARE(adsbVehicleManager.adsbVehiclesInView()->value<ADSBVehicle*>(0)->icaoAddress(), 0x8678C0);
+
+    // Whole world is filtered without the grid
+    adsbVehicleManager.setViewRegion(QGeoCoordinate(80, -180), QGeoCoordinate(-80, 180));
+    QCOMPARE(adsbVehicleManager.adsbVehiclesInView()->count(), 5);
+
+    // Vehicle moving out of the view region and into another grid cell
+    adsbVehicleManager.setViewRegion(QGeoCoordinate(52, -2), QGeoCoordinate(51, 0));
+    ADSBVehicle::ADSBVehicleInfo_t adsbInfo;
+    adsbInfo.icaoAddress    = 0x40621D;
+    adsbInfo.location       = QGeoCoordinate(48.8, 2.3);
+    adsbInfo.availableFlags = ADSBVehicle::LocationAvailable;
+    adsbVehicleManager.adsbVehicleUpdate(adsbInfo);
+    QTRY_COMPARE(adsbVehicleManager.adsbVehiclesInView()->count(), 1);
+    QCOMPARE(adsbVehicleManager.vehiclesInRegion(QGeoRectangle(QGeoCoordinate(48.9, 2.2), QGeoCoordinate(48.7, 2.4))).count(), 2);
+    QCOMPARE(adsbVehicleManager.adsbVehicles()->count(), 5);
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "ADSBSBSParser.h"
+
+/// Unit test for the SBS-1 parser and the ADSBVehicleManager spatial index, driven by a replay file of SBS-1 messages
+class ADSBVehicleManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _parseLine_test    (void);
+    void _replay_test       (void);
+    void _viewRegion_test   (void);
+
+private:
+    ADSBSBSParser::UpdateMap_t _replayUpdates(int chunkSize);
+};
@@ -13,27 +13,86 @@ ExifParser::~ExifParser()
 
 }
 
+/// EXIF data is only handled in little endian (Intel) byte order
+/// @return false: value lies outside of the buffer
+template<typename T>
+static bool _readLittleEndian(const QByteArray& buf, int index, T& value)
+{
+    if (index < 0 || index > buf.count() - static_cast<int>(sizeof(T))) {
+        return false;
+    }
+    value = qFromLittleEndian<T>(reinterpret_cast<const uchar*>(buf.constData() + index));
+    return true;
+}
+
+QByteArray ExifParser::readHeader(QIODevice& image)
+{
+    // Only application segments may come before APP1, anything else means there is no EXIF data
+    static const int maxSegments = 16;
+
+    QByteArray header = image.read(2);
+    if (header != QByteArray("\xff\xd8", 2)) {
+        return QByteArray();
+    }
+
+    for (int i = 0; i < maxSegments; i++) {
+        QByteArray segmentHeader = image.read(4);
+        if (segmentHeader.count() < 4 || static_cast<uint8_t>(segmentHeader[0]) != 0xff) {
+            break;
+        }
+        uint8_t marker = static_cast<uint8_t>(segmentHeader[1]);
+        if ((marker < 0xe0 || marker > 0xef) && marker != 0xfe) {
+            break;
+        }
+        uint16_t segmentLength = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(segmentHeader.constData() + 2));
+        if (segmentLength < 2) {
+            break;
+        }
+        QByteArray segmentData = image.read(segmentLength - 2);
+        if (segmentData.count() != segmentLength - 2) {
+            break;
+        }
+        header.append(segmentHeader);
+        header.append(segmentData);
+        if (marker == 0xe1 && segmentData.startsWith("Exif")) {
+            return header;
+        }
+    }
+
+    return QByteArray();
+}
+
 double ExifParser::readTime(QByteArray& buf)
 {
     QByteArray tiffHeader("\x49\x49\x2A", 3);
     QByteArray createDateHeader("\x04\x90\x02", 3);
 
     // find header position
-    uint32_t tiffHeaderIndex = buf.indexOf(tiffHeader);
+    int tiffHeaderIndex = buf.indexOf(tiffHeader);
 
     // find creation date header index
-    uint32_t createDateHeaderIndex = buf.indexOf(createDateHeader);
-
-    // extract size of date-time string, -1 accounting for null-termination
-    uint32_t* sizeString = reinterpret_cast<uint32_t*>(buf.mid(createDateHeaderIndex + 4, 4).data());
-    uint32_t createDateStringSize = qFromLittleEndian(*sizeString) - 1;
+    int createDateHeaderIndex = buf.indexOf(createDateHeader);
+
+    // extract size of date-time string and location of date-time string
+    quint32 createDateStringSize;
+    quint32 createDateStringDataIndex;
+    if (tiffHeaderIndex < 0 || createDateHeaderIndex < 0 ||
+            !_readLittleEndian(buf, createDateHeaderIndex + 4, createDateStringSize) ||
+            !_readLittleEndian(buf, createDateHeaderIndex + 8, createDateStringDataIndex)) {
+        qWarning() << "Could not find creation time and date";
+        return -1.0;
+    }
 
-    // extract location of date-time string
-    uint32_t* dataIndex = reinterpret_cast<uint32_t*>(buf.mid(createDateHeaderIndex + 8, 4).data());
-    uint32_t createDateStringDataIndex = qFromLittleEndian(*dataIndex) + tiffHeaderIndex;
+    // -1 accounting for null-termination
+    quint64 createDateStringStart   = static_cast<quint64>(createDateStringDataIndex) + static_cast<quint64>(tiffHeaderIndex);
+    quint64 createDateStringEnd     = createDateStringStart + createDateStringSize - 1;
+    if (createDateStringSize < 1 || createDateStringEnd > static_cast<quint64>(buf.count())) {
+        qWarning() << "Creation time and date outside of EXIF data";
+        return -1.0;
+    }
 
     // read out data of create date-time field
-    QString createDate = buf.mid(createDateStringDataIndex, createDateStringSize);
+    QString createDate = buf.mid(static_cast<int>(createDateStringStart), static_cast<int>(createDateStringSize - 1));
 
     QStringList createDateList = createDate.split(' ');
     if (createDateList.count() < 2) {
@@ -59,17 +118,41 @@ double ExifParser::readTime(QByteArray& buf)
 bool ExifParser::write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag)
 {
     QByteArray app1Header("\xff\xe1", 2);
-    uint32_t app1HeaderInd = buf.indexOf(app1Header);
-    uint16_t *conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(app1HeaderInd + 2, 2).data());
-    uint16_t app1Size = *conversionPointer;
-    uint16_t app1SizeEndian = qFromBigEndian(app1Size) + 0xa5;  // change wrong endian
+    int app1HeaderInd = buf.indexOf(app1Header);
     QByteArray tiffHeader("\x49\x49\x2A", 3);
-    uint32_t tiffHeaderInd = buf.indexOf(tiffHeader);
-    conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(tiffHeaderInd + 8, 2).data());
-    uint16_t numberOfTiffFields  = *conversionPointer;
-    uint32_t nextIfdOffsetInd = tiffHeaderInd + 10 + 12 * (numberOfTiffFields);
-    conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(nextIfdOffsetInd, 2).data());
-    uint16_t nextIfdOffset = *conversionPointer;
+    int tiffHeaderInd = buf.indexOf(tiffHeader);
+    if (app1HeaderInd < 0 || tiffHeaderInd < app1HeaderInd || app1HeaderInd + 4 > buf.count()) {
+        qWarning() << "No little endian EXIF data found";
+        return false;
+    }
+
+    // Everything read or moved below has to be inside the APP1 segment, which has to fit in the buffer
+    uint16_t app1Size = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(buf.constData() + app1HeaderInd + 2));
+    int app1End = app1HeaderInd + 2 + app1Size;
+    if (app1End > buf.count() || app1Size > 0xffff - 0xa5) {
+        qWarning() << "EXIF segment truncated or full";
+        return false;
+    }
+    uint16_t app1SizeEndian = app1Size + 0xa5;  // change wrong endian
+
+    uint16_t numberOfTiffFields;
+    if (!_readLittleEndian(buf, tiffHeaderInd + 8, numberOfTiffFields)) {
+        qWarning() << "EXIF IFD0 truncated";
+        return false;
+    }
+    int nextIfdOffsetInd = tiffHeaderInd + 10 + 12 * (numberOfTiffFields);
+    // The GPS IFD entry takes the place of the 12 bytes which follow the next IFD offset
+    uint32_t nextIfdOffset;
+    if (nextIfdOffsetInd + 4 + 12 > app1End || !_readLittleEndian(buf, nextIfdOffsetInd, nextIfdOffset)) {
+        qWarning() << "EXIF IFD0 entries outside of EXIF segment";
+        return false;
+    }
+    // The GPS IFD is inserted where IFD1 starts, past everything moved around above
+    if (nextIfdOffset > static_cast<uint32_t>(app1End - tiffHeaderInd) ||
+            static_cast<int>(nextIfdOffset) + tiffHeaderInd < nextIfdOffsetInd + 4 + 12) {
+        qWarning() << "EXIF IFD1 offset invalid" << nextIfdOffset;
+        return false;
+    }
 
     // Definition of useful unions and structs
     union char2uint32_u {
@@ -3,6 +3,7 @@
 
 #include <QGeoCoordinate>
 #include <QDebug>
+#include <QIODevice>
 
 #include "GeoTagController.h"
 
@@ -13,6 +14,11 @@ public:
     ~ExifParser();
     double readTime(QByteArray& buf);
     bool write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag);
+
+    /// Reads the start of a JPEG up to the end of the APP1 (EXIF) segment, which is all readTime and write need to
+    /// look at. On return the device is positioned at the first byte following the returned data.
+    /// @return Header bytes, empty if no APP1 segment was found
+    static QByteArray readHeader(QIODevice& image);
 };
 
 #endif // EXIFPARSER_H
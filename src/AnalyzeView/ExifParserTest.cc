@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ExifParserTest.h"
+#include "ExifParser.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QtEndian>
+
+static const char* kCreateDate = "2020:01:02 03:04:05";
+
+/// EXIF is little endian, as are all the platforms we run tests on
+template<typename T>
+static void _append(QByteArray& bytes, T value)
+{
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+static T _read(const QByteArray& bytes, int index)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(bytes.constData() + index));
+}
+
+QByteArray ExifParserTest::_exifHeader(quint16 ifd0EntryCount, quint32 ifd1Offset)
+{
+    QByteArray tiff("II*\0", 4);
+    _append<quint32>(tiff, 8);                      // IFD0 offset
+
+    // IFD0, the creation date followed by any extra (unused) entries the test asks for
+    _append<quint16>(tiff, ifd0EntryCount);
+    _append<quint16>(tiff, 0x9004);                 // DateTimeDigitized
+    _append<quint16>(tiff, 2);                      // ASCII
+    _append<quint32>(tiff, kDateSize);
+    _append<quint32>(tiff, kDateOffset);
+    _append<quint32>(tiff, ifd1Offset);
+    tiff.append(QByteArray(12, 0));                 // Space the GPS IFD entry takes over
+    tiff.append(kCreateDate, kDateSize);
+
+    // IFD1, empty
+    _append<quint16>(tiff, 0);
+    _append<quint32>(tiff, 0);
+
+    QByteArray app1("Exif\0\0", 6);
+    app1.append(tiff);
+
+    QByteArray header("\xff\xd8\xff\xe1", 4);
+    quint16 app1Size = qToBigEndian<quint16>(static_cast<quint16>(app1.count() + 2));
+    header.append(reinterpret_cast<const char*>(&app1Size), 2);
+    header.append(app1);
+    return header;
+}
+
+void ExifParserTest::_readWrite_test(void)
+{
+    QByteArray header = _exifHeader();
+    QCOMPARE(header.count(), kTiffStart + kIfd1Offset + 6);
+
+    // readHeader stops at the end of the APP1 segment
+    QByteArray image = header + QByteArray("\xff\xdb\x00\x04\x00\x00", 6);
+    QBuffer buffer(&image);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCOMPARE(ExifParser::readHeader(buffer), header);
+    QCOMPARE(buffer.pos(), static_cast<qint64>(header.count()));
+
+    ExifParser parser;
+    QDateTime createDate(QDate(2020, 1, 2), QTime(3, 4, 5));
+    QCOMPARE(parser.readTime(header), createDate.toMSecsSinceEpoch() / 1000.0);
+
+    GeoTagWorker::cameraFeedbackPacket geotag = {};
+    geotag.latitude     = 47.3977;
+    geotag.longitude    = 8.5456;
+    geotag.altitude     = 488.0;
+    const int originalCount = header.count();
+    QVERIFY(parser.write(header, geotag));
+
+    // The GPS IFD is 0xa5 bytes, the segment length and IFD0 entry count follow along
+    QCOMPARE(header.count(), originalCount + 0xa5);
+    QCOMPARE(qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(header.constData() + 4)), static_cast<quint16>(header.count() - 4));
+    QCOMPARE(_read<quint16>(header, kTiffStart + 8), static_cast<quint16>(2));
+    QCOMPARE(_read<quint16>(header, kTiffStart + 22), static_cast<quint16>(0x8825));
+    QCOMPARE(_read<quint32>(header, kTiffStart + 30), static_cast<quint32>(kIfd1Offset));
+    QCOMPARE(_read<quint16>(header, kTiffStart + kIfd1Offset), static_cast<quint16>(8));
+
+    // The creation date did not move
+    QCOMPARE(parser.readTime(header), createDate.toMSecsSinceEpoch() / 1000.0);
+}
+
+void ExifParserTest::_truncated_test(void)
+{
+    const QByteArray    header  = _exifHeader();
+    const int           dateEnd = kTiffStart + kDateOffset + kDateSize - 1;
+    ExifParser          parser;
+
+    for (int count=0; count<header.count(); count++) {
+        QByteArray truncated = header.left(count);
+
+        QBuffer buffer(&truncated);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QVERIFY(ExifParser::readHeader(buffer).isEmpty());
+
+        GeoTagWorker::cameraFeedbackPacket geotag = {};
+        QVERIFY(!parser.write(truncated, geotag));
+        QCOMPARE(truncated, header.left(count));
+
+        if (count < dateEnd) {
+            QCOMPARE(parser.readTime(truncated), -1.0);
+        }
+    }
+}
+
+void ExifParserTest::_malformed_test(void)
+{
+    ExifParser                          parser;
+    GeoTagWorker::cameraFeedbackPacket  geotag = {};
+
+    // IFD0 entries running past the end of the segment
+    QByteArray header = _exifHeader(0xffff);
+    QVERIFY(!parser.write(header, geotag));
+
+    // IFD1 past the end of the segment
+    header = _exifHeader(1, 0x7fffffff);
+    QVERIFY(!parser.write(header, geotag));
+
+    // IFD1 overlapping IFD0, or missing
+    header = _exifHeader(1, 8);
+    QVERIFY(!parser.write(header, geotag));
+    header = _exifHeader(1, 0);
+    QVERIFY(!parser.write(header, geotag));
+
+    // Segment length larger than the data
+    header = _exifHeader();
+    header[4] = static_cast<char>(0x7f);
+    QVERIFY(!parser.write(header, geotag));
+
+    // No TIFF header at all
+    header = _exifHeader();
+    header.replace(kTiffStart, 3, "MM\0", 3);
+    QVERIFY(!parser.write(header, geotag));
+    QCOMPARE(parser.readTime(header), -1.0);
+
+    // Creation date pointing outside of the data, and with a length which wraps around
+    header = _exifHeader();
+    header.replace(kTiffStart + 18, 4, "\xff\xff\xff\x7f", 4);
+    QCOMPARE(parser.readTime(header), -1.0);
+    header = _exifHeader();
+    header.replace(kTiffStart + 14, 4, "\x00\x00\x00\x00", 4);
+    QCOMPARE(parser.readTime(header), -1.0);
+    header = _exifHeader();
+    header.replace(kTiffStart + 14, 4, "\xff\xff\xff\xff", 4);
+    QCOMPARE(parser.readTime(header), -1.0);
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for ExifParser. The EXIF headers are built in memory: a JPEG start of image followed by an APP1 segment
+/// holding a little endian TIFF header, IFD0 with the creation date and an empty IFD1.
+class ExifParserTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _readWrite_test    (void);
+    void _truncated_test    (void);
+    void _malformed_test    (void);
+
+private:
+    QByteArray  _exifHeader (quint16 ifd0EntryCount = 1, quint32 ifd1Offset = kIfd1Offset);
+
+    static const int kTiffStart     = 2 + 4 + 6;    ///< SOI, APP1 marker and length, "Exif\0\0"
+    static const int kDateOffset    = 38;           ///< Creation date string, relative to the TIFF header
+    static const int kDateSize      = 20;
+    static const int kIfd1Offset    = 58;           ///< Relative to the TIFF header
+};
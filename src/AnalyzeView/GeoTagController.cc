@@ -15,6 +15,9 @@
 #include <cfloat>
 #include <QDir>
 #include <QUrl>
+#include <QtConcurrent>
+
+#include <limits>
 
 #include "ExifParser.h"
 #include "ULogParser.h"
@@ -24,9 +27,11 @@ static const char* kTagged = "/TAGGED";
 
 GeoTagController::GeoTagController()
     : _progress(0)
+    , _throughput(0)
     , _inProgress(false)
 {
     connect(&_worker, &GeoTagWorker::progressChanged,   this, &GeoTagController::_workerProgressChanged);
+    connect(&_worker, &GeoTagWorker::throughputChanged, this, &GeoTagController::_workerThroughputChanged);
     connect(&_worker, &GeoTagWorker::error,             this, &GeoTagController::_workerError);
     connect(&_worker, &GeoTagWorker::started,           this, &GeoTagController::inProgressChanged);
     connect(&_worker, &GeoTagWorker::finished,          this, &GeoTagController::inProgressChanged);
@@ -120,6 +125,12 @@ void GeoTagController::_workerProgressChanged(double progress)
     emit progressChanged(progress);
 }
 
+void GeoTagController::_workerThroughputChanged(double imagesPerSecond)
+{
+    _throughput = imagesPerSecond;
+    emit throughputChanged(imagesPerSecond);
+}
+
 void GeoTagController::_workerError(QString errorMessage)
 {
     _errorMessage = errorMessage;
@@ -161,26 +172,18 @@ void GeoTagWorker::run()
     emit progressChanged((100/nSteps));
 
     // Parse EXIF
-    ExifParser exifParser;
-    _imageTime.clear();
-    for (int i = 0; i < _imageList.size(); ++i) {
-        QFile file(_imageList.at(i).absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
+    QFuture<double> imageTimes = QtConcurrent::mapped(_imageList, &GeoTagWorker::_readImageTime);
+    if (!_waitForImages(imageTimes, _imageList.size(), (100/nSteps), (100/nSteps))) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
+    _imageTime = imageTimes.results();
+    for (double imageTime: _imageTime) {
+        if (qIsNaN(imageTime)) {
             emit error(tr("Geotagging failed. Couldn't open an image."));
             return;
         }
-        QByteArray imageBuffer = file.readAll();
-        file.close();
-
-        _imageTime.append(exifParser.readTime(imageBuffer));
-
-        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
-            return;
-        }
     }
 
     // Load log
@@ -190,22 +193,29 @@ void GeoTagWorker::run()
         emit error(tr("Geotagging failed. Couldn't open log file."));
         return;
     }
-    QByteArray log = file.readAll();
-    file.close();
 
     // Instantiate appropriate parser
     _triggerList.clear();
     bool parseComplete = false;
     QString errorString;
     if (isULog) {
+        // ULogs are streamed from the file, they can be far larger than we want to hold in memory
         ULogParser parser;
-        parseComplete = parser.getTagsFromLog(log, _triggerList, errorString);
+        auto progressCb = [this, nSteps](qint64 bytesRead, qint64 totalBytes) {
+            if (totalBytes > 0) {
+                emit progressChanged(2*(100/nSteps) + ((100/nSteps) * bytesRead) / totalBytes);
+            }
+            return !_cancel;
+        };
+        parseComplete = parser.getTagsFromLog(file, _triggerList, errorString, progressCb);
 
     } else {
+        QByteArray log = file.readAll();
         PX4LogParser parser;
         parseComplete = parser.getTagsFromLog(log, _triggerList);
 
     }
+    file.close();
 
     if (!parseComplete) {
         if (_cancel) {
@@ -246,42 +256,32 @@ void GeoTagWorker::run()
     // Tag images
     int maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
     maxIndex = std::min(maxIndex, _imageList.count());
+    QList<ImageTagJob> tagJobs;
     for(int i = 0; i < maxIndex; i++) {
         int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return;
         }
-        QFile fileRead(_imageList.at(_imageIndices[i]).absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
-
-        if (!exifParser.write(imageBuffer, _triggerList[_triggerIndices[i]])) {
-            emit error(tr("Geotagging failed. Couldn't write to image."));
-            return;
+        ImageTagJob job;
+        job.imagePath   = _imageList.at(imageIndex).absoluteFilePath();
+        job.geotag      = _triggerList[_triggerIndices[i]];
+        if(_saveDirectory == "") {
+            job.taggedPath = _imageDirectory + "/TAGGED/" + _imageList.at(imageIndex).fileName();
         } else {
-            QFile fileWrite;
-            if(_saveDirectory == "") {
-                fileWrite.setFileName(_imageDirectory + "/TAGGED/" + _imageList.at(_imageIndices[i]).fileName());
-            } else {
-                fileWrite.setFileName(_saveDirectory + "/" + _imageList.at(_imageIndices[i]).fileName());
-            }
-            if (!fileWrite.open(QFile::WriteOnly)) {
-                emit error(tr("Geotagging failed. Couldn't write to an image."));
-                return;
-            }
-            fileWrite.write(imageBuffer);
-            fileWrite.close();
+            job.taggedPath = _saveDirectory + "/" + _imageList.at(imageIndex).fileName();
         }
-        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
+        tagJobs.append(job);
+    }
+    QFuture<QString> tagResults = QtConcurrent::mapped(tagJobs, &GeoTagWorker::_tagImage);
+    if (!_waitForImages(tagResults, tagJobs.count(), 4*(100/nSteps), (100/nSteps))) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
+    for (const QString& tagError: tagResults.results()) {
+        if (!tagError.isEmpty()) {
+            emit error(tagError);
             return;
         }
     }
@@ -295,6 +295,86 @@ void GeoTagWorker::run()
     emit progressChanged(100);
 }
 
+/// Waits for the images to be processed by the thread pool, reporting progress and throughput as it goes
+/// @return false: tagging was cancelled
+bool GeoTagWorker::_waitForImages(QFuture<void> future, int imageCount, double progressStart, double progressRange)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!future.isFinished()) {
+        if (_cancel) {
+            future.cancel();
+            future.waitForFinished();
+            emit throughputChanged(0);
+            return false;
+        }
+        int imagesDone = future.progressValue();
+        if (imageCount > 0) {
+            emit progressChanged(progressStart + (progressRange * imagesDone) / imageCount);
+        }
+        if (timer.elapsed() > 0) {
+            emit throughputChanged((imagesDone * 1000.0) / timer.elapsed());
+        }
+        QThread::msleep(100);
+    }
+
+    qCDebug(GeotaggingLog) << "Processed" << imageCount << "images in" << timer.elapsed() << "msecs";
+    emit throughputChanged(0);
+    return true;
+}
+
+/// Runs on the thread pool
+/// @return Image creation time, -1 if it can't be decoded, NaN if the image can't be read
+double GeoTagWorker::_readImageTime(const QFileInfo& imageInfo)
+{
+    QFile file(imageInfo.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    QByteArray header = ExifParser::readHeader(file);
+    if (header.isEmpty()) {
+        qCWarning(GeotaggingLog) << "No EXIF segment found" << imageInfo.fileName();
+        return -1.0;
+    }
+
+    ExifParser exifParser;
+    return exifParser.readTime(header);
+}
+
+/// Runs on the thread pool. Only the EXIF header is modified in memory, the image data is copied across in chunks.
+/// @return Error message, empty on success
+QString GeoTagWorker::_tagImage(const ImageTagJob& job)
+{
+    static const qint64 copyChunkSize = 1024 * 1024;
+
+    QFile fileRead(job.imagePath);
+    if (!fileRead.open(QIODevice::ReadOnly)) {
+        return tr("Geotagging failed. Couldn't open an image.");
+    }
+    QByteArray header = ExifParser::readHeader(fileRead);
+    ExifParser exifParser;
+    cameraFeedbackPacket geotag = job.geotag;
+    if (header.isEmpty() || !exifParser.write(header, geotag)) {
+        return tr("Geotagging failed. Couldn't write to image.");
+    }
+
+    QFile fileWrite(job.taggedPath);
+    if (!fileWrite.open(QFile::WriteOnly)) {
+        return tr("Geotagging failed. Couldn't write to an image.");
+    }
+    bool writeOk = fileWrite.write(header) == header.count();
+    QByteArray chunk;
+    while (writeOk && !(chunk = fileRead.read(copyChunkSize)).isEmpty()) {
+        writeOk = fileWrite.write(chunk) == chunk.count();
+    }
+    if (!writeOk) {
+        return tr("Geotagging failed. Couldn't write to an image.");
+    }
+
+    return QString();
+}
+
 bool GeoTagWorker::triggerFiltering()
 {
     _imageIndices.clear();
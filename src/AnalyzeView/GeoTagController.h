@@ -18,6 +18,7 @@
 #include <QThread>
 #include <QFileInfoList>
 #include <QElapsedTimer>
+#include <QFuture>
 #include <QDebug>
 #include <QGeoCoordinate>
 
@@ -57,9 +58,20 @@ signals:
     void error              (QString errorMsg);
     void taggingComplete    ();
     void progressChanged    (double progress);
+    void throughputChanged  (double imagesPerSecond);
 
 private:
+    struct ImageTagJob {
+        QString                 imagePath;
+        QString                 taggedPath;
+        cameraFeedbackPacket    geotag;
+    };
+
     bool triggerFiltering();
+    bool _waitForImages     (QFuture<void> future, int imageCount, double progressStart, double progressRange);
+
+    static double   _readImageTime  (const QFileInfo& imageInfo);
+    static QString  _tagImage       (const ImageTagJob& job);
 
     bool                    _cancel;
     QString                 _logFile;
@@ -94,6 +106,9 @@ public:
     /// true: Currently in the process of tagging
     Q_PROPERTY(bool     inProgress      READ inProgress     NOTIFY inProgressChanged)
 
+    /// Images read or tagged per second in the current phase, 0 if not processing images
+    Q_PROPERTY(double   throughput      READ throughput     NOTIFY throughputChanged)
+
     Q_INVOKABLE void startTagging();
     Q_INVOKABLE void cancelTagging() { _worker.cancelTagging(); }
 
@@ -102,6 +117,7 @@ public:
     QString saveDirectory       () const { return _worker.saveDirectory(); }
     double  progress            () const { return _progress; }
     bool    inProgress          () const { return _worker.isRunning(); }
+    double  throughput          () const { return _throughput; }
     QString errorMessage        () const { return _errorMessage; }
 
     void    setLogFile          (QString file);
@@ -115,15 +131,18 @@ signals:
     void progressChanged        (double progress);
     void inProgressChanged      ();
     void errorMessageChanged    (QString errorMessage);
+    void throughputChanged      (double throughput);
 
 private slots:
     void _workerProgressChanged (double progress);
     void _workerError           (QString errorMsg);
+    void _workerThroughputChanged(double imagesPerSecond);
     void _setErrorMessage       (const QString& error);
 
 private:
     QString             _errorMessage;
     double              _progress;
+    double              _throughput;
     bool                _inProgress;
 
     GeoTagWorker        _worker;
@@ -62,6 +62,14 @@ AnalyzePage {
                 Layout.columnSpan:  2
             }
             //-----------------------------------------------------------------
+            QGCLabel {
+                text:               qsTr("%1 images/sec").arg(geoController.throughput.toFixed(1))
+                visible:            geoController.throughput > 0
+                horizontalAlignment:Text.AlignHCenter
+                Layout.alignment:   Qt.AlignHCenter
+                Layout.columnSpan:  2
+            }
+            //-----------------------------------------------------------------
             //-- Log File
             QGCButton {
                 text:               qsTr("Select log file")
@@ -28,16 +28,25 @@
 #define kTimeOutMilliseconds 500
 #define kGUIRateMilliseconds 17
 #define kTableBins           512
-#define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kWindowBins          (kTableBins * 8)   // Largest single request, a new request cancels any stream in progress
 
 QGC_LOGGING_CATEGORY(LogDownloadLog, "LogDownloadLog")
 
 //-----------------------------------------------------------------------------
+// Received data is tracked per MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bin over the whole log. Packets are accepted in
+// any order and written straight into the preallocated, memory mapped log file.
 struct LogDownloadData {
     LogDownloadData(QGCLogEntry* entry);
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
+    ~LogDownloadData();
+    QBitArray     bin_table;
+    uint32_t      bins_received;    // Running count of set bits in bin_table
+    uint32_t      first_missing;    // All bins below this have been received
+    uint32_t      request_start;    // Bin range of the request in progress
+    uint32_t      request_end;
+    uint32_t      requested_end;    // Bins below this have been requested at least once
+    uint32_t      retransmit_bins;  // Bins requested more than once
     QFile         file;
+    uchar*        map;
     QString       filename;
     uint          ID;
     QGCLogEntry*  entry;
@@ -46,36 +55,52 @@ struct LogDownloadData {
     qreal         rate_avg;
     QElapsedTimer elapsed;
 
-    void advanceChunk()
+    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the file
+    uint32_t numBins() const
     {
-           current_chunk++;
-           chunk_table = QBitArray(chunkBins(), false);
+        return qCeil(entry->size() / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN));
     }
 
-    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const
+    // Stores a bin, returns false if it was already received
+    bool setBin(uint32_t bin, uint32_t ofs, const uint8_t* data, uint8_t count)
     {
-        return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
-                    kTableBins);
-    }
-
-    // The number of kChunkSize chunks in the file
-    uint32_t numChunks() const
-    {
-        return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
+        if (bin_table.testBit(bin)) {
+            return false;
+        }
+        if (map) {
+            memcpy(map + ofs, data, count);
+        } else if (!file.seek(ofs) || file.write(reinterpret_cast<const char*>(data), count) != count) {
+            qWarning() << "Error while writing log file chunk";
+            return false;
+        }
+        bin_table.setBit(bin);
+        bins_received++;
+        while (first_missing < static_cast<uint32_t>(bin_table.size()) && bin_table.testBit(first_missing)) {
+            first_missing++;
+        }
+        return true;
     }
 
-    // True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const
+    void closeFile()
     {
-        return chunk_table == QBitArray(chunk_table.size(), val);
+        if (map) {
+            file.unmap(map);
+            map = nullptr;
+        }
+        file.close();
     }
-
 };
 
 //----------------------------------------------------------------------------------------
 LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
+    : bins_received(0)
+    , first_missing(0)
+    , request_start(0)
+    , request_end(0)
+    , requested_end(0)
+    , retransmit_bins(0)
+    , map(nullptr)
+    , ID(entry_->id())
     , entry(entry_)
     , written(0)
     , rate_bytes(0)
@@ -84,6 +109,11 @@ LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
 
 }
 
+LogDownloadData::~LogDownloadData()
+{
+    closeFile();
+}
+
 //----------------------------------------------------------------------------------------
 QGCLogEntry::QGCLogEntry(uint logId, const QDateTime& dateTime, uint logSize, bool received)
     : _logID(logId)
@@ -301,9 +331,16 @@ void LogDownloadController::_updateDataRate(void)
         _downloadData->rate_avg = (_downloadData->rate_avg * 0.95) + (rrate * 0.05);
         _downloadData->rate_bytes = 0;
 
+        _downloadRate       = _downloadData->rate_avg;
+        _retransmitRatio    = _downloadData->bin_table.size() ? _downloadData->retransmit_bins / static_cast<qreal>(_downloadData->bin_table.size()) : 0;
+        emit downloadStatsChanged();
+
         //-- Update status
-        const QString status = QString("%1 (%2/s)").arg(QGCMapEngine::bigSizeToString(_downloadData->written),
-                                                        QGCMapEngine::bigSizeToString(_downloadData->rate_avg));
+        QString status = QString("%1 (%2/s)").arg(QGCMapEngine::bigSizeToString(_downloadData->written),
+                                                  QGCMapEngine::bigSizeToString(_downloadData->rate_avg));
+        if (_downloadData->retransmit_bins) {
+            status += tr(" %1% resent").arg(_retransmitRatio * 100.0, 0, 'f', 1);
+        }
 
         _downloadData->entry->setStatus(status);
         _downloadData->elapsed.start();
@@ -330,75 +367,39 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
         return;
     }
 
-    bool result = false;
-    uint32_t timeout_time = kTimeOutMilliseconds;
-    if(ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qWarning() << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
-            return;
-        }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qWarning() << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
-        if (_downloadData->file.pos() != ofs) {
-            // Seek to correct position
-            if (!_downloadData->file.seek(ofs)) {
-                qWarning() << "Error while seeking log file offset";
-                return;
-            }
-        }
+    if (count == 0 || static_cast<quint64>(ofs) + count > _downloadData->entry->size()) {
+        qWarning() << "Ignored log data packet out of range ofs:count" << ofs << count;
+        return;
+    }
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-            result = true;
-            //-- reset retries
-            _retries = 0;
-            //-- Reset timer
-            _timer.start(timeout_time);
-            //-- Do we have it all?
-            if(_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                //-- Check for more
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
-            qWarning() << "Error while writing log file chunk";
-        }
-    } else {
-        qWarning() << "Received log offset greater than expected";
+    //-- Any bin of the log is accepted, whatever request it belongs to
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (_downloadData->setBin(bin, ofs, data, count)) {
+        _downloadData->written += count;
+        _downloadData->rate_bytes += count;
     }
-    if(!result) {
-        _downloadData->entry->setStatus(tr("Error"));
+    _updateDataRate();
+    //-- reset retries
+    _retries = 0;
+    //-- Reset timer
+    _timer.start(kTimeOutMilliseconds);
+    //-- Do we have it all?
+    if(_logComplete()) {
+        _downloadData->entry->setStatus(tr("Downloaded"));
+        //-- Check for more
+        _receivedAllData();
+    } else if (bin + 1 == _downloadData->request_end) {
+        //-- End of the requested range, move on to the next missing range
+        _requestNextRange();
     }
 }
 
 
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
 //----------------------------------------------------------------------------------------
 bool
 LogDownloadController::_logComplete() const
 {
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    return _downloadData->bins_received == static_cast<uint32_t>(_downloadData->bin_table.size());
 }
 
 //----------------------------------------------------------------------------------------
@@ -406,10 +407,13 @@ void
 LogDownloadController::_receivedAllData()
 {
     _timer.stop();
+    if (_downloadData) {
+        qCDebug(LogDownloadLog) << "Log download complete" << _downloadData->filename << "rate" << _downloadData->rate_avg << "retransmit ratio" << _retransmitRatio;
+    }
     //-- Anything queued up for download?
     if(_prepareLogDownload()) {
         //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+        _requestNextRange();
         _timer.start(kTimeOutMilliseconds);
     } else {
         _resetSelection();
@@ -424,8 +428,6 @@ LogDownloadController::_findMissingData()
     if (_logComplete()) {
          _receivedAllData();
          return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
     }
 
     _retries++;
@@ -442,23 +444,34 @@ LogDownloadController::_findMissingData()
 #endif
 
     _updateDataRate();
+    _requestNextRange();
+}
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
-        }
+//----------------------------------------------------------------------------------------
+/// Requests the first range of missing bins, up to kWindowBins. Lost packets leave holes which are requested on their
+/// own, so only missing data is sent again.
+void
+LogDownloadController::_requestNextRange()
+{
+    const uint32_t size  = static_cast<uint32_t>(_downloadData->bin_table.size());
+    const uint32_t start = _downloadData->first_missing;
+    uint32_t       end   = start;
+    while (end < size && end - start < kWindowBins && !_downloadData->bin_table.testBit(end)) {
+        end++;
+    }
+    if (start >= size) {
+        return;
     }
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
+    if (start < _downloadData->requested_end) {
+        _downloadData->retransmit_bins += qMin(end, _downloadData->requested_end) - start;
     }
+    _downloadData->requested_end = qMax(end, _downloadData->requested_end);
+    _downloadData->request_start = start;
+    _downloadData->request_end   = end;
 
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    const uint32_t pos = start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                   len = (end - start) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     _requestLogData(_downloadData->ID, pos, len, _retries);
 }
 
@@ -626,20 +639,30 @@ LogDownloadController::_prepareLogDownload()
         } while( _downloadData->file.exists());
     }
     //-- Create file
-    if (!_downloadData->file.open(QIODevice::WriteOnly)) {
+    if (!_downloadData->file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
         qWarning() << "Failed to create log file:" <<  _downloadData->filename;
     } else {
         //-- Preallocate file
         if(!_downloadData->file.resize(entry->size())) {
             qWarning() << "Failed to allocate space for log file:" <<  _downloadData->filename;
         } else {
-            _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
+            if (entry->size()) {
+                //-- Fall back to seek and write if the file can't be mapped
+                _downloadData->map = _downloadData->file.map(0, entry->size());
+                if (!_downloadData->map) {
+                    qCWarning(LogDownloadLog) << "Unable to map log file" << _downloadData->filename << _downloadData->file.errorString();
+                }
+            }
+            _downloadData->bin_table = QBitArray(static_cast<int>(_downloadData->numBins()), false);
             _downloadData->elapsed.start();
+            _downloadRate       = 0;
+            _retransmitRatio    = 0;
+            emit downloadStatsChanged();
             result = true;
         }
     }
     if(!result) {
+        _downloadData->closeFile();
         if (_downloadData->file.exists()) {
             _downloadData->file.remove();
         }
@@ -703,6 +726,7 @@ LogDownloadController::cancel(void)
     }
     if(_downloadData) {
         _downloadData->entry->setStatus(tr("Canceled"));
+        _downloadData->closeFile();
         if (_downloadData->file.exists()) {
             _downloadData->file.remove();
         }
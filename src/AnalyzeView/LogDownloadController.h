@@ -119,10 +119,14 @@ public:
     Q_PROPERTY(QGCLogModel* model           READ model              NOTIFY modelChanged)
     Q_PROPERTY(bool         requestingList  READ requestingList     NOTIFY requestingListChanged)
     Q_PROPERTY(bool         downloadingLogs READ downloadingLogs    NOTIFY downloadingLogsChanged)
+    Q_PROPERTY(qreal        downloadRate    READ downloadRate       NOTIFY downloadStatsChanged)    ///< bytes/sec
+    Q_PROPERTY(qreal        retransmitRatio READ retransmitRatio    NOTIFY downloadStatsChanged)    ///< Bytes requested again / log size
 
     QGCLogModel*    model                   () { return &_logEntriesModel; }
     bool            requestingList          () const{ return _requestingLogEntries; }
     bool            downloadingLogs         () const{ return _downloadingLogs; }
+    qreal           downloadRate            () const{ return _downloadRate; }
+    qreal           retransmitRatio         () const{ return _retransmitRatio; }
 
     Q_INVOKABLE void refresh                ();
     Q_INVOKABLE void download               (QString path = QString());
@@ -136,6 +140,7 @@ signals:
     void downloadingLogsChanged ();
     void modelChanged           ();
     void selectionChanged       ();
+    void downloadStatsChanged   ();
 
 private slots:
     void _setActiveVehicle  (Vehicle* vehicle);
@@ -145,13 +150,13 @@ private slots:
 
 private:
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
     bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
     void _receivedAllData   ();
     void _resetSelection    (bool canceled = false);
     void _findMissingData   ();
+    void _requestNextRange  ();
     void _requestLogList    (uint32_t start, uint32_t end);
     void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
     bool _prepareLogDownload();
@@ -171,6 +176,8 @@ private:
     int                 _retries;
     int                 _apmOneBased;
     QString             _downloadPath;
+    qreal               _downloadRate       = 0;
+    qreal               _retransmitRatio    = 0;
 };
 
 #endif
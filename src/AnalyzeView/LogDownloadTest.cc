@@ -20,8 +20,20 @@ LogDownloadTest::LogDownloadTest(void)
 
 void LogDownloadTest::downloadTest(void)
 {
+    _downloadTest(1000, 0, 10000);
+}
+
+/// Larger log over a lossy link, the lost packets must be requested again
+void LogDownloadTest::lossyDownloadTest(void)
+{
+    _downloadTest(100000, 7, 60000);
+}
 
+void LogDownloadTest::_downloadTest(uint32_t logSize, int dropEveryN, int timeoutMsecs)
+{
     _connectMockLink(MAV_AUTOPILOT_PX4);
+    _mockLink->setLogDownloadFileSize(logSize);
+    _mockLink->setLogDownloadDropRate(dropEveryN);
 
     LogDownloadController* controller = new LogDownloadController();
 
@@ -52,15 +64,19 @@ void LogDownloadTest::downloadTest(void)
     QVERIFY(_multiSpyLogDownloadController->waitForSignalByIndex(downloadingLogsChangedSignalIndex, 10000));
     _multiSpyLogDownloadController->clearAllSignals();
     if (controller->downloadingLogs()) {
-        QVERIFY(_multiSpyLogDownloadController->waitForSignalByIndex(downloadingLogsChangedSignalIndex, 10000));
+        QVERIFY(_multiSpyLogDownloadController->waitForSignalByIndex(downloadingLogsChangedSignalIndex, timeoutMsecs));
         QCOMPARE(controller->downloadingLogs(), false);
     }
     _multiSpyLogDownloadController->clearAllSignals();
 
     QString downloadFile = QDir(downloadTo).filePath("log_0_UnknownDate.ulg");
     QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+    if (dropEveryN) {
+        QVERIFY(controller->retransmitRatio() > 0);
+    }
 
     QFile::remove(downloadFile);
 
+    delete _multiSpyLogDownloadController;
     delete controller;
 }
@@ -25,8 +25,11 @@ private slots:
     //void cleanup(void) { _cleanup(); }
 
     void downloadTest(void);
+    void lossyDownloadTest(void);
 
 private:
+    void _downloadTest(uint32_t logSize, int dropEveryN, int timeoutMsecs);
+
     // LogDownloadController signals
 
     enum {
@@ -38,7 +38,7 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
-        _dataIndex = 0;
+        _resetValues();
         _msg->updateFieldSelection();
     }
 }
@@ -48,7 +48,7 @@ void
 QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
-        _values.clear();
+        _resetValues();
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
         lineSeries->replace(_values);
         _pSeries = nullptr;
@@ -95,8 +95,7 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
     }
     if(_pSeries && _chart) {
         int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
+        if(count < _maxSamples) {
             QPointF p(QGC::bootTimeMilliseconds(), v);
             _values.append(p);
         } else {
@@ -105,15 +104,11 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
             _values[_dataIndex].setY(v);
             _dataIndex++;
         }
+        _updateRange(v);
         //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
+        if(_chart->rangeYIndex() == 0 && !_minQueue.empty()) {
+            qreal vmin  = _minQueue.front().value;
+            qreal vmax  = _maxQueue.front().value;
             bool changed = false;
             if(std::abs(_rangeMin - vmin) > 0.000001) {
                 _rangeMin = vmin;
@@ -132,20 +127,104 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
 
 //-----------------------------------------------------------------------------
 void
+QGCMAVLinkMessageField::_resetValues()
+{
+    _values.clear();
+    _seriesPoints.clear();
+    _minQueue.clear();
+    _maxQueue.clear();
+    _dataIndex      = 0;
+    _sampleCount    = 0;
+}
+
+//-----------------------------------------------------------------------------
+/// Maintains the min/max of the ring buffer as monotonic queues, which makes auto range O(1) amortized per sample
+void
+QGCMAVLinkMessageField::_updateRange(qreal v)
+{
+    quint64 sample = _sampleCount++;
+    if(!qIsNaN(v)) {
+        while(!_minQueue.empty() && _minQueue.back().value >= v) {
+            _minQueue.pop_back();
+        }
+        _minQueue.push_back({ sample, v });
+        while(!_maxQueue.empty() && _maxQueue.back().value <= v) {
+            _maxQueue.pop_back();
+        }
+        _maxQueue.push_back({ sample, v });
+    }
+    //-- Drop samples which have been overwritten in the ring buffer
+    if(sample >= static_cast<quint64>(_maxSamples)) {
+        quint64 oldest = sample - static_cast<quint64>(_maxSamples) + 1;
+        while(!_minQueue.empty() && _minQueue.front().index < oldest) {
+            _minQueue.pop_front();
+        }
+        while(!_maxQueue.empty() && _maxQueue.front().index < oldest) {
+            _maxQueue.pop_front();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Hands the samples to the series in time order. When there are more samples than the plot has pixels only the
+/// min and max sample of each pixel column are kept, which draws the same line for a fraction of the points.
+void
 QGCMAVLinkMessageField::updateSeries()
 {
     int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
+    if (count > 1 && _chart) {
+        const qreal xMin        = _chart->rangeXMin().toMSecsSinceEpoch();
+        const qreal xMax        = _chart->rangeXMax().toMSecsSinceEpoch();
+        const int   columns     = _chart->plotWidth();
+        const bool  decimate    = columns > 0 && count > columns * 2 && xMax > xMin;
+        const qreal columnWidth = decimate ? (xMax - xMin) / columns : 0;
+
+        _seriesPoints.clear();
+        _seriesPoints.reserve(decimate ? (columns * 2) + 2 : count);
+
+        int             column  = -2;
+        const QPointF*  minPt   = nullptr;
+        const QPointF*  maxPt   = nullptr;
+        auto flushColumn = [this, &minPt, &maxPt]() {
+            if(minPt) {
+                if(minPt == maxPt) {
+                    _seriesPoints.append(*minPt);
+                } else if(minPt->x() <= maxPt->x()) {
+                    _seriesPoints.append(*minPt);
+                    _seriesPoints.append(*maxPt);
+                } else {
+                    _seriesPoints.append(*maxPt);
+                    _seriesPoints.append(*minPt);
+                }
+            }
+        };
+
         int idx = _dataIndex;
         for(int i = 0; i < count; i++, idx++) {
             if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
+            const QPointF& p = _values[idx];
+            if(!decimate) {
+                _seriesPoints.append(p);
+                continue;
+            }
+            //-- Everything left of the plot collapses into a single column so the line still enters from the left edge
+            int pointColumn = p.x() < xMin ? -1 : static_cast<int>((p.x() - xMin) / columnWidth);
+            if(pointColumn != column) {
+                flushColumn();
+                column  = pointColumn;
+                minPt   = &p;
+                maxPt   = &p;
+            } else {
+                if(p.y() < minPt->y()) minPt = &p;
+                if(p.y() > maxPt->y()) maxPt = &p;
+            }
         }
+        if(decimate) {
+            flushColumn();
+        }
+
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
+        lineSeries->replace(_seriesPoints);
     }
 }
 
@@ -485,28 +564,22 @@ QGCMAVLinkSystem::~QGCMAVLinkSystem()
 QGCMAVLinkMessage*
 QGCMAVLinkSystem::findMessage(uint32_t id, uint8_t cid)
 {
-    for(int i = 0; i < _messages.count(); i++) {
-        QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(_messages.get(i));
-        if(m) {
-            if(m->id() == id && m->cid() == cid) {
-                return m;
-            }
-        }
-    }
-    return nullptr;
+    return _messageMap.value(_messageKey(id, cid), nullptr);
 }
 
 //-----------------------------------------------------------------------------
 int
 QGCMAVLinkSystem::findMessage(QGCMAVLinkMessage* message)
 {
-    for(int i = 0; i < _messages.count(); i++) {
-        QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(_messages.get(i));
-        if(m && m == message) {
-            return i;
-        }
-    }
-    return -1;
+    return _messages.indexOf(message);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkSystem::clearMessages()
+{
+    _messageMap.clear();
+    _messages.clearAndDeleteContents();
 }
 
 //-----------------------------------------------------------------------------
@@ -562,6 +635,7 @@ QGCMAVLinkSystem::append(QGCMAVLinkMessage* message)
         message->setSelected(true);
     }
     _messages.append(message);
+    _messageMap[_messageKey(message->id(), message->cid())] = message;
     //-- Sort messages by id and then cid
     if (_messages.count() > 0) {
         _messages.beginReset();
@@ -622,6 +696,16 @@ MAVLinkChartController::setRangeYIndex(quint32 r)
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+MAVLinkChartController::setPlotWidth(int width)
+{
+    if(_plotWidth != width) {
+        _plotWidth = width;
+        emit plotWidthChanged();
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkChartController::setRangeXIndex(quint32 t)
@@ -650,7 +734,7 @@ MAVLinkChartController::updateYRange()
 {
     if(_chartFields.count()) {
         qreal vmin  = std::numeric_limits<qreal>::max();
-        qreal vmax  = std::numeric_limits<qreal>::min();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
         for(int i = 0; i < _chartFields.count(); i++) {
             QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
             QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
@@ -730,7 +814,7 @@ MAVLinkInspectorController::MAVLinkInspectorController()
     connect(multiVehicleManager, &MultiVehicleManager::vehicleAdded,   this, &MAVLinkInspectorController::_vehicleAdded);
     connect(multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkInspectorController::_vehicleRemoved);
     MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
-    connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
+    connect(mavlinkProtocol, &MAVLinkProtocol::messagesReceived, this, &MAVLinkInspectorController::_receiveMessages);
     connect(&_updateFrequencyTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFrequency);
     _updateFrequencyTimer.start(1000);
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
@@ -805,15 +889,7 @@ MAVLinkInspectorController::_setActiveVehicle(Vehicle* vehicle)
 QGCMAVLinkSystem*
 MAVLinkInspectorController::_findVehicle(uint8_t id)
 {
-    for(int i = 0; i < _systems.count(); i++) {
-        QGCMAVLinkSystem* v = qobject_cast<QGCMAVLinkSystem*>(_systems.get(i));
-        if(v) {
-            if(v->id() == id) {
-                return v;
-            }
-        }
-    }
-    return nullptr;
+    return _systemMap.value(id, nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -839,10 +915,11 @@ MAVLinkInspectorController::_vehicleAdded(Vehicle* vehicle)
 {
     QGCMAVLinkSystem* v = _findVehicle(static_cast<uint8_t>(vehicle->id()));
     if(v) {
-        v->messages()->clearAndDeleteContents();
+        v->clearMessages();
     } else {
         v = new QGCMAVLinkSystem(this, static_cast<uint8_t>(vehicle->id()));
         _systems.append(v);
+        _systemMap[v->id()] = v;
         _systemNames.append(tr("System %1").arg(vehicle->id()));
     }
     emit systemsChanged();
@@ -856,6 +933,7 @@ MAVLinkInspectorController::_vehicleRemoved(Vehicle* vehicle)
     if(v) {
         v->deleteLater();
         _systems.removeOne(v);
+        _systemMap.remove(v->id());
         QString vs = tr("System %1").arg(vehicle->id());
         _systemNames.removeOne(vs);
         emit systemsChanged();
@@ -864,13 +942,23 @@ MAVLinkInspectorController::_vehicleRemoved(Vehicle* vehicle)
 
 //-----------------------------------------------------------------------------
 void
-MAVLinkInspectorController::_receiveMessage(LinkInterface*, mavlink_message_t message)
+MAVLinkInspectorController::_receiveMessages(LinkInterface*, const QVector<mavlink_message_t>& messages)
+{
+    for (const mavlink_message_t& message: messages) {
+        _receiveMessage(message);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkInspectorController::_receiveMessage(mavlink_message_t message)
 {
     QGCMAVLinkMessage* m = nullptr;
     QGCMAVLinkSystem* v = _findVehicle(message.sysid);
     if(!v) {
         v = new QGCMAVLinkSystem(this, message.sysid);
         _systems.append(v);
+        _systemMap[v->id()] = v;
         _systemNames.append(tr("System %1").arg(message.sysid));
         emit systemsChanged();
         if(!_activeSystem) {
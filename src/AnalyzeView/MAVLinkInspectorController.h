@@ -20,8 +20,11 @@
 #include <QString>
 #include <QDebug>
 #include <QVariantList>
+#include <QHash>
 #include <QtCharts/QAbstractSeries>
 
+#include <deque>
+
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkInspectorLog)
 
 QT_CHARTS_USE_NAMESPACE
@@ -53,7 +56,7 @@ public:
     bool            selectable      () const{ return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
+    QVector<QPointF>* values        () { return &_values;}
     qreal           rangeMin        () const{ return _rangeMin; }
     qreal           rangeMax        () const{ return _rangeMax; }
     int             chartIndex      ();
@@ -71,6 +74,15 @@ signals:
     void            valueChanged        ();
 
 private:
+    /// Sample held in the running min/max queues
+    struct RangeSample {
+        quint64 index;
+        qreal   value;
+    };
+
+    void        _resetValues    ();
+    void        _updateRange    (qreal v);
+
     QString     _type;
     QString     _name;
     QString     _value;
@@ -82,7 +94,13 @@ private:
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    QVector<QPointF>    _values;                ///< Ring buffer of samples, _dataIndex is the oldest once full
+    QVector<QPointF>    _seriesPoints;          ///< Decimated points handed to the series, reused across updates
+    quint64             _sampleCount = 0;       ///< Total samples added since the series was attached
+    std::deque<RangeSample> _minQueue;          ///< Increasing values, front is the minimum of the ring buffer
+    std::deque<RangeSample> _maxQueue;          ///< Decreasing values, front is the maximum of the ring buffer
+
+    static const int    _maxSamples = 50 * 60;  ///< Arbitrary limit of 1 minute of data at 50Hz
 };
 
 //-----------------------------------------------------------------------------
@@ -160,6 +178,7 @@ public:
     QGCMAVLinkMessage*  findMessage     (uint32_t id, uint8_t cid);
     int                 findMessage     (QGCMAVLinkMessage* message);
     void                append          (QGCMAVLinkMessage* message);
+    void                clearMessages   ();
 
 signals:
     void compIDsChanged                 ();
@@ -169,11 +188,14 @@ private:
     void _checkCompID                   (QGCMAVLinkMessage *message);
     void _resetSelection                ();
 
+    static quint32 _messageKey          (uint32_t id, uint8_t cid) { return (id << 8) | cid; }
+
 private:
     quint8              _id;
     QList<int>          _compIDs;
     QStringList         _compIDsStr;
     QmlObjectListModel  _messages;      //-- List of QGCMAVLinkMessage
+    QHash<quint32, QGCMAVLinkMessage*> _messageMap;    //-- Messages keyed by msgid and compid
     int                 _selected = 0;
 };
 
@@ -193,6 +215,7 @@ public:
 
     Q_PROPERTY(quint32      rangeYIndex         READ rangeYIndex            WRITE setRangeYIndex    NOTIFY rangeYIndexChanged)
     Q_PROPERTY(quint32      rangeXIndex         READ rangeXIndex            WRITE setRangeXIndex    NOTIFY rangeXIndexChanged)
+    Q_PROPERTY(int          plotWidth           READ plotWidth              WRITE setPlotWidth      NOTIFY plotWidthChanged)     ///< Width of the plot area in pixels, used to decimate the series
 
     Q_INVOKABLE void        addSeries           (QGCMAVLinkMessageField* field, QAbstractSeries* series);
     Q_INVOKABLE void        delSeries           (QGCMAVLinkMessageField* field);
@@ -207,9 +230,11 @@ public:
     quint32                 rangeXIndex         () const{ return _rangeXIndex; }
     quint32                 rangeYIndex         () const{ return _rangeYIndex; }
     int                     chartIndex          () const{ return _index; }
+    int                     plotWidth           () const{ return _plotWidth; }
 
     void                    setRangeXIndex      (quint32 t);
     void                    setRangeYIndex      (quint32 r);
+    void                    setPlotWidth        (int width);
     void                    updateXRange        ();
     void                    updateYRange        ();
 
@@ -221,6 +246,7 @@ signals:
     void rangeYMaxChanged   ();
     void rangeYIndexChanged ();
     void rangeXIndexChanged ();
+    void plotWidthChanged   ();
 
 private slots:
     void _refreshSeries     ();
@@ -234,6 +260,7 @@ private:
     qreal               _rangeYMax           = 1;
     quint32             _rangeXIndex         = 0;                    ///< 5 Seconds
     quint32             _rangeYIndex         = 0;                    ///< Auto Range
+    int                 _plotWidth           = 0;                    ///< 0: Unknown, series is not decimated
     QVariantList        _chartFields;
     MAVLinkInspectorController* _controller  = nullptr;
 };
@@ -290,14 +317,15 @@ signals:
     void rangeListChanged   ();
 
 private slots:
-    void _receiveMessage    (LinkInterface* link, mavlink_message_t message);
+    void _receiveMessages   (LinkInterface* link, const QVector<mavlink_message_t>& messages);
     void _vehicleAdded      (Vehicle* vehicle);
     void _vehicleRemoved    (Vehicle* vehicle);
     void _setActiveVehicle  (Vehicle* vehicle);
     void _refreshFrequency  ();
 
 private:
-    QGCMAVLinkSystem* _findVehicle (uint8_t id);
+    QGCMAVLinkSystem* _findVehicle      (uint8_t id);
+    void              _receiveMessage   (mavlink_message_t message);
 
 private:
 
@@ -309,6 +337,7 @@ private:
     QTimer              _updateFrequencyTimer;
     QStringList         _systemNames;
     QmlObjectListModel  _systems;                           ///< List of QGCMAVLinkSystem
+    QHash<quint8, QGCMAVLinkSystem*> _systemMap;            ///< Systems keyed by system id
     QmlObjectListModel  _charts;                            ///< List of MAVLinkCharts
     QList<TimeScale_st*>_timeScaleSt;
     QList<Range_st*>    _rangeSt;
@@ -1,6 +1,11 @@
 #include "ULogParser.h"
 #include <math.h>
+#include <string.h>
+#include <algorithm>
 #include <QDateTime>
+#include <QtEndian>
+
+QGC_LOGGING_CATEGORY(ULogParserLog, "ULogParserLog")
 
 ULogParser::ULogParser()
 {
@@ -83,97 +88,214 @@ bool ULogParser::parseFieldFormat(QString& fields)
         prevFieldEnd = fieldEnd + 1;
         fieldEnd = fields.indexOf(';', prevFieldEnd);
     }
+
+    // Resolve the fields we need once, rather than with a map lookup for every message
+    _cameraCapture.timestamp        = _cameraCaptureOffsets.value(QStringLiteral("timestamp"), -1);
+    _cameraCapture.timestampUTC     = _cameraCaptureOffsets.value(QStringLiteral("timestamp_utc"), -1);
+    _cameraCapture.seq              = _cameraCaptureOffsets.value(QStringLiteral("seq"), -1);
+    _cameraCapture.lat              = _cameraCaptureOffsets.value(QStringLiteral("lat"), -1);
+    _cameraCapture.lon              = _cameraCaptureOffsets.value(QStringLiteral("lon"), -1);
+    _cameraCapture.alt              = _cameraCaptureOffsets.value(QStringLiteral("alt"), -1);
+    _cameraCapture.groundDistance   = _cameraCaptureOffsets.value(QStringLiteral("ground_distance"), -1);
+    _cameraCapture.result           = _cameraCaptureOffsets.value(QStringLiteral("result"), -1);
+
     return false;
 }
 
-bool ULogParser::getTagsFromLog(QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage)
+bool ULogParser::parseFlagBits(const char* payload, int payloadSize, QList<qint64>& appendedOffsets, QString& errorMessage)
+{
+    if (payloadSize < ULOG_FLAG_BITS_PAYLOAD_LEN) {
+        return true;
+    }
+
+    const uint8_t* incompatFlags = reinterpret_cast<const uint8_t*>(payload) + 8;
+    if ((incompatFlags[0] & ~ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK) != 0) {
+        errorMessage = tr("ULog uses unsupported features");
+        return false;
+    }
+    for (int i = 1; i < 8; i++) {
+        if (incompatFlags[i] != 0) {
+            errorMessage = tr("ULog uses unsupported features");
+            return false;
+        }
+    }
+
+    if (incompatFlags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK) {
+        for (int i = 0; i < 3; i++) {
+            qint64 offset = qFromLittleEndian<qint64>(reinterpret_cast<const uchar*>(payload + 16 + (i * 8)));
+            if (offset > 0) {
+                appendedOffsets.append(offset);
+            }
+        }
+        std::sort(appendedOffsets.begin(), appendedOffsets.end());
+    }
+
+    return true;
+}
+
+void ULogParser::decodeCameraCapture(const char* payload, int payloadSize, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback)
 {
+    // Payload starts with the 2 byte msg_id. Completely dynamic parsing, so that changing/reordering the message
+    // format will not break the parser.
+    const char* data        = payload + 2;
+    int         dataSize    = payloadSize - 2;
+    auto field = [data, dataSize](int offset, void* value, int size) {
+        if (offset >= 0 && offset + size <= dataSize) {
+            memcpy(value, data + offset, size);
+        }
+    };
+
+    GeoTagWorker::cameraFeedbackPacket feedback;
+    memset(&feedback, 0, sizeof(feedback));
+    uint64_t timestamp      = 0;
+    uint64_t timestampUTC   = 0;
+    field(_cameraCapture.timestamp,         &timestamp,                 8);
+    field(_cameraCapture.timestampUTC,      &timestampUTC,              8);
+    field(_cameraCapture.seq,               &feedback.imageSequence,    4);
+    field(_cameraCapture.lat,               &feedback.latitude,         8);
+    field(_cameraCapture.lon,               &feedback.longitude,        8);
+    field(_cameraCapture.alt,               &feedback.altitude,         4);
+    field(_cameraCapture.groundDistance,    &feedback.groundDistance,   4);
+    field(_cameraCapture.result,            &feedback.captureResult,    1);
+    feedback.timestamp      = timestamp / 1.0e6;    // to seconds
+    feedback.timestampUTC   = timestampUTC / 1.0e6; // to seconds
+    feedback.longitude      = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
+
+    cameraFeedback.append(feedback);
+}
+
+bool ULogParser::getTagsFromLog(QIODevice& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage, const ProgressCb& progressCb)
+{
+    static const char   cameraCaptureFormat[]       = "camera_capture:";
+    static const int    cameraCaptureFormatLength   = sizeof(cameraCaptureFormat) - 1;
+    static const int    maxMessageLength            = ULOG_MSG_HEADER_LEN + 0xFFFF;
+
     errorMessage.clear();
+    _cameraCaptureOffsets.clear();
+    _cameraCapture      = CameraCaptureOffsets();
+    _cameraCaptureMsgID = -1;
 
     //verify it's an ULog file
-    if(!log.contains(_ULogMagic)) {
+    QByteArray fileHeader = log.read(ULOG_FILE_HEADER_LEN);
+    if (fileHeader.count() < ULOG_FILE_HEADER_LEN || memcmp(fileHeader.constData(), _ULogMagic, 7) != 0) {
         errorMessage = tr("Could not detect ULog file header magic");
         return false;
     }
 
-    int index = ULOG_FILE_HEADER_LEN;
-    bool geotagFound = false;
+    const qint64    totalBytes      = log.isSequential() ? -1 : log.size();
+    QList<qint64>   appendedOffsets;
+    QByteArray      buffer;
+    qint64          bufferOffset    = log.pos();    // Log offset of buffer[0]
+    int             position        = 0;            // Current message within buffer
+    bool            atEnd           = false;
+    bool            geotagFound     = false;
+
+    buffer.reserve(_chunkSize + maxMessageLength);
+
+    // Drops the buffered data and continues reading at the specified log offset
+    auto seek = [&](qint64 offset) -> bool {
+        if (offset >= bufferOffset && offset <= bufferOffset + buffer.count()) {
+            position = static_cast<int>(offset - bufferOffset);
+            return true;
+        }
+        if (!log.seek(offset)) {
+            return false;
+        }
+        buffer.clear();
+        bufferOffset    = offset;
+        position        = 0;
+        atEnd           = false;
+        return true;
+    };
+
+    while (true) {
+        qint64  messageOffset   = bufferOffset + position;
+        int     available       = buffer.count() - position;
+
+        // A message which runs into appended data was cut short, the appended data continues at the offset
+        if (!appendedOffsets.isEmpty() && messageOffset + ULOG_MSG_HEADER_LEN > appendedOffsets.first()) {
+            qint64 appendedOffset = appendedOffsets.takeFirst();
+            if (messageOffset != appendedOffset && !seek(appendedOffset)) {
+                break;
+            }
+            continue;
+        }
+
+        int msgSize = available >= ULOG_MSG_HEADER_LEN ? qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(buffer.constData() + position)) : 0;
+        if (available >= ULOG_MSG_HEADER_LEN && !appendedOffsets.isEmpty() && messageOffset + ULOG_MSG_HEADER_LEN + msgSize > appendedOffsets.first()) {
+            if (!seek(appendedOffsets.takeFirst())) {
+                break;
+            }
+            continue;
+        }
 
-    while(index < log.count() - 1) {
+        if (available < ULOG_MSG_HEADER_LEN || available < ULOG_MSG_HEADER_LEN + msgSize) {
+            if (atEnd) {
+                // Truncated log, ignore the partial message
+                if (available > 0) {
+                    qCWarning(ULogParserLog) << "ULog truncated, ignoring last" << available << "bytes";
+                }
+                break;
+            }
 
-        ULogMessageHeader header;
-        memset(&header, 0, sizeof(header));
-        memcpy(&header, log.data() + index, ULOG_MSG_HEADER_LEN);
+            // Keep the partial message and read the next chunk behind it
+            buffer.remove(0, position);
+            bufferOffset    += position;
+            position        = 0;
+            int keep        = buffer.count();
+            buffer.resize(keep + _chunkSize);
+            qint64 bytesRead = log.read(buffer.data() + keep, _chunkSize);
+            if (bytesRead <= 0) {
+                atEnd       = true;
+                bytesRead   = 0;
+            }
+            buffer.resize(keep + static_cast<int>(bytesRead));
 
-        switch (header.msgType) {
-            case (int)ULogMessageType::FORMAT:
-            {
-                ULogMessageFormat format_msg;
-                memset(&format_msg, 0, sizeof(format_msg));
-                memcpy(&format_msg, log.data() + index, ULOG_MSG_HEADER_LEN + header.msgSize);
+            if (progressCb && !progressCb(bufferOffset + buffer.count(), totalBytes)) {
+                errorMessage = tr("Log parsing cancelled");
+                return false;
+            }
+            continue;
+        }
 
-                QString fmt(format_msg.format);
-                int posSeparator = fmt.indexOf(':');
-                QString messageName = fmt.left(posSeparator);
-                QString messageFields = fmt.mid(posSeparator + 1, header.msgSize - posSeparator - 1);
+        const char* payload = buffer.constData() + position + ULOG_MSG_HEADER_LEN;
 
-                if(messageName == QLatin1String("camera_capture")) {
+        switch (static_cast<uint8_t>(buffer.at(position + 2))) {
+            case (int)ULogMessageType::FLAG_BITS:
+                if (!parseFlagBits(payload, msgSize, appendedOffsets, errorMessage)) {
+                    return false;
+                }
+                break;
+
+            case (int)ULogMessageType::FORMAT:
+                // Only the camera_capture format is of interest, skip the rest without decoding them
+                if (msgSize > cameraCaptureFormatLength && memcmp(payload, cameraCaptureFormat, cameraCaptureFormatLength) == 0) {
+                    QString messageFields = QString::fromLatin1(payload + cameraCaptureFormatLength, msgSize - cameraCaptureFormatLength);
                     parseFieldFormat(messageFields);
                 }
                 break;
-            }
 
             case (int)ULogMessageType::ADD_LOGGED_MSG:
-            {
-                ULogMessageAddLogged addLoggedMsg;
-                memset(&addLoggedMsg, 0, sizeof(addLoggedMsg));
-                memcpy(&addLoggedMsg, log.data() + index, ULOG_MSG_HEADER_LEN + header.msgSize);
-
-                QString messageName(addLoggedMsg.msgName);
-
-                if(messageName.contains(QLatin1String("camera_capture"))) {
-                    _cameraCaptureMsgID = addLoggedMsg.msgID;
-                    geotagFound = true;
+                if (msgSize > 3) {
+                    // multi_id, msg_id, message name
+                    if (QByteArray::fromRawData(payload + 3, msgSize - 3).contains("camera_capture")) {
+                        _cameraCaptureMsgID = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(payload + 1));
+                        geotagFound = true;
+                    }
                 }
-
                 break;
-            }
 
             case (int)ULogMessageType::DATA:
-            {
-                uint16_t msgID = -1;
-                memcpy(&msgID, log.data() + index + ULOG_MSG_HEADER_LEN, 2);
-
-                if (geotagFound && msgID == _cameraCaptureMsgID) {
-
-                    // Completely dynamic parsing, so that changing/reordering the message format will not break the parser
-                    GeoTagWorker::cameraFeedbackPacket feedback;
-                    memset(&feedback, 0, sizeof(feedback));
-                    memcpy(&feedback.timestamp, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("timestamp")), 8);
-                    feedback.timestamp /= 1.0e6; // to seconds
-                    memcpy(&feedback.timestampUTC, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("timestamp_utc")), 8);
-                    feedback.timestampUTC /= 1.0e6; // to seconds
-                    memcpy(&feedback.imageSequence, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("seq")), 4);
-                    memcpy(&feedback.latitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("lat")), 8);
-                    memcpy(&feedback.longitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("lon")), 8);
-                    feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
-                    memcpy(&feedback.altitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("alt")), 4);
-                    memcpy(&feedback.groundDistance, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("ground_distance")), 4);
-                    memcpy(&feedback.captureResult, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("result")), 1);
-
-                    cameraFeedback.append(feedback);
-
+                if (geotagFound && msgSize >= 2 && qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(payload)) == _cameraCaptureMsgID) {
+                    decodeCameraCapture(payload, msgSize, cameraFeedback);
                 }
-
                 break;
-            }
 
             default:
                 break;
         }
 
-        index += (3 + header.msgSize);
-
+        position += ULOG_MSG_HEADER_LEN + msgSize;
     }
 
     if (cameraFeedback.count() == 0) {
@@ -4,26 +4,56 @@
 #include <QGeoCoordinate>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QIODevice>
+
+#include <functional>
 
 #include "GeoTagController.h"
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ULogParserLog)
 
 #define ULOG_FILE_HEADER_LEN 16
 
+/// Streaming ULog reader which extracts the camera_capture messages used for geotagging. The log is read in fixed
+/// size chunks so memory use doesn't depend on the size of the log, and only camera_capture payloads are decoded.
 class ULogParser
 {
     Q_DECLARE_TR_FUNCTIONS(ULogParser)
 
+    friend class ULogParserTest; // Unit test
+
 public:
+    /// Called after each chunk is read
+    ///     @param bytesRead Byte offset reached in the log
+    ///     @param totalBytes Size of the log, -1 if not known
+    /// @return false to cancel parsing
+    using ProgressCb = std::function<bool(qint64 bytesRead, qint64 totalBytes)>;
+
     ULogParser();
     ~ULogParser();
 
-    /// @return true: failed, errorMessage set
-    bool getTagsFromLog(QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage);
+    /// Reads the log from the current position of the device to the end. A truncated final message is ignored, data
+    /// appended after a truncated message is picked up through the appended offsets of the flag bits message.
+    /// @return true: success, false: failed, errorMessage set
+    bool getTagsFromLog(QIODevice& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage, const ProgressCb& progressCb = ProgressCb());
 
 private:
+    struct CameraCaptureOffsets {
+        int timestamp       = -1;
+        int timestampUTC    = -1;
+        int seq             = -1;
+        int lat             = -1;
+        int lon             = -1;
+        int alt             = -1;
+        int groundDistance  = -1;
+        int result          = -1;
+    };
 
-    QMap<QString, int> _cameraCaptureOffsets; // <fieldName, fieldOffset>
-    int _cameraCaptureMsgID;
+    QMap<QString, int>      _cameraCaptureOffsets; // <fieldName, fieldOffset>
+    CameraCaptureOffsets    _cameraCapture;
+    int                     _cameraCaptureMsgID = -1;
+    int                     _chunkSize          = 1024 * 1024;
 
     const char _ULogMagic[8] = {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35};
 
@@ -32,6 +62,8 @@ private:
     QString extractArraySize(QString& typeNameFull, int& arraySize);
 
     bool parseFieldFormat(QString& fields);
+    bool parseFlagBits(const char* payload, int payloadSize, QList<qint64>& appendedOffsets, QString& errorMessage);
+    void decodeCameraCapture(const char* payload, int payloadSize, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback);
 
     enum class ULogMessageType : uint8_t {
         FORMAT = 'F',
@@ -43,29 +75,13 @@ private:
         SYNC = 'S',
         DROPOUT = 'O',
         LOGGING = 'L',
+        FLAG_BITS = 'B',
     };
 
     #define ULOG_MSG_HEADER_LEN 3
-    struct ULogMessageHeader {
-        uint16_t msgSize;
-        uint8_t msgType;
-    };
-
-    struct ULogMessageFormat {
-        uint16_t msgSize;
-        uint8_t msgType;
-
-        char format[2096];
-    };
-
-    struct ULogMessageAddLogged {
-	  uint16_t msgSize;
-      uint8_t msgType;
 
-	  uint8_t multiID;
-	  uint16_t msgID;
-	  char msgName[255];
-	};
+    #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK  (1 << 0)
+    #define ULOG_FLAG_BITS_PAYLOAD_LEN              40  // compat_flags[8], incompat_flags[8], appended_offsets[3]
 
 };
 
@@ -0,0 +1,231 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogParserTest.h"
+#include "ULogParser.h"
+
+#include <QBuffer>
+
+static const quint16    kOtherMsgID         = 0;
+static const quint16    kCameraCaptureMsgID = 1;
+static const int        kCaptureCount       = 500;
+
+/// ULog is little endian, as are all the platforms we run tests on
+template<typename T>
+static void _append(QByteArray& bytes, T value)
+{
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+QByteArray ULogParserTest::_logHeader(void)
+{
+    QByteArray bytes("ULog\x01\x12\x35", 7);
+    bytes.append(static_cast<char>(1));     // Version
+    _append<quint64>(bytes, 123456);        // Timestamp
+    return bytes;
+}
+
+QByteArray ULogParserTest::_message(char type, const QByteArray& payload)
+{
+    QByteArray bytes;
+    _append<quint16>(bytes, static_cast<quint16>(payload.count()));
+    bytes.append(type);
+    bytes.append(payload);
+    return bytes;
+}
+
+QByteArray ULogParserTest::_flagBits(quint64 appendedOffset)
+{
+    QByteArray payload(16, 0);
+    if (appendedOffset) {
+        payload[8] = 1; // DATA_APPENDED
+    }
+    _append<quint64>(payload, appendedOffset);
+    _append<quint64>(payload, 0);
+    _append<quint64>(payload, 0);
+    return _message('B', payload);
+}
+
+QByteArray ULogParserTest::_definitions(void)
+{
+    QByteArray bytes;
+    bytes.append(_message('F', "vehicle_status:uint64_t timestamp;uint8_t arming_state;uint8_t[7] _padding0;"));
+    bytes.append(_message('F', "camera_capture:uint64_t timestamp;uint64_t timestamp_utc;uint32_t seq;double lat;double lon;float alt;float ground_distance;float[4] q;int8_t result;uint8_t[7] _padding0;"));
+
+    QByteArray addOther;
+    addOther.append(static_cast<char>(0));
+    _append<quint16>(addOther, kOtherMsgID);
+    addOther.append("vehicle_status");
+    bytes.append(_message('A', addOther));
+
+    QByteArray addCapture;
+    addCapture.append(static_cast<char>(0));
+    _append<quint16>(addCapture, kCameraCaptureMsgID);
+    addCapture.append("camera_capture");
+    bytes.append(_message('A', addCapture));
+
+    return bytes;
+}
+
+QByteArray ULogParserTest::_cameraCapture(uint32_t seq)
+{
+    QByteArray payload;
+    _append<quint16>(payload, kCameraCaptureMsgID);
+    _append<quint64>(payload, seq * 1000000ull);        // timestamp
+    _append<quint64>(payload, 1600000000000000ull);     // timestamp_utc
+    _append<quint32>(payload, seq);
+    _append<double>(payload, 47.0 + (seq * 0.001));     // lat
+    _append<double>(payload, 8.0 + (seq * 0.001));      // lon
+    _append<float>(payload, 500.0f + seq);              // alt
+    _append<float>(payload, 100.0f);                    // ground_distance
+    for (int i=0; i<4; i++) {
+        _append<float>(payload, 0.0f);                  // q
+    }
+    payload.append(static_cast<char>(1));               // result
+    payload.append(QByteArray(7, 0));                   // _padding0
+    return _message('D', payload);
+}
+
+QByteArray ULogParserTest::_otherData(void)
+{
+    QByteArray payload;
+    _append<quint16>(payload, kOtherMsgID);
+    _append<quint64>(payload, 42);
+    payload.append(static_cast<char>(2));
+    payload.append(QByteArray(7, 0));
+    return _message('D', payload);
+}
+
+QByteArray ULogParserTest::_buildLog(int captureCount, quint64 appendedOffset)
+{
+    QByteArray log = _logHeader();
+    log.append(_flagBits(appendedOffset));
+    log.append(_definitions());
+    for (int i=0; i<captureCount; i++) {
+        log.append(_otherData());
+        log.append(_message('I', QByteArray(100, 'x')));
+        log.append(_cameraCapture(static_cast<uint32_t>(i)));
+    }
+    return log;
+}
+
+bool ULogParserTest::_parse(const QByteArray& log, int chunkSize, QList<GeoTagWorker::cameraFeedbackPacket>& feedback)
+{
+    QByteArray  logCopy(log);
+    QBuffer     buffer(&logCopy);
+    QString     errorMessage;
+    ULogParser  parser;
+
+    feedback.clear();
+    parser._chunkSize = chunkSize;
+    buffer.open(QIODevice::ReadOnly);
+    return parser.getTagsFromLog(buffer, feedback, errorMessage);
+}
+
+void ULogParserTest::_checkFeedback(const QList<GeoTagWorker::cameraFeedbackPacket>& feedback, int count)
+{
+    QCOMPARE(feedback.count(), count);
+    for (int i=0; i<count; i++) {
+        QCOMPARE(feedback[i].imageSequence, static_cast<uint32_t>(i));
+        QCOMPARE(feedback[i].timestamp, static_cast<double>(i));
+        QCOMPARE(feedback[i].latitude, 47.0 + (i * 0.001));
+        QVERIFY(qAbs(feedback[i].longitude - (8.0 + (i * 0.001))) < 1e-9);
+        QCOMPARE(feedback[i].altitude, 500.0f + i);
+        QCOMPARE(feedback[i].groundDistance, 100.0f);
+        QCOMPARE(feedback[i].captureResult, static_cast<uint8_t>(1));
+    }
+}
+
+void ULogParserTest::_parse_test(void)
+{
+    QByteArray                                  log = _buildLog(kCaptureCount);
+    QList<GeoTagWorker::cameraFeedbackPacket>   feedback;
+
+    // Chunk sizes which split messages at every possible point must all give the same result
+    for (int chunkSize: { 1, 7, 64, 1000, 1024 * 1024 }) {
+        QVERIFY(_parse(log, chunkSize, feedback));
+        _checkFeedback(feedback, kCaptureCount);
+    }
+
+    QVERIFY(!_parse(QByteArray("NotAULog"), 1024, feedback));
+    QVERIFY(!_parse(_buildLog(0), 1024, feedback));
+}
+
+void ULogParserTest::_truncated_test(void)
+{
+    QByteArray                                  log = _buildLog(kCaptureCount);
+    QList<GeoTagWorker::cameraFeedbackPacket>   feedback;
+
+    // Cut into the last camera_capture message
+    log.chop(10);
+    QVERIFY(_parse(log, 64, feedback));
+    _checkFeedback(feedback, kCaptureCount - 1);
+
+    // Cut inside the last message header
+    log.chop(_cameraCapture(0).count() - 10 - 1);
+    QVERIFY(_parse(log, 64, feedback));
+    _checkFeedback(feedback, kCaptureCount - 1);
+}
+
+void ULogParserTest::_appended_test(void)
+{
+    QList<GeoTagWorker::cameraFeedbackPacket> feedback;
+
+    // The logger stopped in the middle of a message, then more data was appended after it
+    QByteArray log = _buildLog(kCaptureCount / 2);
+    log.append(_cameraCapture(kCaptureCount / 2).left(20));
+    quint64 appendedOffset = static_cast<quint64>(log.count());
+    for (int i=kCaptureCount / 2; i<kCaptureCount; i++) {
+        log.append(_cameraCapture(static_cast<uint32_t>(i)));
+    }
+    log.replace(_logHeader().count(), _flagBits(0).count(), _flagBits(appendedOffset));
+
+    for (int chunkSize: { 7, 64, 1024 * 1024 }) {
+        QVERIFY(_parse(log, chunkSize, feedback));
+        _checkFeedback(feedback, kCaptureCount);
+    }
+
+    // Unknown incompatible flags must be rejected
+    log[_logHeader().count() + ULOG_MSG_HEADER_LEN + 8] = static_cast<char>(0x81);
+    QVERIFY(!_parse(log, 1024, feedback));
+}
+
+void ULogParserTest::_progress_test(void)
+{
+    QByteArray  log = _buildLog(kCaptureCount);
+    QBuffer     buffer(&log);
+    QString     errorMessage;
+    qint64      lastBytesRead = 0;
+    int         progressCount = 0;
+    bool        progressValid = true;
+
+    QList<GeoTagWorker::cameraFeedbackPacket> feedback;
+
+    ULogParser parser;
+    parser._chunkSize = 1024;
+    buffer.open(QIODevice::ReadOnly);
+    auto progressCb = [&](qint64 bytesRead, qint64 totalBytes) {
+        if (totalBytes != log.count() || bytesRead < lastBytesRead) {
+            progressValid = false;
+        }
+        lastBytesRead = bytesRead;
+        progressCount++;
+        return true;
+    };
+    QVERIFY(parser.getTagsFromLog(buffer, feedback, errorMessage, progressCb));
+    QVERIFY(progressValid);
+    QCOMPARE(lastBytesRead, static_cast<qint64>(log.count()));
+    QVERIFY(progressCount >= log.count() / 1024);
+
+    // Returning false from the callback cancels parsing
+    buffer.seek(0);
+    feedback.clear();
+    QVERIFY(!parser.getTagsFromLog(buffer, feedback, errorMessage, [](qint64, qint64) { return false; }));
+    QVERIFY(!errorMessage.isEmpty());
+}
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "GeoTagController.h"
+
+/// Unit test for the streaming ULogParser
+class ULogParserTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _parse_test        (void);
+    void _truncated_test    (void);
+    void _appended_test     (void);
+    void _progress_test     (void);
+
+private:
+    QByteArray  _logHeader          (void);
+    QByteArray  _message            (char type, const QByteArray& payload);
+    QByteArray  _flagBits           (quint64 appendedOffset);
+    QByteArray  _definitions        (void);
+    QByteArray  _cameraCapture      (uint32_t seq);
+    QByteArray  _otherData          (void);
+    QByteArray  _buildLog           (int captureCount, quint64 appendedOffset = 0);
+    bool        _parse              (const QByteArray& log, int chunkSize, QList<GeoTagWorker::cameraFeedbackPacket>& feedback);
+    void        _checkFeedback      (const QList<GeoTagWorker::cameraFeedbackPacket>& feedback, int count);
+};
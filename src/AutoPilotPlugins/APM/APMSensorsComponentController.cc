@@ -56,6 +56,7 @@ APMSensorsComponentController::APMSensorsComponentController(void)
     , _orientationCalNoseDownSideRotate(false)
     , _orientationCalTailDownSideRotate(false)
     , _waitingForCancel(false)
+    , _receivingCalMessages(false)
     , _restoreCompassCalFitness(false)
 {
     _compassCal.setVehicle(_vehicle);
@@ -109,7 +110,8 @@ void APMSensorsComponentController::_startLogCalibration(void)
     }
     _cancelButton->setEnabled(_calTypeInProgress == CalTypeOnboardCompass);
 
-    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messagesReceived, this, &APMSensorsComponentController::_mavlinkMessagesReceived);
+    _receivingCalMessages = true;
 }
 
 void APMSensorsComponentController::_startVisualCalibration(void)
@@ -122,7 +124,8 @@ void APMSensorsComponentController::_startVisualCalibration(void)
     
     _progressBar->setProperty("value", 0);
 
-    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messagesReceived, this, &APMSensorsComponentController::_mavlinkMessagesReceived);
+    _receivingCalMessages = true;
 }
 
 void APMSensorsComponentController::_resetInternalState(void)
@@ -153,7 +156,8 @@ void APMSensorsComponentController::_resetInternalState(void)
 
 void APMSensorsComponentController::_stopCalibration(APMSensorsComponentController::StopCalibrationCode code)
 {
-    disconnect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    disconnect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messagesReceived, this, &APMSensorsComponentController::_mavlinkMessagesReceived);
+    _receivingCalMessages = false;
     _vehicle->vehicleLinkManager()->setCommunicationLostEnabled(true);
 
     disconnect(_vehicle, &Vehicle::textMessageReceived, this, &APMSensorsComponentController::_handleUASTextMessage);
@@ -693,10 +697,21 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
     }
 }
 
-void APMSensorsComponentController::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
+void APMSensorsComponentController::_mavlinkMessagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages)
 {
     Q_UNUSED(link);
 
+    for (const mavlink_message_t& message: messages) {
+        // A message earlier in the batch may have stopped the calibration
+        if (!_receivingCalMessages) {
+            break;
+        }
+        _mavlinkMessageReceived(message);
+    }
+}
+
+void APMSensorsComponentController::_mavlinkMessageReceived(mavlink_message_t message)
+{
     if (message.sysid != _vehicle->id()) {
         return;
     }
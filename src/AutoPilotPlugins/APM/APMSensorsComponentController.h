@@ -135,7 +135,7 @@ signals:
 
 private slots:
     void _handleUASTextMessage  (int uasId, int compId, int severity, QString text);
-    void _mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message);
+    void _mavlinkMessagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages);
     void _mavCommandResult      (int vehicleId, int component, int command, int result, bool noReponseFromVehicle);
 
 private:
@@ -149,6 +149,7 @@ private:
     void _handleMagCalProgress              (mavlink_message_t& message);
     void _handleMagCalReport                (mavlink_message_t& message);
     void _handleCommandLong                 (mavlink_message_t& message);
+    void _mavlinkMessageReceived            (mavlink_message_t message);
     void _restorePreviousCompassCalFitness  (void);
 
     enum StopCalibrationCode {
@@ -208,6 +209,7 @@ private:
     bool _orientationCalTailDownSideRotate;
     
     bool _waitingForCancel;
+    bool _receivingCalMessages;
 
     bool _restoreCompassCalFitness;
     float _previousCompassCalFitness;
@@ -0,0 +1,381 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCache.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
+
+#include <QSaveFile>
+
+#include <algorithm>
+#include <string.h>
+
+ParameterCache::ParameterCache(const QString& fileName)
+    : _file(fileName)
+{
+
+}
+
+ParameterCache::~ParameterCache()
+{
+    close();
+}
+
+bool ParameterCache::open(bool writable)
+{
+    close();
+
+    if (!_file.open(writable ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 fileSize = _file.size();
+    if (fileSize < static_cast<qint64>(sizeof(Header_t))) {
+        close();
+        return false;
+    }
+    _map = _file.map(0, fileSize);
+    if (!_map) {
+        qCWarning(ParameterManagerLog) << "Unable to map parameter cache" << _file.fileName() << _file.errorString();
+        close();
+        return false;
+    }
+
+    // Validate the layout before trusting any of the offsets
+    Header_t* header = reinterpret_cast<Header_t*>(_map);
+    qint64 valuesOffset = sizeof(Header_t) + (static_cast<qint64>(header->count) * sizeof(Entry_t));
+    qint64 namesOffset  = valuesOffset + (static_cast<qint64>(header->count) * sizeof(quint64));
+    if (header->magic != _magic || header->version != _version || header->namesOffset != namesOffset || namesOffset + header->namesSize > fileSize) {
+        qCWarning(ParameterManagerLog) << "Invalid parameter cache" << _file.fileName();
+        close();
+        return false;
+    }
+
+    _header     = header;
+    _entries    = reinterpret_cast<Entry_t*>(_map + sizeof(Header_t));
+    _values     = reinterpret_cast<quint64*>(_map + valuesOffset);
+    _names      = reinterpret_cast<const char*>(_map + namesOffset);
+
+    for (quint32 i=0; i<header->count; i++) {
+        if (static_cast<quint64>(_entries[i].nameOffset) + _entries[i].nameLength > header->namesSize) {
+            qCWarning(ParameterManagerLog) << "Invalid parameter cache name table" << _file.fileName();
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ParameterCache::close(void)
+{
+    if (_map) {
+        _file.unmap(_map);
+    }
+    _map        = nullptr;
+    _header     = nullptr;
+    _entries    = nullptr;
+    _values     = nullptr;
+    _names      = nullptr;
+    _file.close();
+}
+
+int ParameterCache::count(void) const
+{
+    return _header ? static_cast<int>(_header->count) : 0;
+}
+
+quint32 ParameterCache::hash(void) const
+{
+    return _header ? _header->hash : 0;
+}
+
+const char* ParameterCache::_nameData(int index) const
+{
+    return _names + _entries[index].nameOffset;
+}
+
+QString ParameterCache::name(int index) const
+{
+    return QString::fromLatin1(_nameData(index), _entries[index].nameLength);
+}
+
+FactMetaData::ValueType_t ParameterCache::type(int index) const
+{
+    return static_cast<FactMetaData::ValueType_t>(_entries[index].type);
+}
+
+QVariant ParameterCache::rawValue(int index) const
+{
+    return _bitsToValue(type(index), _values[index]);
+}
+
+int ParameterCache::indexOf(const QString& name) const
+{
+    QByteArray  nameBytes   = name.toLatin1();
+    int         low         = 0;
+    int         high        = count() - 1;
+
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        const Entry_t& entry = _entries[mid];
+        int compare = memcmp(_nameData(mid), nameBytes.constData(), qMin(static_cast<int>(entry.nameLength), nameBytes.length()));
+        if (compare == 0) {
+            compare = entry.nameLength - nameBytes.length();
+        }
+        if (compare == 0) {
+            return mid;
+        } else if (compare < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return -1;
+}
+
+bool ParameterCache::updateValue(const QString& name, FactMetaData::ValueType_t type, const QVariant& rawValue)
+{
+    Param_t param;
+    param.name          = name;
+    param.type          = type;
+    param.rawValue      = rawValue;
+    param.volatileValue = false;
+
+    return updateValues({ param });
+}
+
+bool ParameterCache::updateValues(const QList<Param_t>& params)
+{
+    if (!isOpen() || !_file.isWritable()) {
+        return false;
+    }
+
+    bool success = true;
+    bool changed = false;
+    for (const Param_t& param: params) {
+        int index = indexOf(param.name);
+        if (index < 0 || this->type(index) != param.type) {
+            success = false;
+            break;
+        }
+
+        quint64 bits = _valueToBits(param.type, param.rawValue);
+        if (_values[index] != bits) {
+            _values[index] = bits;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        _header->hash = _calcHash(_entries, _values, _names, count());
+    }
+
+    return success;
+}
+
+/// Hash matches the one calculated by PX4 for _HASH_CHECK: crc32 over name and value of each non-volatile parameter in name order
+quint32 ParameterCache::_calcHash(const Entry_t* entries, const quint64* values, const char* names, int count)
+{
+    quint32 crc32Value = 0;
+
+    for (int i=0; i<count; i++) {
+        const Entry_t& entry = entries[i];
+        if (entry.flags & _flagVolatile) {
+            continue;
+        }
+        crc32Value = QGC::crc32(reinterpret_cast<const quint8*>(names + entry.nameOffset), entry.nameLength, crc32Value);
+        crc32Value = QGC::crc32(reinterpret_cast<const quint8*>(&values[i]), static_cast<unsigned>(FactMetaData::typeToSize(static_cast<FactMetaData::ValueType_t>(entry.type))), crc32Value);
+    }
+
+    return crc32Value;
+}
+
+bool ParameterCache::write(const QString& fileName, QList<Param_t> params)
+{
+    // Parameter names are plain ascii, so QString ordering matches the byte ordering used for lookups
+    std::sort(params.begin(), params.end(), [](const Param_t& a, const Param_t& b) { return a.name < b.name; });
+
+    QByteArray names;
+    for (const Param_t& param: params) {
+        names.append(param.name.toLatin1());
+    }
+
+    quint32     count           = static_cast<quint32>(params.count());
+    quint32     valuesOffset    = sizeof(Header_t) + (count * sizeof(Entry_t));
+    quint32     namesOffset     = valuesOffset + (count * sizeof(quint64));
+    QByteArray  buffer(static_cast<int>(namesOffset) + names.size(), 0);
+    uchar*      data            = reinterpret_cast<uchar*>(buffer.data());
+
+    Header_t* header    = reinterpret_cast<Header_t*>(data);
+    header->magic       = _magic;
+    header->version     = _version;
+    header->count       = count;
+    header->namesOffset = namesOffset;
+    header->namesSize   = static_cast<quint32>(names.size());
+
+    Entry_t*    entries     = reinterpret_cast<Entry_t*>(data + sizeof(Header_t));
+    quint64*    values      = reinterpret_cast<quint64*>(data + valuesOffset);
+    quint32     nameOffset  = 0;
+    for (quint32 i=0; i<count; i++) {
+        const Param_t& param = params[static_cast<int>(i)];
+        entries[i].nameOffset   = nameOffset;
+        entries[i].nameLength   = static_cast<quint16>(param.name.length());
+        entries[i].type         = static_cast<quint8>(param.type);
+        entries[i].flags        = param.volatileValue ? _flagVolatile : 0;
+        values[i]               = _valueToBits(param.type, param.rawValue);
+        nameOffset += entries[i].nameLength;
+    }
+    memcpy(data + namesOffset, names.constData(), static_cast<size_t>(names.size()));
+    header->hash = _calcHash(entries, values, reinterpret_cast<const char*>(data + namesOffset), static_cast<int>(count));
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(buffer) != buffer.size() || !file.commit()) {
+        qCWarning(ParameterManagerLog) << "Unable to write parameter cache" << fileName << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+quint64 ParameterCache::_valueToBits(FactMetaData::ValueType_t type, const QVariant& rawValue)
+{
+    quint64 bits = 0;
+
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    {
+        quint8 value = static_cast<quint8>(rawValue.toUInt());
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeInt8:
+    {
+        qint8 value = static_cast<qint8>(rawValue.toInt());
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeUint16:
+    {
+        quint16 value = static_cast<quint16>(rawValue.toUInt());
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeInt16:
+    {
+        qint16 value = static_cast<qint16>(rawValue.toInt());
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeUint32:
+    {
+        quint32 value = rawValue.toUInt();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeUint64:
+    {
+        quint64 value = rawValue.toULongLong();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeInt64:
+    {
+        qint64 value = rawValue.toLongLong();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeFloat:
+    {
+        float value = rawValue.toFloat();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeDouble:
+    {
+        double value = rawValue.toDouble();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    case FactMetaData::valueTypeInt32:
+    default:
+    {
+        qint32 value = rawValue.toInt();
+        memcpy(&bits, &value, sizeof(value));
+        break;
+    }
+    }
+
+    return bits;
+}
+
+/// Values are returned with the same QVariant types ParameterManager uses for values received from the vehicle
+QVariant ParameterCache::_bitsToValue(FactMetaData::ValueType_t type, quint64 bits)
+{
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    {
+        quint8 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeInt8:
+    {
+        qint8 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeUint16:
+    {
+        quint16 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeInt16:
+    {
+        qint16 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeUint32:
+    {
+        quint32 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeUint64:
+        return QVariant(bits);
+    case FactMetaData::valueTypeInt64:
+    {
+        qint64 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeFloat:
+    {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeDouble:
+    {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    case FactMetaData::valueTypeInt32:
+    default:
+    {
+        qint32 value;
+        memcpy(&value, &bits, sizeof(value));
+        return QVariant(value);
+    }
+    }
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "FactMetaData.h"
+
+#include <QFile>
+#include <QList>
+#include <QVariant>
+
+/// Binary parameter cache file which is memory mapped for reading.
+///
+/// Layout:
+///     Header_t
+///     Entry_t[count]      - sorted by parameter name
+///     quint64[count]      - values in the same order as the entries
+///     char[]              - parameter names, not null terminated
+///
+/// The header carries the PX4 style hash of the cached set, so matching against the _HASH_CHECK value from the
+/// vehicle only needs the header. Values can be patched in place when a single parameter changes.
+///
+/// Only PX4 vehicles use the cache. ArduPilot sends no _HASH_CHECK and has volatile parameters, so its parameter list is
+/// always requested in full.
+class ParameterCache
+{
+public:
+    struct Param_t {
+        QString                     name;
+        FactMetaData::ValueType_t   type;
+        QVariant                    rawValue;
+        bool                        volatileValue;  ///< true: value does not take part in the hash
+    };
+
+    ParameterCache(const QString& fileName);
+    ~ParameterCache();
+
+    /// Maps the cache file
+    /// @return false: file is missing or not a valid cache
+    bool open(bool writable = false);
+    void close(void);
+
+    bool                        isOpen      (void) const { return _entries != nullptr; }
+    int                         count       (void) const;
+    quint32                     hash        (void) const;
+    QString                     name        (int index) const;
+    FactMetaData::ValueType_t   type        (int index) const;
+    QVariant                    rawValue    (int index) const;
+
+    /// @return Index of the named parameter, -1 if not found
+    int indexOf(const QString& name) const;
+
+    /// Updates a single value in place and recalculates the hash. Cache must be opened writable.
+    /// @return false: parameter not in the cache or type differs
+    bool updateValue(const QString& name, FactMetaData::ValueType_t type, const QVariant& rawValue);
+
+    /// Updates a batch of values in place, the hash is only recalculated once. Cache must be opened writable.
+    /// @return false: a parameter is not in the cache or its type differs, the values before it were updated
+    bool updateValues(const QList<Param_t>& params);
+
+    /// Writes a new cache file replacing any existing one
+    static bool write(const QString& fileName, QList<Param_t> params);
+
+private:
+    typedef struct {
+        quint32 magic;
+        quint32 version;
+        quint32 count;
+        quint32 hash;
+        quint32 namesOffset;
+        quint32 namesSize;
+    } Header_t;
+
+    typedef struct {
+        quint32 nameOffset;         ///< Offset into the names block
+        quint16 nameLength;
+        quint8  type;               ///< FactMetaData::ValueType_t
+        quint8  flags;
+    } Entry_t;
+
+    const char* _nameData       (int index) const;
+
+    static quint32  _calcHash       (const Entry_t* entries, const quint64* values, const char* names, int count);
+    static quint64  _valueToBits    (FactMetaData::ValueType_t type, const QVariant& rawValue);
+    static QVariant _bitsToValue    (FactMetaData::ValueType_t type, quint64 bits);
+
+    QFile       _file;
+    uchar*      _map        = nullptr;
+    Header_t*   _header     = nullptr;
+    Entry_t*    _entries    = nullptr;
+    quint64*    _values     = nullptr;
+    const char* _names      = nullptr;
+
+    static const quint32 _magic         = 0x33435051;   ///< "QPC3"
+    static const quint32 _version       = 1;
+    static const quint8  _flagVolatile  = 0x01;
+};
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheTest.h"
+#include "QGC.h"
+
+#include <QTemporaryDir>
+
+QList<ParameterCache::Param_t> ParameterCacheTest::_params(void)
+{
+    // Intentionally unsorted, and with a name which is a prefix of another
+    QList<ParameterCache::Param_t> params;
+    params.append({ QStringLiteral("SYS_AUTOSTART"),    FactMetaData::valueTypeInt32,   QVariant(static_cast<qint32>(4001)),    false });
+    params.append({ QStringLiteral("MPC_XY_VEL_MAX"),   FactMetaData::valueTypeFloat,   QVariant(12.5f),                        false });
+    params.append({ QStringLiteral("CAL_ACC0_ID"),      FactMetaData::valueTypeInt32,   QVariant(static_cast<qint32>(-12)),     true });
+    params.append({ QStringLiteral("MPC_XY"),           FactMetaData::valueTypeUint8,   QVariant(static_cast<quint8>(200)),     false });
+    params.append({ QStringLiteral("BAT_N_CELLS"),      FactMetaData::valueTypeInt16,   QVariant(static_cast<qint16>(-4)),      false });
+    params.append({ QStringLiteral("COM_FLTMODE1"),     FactMetaData::valueTypeUint32,  QVariant(static_cast<quint32>(7)),      false });
+    return params;
+}
+
+/// Hash calculated the same way the original QDataStream cache did
+quint32 ParameterCacheTest::_expectedHash(const QList<ParameterCache::Param_t>& params)
+{
+    QMap<QString, ParameterCache::Param_t> sortedParams;
+    for (const ParameterCache::Param_t& param: params) {
+        sortedParams[param.name] = param;
+    }
+
+    quint32 crc32Value = 0;
+    for (const ParameterCache::Param_t& param: sortedParams) {
+        if (param.volatileValue) {
+            continue;
+        }
+        QByteArray  name = param.name.toLatin1();
+        quint64     bits = 0;
+        switch (param.type) {
+        case FactMetaData::valueTypeFloat:
+        {
+            float value = param.rawValue.toFloat();
+            memcpy(&bits, &value, sizeof(value));
+            break;
+        }
+        default:
+        {
+            qint64 value = param.rawValue.toLongLong();
+            memcpy(&bits, &value, sizeof(value));
+            break;
+        }
+        }
+        crc32Value = QGC::crc32(reinterpret_cast<const quint8*>(name.constData()), static_cast<unsigned>(name.length()), crc32Value);
+        crc32Value = QGC::crc32(reinterpret_cast<const quint8*>(&bits), static_cast<unsigned>(FactMetaData::typeToSize(param.type)), crc32Value);
+    }
+
+    return crc32Value;
+}
+
+void ParameterCacheTest::_writeRead_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath("1_1.v3");
+
+    QList<ParameterCache::Param_t> params = _params();
+    QVERIFY(ParameterCache::write(fileName, params));
+
+    ParameterCache cache(fileName);
+    QVERIFY(cache.open());
+    QCOMPARE(cache.count(), params.count());
+    QCOMPARE(cache.hash(), _expectedHash(params));
+
+    // Entries come back sorted by name
+    for (int i=1; i<cache.count(); i++) {
+        QVERIFY(cache.name(i - 1) < cache.name(i));
+    }
+
+    for (const ParameterCache::Param_t& param: params) {
+        int index = cache.indexOf(param.name);
+        QVERIFY(index >= 0);
+        QCOMPARE(cache.name(index), param.name);
+        QCOMPARE(cache.type(index), param.type);
+        QCOMPARE(cache.rawValue(index).toDouble(), param.rawValue.toDouble());
+    }
+    QCOMPARE(cache.indexOf(QStringLiteral("MPC_X")), -1);
+    QCOMPARE(cache.indexOf(QStringLiteral("ZZZ")), -1);
+}
+
+void ParameterCacheTest::_updateValue_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath("1_1.v3");
+
+    QList<ParameterCache::Param_t> params = _params();
+    QVERIFY(ParameterCache::write(fileName, params));
+
+    {
+        ParameterCache cache(fileName);
+        QVERIFY(cache.open());
+        // Read only caches can't be updated
+        QVERIFY(!cache.updateValue(QStringLiteral("MPC_XY_VEL_MAX"), FactMetaData::valueTypeFloat, QVariant(8.0f)));
+    }
+
+    {
+        ParameterCache cache(fileName);
+        QVERIFY(cache.open(true /* writable */));
+        QVERIFY(cache.updateValue(QStringLiteral("MPC_XY_VEL_MAX"), FactMetaData::valueTypeFloat, QVariant(8.0f)));
+        QVERIFY(!cache.updateValue(QStringLiteral("MPC_XY_VEL_MAX"), FactMetaData::valueTypeInt32, QVariant(8)));
+        QVERIFY(!cache.updateValue(QStringLiteral("NOT_CACHED"), FactMetaData::valueTypeFloat, QVariant(8.0f)));
+    }
+
+    // Updated value and hash must be persisted to the file
+    params[1].rawValue = QVariant(8.0f);
+    ParameterCache cache(fileName);
+    QVERIFY(cache.open());
+    QCOMPARE(cache.rawValue(cache.indexOf(QStringLiteral("MPC_XY_VEL_MAX"))).toFloat(), 8.0f);
+    QCOMPARE(cache.hash(), _expectedHash(params));
+    cache.close();
+
+    // Batched updates
+    QList<ParameterCache::Param_t> updates;
+    updates.append({ QStringLiteral("SYS_AUTOSTART"),   FactMetaData::valueTypeInt32,   QVariant(static_cast<qint32>(4002)),    false });
+    updates.append({ QStringLiteral("BAT_N_CELLS"),     FactMetaData::valueTypeInt16,   QVariant(static_cast<qint16>(6)),       false });
+    params[0].rawValue = updates[0].rawValue;
+    params[4].rawValue = updates[1].rawValue;
+    QVERIFY(cache.open(true /* writable */));
+    QVERIFY(cache.updateValues(updates));
+    QCOMPARE(cache.hash(), _expectedHash(params));
+    updates.append({ QStringLiteral("NOT_CACHED"),      FactMetaData::valueTypeFloat,   QVariant(8.0f),                         false });
+    QVERIFY(!cache.updateValues(updates));
+    QCOMPARE(cache.hash(), _expectedHash(params));
+}
+
+void ParameterCacheTest::_invalidFile_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    ParameterCache missingCache(tempDir.filePath("missing.v3"));
+    QVERIFY(!missingCache.open());
+
+    // Truncated file must be rejected rather than read past the end
+    const QString fileName = tempDir.filePath("1_1.v3");
+    QVERIFY(ParameterCache::write(fileName, _params()));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 4));
+    file.close();
+
+    ParameterCache truncatedCache(fileName);
+    QVERIFY(!truncatedCache.open());
+    QCOMPARE(truncatedCache.count(), 0);
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "ParameterCache.h"
+
+/// Unit test for the binary ParameterCache file
+class ParameterCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _writeRead_test    (void);
+    void _updateValue_test  (void);
+    void _invalidFile_test  (void);
+
+private:
+    QList<ParameterCache::Param_t>  _params         (void);
+    quint32                         _expectedHash   (const QList<ParameterCache::Param_t>& params);
+};
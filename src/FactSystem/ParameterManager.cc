@@ -17,6 +17,7 @@
 #include "JsonHelper.h"
 #include "ComponentInformationManager.h"
 #include "CompInfoParam.h"
+#include "ParameterCache.h"
 
 #include <QEasingCurve>
 #include <QFile>
@@ -105,6 +106,10 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     _waitingParamTimeoutTimer.setInterval(3000);
     connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
+    _paramCacheUpdateTimer.setSingleShot(true);
+    _paramCacheUpdateTimer.setInterval(1000);
+    connect(&_paramCacheUpdateTimer, &QTimer::timeout, this, &ParameterManager::_writePendingParamCacheUpdates);
+
     // Ensure the cache directory exists
     QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
 }
@@ -399,6 +404,10 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
         if (_prevWaitingReadParamIndexCount + _prevWaitingReadParamNameCount != 0 && readWaitingParamCount == 0) {
             // All reads just finished, update the cache
             _writeLocalParamCache(_vehicle->id(), componentId);
+        } else if (_initialLoadComplete) {
+            // Keep the cache in step with changes made after the initial load, otherwise the next connect would miss the
+            // vehicle hash and need a full parameter load.
+            _updateLocalParamCache(componentId, fact);
         }
     }
 
@@ -799,18 +808,65 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
 
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    QList<ParameterCache::Param_t>  params;
+    CompInfoParam*                  compInfoParam = _vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1);
+
+    params.reserve(_mapCompId2FactMap[componentId].count());
+    for (const Fact* fact: _mapCompId2FactMap[componentId]) {
+        ParameterCache::Param_t param;
+        param.name          = fact->name();
+        param.type          = fact->type();
+        param.rawValue      = fact->rawValue();
+        param.volatileValue = compInfoParam->factMetaDataForName(fact->name(), fact->type())->volatileValue();
+        params.append(param);
+    }
+
+    ParameterCache::write(parameterCacheFile(vehicleId, componentId), params);
+
+    // The QDataStream format cache this replaces is never read again
+    QFile::remove(parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId)));
+
+    // Everything pending for the component was just written out
+    _pendingParamCacheUpdates.remove(componentId);
+}
 
-    for (const QString& paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+/// Queues a value change for the cache file. Changes are written in batches by _writePendingParamCacheUpdates, so a
+/// stream of PARAM_VALUE messages doesn't map the file and recalculate the hash for every single one.
+void ParameterManager::_updateLocalParamCache(int componentId, const Fact* fact)
+{
+    _pendingParamCacheUpdates[componentId].insert(fact->name());
+    if (!_paramCacheUpdateTimer.isActive()) {
+        _paramCacheUpdateTimer.start();
     }
+}
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+/// Patches the queued values in the cache files in place
+void ParameterManager::_writePendingParamCacheUpdates(void)
+{
+    const QMap<int, QSet<QString>> pendingUpdates = _pendingParamCacheUpdates;
+    _pendingParamCacheUpdates.clear();
+
+    for (int componentId: pendingUpdates.keys()) {
+        QList<ParameterCache::Param_t> params;
+        for (const QString& name: pendingUpdates[componentId]) {
+            const Fact* fact = _mapCompId2FactMap[componentId].value(name, nullptr);
+            if (fact) {
+                ParameterCache::Param_t param;
+                param.name          = fact->name();
+                param.type          = fact->type();
+                param.rawValue      = fact->rawValue();
+                param.volatileValue = false;
+                params.append(param);
+            }
+        }
 
-    QDataStream ds(&cacheFile);
-    ds << cacheMap;
+        ParameterCache cache(parameterCacheFile(_vehicle->id(), componentId));
+        if (!cache.open(true /* writable */) || !cache.updateValues(params)) {
+            // Parameter set changed shape, fall back to writing the whole cache
+            cache.close();
+            _writeLocalParamCache(_vehicle->id(), componentId);
+        }
+    }
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -821,80 +877,59 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
+}
+
+/// Return the hash value to notify we don't want any more updates
+void ParameterManager::_sendHashCheck(int componentId, uint32_t hash)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+
+    if (!weakLink.expired()) {
+        mavlink_param_set_t     p;
+        mavlink_param_union_t   union_value;
+        SharedLinkInterfacePtr  sharedLink = weakLink.lock();
+
+        memset(&p, 0, sizeof(p));
+        p.param_type = MAV_PARAM_TYPE_UINT32;
+        strncpy(p.param_id, "_HASH_CHECK", sizeof(p.param_id));
+        union_value.param_uint32 = hash;
+        p.param_value = union_value.param_float;
+        p.target_system = (uint8_t)_vehicle->id();
+        p.target_component = (uint8_t)componentId;
+        mavlink_message_t msg;
+        mavlink_msg_param_set_encode_chan(_mavlink->getSystemId(),
+                                          _mavlink->getComponentId(),
+                                          sharedLink->mavlinkChannel(),
+                                          &msg,
+                                          &p);
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    }
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
-    uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (!cacheFile.exists()) {
+    // The hash of the cached set is stored in the cache header, so a miss only costs mapping the file
+    ParameterCache cache(parameterCacheFile(vehicleId, componentId));
+    if (!cache.open()) {
         /* no local cache, just wait for them to come in*/
         return;
     }
-    cacheFile.open(QIODevice::ReadOnly);
-
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
-
-    /* compute the crc of the local cache to check against the remote */
-
-    for (const QString& name: cacheMap.keys()) {
-        const ParamTypeVal&             paramTypeVal    = cacheMap[name];
-        const FactMetaData::ValueType_t fact_type       = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, fact_type)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
-        }
-    }
 
     /* if the two param set hashes match, just load from the disk */
-    if (crc32_value == hash_value.toUInt()) {
-        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-
-        int count = cacheMap.count();
-        int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
+    if (cache.hash() == hash_value.toUInt()) {
+        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(parameterCacheFile(vehicleId, componentId));
+
+        int count = cache.count();
+        for (int index=0; index<count; index++) {
+            const FactMetaData::ValueType_t fact_type = cache.type(index);
             const MAV_PARAM_TYPE mavParamType = factTypeToMavType(fact_type);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
+            _handleParamValue(componentId, cache.name(index), count, index, mavParamType, cache.rawValue(index));
         }
 
-        WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-
-        if (!weakLink.expired()) {
-            mavlink_param_set_t     p;
-            mavlink_param_union_t   union_value;
-            SharedLinkInterfacePtr  sharedLink = weakLink.lock();
-
-            // Return the hash value to notify we don't want any more updates
-            memset(&p, 0, sizeof(p));
-            p.param_type = MAV_PARAM_TYPE_UINT32;
-            strncpy(p.param_id, "_HASH_CHECK", sizeof(p.param_id));
-            union_value.param_uint32 = crc32_value;
-            p.param_value = union_value.param_float;
-            p.target_system = (uint8_t)_vehicle->id();
-            p.target_component = (uint8_t)componentId;
-            mavlink_message_t msg;
-            mavlink_msg_param_set_encode_chan(_mavlink->getSystemId(),
-                                              _mavlink->getComponentId(),
-                                              sharedLink->mavlinkChannel(),
-                                              &msg,
-                                              &p);
-            _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-        }
+        _sendHashCheck(componentId, cache.hash());
 
         // Give the user some feedback things loaded properly
         QVariantAnimation *ani = new QVariantAnimation(this);
@@ -916,11 +951,12 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
 
         ani->start(QAbstractAnimation::DeleteWhenStopped);
     } else {
-        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
+        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(parameterCacheFile(vehicleId, componentId));
         if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString& name: cacheMap.keys()) {
+            for (int index=0; index<cache.count(); index++) {
+                QString name = cache.name(index);
+                _debugCacheMap[componentId][name] = ParamTypeVal(cache.type(index), cache.rawValue(index));
                 _debugCacheParamSeen[componentId][name] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
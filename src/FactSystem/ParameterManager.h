@@ -11,6 +11,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QSet>
 #include <QXmlStreamReader>
 #include <QLoggingCategory>
 #include <QMutex>
@@ -116,6 +117,9 @@ private:
     void    _readParameterRaw                   (int componentId, const QString& paramName, int paramIndex);
     void    _sendParamSetToVehicle              (int componentId, const QString& paramName, FactMetaData::ValueType_t valueType, const QVariant& value);
     void    _writeLocalParamCache               (int vehicleId, int componentId);
+    void    _updateLocalParamCache              (int componentId, const Fact* fact);
+    void    _writePendingParamCacheUpdates      (void);
+    void    _sendHashCheck                      (int componentId, uint32_t hash);
     void    _tryCacheHashLoad                   (int vehicleId, int componentId, QVariant hash_value);
     void    _loadMetaData                       (void);
     void    _clearMetaData                      (void);
@@ -180,6 +184,9 @@ private:
 
     QTimer _initialRequestTimeoutTimer;
     QTimer _waitingParamTimeoutTimer;
+    QTimer _paramCacheUpdateTimer;              ///< Batches up cache updates for values which change after the initial load
+
+    QMap<int /* component id */, QSet<QString> /* param names */> _pendingParamCacheUpdates;
 
     Fact _defaultFact;   ///< Used to return default fact, when parameter not found
 
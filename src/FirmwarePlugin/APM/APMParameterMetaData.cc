@@ -16,6 +16,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QStack>
 
 static const char* kInvalidConverstion = "Internal Error: No support for string parameters";
@@ -143,6 +144,54 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    if (_compiledMetaData.load(metaDataFile)) {
+        qCDebug(APMParameterMetaDataLog) << "Loaded compiled parameter meta data:" << metaDataFile << loadTimer.elapsed() << "msecs";
+        return;
+    }
+
+    QMap<QString, ParameterNametoFactMetaDataMap> vehicleTypeToParametersMap;
+    bool parsed = _parseParameterFactMetaDataFile(metaDataFile, vehicleTypeToParametersMap);
+
+    QList<CompiledParameterMetaData::RawParam_t> rawParams;
+    for (const QString& category: vehicleTypeToParametersMap.keys()) {
+        for (const APMFactMetaDataRaw* rawMetaData: vehicleTypeToParametersMap[category]) {
+            CompiledParameterMetaData::RawParam_t rawParam;
+
+            rawParam.section                                                    = category;
+            rawParam.name                                                       = rawMetaData->name;
+            rawParam.fields[CompiledParameterMetaData::FieldCategory]           = rawMetaData->category;
+            rawParam.fields[CompiledParameterMetaData::FieldGroup]              = rawMetaData->group;
+            rawParam.fields[CompiledParameterMetaData::FieldShortDescription]   = rawMetaData->shortDescription;
+            rawParam.fields[CompiledParameterMetaData::FieldLongDescription]    = rawMetaData->longDescription;
+            rawParam.fields[CompiledParameterMetaData::FieldUnits]              = rawMetaData->units;
+            rawParam.fields[CompiledParameterMetaData::FieldMin]                = rawMetaData->min;
+            rawParam.fields[CompiledParameterMetaData::FieldMax]                = rawMetaData->max;
+            rawParam.fields[CompiledParameterMetaData::FieldIncrement]          = rawMetaData->incrementSize;
+            rawParam.values                                                     = rawMetaData->values;
+            rawParam.bitmask                                                    = rawMetaData->bitmask;
+            if (rawMetaData->rebootRequired) {
+                rawParam.flags |= CompiledParameterMetaData::FlagRebootRequired;
+            }
+            if (rawMetaData->readOnly) {
+                rawParam.flags |= CompiledParameterMetaData::FlagReadOnly;
+            }
+
+            rawParams.append(rawParam);
+        }
+        qDeleteAll(vehicleTypeToParametersMap[category]);
+    }
+
+    // Only a complete parse goes into the cache, otherwise the next connect would pick up partial meta data
+    _compiledMetaData.compile(metaDataFile, rawParams, parsed);
+    qCDebug(APMParameterMetaDataLog) << "Compiled parameter meta data:" << metaDataFile << loadTimer.elapsed() << "msecs";
+}
+
+/// @return false: the xml could not be parsed completely
+bool APMParameterMetaData::_parseParameterFactMetaDataFile(const QString& metaDataFile, QMap<QString, ParameterNametoFactMetaDataMap>& vehicleTypeToParametersMap)
+{
     QRegExp parameterCategories = QRegExp("ArduCopter|ArduPlane|APMrover2|Rover|ArduSub|AntennaTracker");
     QString currentCategory;
 
@@ -151,15 +200,16 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     QFile xmlFile(metaDataFile);
     Q_ASSERT(xmlFile.exists());
 
-    bool success = xmlFile.open(QIODevice::ReadOnly);
-    Q_UNUSED(success);
-    Q_ASSERT(success);
+    if (!xmlFile.open(QIODevice::ReadOnly)) {
+        qCWarning(APMParameterMetaDataLog) << "Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
+        return false;
+    }
 
     QXmlStreamReader xml(xmlFile.readAll());
     xmlFile.close();
     if (xml.hasError()) {
         qCWarning(APMParameterMetaDataLog) << "Badly formed XML, reading failed: " << xml.errorString();
-        return;
+        return false;
     }
 
     bool                badMetaData = true;
@@ -185,13 +235,13 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "vehicles") {
                 if (xmlState.top() != XmlstateParamFileFound) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, vehicles matched";
-                    return;
+                    return false;
                 }
                 xmlState.push(XmlStateFoundVehicles);
             } else if (elementName == "libraries") {
                 if (xmlState.top() != XmlstateParamFileFound) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, libraries matched";
-                    return;
+                    return false;
                 }
                 currentCategory = "libraries";
                 xmlState.push(XmlStateFoundLibraries);
@@ -199,7 +249,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState.top() != XmlStateFoundVehicles && xmlState.top() != XmlStateFoundLibraries) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, parameters matched"
                                                        << "but we don't have proper vehicle or libraries yet";
-                    return;
+                    return false;
                 }
 
                 if (xml.attributes().hasAttribute("name")) {
@@ -216,7 +266,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                         qCDebug(APMParameterMetaDataVerboseLog) << "not interested in this block of parameters, skipping:" << nameValue;
                         if (skipXMLBlock(xml, "parameters")) {
                             qCWarning(APMParameterMetaDataLog) << "something wrong with the xml, skip of the xml failed";
-                            return;
+                            return false;
                         }
                         xml.readNext();
                         continue;
@@ -226,13 +276,13 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState.top() != XmlStateFoundParameters) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, element param matched"
                                                        << "while we are not yet in parameters";
-                    return;
+                    return false;
                 }
                 xmlState.push(XmlStateFoundParameter);
 
                 if (!xml.attributes().hasAttribute("name")) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, parameter attribute name missing";
-                    return;
+                    return false;
                 }
 
                 QString name = xml.attributes().value("name").toString();
@@ -253,12 +303,12 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                           << "group: " << group;
 
                 Q_ASSERT(!rawMetaData);
-                if (_vehicleTypeToParametersMap[currentCategory].contains(name)) {
+                if (vehicleTypeToParametersMap[currentCategory].contains(name)) {
                     qCDebug(APMParameterMetaDataLog) << "Duplicate parameter found:" << name;
-                    rawMetaData = _vehicleTypeToParametersMap[currentCategory][name];
+                    rawMetaData = vehicleTypeToParametersMap[currentCategory][name];
                 } else {
-                    rawMetaData = new APMFactMetaDataRaw(this);
-                    _vehicleTypeToParametersMap[currentCategory][name] = rawMetaData;
+                    rawMetaData = new APMFactMetaDataRaw();
+                    vehicleTypeToParametersMap[currentCategory][name] = rawMetaData;
                     groupMembers[group] << name;
                 }
                 qCDebug(APMParameterMetaDataVerboseLog) << "inserting metadata for field" << name;
@@ -273,12 +323,12 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 // We should be getting meta data now
                 if (xmlState.top() != XmlStateFoundParameter) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, while reading parameter fields wrong state";
-                    return;
+                    return false;
                 }
                 if (!badMetaData) {
                     if (!parseParameterAttributes(xml, rawMetaData)) {
                         qCDebug(APMParameterMetaDataLog) << "Badly formed XML, failed to read parameter attributes";
-                        return;
+                        return false;
                     }
                     continue;
                 }
@@ -295,7 +345,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 xmlState.pop();
             } else if (elementName == "parameters") {
                 qCDebug(APMParameterMetaDataVerboseLog) << "end of parameters for category: " << currentCategory;
-                correctGroupMemberships(_vehicleTypeToParametersMap[currentCategory], groupMembers);
+                correctGroupMemberships(vehicleTypeToParametersMap[currentCategory], groupMembers);
                 groupMembers.clear();
                 xmlState.pop();
             } else if (elementName == "vehicles") {
@@ -305,6 +355,13 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         }
         xml.readNext();
     }
+
+    if (xml.hasError()) {
+        qCWarning(APMParameterMetaDataLog) << "Badly formed XML, reading failed: " << xml.errorString();
+        return false;
+    }
+
+    return true;
 }
 
 void APMParameterMetaData::correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap,
@@ -434,16 +491,15 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
 {
     bool                keepTrying      = true;
     QString             mavTypeString   = mavTypeToString(vehicleType);
-    APMFactMetaDataRaw* rawMetaData     = nullptr;
+    int                 index           = -1;
 
     // check if we have metadata for fact, use generic otherwise
     while (keepTrying) {
-        if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-        } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+        index = _compiledMetaData.indexOf(mavTypeString, name);
+        if (index < 0) {
+            index = _compiledMetaData.indexOf(QStringLiteral("libraries"), name);
         }
-        if (!rawMetaData && mavTypeString == "Rover") {
+        if (index < 0 && mavTypeString == "Rover") {
             // Hack city: Older versions of Rover have different name
             mavTypeString = "APMrover2";
         } else {
@@ -454,65 +510,68 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     FactMetaData *metaData = new FactMetaData(type, this);
 
     // we don't have data for this fact
-    if (!rawMetaData) {
+    if (index < 0) {
         metaData->setCategory(QStringLiteral("Advanced"));
         metaData->setGroup(_groupFromParameterName(name));
         qCDebug(APMParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
         return metaData;
     }
 
-    metaData->setName(rawMetaData->name);
-    if (!rawMetaData->category.isEmpty()) {
-        metaData->setCategory(rawMetaData->category);
+    // Strings are only pulled out of the compiled meta data for parameters which are actually used
+    const APMFactMetaDataRaw rawMetaData = _rawMetaData(index);
+
+    metaData->setName(rawMetaData.name);
+    if (!rawMetaData.category.isEmpty()) {
+        metaData->setCategory(rawMetaData.category);
     }
-    metaData->setGroup(rawMetaData->group);
-    metaData->setVehicleRebootRequired(rawMetaData->rebootRequired);
-    metaData->setReadOnly(rawMetaData->readOnly);
+    metaData->setGroup(rawMetaData.group);
+    metaData->setVehicleRebootRequired(rawMetaData.rebootRequired);
+    metaData->setReadOnly(rawMetaData.readOnly);
 
-    if (!rawMetaData->shortDescription.isEmpty()) {
-        metaData->setShortDescription(rawMetaData->shortDescription);
+    if (!rawMetaData.shortDescription.isEmpty()) {
+        metaData->setShortDescription(rawMetaData.shortDescription);
     }
 
-    if (!rawMetaData->longDescription.isEmpty()) {
-        metaData->setLongDescription(rawMetaData->longDescription);
+    if (!rawMetaData.longDescription.isEmpty()) {
+        metaData->setLongDescription(rawMetaData.longDescription);
     }
 
-    if (!rawMetaData->units.isEmpty()) {
-        metaData->setRawUnits(rawMetaData->units);
+    if (!rawMetaData.units.isEmpty()) {
+        metaData->setRawUnits(rawMetaData.units);
     }
 
-    if (!rawMetaData->min.isEmpty()) {
+    if (!rawMetaData.min.isEmpty()) {
         QVariant varMin;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->min, false /* validate as well */, varMin, errorString)) {
+        if (metaData->convertAndValidateRaw(rawMetaData.min, false /* validate as well */, varMin, errorString)) {
             metaData->setRawMin(varMin);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid min value, name:" << metaData->name()
-                                             << " type:" << metaData->type() << " min:" << rawMetaData->min
+                                             << " type:" << metaData->type() << " min:" << rawMetaData.min
                                              << " error:" << errorString;
         }
     }
 
-    if (!rawMetaData->max.isEmpty()) {
+    if (!rawMetaData.max.isEmpty()) {
         QVariant varMax;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->max, false /* validate as well */, varMax, errorString)) {
+        if (metaData->convertAndValidateRaw(rawMetaData.max, false /* validate as well */, varMax, errorString)) {
             metaData->setRawMax(varMax);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:"
-                                             << metaData->type() << " max:" << rawMetaData->max
+                                             << metaData->type() << " max:" << rawMetaData.max
                                              << " error:" << errorString;
         }
     }
 
-    if (rawMetaData->values.count() > 0) {
+    if (rawMetaData.values.count() > 0) {
         QStringList     enumStrings;
         QVariantList    enumValues;
 
-        for (int i=0; i<rawMetaData->values.count(); i++) {
+        for (int i=0; i<rawMetaData.values.count(); i++) {
             QVariant    enumValue;
             QString     errorString;
-            QPair<QString, QString> enumPair = rawMetaData->values[i];
+            QPair<QString, QString> enumPair = rawMetaData.values[i];
 
             if (metaData->convertAndValidateRaw(enumPair.first, false /* validate */, enumValue, errorString)) {
                 enumValues << enumValue;
@@ -532,14 +591,14 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
         }
     }
 
-    if (rawMetaData->bitmask.count() > 0) {
+    if (rawMetaData.bitmask.count() > 0) {
         QStringList     bitmaskStrings;
         QVariantList    bitmaskValues;
 
-        for (int i=0; i<rawMetaData->bitmask.count(); i++) {
+        for (int i=0; i<rawMetaData.bitmask.count(); i++) {
             QVariant    bitmaskValue;
             QString     errorString;
-            QPair<QString, QString> bitmaskPair = rawMetaData->bitmask[i];
+            QPair<QString, QString> bitmaskPair = rawMetaData.bitmask[i];
 
             bool ok = false;
             unsigned int bitSet = bitmaskPair.first.toUInt(&ok);
@@ -603,14 +662,14 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
         }
     }
 
-    if (!rawMetaData->incrementSize.isEmpty()) {
+    if (!rawMetaData.incrementSize.isEmpty()) {
         double  increment;
         bool    ok;
-        increment = rawMetaData->incrementSize.toDouble(&ok);
+        increment = rawMetaData.incrementSize.toDouble(&ok);
         if (ok) {
             metaData->setRawIncrement(increment);
         } else {
-            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << rawMetaData->incrementSize;
+            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << rawMetaData.incrementSize;
         }
     }
 
@@ -626,6 +685,27 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     return metaData;
 }
 
+APMFactMetaDataRaw APMParameterMetaData::_rawMetaData(int index) const
+{
+    APMFactMetaDataRaw rawMetaData;
+
+    rawMetaData.name                = _compiledMetaData.name(index);
+    rawMetaData.category            = _compiledMetaData.field(index, CompiledParameterMetaData::FieldCategory);
+    rawMetaData.group               = _compiledMetaData.field(index, CompiledParameterMetaData::FieldGroup);
+    rawMetaData.shortDescription    = _compiledMetaData.field(index, CompiledParameterMetaData::FieldShortDescription);
+    rawMetaData.longDescription     = _compiledMetaData.field(index, CompiledParameterMetaData::FieldLongDescription);
+    rawMetaData.units               = _compiledMetaData.field(index, CompiledParameterMetaData::FieldUnits);
+    rawMetaData.min                 = _compiledMetaData.field(index, CompiledParameterMetaData::FieldMin);
+    rawMetaData.max                 = _compiledMetaData.field(index, CompiledParameterMetaData::FieldMax);
+    rawMetaData.incrementSize       = _compiledMetaData.field(index, CompiledParameterMetaData::FieldIncrement);
+    rawMetaData.rebootRequired      = _compiledMetaData.flags(index) & CompiledParameterMetaData::FlagRebootRequired;
+    rawMetaData.readOnly            = _compiledMetaData.flags(index) & CompiledParameterMetaData::FlagReadOnly;
+    rawMetaData.values              = _compiledMetaData.values(index);
+    rawMetaData.bitmask             = _compiledMetaData.bitmask(index);
+
+    return rawMetaData;
+}
+
 void APMParameterMetaData::getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion)
 {
     majorVersion = -1;
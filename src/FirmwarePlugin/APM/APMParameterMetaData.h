@@ -20,18 +20,15 @@
 #include "FactSystem.h"
 #include "AutoPilotPlugin.h"
 #include "Vehicle.h"
+#include "CompiledParameterMetaData.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
 
-class APMFactMetaDataRaw : public QObject
+/// Parameter meta data as read from the xml, before it is compiled
+class APMFactMetaDataRaw
 {
-    Q_OBJECT
 public:
-    APMFactMetaDataRaw(QObject *parent = nullptr)
-        : QObject(parent), rebootRequired(false)
-    { }
-
     QString name;
     QString category;
     QString group;
@@ -41,8 +38,8 @@ public:
     QString max;
     QString incrementSize;
     QString units;
-    bool    rebootRequired;
-    bool    readOnly;
+    bool    rebootRequired  = false;
+    bool    readOnly        = false;
     QList<QPair<QString, QString> > values;
     QList<QPair<QString, QString> > bitmask;
 };
@@ -78,15 +75,16 @@ private:
     };    
 
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    bool _parseParameterFactMetaDataFile(const QString& metaDataFile, QMap<QString, ParameterNametoFactMetaDataMap>& vehicleTypeToParametersMap);
+    APMFactMetaDataRaw _rawMetaData(int index) const;
     bool skipXMLBlock(QXmlStreamReader& xml, const QString& blockName);
     bool parseParameterAttributes(QXmlStreamReader& xml, APMFactMetaDataRaw *rawMetaData);
     void correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap, QMap<QString,QStringList>& groupMembers);
     QString mavTypeToString(MAV_TYPE vehicleTypeEnum);
     QString _groupFromParameterName(const QString& name);
 
-    bool                                            _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    // FIXME: metadata is vehicle type specific now
-    QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>
+    bool                        _parameterMetaDataLoaded    = false;    ///< true: parameter meta data already loaded
+    CompiledParameterMetaData   _compiledMetaData;                      ///< Vehicle type is the section, libraries are in the "libraries" section
 };
 
 #endif
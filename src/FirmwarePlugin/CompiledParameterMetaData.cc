@@ -0,0 +1,350 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompiledParameterMetaData.h"
+#include "ParameterManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QVector>
+
+#include <algorithm>
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(CompiledParameterMetaDataLog, "CompiledParameterMetaDataLog")
+
+CompiledParameterMetaData::CompiledParameterMetaData(void)
+{
+
+}
+
+CompiledParameterMetaData::~CompiledParameterMetaData()
+{
+    close();
+}
+
+QString CompiledParameterMetaData::compiledFileName(const QString& metaDataFile)
+{
+    QFileInfo fileInfo(metaDataFile);
+    return ParameterManager::parameterCacheDir().filePath(QStringLiteral("%1_%2.meta").arg(fileInfo.completeBaseName()).arg(qHash(fileInfo.absoluteFilePath()), 8, 16, QLatin1Char('0')));
+}
+
+/// The key changes whenever the meta data file may have changed. Resource files only change with a new build.
+QString CompiledParameterMetaData::_sourceKey(const QString& metaDataFile)
+{
+    QFileInfo fileInfo(metaDataFile);
+    return QStringLiteral("%1|%2|%3|%4").arg(fileInfo.absoluteFilePath())
+            .arg(fileInfo.size())
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+            .arg(QCoreApplication::applicationVersion());
+}
+
+bool CompiledParameterMetaData::load(const QString& metaDataFile)
+{
+    close();
+
+    _file.setFileName(compiledFileName(metaDataFile));
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 fileSize = _file.size();
+    _map = fileSize > 0 ? _file.map(0, fileSize) : nullptr;
+    if (!_map) {
+        close();
+        return false;
+    }
+
+    if (!_setData(_map, fileSize)) {
+        qCWarning(CompiledParameterMetaDataLog) << "Invalid compiled parameter meta data" << _file.fileName();
+        close();
+        return false;
+    }
+
+    if (_string(_header->sourceKey) != _sourceKey(metaDataFile)) {
+        qCDebug(CompiledParameterMetaDataLog) << "Compiled parameter meta data out of date" << _file.fileName();
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void CompiledParameterMetaData::close(void)
+{
+    if (_map) {
+        _file.unmap(_map);
+    }
+    _file.close();
+    _memoryData.clear();
+
+    _map            = nullptr;
+    _header         = nullptr;
+    _params         = nullptr;
+    _pairs          = nullptr;
+    _stringOffsets  = nullptr;
+    _stringData     = nullptr;
+}
+
+/// Validates the layout before trusting any of the offsets or indices
+bool CompiledParameterMetaData::_setData(const uchar* data, qint64 size)
+{
+    if (size < static_cast<qint64>(sizeof(Header_t))) {
+        return false;
+    }
+
+    const Header_t* header = reinterpret_cast<const Header_t*>(data);
+    if (header->magic != _magic || header->version != _version || header->stringCount == 0) {
+        return false;
+    }
+
+    qint64 pairsOffset          = sizeof(Header_t) + (static_cast<qint64>(header->paramCount) * sizeof(Param_t));
+    qint64 stringOffsetsOffset  = pairsOffset + (static_cast<qint64>(header->pairCount) * sizeof(Pair_t));
+    qint64 stringDataOffset     = stringOffsetsOffset + ((static_cast<qint64>(header->stringCount) + 1) * sizeof(quint32));
+    if (stringDataOffset + header->stringDataSize != size) {
+        return false;
+    }
+
+    const Param_t*  params          = reinterpret_cast<const Param_t*>(data + sizeof(Header_t));
+    const Pair_t*   pairs           = reinterpret_cast<const Pair_t*>(data + pairsOffset);
+    const quint32*  stringOffsets   = reinterpret_cast<const quint32*>(data + stringOffsetsOffset);
+
+    for (quint32 i=0; i<header->stringCount; i++) {
+        if (stringOffsets[i] > stringOffsets[i + 1]) {
+            return false;
+        }
+    }
+    if (stringOffsets[header->stringCount] != header->stringDataSize || header->sourceKey >= header->stringCount) {
+        return false;
+    }
+    for (quint32 i=0; i<header->pairCount; i++) {
+        if (pairs[i].first >= header->stringCount || pairs[i].second >= header->stringCount) {
+            return false;
+        }
+    }
+    for (quint32 i=0; i<header->paramCount; i++) {
+        const Param_t& param = params[i];
+        if (param.section >= header->stringCount || param.name >= header->stringCount) {
+            return false;
+        }
+        for (int j=0; j<FieldCount; j++) {
+            if (param.fields[j] >= header->stringCount) {
+                return false;
+            }
+        }
+        if (static_cast<quint64>(param.valuesIndex) + param.valuesCount > header->pairCount ||
+                static_cast<quint64>(param.bitmaskIndex) + param.bitmaskCount > header->pairCount) {
+            return false;
+        }
+    }
+
+    _header         = header;
+    _params         = params;
+    _pairs          = pairs;
+    _stringOffsets  = stringOffsets;
+    _stringData     = reinterpret_cast<const char*>(data + stringDataOffset);
+
+    return true;
+}
+
+void CompiledParameterMetaData::compile(const QString& metaDataFile, const QList<RawParam_t>& params, bool cacheResult)
+{
+    close();
+
+    QHash<QString, quint32> stringIndices;
+    QVector<quint32>        stringOffsets;
+    QByteArray              stringData;
+
+    auto internString = [&stringIndices, &stringOffsets, &stringData](const QString& string) -> quint32 {
+        auto iter = stringIndices.constFind(string);
+        if (iter != stringIndices.constEnd()) {
+            return iter.value();
+        }
+        quint32 index = static_cast<quint32>(stringOffsets.count());
+        stringIndices.insert(string, index);
+        stringOffsets.append(static_cast<quint32>(stringData.size()));
+        stringData.append(string.toUtf8());
+        return index;
+    };
+
+    // Empty string is always index 0 so unused fields are free
+    internString(QString());
+    quint32 sourceKey = internString(_sourceKey(metaDataFile));
+
+    // Lookups compare utf8 bytes, so sort the same way
+    QVector<int>        order(params.count());
+    QVector<QByteArray> sortKeys(params.count());
+    for (int i=0; i<params.count(); i++) {
+        order[i] = i;
+        sortKeys[i] = params[i].name.toUtf8() + '\0' + params[i].section.toUtf8();
+    }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](int a, int b) { return sortKeys[a] < sortKeys[b]; });
+
+    QVector<Param_t>    compiledParams(params.count());
+    QVector<Pair_t>     compiledPairs;
+    for (int i=0; i<order.count(); i++) {
+        const RawParam_t&   rawParam    = params[order[i]];
+        Param_t&            param       = compiledParams[i];
+
+        param.section   = internString(rawParam.section);
+        param.name      = internString(rawParam.name);
+        param.flags     = rawParam.flags;
+        for (int j=0; j<FieldCount; j++) {
+            param.fields[j] = internString(rawParam.fields[j]);
+        }
+
+        param.valuesIndex = static_cast<quint32>(compiledPairs.count());
+        param.valuesCount = static_cast<quint32>(rawParam.values.count());
+        for (const QPair<QString, QString>& rawPair: rawParam.values) {
+            Pair_t pair = { internString(rawPair.first), internString(rawPair.second) };
+            compiledPairs.append(pair);
+        }
+        param.bitmaskIndex = static_cast<quint32>(compiledPairs.count());
+        param.bitmaskCount = static_cast<quint32>(rawParam.bitmask.count());
+        for (const QPair<QString, QString>& rawPair: rawParam.bitmask) {
+            Pair_t pair = { internString(rawPair.first), internString(rawPair.second) };
+            compiledPairs.append(pair);
+        }
+    }
+    stringOffsets.append(static_cast<quint32>(stringData.size()));
+
+    Header_t header;
+    header.magic            = _magic;
+    header.version          = _version;
+    header.sourceKey        = sourceKey;
+    header.paramCount       = static_cast<quint32>(compiledParams.count());
+    header.pairCount        = static_cast<quint32>(compiledPairs.count());
+    header.stringCount      = static_cast<quint32>(stringOffsets.count() - 1);
+    header.stringDataSize   = static_cast<quint32>(stringData.size());
+
+    QByteArray buffer;
+    buffer.reserve(static_cast<int>(sizeof(Header_t)) + (compiledParams.count() * static_cast<int>(sizeof(Param_t))) +
+                   (compiledPairs.count() * static_cast<int>(sizeof(Pair_t))) + (stringOffsets.count() * static_cast<int>(sizeof(quint32))) +
+                   stringData.size());
+    buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.append(reinterpret_cast<const char*>(compiledParams.constData()), compiledParams.count() * static_cast<int>(sizeof(Param_t)));
+    buffer.append(reinterpret_cast<const char*>(compiledPairs.constData()), compiledPairs.count() * static_cast<int>(sizeof(Pair_t)));
+    buffer.append(reinterpret_cast<const char*>(stringOffsets.constData()), stringOffsets.count() * static_cast<int>(sizeof(quint32)));
+    buffer.append(stringData);
+
+    qCDebug(CompiledParameterMetaDataLog) << "Compiled parameter meta data" << metaDataFile
+                                          << "params:" << header.paramCount << "strings:" << header.stringCount << "bytes:" << buffer.size();
+
+    if (cacheResult) {
+        QDir cacheDir = ParameterManager::parameterCacheDir();
+        cacheDir.mkpath(cacheDir.absolutePath());
+
+        QSaveFile file(compiledFileName(metaDataFile));
+        if (file.open(QIODevice::WriteOnly) && file.write(buffer) == buffer.size() && file.commit()) {
+            if (load(metaDataFile)) {
+                return;
+            }
+        } else {
+            qCWarning(CompiledParameterMetaDataLog) << "Unable to write compiled parameter meta data" << file.fileName() << file.errorString();
+        }
+    } else {
+        // Never leave a stale compiled form behind for meta data which no longer parses
+        QFile::remove(compiledFileName(metaDataFile));
+    }
+
+    _memoryData = buffer;
+    _setData(reinterpret_cast<const uchar*>(_memoryData.constData()), _memoryData.size());
+}
+
+int CompiledParameterMetaData::count(void) const
+{
+    return _header ? static_cast<int>(_header->paramCount) : 0;
+}
+
+QString CompiledParameterMetaData::_string(quint32 stringIndex) const
+{
+    quint32 offset = _stringOffsets[stringIndex];
+    return QString::fromUtf8(_stringData + offset, static_cast<int>(_stringOffsets[stringIndex + 1] - offset));
+}
+
+int CompiledParameterMetaData::_compareString(quint32 stringIndex, const QByteArray& utf8) const
+{
+    quint32 offset  = _stringOffsets[stringIndex];
+    int     length  = static_cast<int>(_stringOffsets[stringIndex + 1] - offset);
+    int     compare = memcmp(_stringData + offset, utf8.constData(), static_cast<size_t>(qMin(length, utf8.length())));
+    return compare == 0 ? length - utf8.length() : compare;
+}
+
+QString CompiledParameterMetaData::section(int index) const
+{
+    return _string(_params[index].section);
+}
+
+QString CompiledParameterMetaData::name(int index) const
+{
+    return _string(_params[index].name);
+}
+
+QString CompiledParameterMetaData::field(int index, Field_t field) const
+{
+    return _string(_params[index].fields[field]);
+}
+
+quint32 CompiledParameterMetaData::flags(int index) const
+{
+    return _params[index].flags;
+}
+
+CompiledParameterMetaData::PairList_t CompiledParameterMetaData::_pairList(quint32 index, quint32 count) const
+{
+    PairList_t pairList;
+
+    pairList.reserve(static_cast<int>(count));
+    for (quint32 i=index; i<index+count; i++) {
+        pairList.append(QPair<QString, QString>(_string(_pairs[i].first), _string(_pairs[i].second)));
+    }
+
+    return pairList;
+}
+
+CompiledParameterMetaData::PairList_t CompiledParameterMetaData::values(int index) const
+{
+    return _pairList(_params[index].valuesIndex, _params[index].valuesCount);
+}
+
+CompiledParameterMetaData::PairList_t CompiledParameterMetaData::bitmask(int index) const
+{
+    return _pairList(_params[index].bitmaskIndex, _params[index].bitmaskCount);
+}
+
+int CompiledParameterMetaData::indexOf(const QString& section, const QString& name) const
+{
+    QByteArray  nameBytes   = name.toUtf8();
+    int         low         = 0;
+    int         high        = count() - 1;
+
+    // Find the first entry with a matching name, then walk the sections which follow it
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (_compareString(_params[mid].name, nameBytes) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    QByteArray sectionBytes = section.toUtf8();
+    for (int i=low; i<count() && _compareString(_params[i].name, nameBytes) == 0; i++) {
+        if (_compareString(_params[i].section, sectionBytes) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QLoggingCategory>
+#include <QPair>
+#include <QString>
+
+Q_DECLARE_LOGGING_CATEGORY(CompiledParameterMetaDataLog)
+
+/// Compact binary form of the firmware parameter meta data xml files. The xml is compiled once into a blob which is
+/// stored in the parameter cache directory and memory mapped on later loads, so no xml parsing is needed on connect.
+/// Nothing is converted to QString until a parameter is actually looked up.
+///
+/// Layout:
+///     Header_t
+///     Param_t[paramCount]         - sorted by name, then section
+///     Pair_t[pairCount]           - enum values and bitmask bits for all parameters
+///     quint32[stringCount + 1]    - string offsets into the string data
+///     char[]                      - utf8 string data, each distinct string is stored once
+class CompiledParameterMetaData
+{
+public:
+    enum Field_t {
+        FieldCategory,
+        FieldGroup,
+        FieldShortDescription,
+        FieldLongDescription,
+        FieldUnits,
+        FieldMin,
+        FieldMax,
+        FieldDefault,
+        FieldIncrement,
+        FieldDecimalPlaces,
+        FieldType,
+        FieldCount
+    };
+
+    enum Flag_t {
+        FlagRebootRequired  = 0x01,
+        FlagReadOnly        = 0x02,
+        FlagVolatile        = 0x04,
+        FlagBoolean         = 0x08,
+        FlagDuplicate       = 0x10,
+    };
+
+    typedef QList<QPair<QString, QString>> PairList_t;
+
+    /// Parameter meta data as read from the xml, input to compile
+    struct RawParam_t {
+        QString     section;            ///< Meta data files with vehicle specific blocks use this to separate them
+        QString     name;
+        QString     fields[FieldCount];
+        quint32     flags = 0;
+        PairList_t  values;             ///< code, description
+        PairList_t  bitmask;            ///< bit index, description
+    };
+
+    CompiledParameterMetaData(void);
+    ~CompiledParameterMetaData();
+
+    /// Loads the compiled form of the specified meta data file from the cache
+    /// @return false: no compiled form, or it is out of date with respect to the meta data file
+    bool load(const QString& metaDataFile);
+
+    /// Compiles the raw meta data and writes it to the cache. If the cache can't be written the compiled form is
+    /// still used from memory.
+    ///     @param cacheResult false: the meta data file didn't parse completely. The compiled form is only kept in
+    ///                         memory and any existing compiled form in the cache is deleted.
+    void compile(const QString& metaDataFile, const QList<RawParam_t>& params, bool cacheResult = true);
+
+    void close(void);
+
+    bool        isLoaded    (void) const { return _params != nullptr; }
+    int         count       (void) const;
+    QString     section     (int index) const;
+    QString     name        (int index) const;
+    QString     field       (int index, Field_t field) const;
+    quint32     flags       (int index) const;
+    PairList_t  values      (int index) const;
+    PairList_t  bitmask     (int index) const;
+
+    /// @return Index of the parameter in the specified section, -1 if not found
+    int indexOf(const QString& section, const QString& name) const;
+
+    /// @return Location of the compiled form of the specified meta data file
+    static QString compiledFileName(const QString& metaDataFile);
+
+private:
+    typedef struct {
+        quint32 magic;
+        quint32 version;
+        quint32 sourceKey;          ///< String index of the key which identifies the meta data file contents
+        quint32 paramCount;
+        quint32 pairCount;
+        quint32 stringCount;
+        quint32 stringDataSize;
+    } Header_t;
+
+    typedef struct {
+        quint32 section;
+        quint32 name;
+        quint32 fields[FieldCount];
+        quint32 flags;
+        quint32 valuesIndex;
+        quint32 valuesCount;
+        quint32 bitmaskIndex;
+        quint32 bitmaskCount;
+    } Param_t;
+
+    typedef struct {
+        quint32 first;
+        quint32 second;
+    } Pair_t;
+
+    bool        _setData        (const uchar* data, qint64 size);
+    QString     _string         (quint32 stringIndex) const;
+    int         _compareString  (quint32 stringIndex, const QByteArray& utf8) const;
+    PairList_t  _pairList       (quint32 index, quint32 count) const;
+
+    static QString _sourceKey(const QString& metaDataFile);
+
+    QFile           _file;
+    uchar*          _map            = nullptr;
+    QByteArray      _memoryData;                    ///< Used when the compiled form could not be written to the cache
+    const Header_t* _header         = nullptr;
+    const Param_t*  _params         = nullptr;
+    const Pair_t*   _pairs          = nullptr;
+    const quint32*  _stringOffsets  = nullptr;
+    const char*     _stringData     = nullptr;
+
+    static const quint32 _magic     = 0x4d504351;   ///< "QCPM"
+    static const quint32 _version   = 1;
+};
@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompiledParameterMetaDataTest.h"
+#include "APMParameterMetaData.h"
+
+#include <QTemporaryDir>
+
+QList<CompiledParameterMetaData::RawParam_t> CompiledParameterMetaDataTest::_rawParams(void)
+{
+    // Intentionally unsorted, with the same name in two sections and a name which is a prefix of another
+    QList<CompiledParameterMetaData::RawParam_t> rawParams;
+
+    CompiledParameterMetaData::RawParam_t rawParam;
+    rawParam.section                                                    = QStringLiteral("ArduCopter");
+    rawParam.name                                                       = QStringLiteral("FRAME_CLASS");
+    rawParam.fields[CompiledParameterMetaData::FieldShortDescription]   = QStringLiteral("Frame Class");
+    rawParam.fields[CompiledParameterMetaData::FieldCategory]           = QStringLiteral("Standard");
+    rawParam.flags                                                      = CompiledParameterMetaData::FlagRebootRequired;
+    rawParam.values.append(QPair<QString, QString>(QStringLiteral("0"), QStringLiteral("Undefined")));
+    rawParam.values.append(QPair<QString, QString>(QStringLiteral("1"), QStringLiteral("Quad")));
+    rawParams.append(rawParam);
+
+    rawParam = CompiledParameterMetaData::RawParam_t();
+    rawParam.section                                                    = QStringLiteral("libraries");
+    rawParam.name                                                       = QStringLiteral("FRAME_CLASS");
+    rawParam.fields[CompiledParameterMetaData::FieldShortDescription]   = QStringLiteral("Library frame class");
+    rawParams.append(rawParam);
+
+    rawParam = CompiledParameterMetaData::RawParam_t();
+    rawParam.section                                                    = QStringLiteral("libraries");
+    rawParam.name                                                       = QStringLiteral("ARMING_CHECK");
+    rawParam.fields[CompiledParameterMetaData::FieldCategory]           = QStringLiteral("Standard");
+    rawParam.fields[CompiledParameterMetaData::FieldShortDescription]   = QStringLiteral("Arm Checks to Perform (bitmask)");
+    rawParam.fields[CompiledParameterMetaData::FieldLongDescription]    = QStringLiteral("Checks prior to arming motor ") + QChar(0x00b0);   // Non ascii must survive
+    rawParam.bitmask.append(QPair<QString, QString>(QStringLiteral("0"), QStringLiteral("All")));
+    rawParam.bitmask.append(QPair<QString, QString>(QStringLiteral("1"), QStringLiteral("Barometer")));
+    rawParams.append(rawParam);
+
+    rawParam = CompiledParameterMetaData::RawParam_t();
+    rawParam.section                                                    = QStringLiteral("libraries");
+    rawParam.name                                                       = QStringLiteral("ARMING");
+    rawParam.fields[CompiledParameterMetaData::FieldMin]                = QStringLiteral("0");
+    rawParam.fields[CompiledParameterMetaData::FieldMax]                = QStringLiteral("1");
+    rawParam.flags                                                      = CompiledParameterMetaData::FlagReadOnly | CompiledParameterMetaData::FlagVolatile;
+    rawParams.append(rawParam);
+
+    return rawParams;
+}
+
+void CompiledParameterMetaDataTest::_compileLoad_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString metaDataFile = tempDir.filePath(QStringLiteral("ParameterFactMetaData.xml"));
+    QFile file(metaDataFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<parameters/>");
+    file.close();
+
+    QList<CompiledParameterMetaData::RawParam_t> rawParams = _rawParams();
+    CompiledParameterMetaData compiled;
+    compiled.compile(metaDataFile, rawParams);
+    QVERIFY(compiled.isLoaded());
+    QVERIFY(QFile::exists(CompiledParameterMetaData::compiledFileName(metaDataFile)));
+
+    // Load from the cache in a new object and check everything survived
+    CompiledParameterMetaData loaded;
+    QVERIFY(loaded.load(metaDataFile));
+    QCOMPARE(loaded.count(), rawParams.count());
+
+    for (const CompiledParameterMetaData::RawParam_t& rawParam: rawParams) {
+        int index = loaded.indexOf(rawParam.section, rawParam.name);
+        QVERIFY(index >= 0);
+        QCOMPARE(loaded.section(index), rawParam.section);
+        QCOMPARE(loaded.name(index), rawParam.name);
+        QCOMPARE(loaded.flags(index), rawParam.flags);
+        for (int i=0; i<CompiledParameterMetaData::FieldCount; i++) {
+            QCOMPARE(loaded.field(index, static_cast<CompiledParameterMetaData::Field_t>(i)), rawParam.fields[i]);
+        }
+        QCOMPARE(loaded.values(index), rawParam.values);
+        QCOMPARE(loaded.bitmask(index), rawParam.bitmask);
+    }
+
+    QCOMPARE(loaded.indexOf(QStringLiteral("ArduPlane"), QStringLiteral("FRAME_CLASS")), -1);
+    QCOMPARE(loaded.indexOf(QStringLiteral("libraries"), QStringLiteral("ARMING_")), -1);
+    QCOMPARE(loaded.indexOf(QStringLiteral("libraries"), QStringLiteral("ZZZ")), -1);
+    QCOMPARE(loaded.indexOf(QStringLiteral("libraries"), QStringLiteral("AAA")), -1);
+}
+
+void CompiledParameterMetaDataTest::_outOfDate_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString metaDataFile = tempDir.filePath(QStringLiteral("ParameterFactMetaData.xml"));
+    QFile file(metaDataFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<parameters/>");
+    file.close();
+
+    CompiledParameterMetaData compiled;
+    QVERIFY(!compiled.load(metaDataFile));
+    compiled.compile(metaDataFile, _rawParams());
+    compiled.close();
+    QVERIFY(compiled.load(metaDataFile));
+    compiled.close();
+
+    // A changed meta data file must not use the old compiled form
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("\n");
+    file.close();
+    QVERIFY(!compiled.load(metaDataFile));
+
+    // Corrupt compiled form is rejected
+    compiled.compile(metaDataFile, _rawParams());
+    compiled.close();
+    QFile compiledFile(CompiledParameterMetaData::compiledFileName(metaDataFile));
+    QVERIFY(compiledFile.open(QIODevice::ReadWrite));
+    QVERIFY(compiledFile.resize(compiledFile.size() / 2));
+    compiledFile.close();
+    QVERIFY(!compiled.load(metaDataFile));
+}
+
+void CompiledParameterMetaDataTest::_apmMetaData_test(void)
+{
+    const QString metaDataFile = QStringLiteral(":/FirmwarePlugin/APM/APMParameterFactMetaData.Copter.4.1.xml");
+
+    QFile::remove(CompiledParameterMetaData::compiledFileName(metaDataFile));
+
+    // First load compiles from the xml, second load uses the compiled form. Both must produce the same meta data.
+    for (int pass=0; pass<2; pass++) {
+        APMParameterMetaData apmMetaData;
+        apmMetaData.loadParameterFactMetaDataFile(metaDataFile);
+        QVERIFY(QFile::exists(CompiledParameterMetaData::compiledFileName(metaDataFile)));
+
+        FactMetaData* metaData = apmMetaData.getMetaDataForFact(QStringLiteral("ANGLE_MAX"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt16);
+        QCOMPARE(metaData->name(), QStringLiteral("ANGLE_MAX"));
+        QCOMPARE(metaData->shortDescription(), QStringLiteral("Angle Max"));
+        QCOMPARE(metaData->longDescription(), QStringLiteral("Maximum lean angle in all flight modes"));
+        QCOMPARE(metaData->category(), QStringLiteral("Advanced"));
+        QCOMPARE(metaData->rawUnits(), QStringLiteral("cdeg"));
+        QCOMPARE(metaData->rawMin().toInt(), 1000);
+        QCOMPARE(metaData->rawMax().toInt(), 8000);
+        QCOMPARE(metaData->rawIncrement(), 10.0);
+
+        metaData = apmMetaData.getMetaDataForFact(QStringLiteral("FRAME_CLASS"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt8);
+        QVERIFY(metaData->enumStrings().count() > 2);
+        QCOMPARE(metaData->enumStrings()[1], QStringLiteral("Quad"));
+        QCOMPARE(metaData->enumValues()[1].toInt(), 1);
+
+        metaData = apmMetaData.getMetaDataForFact(QStringLiteral("NOT_A_PARAM"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt8);
+        QCOMPARE(metaData->category(), QStringLiteral("Advanced"));
+        QCOMPARE(metaData->group(), QStringLiteral("NOT"));
+    }
+}
+
+void CompiledParameterMetaDataTest::_parseError_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QFile resourceFile(QStringLiteral(":/FirmwarePlugin/APM/APMParameterFactMetaData.Copter.4.1.xml"));
+    QVERIFY(resourceFile.open(QIODevice::ReadOnly));
+    const QByteArray xml = resourceFile.readAll();
+
+    const QString metaDataFile = tempDir.filePath(QStringLiteral("APMParameterFactMetaData.xml"));
+    QFile file(metaDataFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(xml), static_cast<qint64>(xml.size()));
+    file.close();
+
+    {
+        APMParameterMetaData apmMetaData;
+        apmMetaData.loadParameterFactMetaDataFile(metaDataFile);
+        QVERIFY(QFile::exists(CompiledParameterMetaData::compiledFileName(metaDataFile)));
+    }
+
+    // A meta data file which no longer parses removes the compiled form and never writes a new one
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(xml.left(xml.size() / 2)), static_cast<qint64>(xml.size() / 2));
+    file.close();
+
+    for (int pass=0; pass<2; pass++) {
+        APMParameterMetaData apmMetaData;
+        apmMetaData.loadParameterFactMetaDataFile(metaDataFile);
+        QVERIFY(!QFile::exists(CompiledParameterMetaData::compiledFileName(metaDataFile)));
+    }
+}
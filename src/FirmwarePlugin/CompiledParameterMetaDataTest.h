@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "CompiledParameterMetaData.h"
+
+/// Unit test for CompiledParameterMetaData and the firmware meta data loaded through it
+class CompiledParameterMetaDataTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _compileLoad_test  (void);
+    void _outOfDate_test    (void);
+    void _apmMetaData_test  (void);
+    void _parseError_test   (void);
+
+private:
+    QList<CompiledParameterMetaData::RawParam_t> _rawParams(void);
+};
@@ -19,6 +19,8 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
 
 static const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
@@ -88,32 +90,54 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    if (_compiledMetaData.load(metaDataFile)) {
+        qCDebug(PX4ParameterMetaDataLog) << "Loaded compiled parameter meta data:" << metaDataFile << loadTimer.elapsed() << "msecs";
+    } else {
+        QList<CompiledParameterMetaData::RawParam_t> rawParams;
+        // Only a complete parse goes into the cache, otherwise the next connect would pick up partial meta data
+        bool parsed = _parseParameterFactMetaDataFile(metaDataFile, rawParams);
+        _compiledMetaData.compile(metaDataFile, rawParams, parsed);
+        qCDebug(PX4ParameterMetaDataLog) << "Compiled parameter meta data:" << metaDataFile << loadTimer.elapsed() << "msecs";
+    }
+
+#ifdef GENERATE_PARAMETER_JSON
+    _generateParameterJson();
+#endif
+}
+
+/// Reads the xml into raw string form. Conversion to FactMetaData happens when a parameter is first used.
+/// @return false: the xml could not be parsed completely
+bool PX4ParameterMetaData::_parseParameterFactMetaDataFile(const QString& metaDataFile, QList<CompiledParameterMetaData::RawParam_t>& rawParams)
+{
     qCDebug(PX4ParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
     QFile xmlFile(metaDataFile);
 
     if (!xmlFile.exists()) {
         qWarning() << "Internal error: metaDataFile mission" << metaDataFile;
-        return;
+        return false;
     }
     
     if (!xmlFile.open(QIODevice::ReadOnly)) {
         qWarning() << "Internal error: Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
-        return;
+        return false;
     }
     
     QXmlStreamReader xml(xmlFile.readAll());
     xmlFile.close();
     if (xml.hasError()) {
         qWarning() << "Badly formed XML" << xml.errorString();
-        return;
+        return false;
     }
     
-    QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
-    int             xmlState = XmlStateNone;
-    bool            badMetaData = true;
+    QString             factGroup;
+    QHash<QString, int> nameToIndex;
+    int                 paramIndex = -1;
+    int                 xmlState = XmlStateNone;
+    bool                badMetaData = true;
     
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
@@ -122,14 +146,14 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             if (elementName == "parameters") {
                 if (xmlState != XmlStateNone) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundParameters;
                 
             } else if (elementName == "version") {
                 if (xmlState != XmlStateFoundParameters) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundVersion;
                 
@@ -138,12 +162,12 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 int intVersion = strVersion.toInt(&convertOk);
                 if (!convertOk) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 if (intVersion <= 2) {
                     // We can't read these old files
                     qDebug() << "Parameter version stamp too old, skipping load. Found:" << intVersion << "Want: 3 File:" << metaDataFile;
-                    return;
+                    return false;
                 }
                 
             } else if (elementName == "parameter_version_major") {
@@ -155,13 +179,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState != XmlStateFoundVersion) {
                     // We didn't get a version stamp, assume older version we can't read
                     qDebug() << "Parameter version stamp not found, skipping load" << metaDataFile;
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundGroup;
                 
                 if (!xml.attributes().hasAttribute("name")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 factGroup = xml.attributes().value("name").toString();
                 qCDebug(PX4ParameterMetaDataLog) << "Found group: " << factGroup;
@@ -169,13 +193,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "parameter") {
                 if (xmlState != XmlStateFoundGroup) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundParameter;
                 
                 if (!xml.attributes().hasAttribute("name") || !xml.attributes().hasAttribute("type")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 
                 QString name = xml.attributes().value("name").toString();
@@ -205,173 +229,121 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
 
                 // Convert type from string to FactMetaData::ValueType_t
                 bool unknownType;
-                FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+                FactMetaData::stringToType(type, unknownType);
                 if (unknownType) {
                     qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
-                    return;
+                    return false;
                 }
                 
-                // Now that we know type we can create meta data object and add it to the system
-                metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
+                CompiledParameterMetaData::RawParam_t rawParam;
+                rawParam.name                                           = name;
+                rawParam.fields[CompiledParameterMetaData::FieldType]   = type;
+
+                if (nameToIndex.contains(name)) {
                     // We can't trust the meta data since we have dups
                     qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
                     badMetaData = true;
                     // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
+                    rawParam.flags = CompiledParameterMetaData::FlagDuplicate;
+                    paramIndex = nameToIndex[name];
+                    rawParams[paramIndex] = rawParam;
                 } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
-                    
+                    rawParam.fields[CompiledParameterMetaData::FieldCategory]   = category;
+                    rawParam.fields[CompiledParameterMetaData::FieldGroup]      = factGroup;
+                    if (readOnly) {
+                        rawParam.flags |= CompiledParameterMetaData::FlagReadOnly;
+                    }
+                    if (volatileValue) {
+                        rawParam.flags |= CompiledParameterMetaData::FlagVolatile;
+                    }
                     if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
-                        
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
+                        rawParam.fields[CompiledParameterMetaData::FieldDefault] = strDefault;
                     }
+
+                    paramIndex = rawParams.count();
+                    nameToIndex[name] = paramIndex;
+                    rawParams.append(rawParam);
                 }
                 
             } else {
                 // We should be getting meta data now
                 if (xmlState != XmlStateFoundParameter) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
 
                 if (!badMetaData) {
-                    if (metaData) {
-                        if (elementName == "short_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
-
-                        } else if (elementName == "long_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
-
-                        } else if (elementName == "min") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "max") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "unit") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
-
-                        } else if (elementName == "decimal") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
-
-                        } else if (elementName == "reboot_required") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
-                            if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
-                            }
-
-                        } else if (elementName == "values") {
-                            // doing nothing individual value will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "value") {
-                            QString enumValueStr = xml.attributes().value("code").toString();
-                            QString enumString = xml.readElementText();
+                    CompiledParameterMetaData::RawParam_t& rawParam = rawParams[paramIndex];
+
+                    if (elementName == "short_desc") {
+                        QString text = xml.readElementText();
+                        text = text.replace("\n", " ");
+                        qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldShortDescription] = text;
+
+                    } else if (elementName == "long_desc") {
+                        QString text = xml.readElementText();
+                        text = text.replace("\n", " ");
+                        qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldLongDescription] = text;
+
+                    } else if (elementName == "min") {
+                        QString text = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldMin] = text;
+
+                    } else if (elementName == "max") {
+                        QString text = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldMax] = text;
+
+                    } else if (elementName == "unit") {
+                        QString text = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldUnits] = text;
+
+                    } else if (elementName == "decimal") {
+                        QString text = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
+                        rawParam.fields[CompiledParameterMetaData::FieldDecimalPlaces] = text;
+
+                    } else if (elementName == "reboot_required") {
+                        QString text = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
+                        if (text.compare("true", Qt::CaseInsensitive) == 0) {
+                            rawParam.flags |= CompiledParameterMetaData::FlagRebootRequired;
+                        }
+
+                    } else if (elementName == "values") {
+                        // doing nothing individual value will follow anyway. May be used for sanity checking.
+
+                    } else if (elementName == "value") {
+                        QString enumValueStr = xml.attributes().value("code").toString();
+                        QString enumString = xml.readElementText();
+                        qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                                         << "value desc:" << enumString << "code:" << enumValueStr;
+                        rawParam.values.append(QPair<QString, QString>(enumValueStr, enumString));
+
+                    } else if (elementName == "increment") {
+                        rawParam.fields[CompiledParameterMetaData::FieldIncrement] = xml.readElementText();
+
+                    } else if (elementName == "boolean") {
+                        rawParam.flags |= CompiledParameterMetaData::FlagBoolean;
+
+                    } else if (elementName == "bitmask") {
+                        // doing nothing individual bits will follow anyway. May be used for sanity checking.
+
+                    } else if (elementName == "bit") {
+                        bool ok = false;
+                        unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
+                        if (ok) {
+                            QString bitDescription = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                             << "value desc:" << enumString << "code:" << enumValueStr;
-
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
-                        } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
-                            QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
-
-                        } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
-
-                        } else if (elementName == "bitmask") {
-                            // doing nothing individual bits will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "bit") {
-                            bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
-                            if (ok) {
-                                QString bitDescription = xml.readElementText();
-                                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
-                            }
-                        } else {
-                            qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
+                                                             << "index:" << bit << "description:" << bitDescription;
+                            rawParam.bitmask.append(QPair<QString, QString>(QString::number(bit), bitDescription));
                         }
                     } else {
-                        qWarning() << "Internal error";
+                        qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
                     }
                 }
             }
@@ -379,17 +351,8 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             QString elementName = xml.name().toString();
 
             if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
-
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
-                }
-
                 // Reset for next parameter
-                metaData = nullptr;
+                paramIndex = -1;
                 badMetaData = false;
                 xmlState = XmlStateFoundGroup;
             } else if (elementName == "group") {
@@ -401,9 +364,12 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         xml.readNext();
     }
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+    if (xml.hasError()) {
+        qWarning() << "Badly formed XML" << xml.errorString();
+        return false;
+    }
+
+    return true;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -420,6 +386,11 @@ void PX4ParameterMetaData::_generateParameterJson()
 {
     qCDebug(ParameterManagerLog) << "PX4ParameterMetaData::_generateParameterJson";
 
+    // Meta data is created on first use, so force creation of all of it
+    for (int i=0; i<_compiledMetaData.count(); i++) {
+        getMetaDataForFact(_compiledMetaData.name(i), MAV_TYPE_GENERIC, FactMetaData::valueTypeInt32);
+    }
+
     int indentLevel = 0;
     QFile jsonFile(QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).absoluteFilePath("parameter.json"));
     jsonFile.open(QFile::WriteOnly | QFile::Truncate | QFile::Text);
@@ -495,14 +466,153 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     Q_UNUSED(vehicleType)
 
     if (!_mapParameterName2FactMetaData.contains(name)) {
-        qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
-        _mapParameterName2FactMetaData[name] = metaData;
+        int index = _compiledMetaData.indexOf(QString(), name);
+        if (index >= 0) {
+            _mapParameterName2FactMetaData[name] = _createMetaData(index);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
+            FactMetaData* metaData = new FactMetaData(type, this);
+            _mapParameterName2FactMetaData[name] = metaData;
+        }
     }
 
     return _mapParameterName2FactMetaData[name];
 }
 
+/// Creates the FactMetaData for a parameter from its compiled raw form
+FactMetaData* PX4ParameterMetaData::_createMetaData(int index)
+{
+    QString errorString;
+    bool    unknownType;
+    quint32 flags = _compiledMetaData.flags(index);
+
+    FactMetaData* metaData = new FactMetaData(FactMetaData::stringToType(_compiledMetaData.field(index, CompiledParameterMetaData::FieldType), unknownType), this);
+    if (flags & CompiledParameterMetaData::FlagDuplicate) {
+        // We can't trust the meta data since we have dups
+        return metaData;
+    }
+
+    metaData->setName(_compiledMetaData.name(index));
+    metaData->setCategory(_compiledMetaData.field(index, CompiledParameterMetaData::FieldCategory));
+    metaData->setGroup(_compiledMetaData.field(index, CompiledParameterMetaData::FieldGroup));
+    metaData->setReadOnly(flags & CompiledParameterMetaData::FlagReadOnly);
+    metaData->setVolatileValue(flags & CompiledParameterMetaData::FlagVolatile);
+    metaData->setVehicleRebootRequired(flags & CompiledParameterMetaData::FlagRebootRequired);
+
+    QString text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldDefault);
+    if (!text.isEmpty()) {
+        QVariant varDefault;
+        if (metaData->convertAndValidateRaw(text, false, varDefault, errorString)) {
+            metaData->setRawDefaultValue(varDefault);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldShortDescription);
+    if (!text.isEmpty()) {
+        metaData->setShortDescription(text);
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldLongDescription);
+    if (!text.isEmpty()) {
+        metaData->setLongDescription(text);
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldMin);
+    if (!text.isEmpty()) {
+        QVariant varMin;
+        if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
+            metaData->setRawMin(varMin);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldMax);
+    if (!text.isEmpty()) {
+        QVariant varMax;
+        if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
+            metaData->setRawMax(varMax);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldUnits);
+    if (!text.isEmpty()) {
+        metaData->setRawUnits(text);
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldDecimalPlaces);
+    if (!text.isEmpty()) {
+        bool convertOk;
+        QVariant varDecimals = QVariant(text).toUInt(&convertOk);
+        if (convertOk) {
+            metaData->setDecimalPlaces(varDecimals.toInt());
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
+        }
+    }
+
+    for (const QPair<QString, QString>& enumPair: _compiledMetaData.values(index)) {
+        QVariant enumValue;
+        if (metaData->convertAndValidateRaw(enumPair.first, false /* validate */, enumValue, errorString)) {
+            metaData->addEnumInfo(enumPair.second, enumValue);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                             << " type:" << metaData->type() << " value:" << enumPair.first
+                                             << " error:" << errorString;
+        }
+    }
+
+    if (flags & CompiledParameterMetaData::FlagBoolean) {
+        QVariant enumValue;
+        metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Enabled"), enumValue);
+        metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Disabled"), enumValue);
+    }
+
+    for (const QPair<QString, QString>& bitPair: _compiledMetaData.bitmask(index)) {
+        unsigned int bit = bitPair.first.toUInt();
+        if (bit < 31) {
+            QVariant bitmaskRawValue = 1 << bit;
+            QVariant bitmaskValue;
+            if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                metaData->addBitmaskInfo(bitPair.second, bitmaskValue);
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                 << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                 << " error:" << errorString;
+            }
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
+        }
+    }
+
+    text = _compiledMetaData.field(index, CompiledParameterMetaData::FieldIncrement);
+    if (!text.isEmpty()) {
+        bool    ok;
+        double  increment = text.toDouble(&ok);
+        if (ok) {
+            metaData->setRawIncrement(increment);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
+        }
+    }
+
+    // Validate default value against the full meta data
+    if (metaData->defaultValueAvailable()) {
+        QVariant var;
+        if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
+        }
+    }
+
+    return metaData;
+}
+
 void PX4ParameterMetaData::getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion)
 {
     QFile xmlFile(metaDataFile);
@@ -17,6 +17,7 @@
 #include "FactSystem.h"
 #include "AutoPilotPlugin.h"
 #include "Vehicle.h"
+#include "CompiledParameterMetaData.h"
 
 /// @file
 ///     @author Don Gagne <don@thegagnes.com>
@@ -48,7 +49,9 @@ private:
         XmlStateDone
     };    
 
-    QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    QVariant        _stringToTypedVariant           (const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    bool            _parseParameterFactMetaDataFile (const QString& metaDataFile, QList<CompiledParameterMetaData::RawParam_t>& rawParams);
+    FactMetaData*   _createMetaData                 (int index);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -56,5 +59,6 @@ private:
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    CompiledParameterMetaData           _compiledMetaData;
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, filled on first use
 };
@@ -68,6 +68,15 @@ FlightMap {
         }
     }
 
+    // ADSB vehicles shown on the map are limited to the visible region
+    function updateADSBViewRegion() {
+        if (!pipMode) {
+            var coordinateNW = _root.toCoordinate(Qt.point(0,0), false /* clipToViewPort */)
+            var coordinateSE = _root.toCoordinate(Qt.point(width,height), false /* clipToViewPort */)
+            QGroundControl.adsbVehicleManager.setViewRegion(coordinateNW, coordinateSE)
+        }
+    }
+
     function _adjustMapZoomForPipMode() {
         _saveZoomLevelSetting = false
         if (pipMode) {
@@ -94,11 +103,15 @@ FlightMap {
             QGroundControl.flightMapZoom = zoomLevel
             updateAirspace(false)
         }
+        updateADSBViewRegion()
     }
     onCenterChanged: {
         QGroundControl.flightMapPosition = center
         updateAirspace(false)
+        updateADSBViewRegion()
     }
+    onWidthChanged:     updateADSBViewRegion()
+    onHeightChanged:    updateADSBViewRegion()
 
     on_AirspaceEnabledChanged: {
         updateAirspace(true)
@@ -274,7 +287,7 @@ FlightMap {
     }
     // Add ADSB vehicles to the map
     MapItemView {
-        model: QGroundControl.adsbVehicleManager.adsbVehicles
+        model: pipMode ? QGroundControl.adsbVehicleManager.adsbVehicles : QGroundControl.adsbVehicleManager.adsbVehiclesInView
         delegate: VehicleMapItem {
             coordinate:     object.coordinate
             altitude:       object.altitude
@@ -58,7 +58,7 @@ void GPSManager::connectGPS(const QString& device, const QString& gps_type)
     _gpsProvider->start();
 
     //create RTCM device
-    _rtcmMavlink = new RTCMMavlink(*_toolbox);
+    _rtcmMavlink = new RTCMMavlink(*_toolbox, qgcApp()->gpsRtkFactGroup() ? qgcApp()->gpsRtkFactGroup()->rtcm() : nullptr);
 
     connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate);
 
@@ -12,72 +12,271 @@
 
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
+#include "RTCMFactGroup.h"
+#include "QGCLoggingCategory.h"
+#ifndef NO_SERIAL_LINK
+#include "SerialLink.h"
+#endif
 
-#include <cstdio>
+RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox, RTCMFactGroup* factGroup)
+    : _toolbox  (toolbox)
+    , _factGroup(factGroup)
+{
+    _clock.start();
+
+    _sendTimer.setSingleShot(false);
+    _sendTimer.setInterval(_sendIntervalMsecs);
+    connect(&_sendTimer, &QTimer::timeout, this, &RTCMMavlink::_sendQueuedMessages);
 
-RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
-    : _toolbox(toolbox)
+    connect(&_statisticsTimer, &QTimer::timeout, this, &RTCMMavlink::_updateStatistics);
+    _statisticsTimer.start(_statisticsIntervalMsecs);
+}
+
+RTCMMavlink::~RTCMMavlink()
 {
-    _bandwidthTimer.start();
+    if (_factGroup) {
+        _factGroup->inputRate()->setRawValue(0);
+        _factGroup->outputRate()->setRawValue(0);
+        _factGroup->latency()->setRawValue(0);
+    }
 }
 
 void RTCMMavlink::RTCMDataUpdate(QByteArray message)
 {
-    /* statistics */
-    _bandwidthByteCounter += message.size();
-    qint64 elapsed = _bandwidthTimer.elapsed();
-    if (elapsed > 1000) {
-        printf("RTCM bandwidth: %.2f kB/s\n", (float) _bandwidthByteCounter / elapsed * 1000.f / 1024.f);
-        _bandwidthTimer.restart();
-        _bandwidthByteCounter = 0;
+    _inputByteCounter += message.size();
+    _messageCount++;
+
+    _updateLinks();
+
+    // The message data is shared between the link queues, not copied
+    QueuedMessage_t queuedMessage = { message, _clock.elapsed(), QSharedPointer<bool>::create(false) };
+    for (LinkQueue_t& linkQueue: _linkQueues) {
+        linkQueue.queue.append(queuedMessage);
     }
 
-    const int maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
-    mavlink_gps_rtcm_data_t mavlinkRtcmData;
-    memset(&mavlinkRtcmData, 0, sizeof(mavlink_gps_rtcm_data_t));
-
-    if (message.size() < maxMessageLength) {
-        mavlinkRtcmData.len = message.size();
-        mavlinkRtcmData.flags = (_sequenceId & 0x1F) << 3;
-        memcpy(&mavlinkRtcmData.data, message.data(), message.size());
-        sendMessageToVehicle(mavlinkRtcmData);
-    } else {
-        // We need to fragment
-
-        uint8_t fragmentId = 0;         // Fragment id indicates the fragment within a set
-        int start = 0;
-        while (start < message.size()) {
-            int length = std::min(message.size() - start, maxMessageLength);
-            mavlinkRtcmData.flags = 1;                      // LSB set indicates message is fragmented
-            mavlinkRtcmData.flags |= fragmentId++ << 1;     // Next 2 bits are fragment id
-            mavlinkRtcmData.flags |= (_sequenceId & 0x1F) << 3;     // Next 5 bits are sequence id
-            mavlinkRtcmData.len = length;
-            memcpy(&mavlinkRtcmData.data, message.data() + start, length);
-            sendMessageToVehicle(mavlinkRtcmData);
-            start += length;
-        }
+    // Messages which arrive together are sent on the next tick so they can be packed
+    if (!_linkQueues.isEmpty() && !_sendTimer.isActive()) {
+        _sendTimer.start();
     }
-    ++_sequenceId;
 }
 
-void RTCMMavlink::sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg)
+/// Keeps one queue for each distinct link which is the primary link of a vehicle. Vehicles sharing a link share
+/// the queue, GPS_RTCM_DATA is a broadcast so they are all served by the same packets.
+void RTCMMavlink::_updateLinks(void)
 {
-    QmlObjectListModel& vehicles = *_toolbox.multiVehicleManager()->vehicles();
-    MAVLinkProtocol* mavlinkProtocol = _toolbox.mavlinkProtocol();
+    QMap<LinkInterface*, Vehicle*>  currentLinks;
+    QmlObjectListModel&             vehicles        = *_toolbox.multiVehicleManager()->vehicles();
+    qint64                          nowMsecs        = _clock.elapsed();
+
     for (int i = 0; i < vehicles.count(); i++) {
         Vehicle*                vehicle     = qobject_cast<Vehicle*>(vehicles[i]);
-        WeakLinkInterfacePtr    weakLink    = vehicle->vehicleLinkManager()->primaryLink();
-
-        if (!weakLink.expired()) {
-            mavlink_message_t       message;
-            SharedLinkInterfacePtr  sharedLink = weakLink.lock();
-
-            mavlink_msg_gps_rtcm_data_encode_chan(mavlinkProtocol->getSystemId(),
-                                                  mavlinkProtocol->getComponentId(),
-                                                  sharedLink->mavlinkChannel(),
-                                                  &message,
-                                                  &msg);
-            vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+        SharedLinkInterfacePtr  sharedLink  = vehicle->vehicleLinkManager()->primaryLink().lock();
+
+        if (sharedLink && !currentLinks.contains(sharedLink.get())) {
+            currentLinks[sharedLink.get()] = vehicle;
+        }
+    }
+
+    for (auto iter = _linkQueues.begin(); iter != _linkQueues.end(); ) {
+        auto currentIter = currentLinks.find(iter.key());
+        if (currentIter == currentLinks.end() || iter.value().weakLink.expired()) {
+            iter = _linkQueues.erase(iter);
+        } else {
+            iter.value().vehicle = currentIter.value();
+            ++iter;
+        }
+    }
+
+    for (auto iter = currentLinks.constBegin(); iter != currentLinks.constEnd(); ++iter) {
+        if (!_linkQueues.contains(iter.key())) {
+            LinkQueue_t linkQueue;
+            linkQueue.weakLink              = iter.value()->vehicleLinkManager()->primaryLink();
+            linkQueue.vehicle               = iter.value();
+            linkQueue.fragmentOffset        = 0;
+            linkQueue.sequenceId            = 0;
+            linkQueue.rateBytesPerSecond    = _linkRate(iter.key());
+            linkQueue.tokens                = linkQueue.rateBytesPerSecond * _burstMsecs / 1000.0;
+            linkQueue.lastRefillMsecs       = nowMsecs;
+            _linkQueues[iter.key()]         = linkQueue;
+            qCDebug(RTKGPSLog) << "RTCM link added" << iter.key() << "rate bytes/sec" << linkQueue.rateBytesPerSecond;
+        }
+    }
+}
+
+void RTCMMavlink::_sendQueuedMessages(void)
+{
+    qint64  nowMsecs    = _clock.elapsed();
+    bool    pending     = false;
+
+    _updateLinks();
+
+    for (LinkQueue_t& linkQueue: _linkQueues) {
+        _sendOnLink(linkQueue, nowMsecs);
+        pending |= !linkQueue.queue.isEmpty();
+    }
+
+    if (!pending) {
+        _sendTimer.stop();
+    }
+}
+
+void RTCMMavlink::_sendOnLink(LinkQueue_t& linkQueue, qint64 nowMsecs)
+{
+    SharedLinkInterfacePtr sharedLink = linkQueue.weakLink.lock();
+    if (!sharedLink) {
+        linkQueue.queue.clear();
+        linkQueue.fragmentOffset = 0;
+        return;
+    }
+
+    // Refill the token bucket. The bucket always holds at least one full packet so slow links still make progress.
+    double burstBytes = qMax(linkQueue.rateBytesPerSecond * _burstMsecs / 1000.0, static_cast<double>(MAVLINK_MAX_PACKET_LEN));
+    linkQueue.tokens            = qMin(burstBytes, linkQueue.tokens + (linkQueue.rateBytesPerSecond * (nowMsecs - linkQueue.lastRefillMsecs) / 1000.0));
+    linkQueue.lastRefillMsecs   = nowMsecs;
+
+    _dropStaleMessages(linkQueue, nowMsecs);
+
+    const int maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
+
+    while (!linkQueue.queue.isEmpty()) {
+        mavlink_gps_rtcm_data_t mavlinkRtcmData;
+        memset(&mavlinkRtcmData, 0, sizeof(mavlink_gps_rtcm_data_t));
+
+        int                 completedMessages   = 0;
+        const QByteArray&   firstMessage        = linkQueue.queue.first().data;
+
+        if (linkQueue.fragmentOffset > 0 || firstMessage.size() >= maxMessageLength) {
+            // We need to fragment
+            int     length      = std::min(firstMessage.size() - linkQueue.fragmentOffset, maxMessageLength);
+            uint8_t fragmentId  = static_cast<uint8_t>(linkQueue.fragmentOffset / maxMessageLength);    // Fragment id indicates the fragment within a set
+            mavlinkRtcmData.flags = 1;                                      // LSB set indicates message is fragmented
+            mavlinkRtcmData.flags |= fragmentId << 1;                       // Next 2 bits are fragment id
+            mavlinkRtcmData.flags |= (linkQueue.sequenceId & 0x1F) << 3;    // Next 5 bits are sequence id
+            mavlinkRtcmData.len = static_cast<uint8_t>(length);
+            memcpy(&mavlinkRtcmData.data, firstMessage.constData() + linkQueue.fragmentOffset, static_cast<size_t>(length));
+            if (!_sendPacket(linkQueue, sharedLink, mavlinkRtcmData)) {
+                break;
+            }
+            linkQueue.fragmentOffset += length;
+            if (linkQueue.fragmentOffset >= firstMessage.size()) {
+                linkQueue.fragmentOffset = 0;
+                completedMessages = 1;
+            }
+        } else {
+            // Pack as many whole small messages as fit. RTCM messages carry their own framing, so the receiver's
+            // GPS splits them apart again.
+            int length = 0;
+            while (completedMessages < linkQueue.queue.count()) {
+                const QByteArray& message = linkQueue.queue[completedMessages].data;
+                if (message.size() >= maxMessageLength || length + message.size() > maxMessageLength) {
+                    break;
+                }
+                memcpy(&mavlinkRtcmData.data[length], message.constData(), static_cast<size_t>(message.size()));
+                length += message.size();
+                completedMessages++;
+            }
+            mavlinkRtcmData.flags = (linkQueue.sequenceId & 0x1F) << 3;
+            mavlinkRtcmData.len = static_cast<uint8_t>(length);
+            if (!_sendPacket(linkQueue, sharedLink, mavlinkRtcmData)) {
+                break;
+            }
         }
+
+        if (completedMessages) {
+            for (int i=0; i<completedMessages; i++) {
+                _latencyMsecsTotal += nowMsecs - linkQueue.queue.first().receivedMsecs;
+                _latencyCount++;
+                linkQueue.queue.removeFirst();
+            }
+            ++linkQueue.sequenceId;
+        }
+    }
+}
+
+/// Once a newer message is waiting, messages past the age limit are of no use to the vehicle anymore. A message
+/// which is partially sent is always finished, the fragments already sent are useless without it.
+void RTCMMavlink::_dropStaleMessages(LinkQueue_t& linkQueue, qint64 nowMsecs)
+{
+    int firstDroppable = linkQueue.fragmentOffset > 0 ? 1 : 0;
+
+    while (linkQueue.queue.count() > firstDroppable + 1 && nowMsecs - linkQueue.queue[firstDroppable].receivedMsecs > _maxMessageAgeMsecs) {
+        QSharedPointer<bool> dropped = linkQueue.queue.takeAt(firstDroppable).dropped;
+        if (!*dropped) {
+            // The same message may be dropped from several link queues, it is only counted the first time
+            *dropped = true;
+            _droppedCount++;
+        }
+    }
+}
+
+/// @return false: Not enough tokens available to send the packet
+bool RTCMMavlink::_sendPacket(LinkQueue_t& linkQueue, SharedLinkInterfacePtr sharedLink, const mavlink_gps_rtcm_data_t& rtcmData)
+{
+    // Cost is checked before encoding since encoding uses up a sequence number on the channel
+    int packetBytes = MAVLINK_NUM_NON_PAYLOAD_BYTES + static_cast<int>(sizeof(rtcmData.flags) + sizeof(rtcmData.len)) + rtcmData.len;
+    if (linkQueue.tokens < packetBytes) {
+        return false;
+    }
+
+    MAVLinkProtocol*    mavlinkProtocol = _toolbox.mavlinkProtocol();
+    mavlink_message_t   message;
+
+    mavlink_msg_gps_rtcm_data_encode_chan(mavlinkProtocol->getSystemId(),
+                                          mavlinkProtocol->getComponentId(),
+                                          sharedLink->mavlinkChannel(),
+                                          &message,
+                                          &rtcmData);
+    linkQueue.vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+
+    linkQueue.tokens -= packetBytes;
+    _outputByteCounter += packetBytes;
+    _packetCount++;
+
+    return true;
+}
+
+double RTCMMavlink::_linkRate(LinkInterface* link) const
+{
+#ifndef NO_SERIAL_LINK
+    SerialConfiguration* serialConfig = qobject_cast<SerialConfiguration*>(link->linkConfiguration().get());
+    if (serialConfig) {
+        // 10 bits on the wire for each byte
+        return serialConfig->baud() / 10.0 * _serialLinkShare;
+    }
+#else
+    Q_UNUSED(link);
+#endif
+    return _defaultLinkRate;
+}
+
+void RTCMMavlink::_updateStatistics(void)
+{
+    qint64 nowMsecs         = _clock.elapsed();
+    double elapsedSecs      = (nowMsecs - _lastStatisticsMsecs) / 1000.0;
+    _lastStatisticsMsecs    = nowMsecs;
+    if (elapsedSecs <= 0) {
+        return;
+    }
+
+    double inputRate    = _inputByteCounter / elapsedSecs / 1024.0;
+    double outputRate   = _outputByteCounter / elapsedSecs / 1024.0;
+    double latency      = _latencyCount ? static_cast<double>(_latencyMsecsTotal) / _latencyCount : 0;
+
+    if (_inputByteCounter) {
+        qCDebug(RTKGPSLog) << QStringLiteral("RTCM bandwidth in:out %1:%2 kB/s latency %3 ms dropped %4").arg(inputRate, 0, 'f', 2).arg(outputRate, 0, 'f', 2).arg(latency, 0, 'f', 0).arg(_droppedCount);
+    }
+
+    _inputByteCounter   = 0;
+    _outputByteCounter  = 0;
+    _latencyMsecsTotal  = 0;
+    _latencyCount       = 0;
+
+    if (_factGroup) {
+        _factGroup->inputRate()->setRawValue(inputRate);
+        _factGroup->outputRate()->setRawValue(outputRate);
+        _factGroup->messageCount()->setRawValue(_messageCount);
+        _factGroup->packetCount()->setRawValue(_packetCount);
+        _factGroup->droppedCount()->setRawValue(_droppedCount);
+        _factGroup->latency()->setRawValue(latency);
     }
 }
@@ -12,29 +12,90 @@
 
 #include <QObject>
 #include <QElapsedTimer>
+#include <QMap>
+#include <QList>
+#include <QSharedPointer>
+#include <QTimer>
 
 #include "QGCToolbox.h"
 #include "MAVLinkProtocol.h"
+#include "LinkInterface.h"
+
+class RTCMFactGroup;
+class Vehicle;
 
 /**
  ** class RTCMMavlink
  * Receives RTCM updates and sends them via MAVLINK to the device
+ *
+ * Messages are queued per link and sent by a scheduler which limits each link to its own token bucket, so corrections
+ * can't starve heartbeats and commands on slow radios. Small messages are packed together into a single GPS_RTCM_DATA
+ * packet. When a link can't keep up, messages which have been superseded by newer ones are dropped.
  */
 class RTCMMavlink : public QObject
 {
     Q_OBJECT
+
+    friend class RTCMMavlinkTest; // Unit test
+
 public:
-    RTCMMavlink(QGCToolbox& toolbox);
-    //TODO: API to select device(s)?
+    RTCMMavlink(QGCToolbox& toolbox, RTCMFactGroup* factGroup = nullptr);
+    ~RTCMMavlink();
 
 public slots:
     void RTCMDataUpdate(QByteArray message);
 
+private slots:
+    void _sendQueuedMessages    (void);
+    void _updateStatistics      (void);
+
 private:
-    void sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg);
+    typedef struct {
+        QByteArray              data;
+        qint64                  receivedMsecs;
+        QSharedPointer<bool>    dropped;        ///< Shared by the copies in each link queue so a drop is counted once
+    } QueuedMessage_t;
+
+    typedef struct {
+        WeakLinkInterfacePtr    weakLink;
+        Vehicle*                vehicle;                ///< Vehicle used to send on the link
+        QList<QueuedMessage_t>  queue;
+        int                     fragmentOffset;         ///< Offset of the next fragment within the first queued message
+        uint8_t                 sequenceId;
+        double                  tokens;                 ///< Bytes which can be sent right now
+        double                  rateBytesPerSecond;
+        qint64                  lastRefillMsecs;
+    } LinkQueue_t;
+
+    void    _updateLinks        (void);
+    void    _sendOnLink         (LinkQueue_t& linkQueue, qint64 nowMsecs);
+    void    _dropStaleMessages  (LinkQueue_t& linkQueue, qint64 nowMsecs);
+    bool    _sendPacket         (LinkQueue_t& linkQueue, SharedLinkInterfacePtr sharedLink, const mavlink_gps_rtcm_data_t& rtcmData);
+    double  _linkRate           (LinkInterface* link) const;
+
+    QGCToolbox&                         _toolbox;
+    RTCMFactGroup*                      _factGroup;
+    QMap<LinkInterface*, LinkQueue_t>   _linkQueues;
+    QElapsedTimer                       _clock;
+    QTimer                              _sendTimer;
+    QTimer                              _statisticsTimer;
+
+    // Statistics since the last update
+    qint64  _inputByteCounter       = 0;
+    qint64  _outputByteCounter      = 0;
+    qint64  _latencyMsecsTotal      = 0;
+    int     _latencyCount           = 0;
+    qint64  _lastStatisticsMsecs    = 0;
+
+    // Running totals
+    quint32 _messageCount           = 0;
+    quint32 _packetCount            = 0;
+    quint32 _droppedCount           = 0;
 
-    QGCToolbox& _toolbox;
-    QElapsedTimer _bandwidthTimer;
-    int _bandwidthByteCounter = 0;
-    uint8_t _sequenceId = 0;
+    static const int        _sendIntervalMsecs          = 20;
+    static const int        _statisticsIntervalMsecs    = 1000;
+    static const int        _maxMessageAgeMsecs         = 1000;         ///< Older messages are dropped when newer ones are waiting
+    static const int        _burstMsecs                 = 250;          ///< Token bucket depth as time at the link rate
+    static const int        _defaultLinkRate            = 64 * 1024;    ///< bytes/sec for links with no known bandwidth
+    static constexpr double _serialLinkShare            = 0.5;          ///< Portion of a serial link's bandwidth RTCM may use
 };
@@ -483,15 +483,84 @@ void Joystick::run()
             _buttonActionArray[buttonIndex]->buttonTime.start();
         }
     }
+    _sentVehicle = nullptr;
+
+    // MANUAL_CONTROL is sent on fixed deadlines from the monotonic axis clock. Input events wake the thread in
+    // between so button actions are handled as soon as they happen and the send latency of an input change can be
+    // measured. Deadlines are advanced by whole periods so sleep overshoot does not accumulate as drift.
+    qint64  nextAxisNsecs       = _axisTime.nsecsElapsed();
+    qint64  inputNsecs          = -1;       // Time of the first input event since the last deadline, -1 for none
+    qint64  statsStartNsecs     = nextAxisNsecs;
+    int     statsSendCount      = 0;
+    int     statsDeadlineCount  = 0;
+    int     statsLatencyCount   = 0;
+    qint64  statsJitterNsecs    = 0;
+    qint64  statsLatencyNsecs   = 0;
+
     while (!_exitThread) {
+        qint64 axisPeriodNsecs  = static_cast<qint64>(1000000000.0f / _axisFrequencyHz);
+        int    buttonPeriodMsecs = qMax(1, static_cast<int>(1000.0f / _buttonFrequencyHz));
+
+        qint64 nowNsecs = _axisTime.nsecsElapsed();
+        if (nowNsecs < nextAxisNsecs) {
+            int remainingMsecs = static_cast<int>((nextAxisNsecs - nowNsecs) / 1000000);
+            if (remainingMsecs > 0) {
+                // Wake on input, but no later than needed for button repeats and the next deadline
+                if (_waitForInput(qMin(remainingMsecs, buttonPeriodMsecs)) && inputNsecs < 0) {
+                    inputNsecs = _axisTime.nsecsElapsed();
+                }
+                _update();
+                _handleButtons();
+            } else {
+                QGC::SLEEP::usleep(static_cast<unsigned long>((nextAxisNsecs - nowNsecs) / 1000));
+            }
+            continue;
+        }
+
+        statsJitterNsecs += nowNsecs - nextAxisNsecs;
+        statsDeadlineCount++;
+
         _update();
         _handleButtons();
-        _handleAxis();
-        QGC::SLEEP::msleep(qMin(static_cast<int>(1000.0f / _maxAxisFrequencyHz), static_cast<int>(1000.0f / _maxButtonFrequencyHz)) / 2);
+        if (_handleAxis()) {
+            statsSendCount++;
+            if (inputNsecs >= 0) {
+                statsLatencyNsecs += _axisTime.nsecsElapsed() - inputNsecs;
+                statsLatencyCount++;
+            }
+        }
+        inputNsecs = -1;
+
+        nextAxisNsecs += axisPeriodNsecs;
+        if (nextAxisNsecs <= nowNsecs) {
+            // Fell more than a period behind (thread starved or frequency changed), resync rather than bursting
+            nextAxisNsecs = nowNsecs + axisPeriodNsecs;
+        }
+
+        if (nowNsecs - statsStartNsecs >= 1000000000) {
+            float elapsedSecs = (nowNsecs - statsStartNsecs) / 1000000000.0f;
+            _sendRateHz         = statsSendCount / elapsedSecs;
+            _sendJitterMsecs    = statsDeadlineCount ? (statsJitterNsecs / statsDeadlineCount) / 1000000.0f : 0.0f;
+            _sendLatencyMsecs   = statsLatencyCount ? (statsLatencyNsecs / statsLatencyCount) / 1000000.0f : 0.0f;
+            qCDebug(JoystickLog) << "MANUAL_CONTROL rate:jitter:latency" << _sendRateHz << _sendJitterMsecs << _sendLatencyMsecs;
+            emit sendStatisticsChanged();
+            statsStartNsecs     = nowNsecs;
+            statsSendCount      = 0;
+            statsDeadlineCount  = 0;
+            statsLatencyCount   = 0;
+            statsJitterNsecs    = 0;
+            statsLatencyNsecs   = 0;
+        }
     }
     _close();
 }
 
+bool Joystick::_waitForInput(int timeoutMsecs)
+{
+    QGC::SLEEP::msleep(static_cast<unsigned long>(timeoutMsecs));
+    return false;
+}
+
 void Joystick::_handleButtons()
 {
     int lastBbuttonValues[256];
@@ -588,100 +657,112 @@ void Joystick::_handleButtons()
     }
 }
 
-void Joystick::_handleAxis()
+/// Called from run() on each axis deadline
+/// @return true: MANUAL_CONTROL was sent
+bool Joystick::_handleAxis()
 {
-    //-- Get frequency
-    int axisDelay = static_cast<int>(1000.0f / _axisFrequencyHz);
-    //-- Check elapsed time since last run
-    if(_axisTime.elapsed() > axisDelay) {
-        _axisTime.start();
-        //-- Update axis
-        for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
-            int newAxisValue = _getAxis(axisIndex);
-            // Calibration code requires signal to be emitted even if value hasn't changed
-            _rgAxisValues[axisIndex] = newAxisValue;
-            emit rawAxisValueChanged(axisIndex, newAxisValue);
-        }
-        if (_activeVehicle->joystickEnabled() && !_calibrationMode && _calibrated) {
-            int     axis = _rgFunctionAxis[rollFunction];
-            float   roll = _adjustRange(_rgAxisValues[axis],    _rgCalibration[axis], _deadband);
+    //-- Update axis
+    for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
+        int newAxisValue = _getAxis(axisIndex);
+        // Calibration code requires signal to be emitted even if value hasn't changed
+        _rgAxisValues[axisIndex] = newAxisValue;
+        emit rawAxisValueChanged(axisIndex, newAxisValue);
+    }
+    if (_activeVehicle->joystickEnabled() && !_calibrationMode && _calibrated) {
+        int     axis = _rgFunctionAxis[rollFunction];
+        float   roll = _adjustRange(_rgAxisValues[axis],    _rgCalibration[axis], _deadband);
 
-                    axis = _rgFunctionAxis[pitchFunction];
-            float   pitch = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis], _deadband);
+                axis = _rgFunctionAxis[pitchFunction];
+        float   pitch = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis], _deadband);
 
-                    axis = _rgFunctionAxis[yawFunction];
-            float   yaw = _adjustRange(_rgAxisValues[axis],     _rgCalibration[axis],_deadband);
+                axis = _rgFunctionAxis[yawFunction];
+        float   yaw = _adjustRange(_rgAxisValues[axis],     _rgCalibration[axis],_deadband);
 
-                    axis = _rgFunctionAxis[throttleFunction];
-            float   throttle = _adjustRange(_rgAxisValues[axis],_rgCalibration[axis], _throttleMode==ThrottleModeDownZero?false:_deadband);
+                axis = _rgFunctionAxis[throttleFunction];
+        float   throttle = _adjustRange(_rgAxisValues[axis],_rgCalibration[axis], _throttleMode==ThrottleModeDownZero?false:_deadband);
 
-            float   gimbalPitch = 0.0f;
-            float   gimbalYaw   = 0.0f;
+        float   gimbalPitch = 0.0f;
+        float   gimbalYaw   = 0.0f;
 
-            if(_axisCount > 4) {
-                axis = _rgFunctionAxis[gimbalPitchFunction];
-                gimbalPitch = _adjustRange(_rgAxisValues[axis], _rgCalibration[axis],_deadband);
-            }
+        if(_axisCount > 4) {
+            axis = _rgFunctionAxis[gimbalPitchFunction];
+            gimbalPitch = _adjustRange(_rgAxisValues[axis], _rgCalibration[axis],_deadband);
+        }
 
-            if(_axisCount > 5) {
-                axis = _rgFunctionAxis[gimbalYawFunction];
-                gimbalYaw = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis],_deadband);
-            }
+        if(_axisCount > 5) {
+            axis = _rgFunctionAxis[gimbalYawFunction];
+            gimbalYaw = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis],_deadband);
+        }
 
-            if (_accumulator) {
-                static float throttle_accu = 0.f;
-                throttle_accu += throttle * (40 / 1000.f); //for throttle to change from min to max it will take 1000ms (40ms is a loop time)
-                throttle_accu = std::max(static_cast<float>(-1.f), std::min(throttle_accu, static_cast<float>(1.f)));
-                throttle = throttle_accu;
-            }
+        if (_accumulator) {
+            static float throttle_accu = 0.f;
+            throttle_accu += throttle / _axisFrequencyHz; //for throttle to change from min to max it will take 1000ms
+            throttle_accu = std::max(static_cast<float>(-1.f), std::min(throttle_accu, static_cast<float>(1.f)));
+            throttle = throttle_accu;
+        }
 
-            if (_circleCorrection) {
-                float roll_limited      = std::max(static_cast<float>(-M_PI_4), std::min(roll,      static_cast<float>(M_PI_4)));
-                float pitch_limited     = std::max(static_cast<float>(-M_PI_4), std::min(pitch,     static_cast<float>(M_PI_4)));
-                float yaw_limited       = std::max(static_cast<float>(-M_PI_4), std::min(yaw,       static_cast<float>(M_PI_4)));
-                float throttle_limited  = std::max(static_cast<float>(-M_PI_4), std::min(throttle,  static_cast<float>(M_PI_4)));
-
-                // Map from unit circle to linear range and limit
-                roll =      std::max(-1.0f, std::min(tanf(asinf(roll_limited)),     1.0f));
-                pitch =     std::max(-1.0f, std::min(tanf(asinf(pitch_limited)),    1.0f));
-                yaw =       std::max(-1.0f, std::min(tanf(asinf(yaw_limited)),      1.0f));
-                throttle =  std::max(-1.0f, std::min(tanf(asinf(throttle_limited)), 1.0f));
-            }
+        if (_circleCorrection) {
+            float roll_limited      = std::max(static_cast<float>(-M_PI_4), std::min(roll,      static_cast<float>(M_PI_4)));
+            float pitch_limited     = std::max(static_cast<float>(-M_PI_4), std::min(pitch,     static_cast<float>(M_PI_4)));
+            float yaw_limited       = std::max(static_cast<float>(-M_PI_4), std::min(yaw,       static_cast<float>(M_PI_4)));
+            float throttle_limited  = std::max(static_cast<float>(-M_PI_4), std::min(throttle,  static_cast<float>(M_PI_4)));
+
+            // Map from unit circle to linear range and limit
+            roll =      std::max(-1.0f, std::min(tanf(asinf(roll_limited)),     1.0f));
+            pitch =     std::max(-1.0f, std::min(tanf(asinf(pitch_limited)),    1.0f));
+            yaw =       std::max(-1.0f, std::min(tanf(asinf(yaw_limited)),      1.0f));
+            throttle =  std::max(-1.0f, std::min(tanf(asinf(throttle_limited)), 1.0f));
+        }
 
-            if ( _exponential < -0.01f) {
-                // Exponential (0% to -50% range like most RC radios)
-                // _exponential is set by a slider in joystickConfigAdvanced.qml
-                // Calculate new RPY with exponential applied
-                roll =  -_exponential*powf(roll, 3) + (1+_exponential)*roll;
-                pitch = -_exponential*powf(pitch,3) + (1+_exponential)*pitch;
-                yaw =   -_exponential*powf(yaw,  3) + (1+_exponential)*yaw;
-            }
+        if ( _exponential < -0.01f) {
+            // Exponential (0% to -50% range like most RC radios)
+            // _exponential is set by a slider in joystickConfigAdvanced.qml
+            // Calculate new RPY with exponential applied
+            roll =  -_exponential*powf(roll, 3) + (1+_exponential)*roll;
+            pitch = -_exponential*powf(pitch,3) + (1+_exponential)*pitch;
+            yaw =   -_exponential*powf(yaw,  3) + (1+_exponential)*yaw;
+        }
 
-            // Adjust throttle to 0:1 range
-            if (_throttleMode == ThrottleModeCenterZero && _activeVehicle->supportsThrottleModeCenterZero()) {
-                if (!_activeVehicle->supportsNegativeThrust() || !_negativeThrust) {
-                    throttle = std::max(0.0f, throttle);
-                }
-            } else {
-                throttle = (throttle + 1.0f) / 2.0f;
+        // Adjust throttle to 0:1 range
+        if (_throttleMode == ThrottleModeCenterZero && _activeVehicle->supportsThrottleModeCenterZero()) {
+            if (!_activeVehicle->supportsNegativeThrust() || !_negativeThrust) {
+                throttle = std::max(0.0f, throttle);
             }
-            qCDebug(JoystickValuesLog) << "name:roll:pitch:yaw:throttle:gimbalPitch:gimbalYaw" << name() << roll << -pitch << yaw << throttle << gimbalPitch << gimbalYaw;
-            // NOTE: The buttonPressedBits going to MANUAL_CONTROL are currently used by ArduSub (and it only handles 16 bits)
-            // Set up button bitmap
-            quint64 buttonPressedBits = 0;  // Buttons pressed for manualControl signal
-            for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
-                quint64 buttonBit = static_cast<quint64>(1LL << buttonIndex);
-                if (_rgButtonValues[buttonIndex] != BUTTON_UP) {
-                    // Mark the button as pressed as long as its pressed
-                    buttonPressedBits |= buttonBit;
-                }
+        } else {
+            throttle = (throttle + 1.0f) / 2.0f;
+        }
+        qCDebug(JoystickValuesLog) << "name:roll:pitch:yaw:throttle:gimbalPitch:gimbalYaw" << name() << roll << -pitch << yaw << throttle << gimbalPitch << gimbalYaw;
+        // NOTE: The buttonPressedBits going to MANUAL_CONTROL are currently used by ArduSub (and it only handles 16 bits)
+        // Set up button bitmap
+        quint64 buttonPressedBits = 0;  // Buttons pressed for manualControl signal
+        for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
+            quint64 buttonBit = static_cast<quint64>(1LL << buttonIndex);
+            if (_rgButtonValues[buttonIndex] != BUTTON_UP) {
+                // Mark the button as pressed as long as its pressed
+                buttonPressedBits |= buttonBit;
             }
-            emit axisValues(roll, pitch, yaw, throttle);
+        }
+        emit axisValues(roll, pitch, yaw, throttle);
+
+        uint16_t shortButtons = static_cast<uint16_t>(buttonPressedBits & 0xFFFF);
 
-            uint16_t shortButtons = static_cast<uint16_t>(buttonPressedBits & 0xFFFF);
-            _activeVehicle->sendJoystickDataThreadSafe(roll, pitch, yaw, throttle, shortButtons);
+        // Unchanged values are only repeated often enough to keep the vehicle from timing out manual control
+        if (_sentVehicle == _activeVehicle && roll == _sentRoll && pitch == _sentPitch && yaw == _sentYaw &&
+                throttle == _sentThrottle && shortButtons == _sentButtons && _keepaliveTime.elapsed() < _keepaliveMsecs) {
+            return false;
         }
+        _activeVehicle->sendJoystickDataThreadSafe(roll, pitch, yaw, throttle, shortButtons);
+        _sentVehicle    = _activeVehicle;
+        _sentRoll       = roll;
+        _sentPitch      = pitch;
+        _sentYaw        = yaw;
+        _sentThrottle   = throttle;
+        _sentButtons    = shortButtons;
+        _keepaliveTime.start();
+        return true;
     }
+    _sentVehicle = nullptr;
+    return false;
 }
 
 void Joystick::startPolling(Vehicle* vehicle)
@@ -944,8 +1025,7 @@ void Joystick::setCircleCorrection(bool circleCorrection)
 void Joystick::setAxisFrequency(float val)
 {
     //-- Arbitrary limits
-    val = qMin(_minAxisFrequencyHz, val);
-    val = qMax(_maxAxisFrequencyHz, val);
+    val = qBound(_minAxisFrequencyHz, val, _maxAxisFrequencyHz);
     _axisFrequencyHz = val;
     _saveSettings();
     emit axisFrequencyHzChanged();
@@ -954,8 +1034,7 @@ void Joystick::setAxisFrequency(float val)
 void Joystick::setButtonFrequency(float val)
 {
     //-- Arbitrary limits
-    val = qMin(_minButtonFrequencyHz, val);
-    val = qMax(_maxButtonFrequencyHz, val);
+    val = qBound(_minButtonFrequencyHz, val, _maxButtonFrequencyHz);
     _buttonFrequencyHz = val;
     _saveSettings();
     emit buttonFrequencyHzChanged();
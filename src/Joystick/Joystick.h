@@ -104,7 +104,7 @@ public:
     Q_PROPERTY(int      throttleMode            READ throttleMode           WRITE setThrottleMode       NOTIFY throttleModeChanged)
     Q_PROPERTY(float    axisFrequencyHz         READ axisFrequencyHz        WRITE setAxisFrequency      NOTIFY axisFrequencyHzChanged)
     Q_PROPERTY(float    minAxisFrequencyHz      MEMBER _minAxisFrequencyHz                              CONSTANT)
-    Q_PROPERTY(float    maxAxisFrequencyHz      MEMBER _minAxisFrequencyHz                              CONSTANT)
+    Q_PROPERTY(float    maxAxisFrequencyHz      MEMBER _maxAxisFrequencyHz                              CONSTANT)
     Q_PROPERTY(float    buttonFrequencyHz       READ buttonFrequencyHz      WRITE setButtonFrequency    NOTIFY buttonFrequencyHzChanged)
     Q_PROPERTY(float    minButtonFrequencyHz    MEMBER _minButtonFrequencyHz                            CONSTANT)
     Q_PROPERTY(float    maxButtonFrequencyHz    MEMBER _maxButtonFrequencyHz                            CONSTANT)
@@ -113,6 +113,11 @@ public:
     Q_PROPERTY(bool     accumulator             READ accumulator            WRITE setAccumulator        NOTIFY accumulatorChanged)
     Q_PROPERTY(bool     circleCorrection        READ circleCorrection       WRITE setCircleCorrection   NOTIFY circleCorrectionChanged)
 
+    //-- MANUAL_CONTROL send statistics over the last second
+    Q_PROPERTY(float    sendRateHz              READ sendRateHz             NOTIFY sendStatisticsChanged)
+    Q_PROPERTY(float    sendJitterMsecs         READ sendJitterMsecs        NOTIFY sendStatisticsChanged)   ///< Average lateness of the send deadlines
+    Q_PROPERTY(float    sendLatencyMsecs        READ sendLatencyMsecs       NOTIFY sendStatisticsChanged)   ///< Average time from input change to send
+
     Q_INVOKABLE void    setButtonRepeat     (int button, bool repeat);
     Q_INVOKABLE bool    getButtonRepeat     (int button);
     Q_INVOKABLE void    setButtonAction     (int button, const QString& action);
@@ -183,6 +188,10 @@ public:
     /// Set joystick button repeat rate (in Hz)
     void  setButtonFrequency(float val);
 
+    float sendRateHz        () const { return _sendRateHz; }
+    float sendJitterMsecs   () const { return _sendJitterMsecs; }
+    float sendLatencyMsecs  () const { return _sendLatencyMsecs; }
+
 signals:
     // The raw signals are only meant for use by calibration
     void rawAxisValueChanged        (int index, int value);
@@ -200,6 +209,7 @@ signals:
 
     void axisFrequencyHzChanged     ();
     void buttonFrequencyHzChanged   ();
+    void sendStatisticsChanged      ();
     void startContinuousZoom        (int direction);
     void stopContinuousZoom         ();
     void stepZoom                   (int direction);
@@ -228,7 +238,7 @@ protected:
     int     _findAssignableButtonAction(const QString& action);
     bool    _validAxis              (int axis) const;
     bool    _validButton            (int button) const;
-    void    _handleAxis             ();
+    bool    _handleAxis             ();
     void    _handleButtons          ();
     void    _buildActionList        (Vehicle* activeVehicle);
 
@@ -246,6 +256,11 @@ private:
     virtual int  _getAxis   (int i)      = 0;
     virtual bool _getHat    (int hat,int i) = 0;
 
+    /// Blocks until joystick input changes or the timeout expires. The default implementation has no input events
+    /// and simply sleeps.
+    /// @return true: input changed
+    virtual bool _waitForInput(int timeoutMsecs);
+
     void _updateTXModeSettingsKey(Vehicle* activeVehicle);
     int _mapFunctionMode(int mode, int function);
     void _remapAxes(int currentMode, int newMode, int (&newMapping)[maxFunction]);
@@ -292,7 +307,20 @@ protected:
 
     static int          _transmitterMode;
     int                 _rgFunctionAxis[maxFunction] = {};
-    QElapsedTimer       _axisTime;
+    QElapsedTimer       _axisTime;                          ///< Monotonic clock for the MANUAL_CONTROL deadlines
+
+    // Last MANUAL_CONTROL values sent, unchanged values are only repeated as a keepalive
+    Vehicle*            _sentVehicle        = nullptr;  ///< nullptr: nothing sent yet
+    float               _sentRoll           = 0;
+    float               _sentPitch          = 0;
+    float               _sentYaw            = 0;
+    float               _sentThrottle       = 0;
+    uint16_t            _sentButtons        = 0;
+    QElapsedTimer       _keepaliveTime;
+
+    std::atomic<float>  _sendRateHz         {0};
+    std::atomic<float>  _sendJitterMsecs    {0};
+    std::atomic<float>  _sendLatencyMsecs   {0};
 
     QmlObjectListModel              _assignableButtonActions;
     QList<AssignedButtonAction*>    _buttonActionArray;
@@ -305,6 +333,7 @@ protected:
     static const float  _maxAxisFrequencyHz;
     static const float  _minButtonFrequencyHz;
     static const float  _maxButtonFrequencyHz;
+    static const int    _keepaliveMsecs     = 200;  ///< Well within the manual control loss timeouts of the firmwares
 
 private:
     static const char*  _rgFunctionSettingsKey[maxFunction];
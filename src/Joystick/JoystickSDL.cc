@@ -1,6 +1,7 @@
 #include "JoystickSDL.h"
 
 #include "QGCApplication.h"
+#include "QGC.h"
 
 #include <QQmlEngine>
 #include <QTextStream>
@@ -15,10 +16,12 @@ JoystickSDL::JoystickSDL(const QString& name, int axisCount, int buttonCount, in
 
 bool JoystickSDL::init(void) {
     if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER | SDL_INIT_JOYSTICK | SDL_INIT_NOPARACHUTE) < 0) {
-        SDL_JoystickEventState(SDL_ENABLE);
         qWarning() << "Couldn't initialize SimpleDirectMediaLayer:" << SDL_GetError();
         return false;
     }
+    // Input events are the wakeup source for the joystick threads
+    SDL_JoystickEventState(SDL_ENABLE);
+    SDL_GameControllerEventState(SDL_ENABLE);
     _loadGameControllerMappings();
     return true;
 }
@@ -162,6 +165,43 @@ bool JoystickSDL::_update(void)
     return true;
 }
 
+/// Without a video subsystem SDL has no blocking event wait (SDL_WaitEventTimeout polls internally as well), so the
+/// event queue is pumped at a short interval which backs off once the sticks are idle. Only input events are taken
+/// from the queue, device added/removed events are left for JoystickManager.
+bool JoystickSDL::_waitForInput(int timeoutMsecs)
+{
+    QElapsedTimer waitTime;
+    waitTime.start();
+    if (!_idleTime.isValid()) {
+        _idleTime.start();
+    }
+
+    forever {
+        SDL_PumpEvents();
+
+        // State is read through the joystick api, so the input events themselves are just discarded
+        SDL_Event   events[16];
+        bool        input = false;
+        while (SDL_PeepEvents(events, 16, SDL_GETEVENT, SDL_JOYAXISMOTION, SDL_JOYBUTTONUP) > 0) {
+            input = true;
+        }
+        while (SDL_PeepEvents(events, 16, SDL_GETEVENT, SDL_CONTROLLERAXISMOTION, SDL_CONTROLLERBUTTONUP) > 0) {
+            input = true;
+        }
+        if (input) {
+            _idleTime.start();
+            return true;
+        }
+
+        int remainingMsecs = timeoutMsecs - static_cast<int>(waitTime.elapsed());
+        if (remainingMsecs <= 0) {
+            return false;
+        }
+        int pollMsecs = _idleTime.elapsed() > _idleMsecs ? _idlePollMsecs : _activePollMsecs;
+        QGC::SLEEP::msleep(static_cast<unsigned long>(qMin(pollMsecs, remainingMsecs)));
+    }
+}
+
 bool JoystickSDL::_getButton(int i) {
     if (_isGameController) {
         return SDL_GameControllerGetButton(sdlController, SDL_GameControllerButton(i)) == 1;
@@ -39,6 +39,7 @@ private:
     bool _open      () final;
     void _close     () final;
     bool _update    () final;
+    bool _waitForInput(int timeoutMsecs) final;
 
     bool _getButton (int i) final;
     int  _getAxis   (int i) final;
@@ -50,4 +51,10 @@ private:
     bool    _isGameController;
     int     _index;      ///< Index for SDL_JoystickOpen
 
+    QElapsedTimer   _idleTime;                  ///< Time since the last input event
+
+    static const int _activePollMsecs   = 2;    ///< Event poll interval while the sticks are moving
+    static const int _idlePollMsecs     = 10;   ///< Event poll interval once the sticks have been idle for _idleMsecs
+    static const int _idleMsecs         = 1000;
+
 };
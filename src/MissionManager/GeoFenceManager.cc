@@ -39,7 +39,7 @@ void GeoFenceManager::sendToVehicle(const QGeoCoordinate&   breachReturn,
                                     QmlObjectListModel&     polygons,
                                     QmlObjectListModel&     circles)
 {
-    QList<MissionItem*> fenceItems;
+    MissionItemStore fenceItems;
 
     _sendPolygons.clear();
     _sendCircles.clear();
@@ -58,53 +58,46 @@ void GeoFenceManager::sendToVehicle(const QGeoCoordinate&   breachReturn,
         for (int j=0; j<polygon.count(); j++) {
             const QGeoCoordinate& vertex = polygon.path()[j].value<QGeoCoordinate>();
 
-            MissionItem* item = new MissionItem(0,
-                                                polygon.inclusion() ? MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION : MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION,
-                                                MAV_FRAME_GLOBAL,
-                                                polygon.count(),    // vertex count
-                                                0, 0, 0,            // param 2-4 unused
-                                                vertex.latitude(),
-                                                vertex.longitude(),
-                                                0,                  // param 7 unused
-                                                false,              // autocontinue
-                                                false,              // isCurrentItem
-                                                this);              // parent
-            fenceItems.append(item);
+            fenceItems.append(0,
+                              polygon.inclusion() ? MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION : MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION,
+                              MAV_FRAME_GLOBAL,
+                              polygon.count(),    // vertex count
+                              0, 0, 0,            // param 2-4 unused
+                              vertex.latitude(),
+                              vertex.longitude(),
+                              0,                  // param 7 unused
+                              false,              // autocontinue
+                              false);             // isCurrentItem
         }
     }
 
     for (int i=0; i<_sendCircles.count(); i++) {
         QGCFenceCircle& circle = _sendCircles[i];
 
-        MissionItem* item = new MissionItem(0,
-                                            circle.inclusion() ? MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION : MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION,
-                                            MAV_FRAME_GLOBAL,
-                                            circle.radius()->rawValue().toDouble(),
-                                            0, 0, 0,                    // param 2-4 unused
-                                            circle.center().latitude(),
-                                            circle.center().longitude(),
-                                            0,                          // param 7 unused
-                                            false,                      // autocontinue
-                                            false,                      // isCurrentItem
-                                            this);                      // parent
-        fenceItems.append(item);
+        fenceItems.append(0,
+                          circle.inclusion() ? MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION : MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION,
+                          MAV_FRAME_GLOBAL,
+                          circle.radius()->rawValue().toDouble(),
+                          0, 0, 0,                    // param 2-4 unused
+                          circle.center().latitude(),
+                          circle.center().longitude(),
+                          0,                          // param 7 unused
+                          false,                      // autocontinue
+                          false);                     // isCurrentItem
     }
 
     if (_breachReturnPoint.isValid()) {
-        MissionItem* item = new MissionItem(0,
-                                            MAV_CMD_NAV_FENCE_RETURN_POINT,
-                                            MAV_FRAME_GLOBAL_RELATIVE_ALT,
-                                            0, 0, 0, 0,                    // param 1-4 unused
-                                            breachReturn.latitude(),
-                                            breachReturn.longitude(),
-                                            breachReturn.altitude(),
-                                            false,                      // autocontinue
-                                            false,                      // isCurrentItem
-                                            this);                      // parent
-        fenceItems.append(item);
+        fenceItems.append(0,
+                          MAV_CMD_NAV_FENCE_RETURN_POINT,
+                          MAV_FRAME_GLOBAL_RELATIVE_ALT,
+                          0, 0, 0, 0,                 // param 1-4 unused
+                          breachReturn.latitude(),
+                          breachReturn.longitude(),
+                          breachReturn.altitude(),
+                          false,                      // autocontinue
+                          false);                     // isCurrentItem
     }
 
-    // Plan manager takes control of MissionItems, so no need to delete
     writeMissionItems(fenceItems);
 }
 
@@ -144,28 +137,28 @@ void GeoFenceManager::_planManagerLoadComplete(bool removeAllRequested)
     MAV_CMD expectedCommand = (MAV_CMD)0;
     int expectedVertexCount = 0;
     QGCFencePolygon nextPolygon(true /* inclusion */);
-    const QList<MissionItem*>& fenceItems = missionItems();
+    const MissionItemStore& fenceItems = missionItems();
 
     for (int i=0; i<fenceItems.count(); i++) {
-        MissionItem* item = fenceItems[i];
+        const MissionItemStore::Item_t& item = fenceItems[i];
 
-        MAV_CMD command = item->command();
+        MAV_CMD command = fenceItems.command(i);
 
         if (command == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION || command == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION) {
             if (nextPolygon.count() == 0) {
                 // Starting a new polygon
-                expectedVertexCount = item->param1();
+                expectedVertexCount = item.param1;
                 expectedCommand = command;
-            } else if (expectedVertexCount != item->param1()){
+            } else if (expectedVertexCount != item.param1){
                 // In the middle of a polygon, but count suddenly changed
-                emit error(BadPolygonItemFormat, tr("GeoFence load: Vertex count change mid-polygon - actual:expected").arg(item->param1()).arg(expectedVertexCount));
+                emit error(BadPolygonItemFormat, tr("GeoFence load: Vertex count change mid-polygon - actual:expected").arg(item.param1).arg(expectedVertexCount));
                 break;
             } if (expectedCommand != command) {
                 // Command changed before last polygon was completely loaded
                 emit error(BadPolygonItemFormat, tr("GeoFence load: Polygon type changed before last load complete - actual:expected").arg(command).arg(expectedCommand));
                 break;
             }
-            nextPolygon.appendVertex(QGeoCoordinate(item->param5(), item->param6()));
+            nextPolygon.appendVertex(QGeoCoordinate(item.param5, item.param6));
             if (nextPolygon.count() == expectedVertexCount) {
                 // Polygon is complete
                 nextPolygon.setInclusion(command == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION);
@@ -178,12 +171,12 @@ void GeoFenceManager::_planManagerLoadComplete(bool removeAllRequested)
                 emit error(IncompletePolygonLoad, tr("GeoFence load: Incomplete polygon loaded"));
                 break;
             }
-            QGCFenceCircle circle(QGeoCoordinate(item->param5(), item->param6()), item->param1(), command == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION /* inclusion */);
+            QGCFenceCircle circle(QGeoCoordinate(item.param5, item.param6), item.param1, command == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION /* inclusion */);
             _circles.append(circle);
         } else if (command == MAV_CMD_NAV_FENCE_RETURN_POINT) {
-            _breachReturnPoint = QGeoCoordinate(item->param5(), item->param6(), item->param7());
+            _breachReturnPoint = QGeoCoordinate(item.param5, item.param6, item.param7);
         } else {
-            emit error(UnsupportedCommand, tr("GeoFence load: Unsupported command %1").arg(item->command()));
+            emit error(UnsupportedCommand, tr("GeoFence load: Unsupported command %1").arg(item.command));
             break;
         }
     }
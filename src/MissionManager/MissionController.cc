@@ -70,6 +70,10 @@ MissionController::MissionController(PlanMasterController* masterController, QOb
     connect(&_updateTimer,                                  &QTimer::timeout,                           this, &MissionController::_updateTimeout);
     connect(_planViewSettings->takeoffItemNotRequired(),    &Fact::rawValueChanged,                     this, &MissionController::_takeoffItemNotRequiredChanged);
     connect(this,                                           &MissionController::missionDistanceChanged, this, &MissionController::recalcTerrainProfile);
+    connect(_planViewSettings->showGimbalOnlyWhenSet(),     &Fact::rawValueChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(_appSettings->offlineEditingAscentSpeed(),      &Fact::rawValueChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(_appSettings->offlineEditingDescentSpeed(),     &Fact::rawValueChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(_appSettings->batteryPercentRemainingAnnounce(), &Fact::rawValueChanged,                    this, &MissionController::_itemFlightStatusChanged);
 
     // The follow is used to compress multiple recalc calls in a row to into a single call.
     connect(this, &MissionController::_recalcMissionFlightStatusSignal, this, &MissionController::_recalcMissionFlightStatus,   Qt::QueuedConnection);
@@ -170,7 +174,7 @@ void MissionController::_newMissionItemsAvailableFromVehicle(bool removeAllReque
         _updateContainsItems(); // This will clear containsItems which will be set again below. This will re-pop Start Mission confirmation.
 
         QmlObjectListModel* newControllerMissionItems = new QmlObjectListModel(this);
-        const QList<MissionItem*>& newMissionItems = _missionManager->missionItems();
+        const MissionItemStore& newMissionItems = _missionManager->missionItems();
         qCDebug(MissionControllerLog) << "loading from vehicle: count"<< newMissionItems.count();
 
         _missionItemCount = newMissionItems.count();
@@ -181,22 +185,24 @@ void MissionController::_newMissionItemsAvailableFromVehicle(bool removeAllReque
         int i=0;
         if (_controllerVehicle->firmwarePlugin()->sendHomePositionToVehicle() && newMissionItems.count() != 0) {
             // First item is fake home position
-            MissionItem* fakeHomeItem = newMissionItems[0];
-            if (fakeHomeItem->coordinate().latitude() != 0 || fakeHomeItem->coordinate().longitude() != 0) {
-                settingsItem->setInitialHomePosition(fakeHomeItem->coordinate());
+            QGeoCoordinate fakeHomeCoordinate = newMissionItems.coordinate(0);
+            if (fakeHomeCoordinate.latitude() != 0 || fakeHomeCoordinate.longitude() != 0) {
+                settingsItem->setInitialHomePosition(fakeHomeCoordinate);
             }
             i = 1;
         }
 
+        // Visual items are created straight from the stored items. Their editing facts and sections are only built once
+        // the item is selected or edited.
         for (; i < newMissionItems.count(); i++) {
-            const MissionItem* missionItem = newMissionItems[i];
-            SimpleMissionItem* simpleItem = new SimpleMissionItem(_masterController, _flyView, *missionItem);
-            if (TakeoffMissionItem::isTakeoffCommand(static_cast<MAV_CMD>(simpleItem->command()))) {
+            SimpleMissionItem* simpleItem;
+            if (TakeoffMissionItem::isTakeoffCommand(newMissionItems.command(i))) {
                 // This needs to be a TakeoffMissionItem
-                _takeoffMissionItem = new TakeoffMissionItem(*missionItem, _masterController, _flyView, settingsItem, false /* forLoad */);
+                _takeoffMissionItem = new TakeoffMissionItem(newMissionItems, i, _masterController, _flyView, settingsItem, false /* forLoad */);
                 _takeoffMissionItem->setWizardMode(false);
-                simpleItem->deleteLater();
                 simpleItem = _takeoffMissionItem;
+            } else {
+                simpleItem = new SimpleMissionItem(_masterController, _flyView, newMissionItems, i);
             }
             newControllerMissionItems->append(simpleItem);
         }
@@ -290,12 +296,12 @@ void MissionController::addMissionToKML(KMLPlanDomDocument& planKML)
 void MissionController::sendItemsToVehicle(Vehicle* vehicle, QmlObjectListModel* visualMissionItems)
 {
     if (vehicle) {
+        QObject*            deleteParent = new QObject();
         QList<MissionItem*> rgMissionItems;
 
-        _convertToMissionItems(visualMissionItems, rgMissionItems, vehicle);
-
-        // PlanManager takes control of MissionItems so no need to delete
+        _convertToMissionItems(visualMissionItems, rgMissionItems, deleteParent);
         vehicle->missionManager()->writeMissionItems(rgMissionItems);
+        delete deleteParent;
     }
 }
 
@@ -1193,18 +1199,28 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_itemFlightStatusChanged);
+
+    // Altitude changes on either end only affect flight status from the item which owns the altitude onwards
+    VisualMissionItem* firstItem    = pair.first;
+    VisualMissionItem* secondItem   = pair.second;
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       [this, firstItem]() {
+        _invalidateFlightStatus(_visualItems->indexOf(firstItem));
+        emit _recalcMissionFlightStatusSignal();
+    });
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       [this, secondItem]() {
+        _invalidateFlightStatus(_visualItems->indexOf(secondItem));
+        emit _recalcMissionFlightStatusSignal();
+    });
 
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
     return segment;
 }
 
-FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame)
+FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame, QObjectList& segments)
 {
     FlightPathSegment* segment = nullptr;
 
@@ -1216,7 +1232,7 @@ FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHas
         _flightPathSegmentHashTable[pair] = segment;
     }
 
-    _simpleFlightPathSegments.append(segment);
+    segments.append(segment);
 
     return segment;
 }
@@ -1254,6 +1270,42 @@ void MissionController::_recalcROISpecialVisuals(void)
     }
 }
 
+/// Updates the model to match newList. Rows which are the same at the start and end of both lists are left alone,
+/// only the changed range in between is removed/inserted.
+void MissionController::_updateObjectListModel(QmlObjectListModel& model, const QObjectList& newList)
+{
+    const QObjectList&  oldList =   *model.objectList();
+    int                 oldCount =  oldList.count();
+    int                 newCount =  newList.count();
+
+    int prefixCount = 0;
+    while (prefixCount < oldCount && prefixCount < newCount && oldList[prefixCount] == newList[prefixCount]) {
+        prefixCount++;
+    }
+    int suffixCount = 0;
+    while (suffixCount < oldCount - prefixCount && suffixCount < newCount - prefixCount && oldList[oldCount - suffixCount - 1] == newList[newCount - suffixCount - 1]) {
+        suffixCount++;
+    }
+
+    if (prefixCount == 0 && suffixCount == 0) {
+        // Nothing in common, a reset is cheaper than removing rows one by one
+        model.beginReset();
+        model.clear();
+        if (!newList.isEmpty()) {
+            model.append(newList);
+        }
+        model.endReset();
+        return;
+    }
+
+    for (int i=oldCount - suffixCount - 1; i>=prefixCount; i--) {
+        model.removeAt(i);
+    }
+    if (newCount - suffixCount > prefixCount) {
+        model.insert(prefixCount, newList.mid(prefixCount, newCount - suffixCount - prefixCount));
+    }
+}
+
 void MissionController::_recalcFlightPathSegments(void)
 {
     VisualItemPair      lastSegmentVisualItemPair;
@@ -1270,7 +1322,10 @@ void MissionController::_recalcFlightPathSegments(void)
 
     qCDebug(MissionControllerLog) << "_recalcFlightPathSegments homePositionValid" << homePositionValid;
 
-    FlightPathSegmentHashTable oldSegmentTable = _flightPathSegmentHashTable;
+    FlightPathSegmentHashTable  oldSegmentTable =               _flightPathSegmentHashTable;
+    QObjectList                 newFlightPathSegments;
+    QObjectList                 newDirectionArrows;
+    bool                        prevMissionContainsVTOLTakeoff = _missionContainsVTOLTakeoff;
 
     _missionContainsVTOLTakeoff = false;
     _flightPathSegmentHashTable.clear();
@@ -1280,12 +1335,9 @@ void MissionController::_recalcFlightPathSegments(void)
     // This is due to the initial implementation being buggy and incomplete with respect to correctly generating the line set.
     // So for now we leave the code for displaying them in, but none are ever added until we have time to implement the correct support.
 
-    _simpleFlightPathSegments.beginReset();
-    _directionArrows.beginReset();
+    // The segment and arrow lists are built up separately and then diffed against the current model contents. That way
+    // views only see the rows which actually changed instead of a full model reset on each edit.
     _incompleteComplexItemLines.beginReset();
-
-    _simpleFlightPathSegments.clear();
-    _directionArrows.clear();
     _incompleteComplexItemLines.clearAndDeleteContents();
 
     // Mission Settings item needs to start with no segment
@@ -1375,10 +1427,10 @@ void MissionController::_recalcFlightPathSegments(void)
                     if (!_flyView || addDirectionArrow) {
                         SimpleMissionItem* simpleItem = qobject_cast<SimpleMissionItem*>(lastFlyThroughVI);
                         bool mavlinkTerrainFrame = simpleItem ? simpleItem->missionItem().frame() == MAV_FRAME_GLOBAL_TERRAIN_ALT : false;
-                        FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, mavlinkTerrainFrame);
+                        FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, mavlinkTerrainFrame, newFlightPathSegments);
                         segment->setSpecialVisual(roiActive);
                         if (addDirectionArrow) {
-                            _directionArrows.append(segment);
+                            newDirectionArrows.append(segment);
                         }
                         if (visualItem->isCurrentItem() && _delayedSplitSegmentUpdate) {
                             _splitSegment = segment;
@@ -1405,7 +1457,7 @@ void MissionController::_recalcFlightPathSegments(void)
         if (_flyView) {
             _waypointPath.append(QVariant::fromValue(_settingsItem->coordinate()));
         }
-        FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, false /* mavlinkTerrainFrame */);
+        FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, false /* mavlinkTerrainFrame */, newFlightPathSegments);
         segment->setSpecialVisual(roiActive);
         lastFlyThroughVI->setSimpleFlighPathSegment(segment);
     }
@@ -1436,13 +1488,18 @@ void MissionController::_recalcFlightPathSegments(void)
             _flightPathSegmentHashTable[lastSegmentVisualItemPair] = coordVector;
         }
 
-        _directionArrows.append(coordVector);
+        newDirectionArrows.append(coordVector);
     }
 
-    _simpleFlightPathSegments.endReset();
-    _directionArrows.endReset();
+    _updateObjectListModel(_simpleFlightPathSegments, newFlightPathSegments);
+    _updateObjectListModel(_directionArrows, newDirectionArrows);
     _incompleteComplexItemLines.endReset();
 
+    if (_missionContainsVTOLTakeoff != prevMissionContainsVTOLTakeoff) {
+        // Initial vtol mode of the flight status calculation is based on this
+        _invalidateFlightStatus();
+    }
+
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
@@ -1534,27 +1591,66 @@ void MissionController::_recalcMissionFlightStatus()
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
+    // Items prior to the first dirty item keep their values. We pick up the calculation state which was saved prior to
+    // the first dirty item and only walk the list from there.
+    int startIndex = qMin(_flightStatusDirtyIndex, _visualItems->count());
+    if (_flightStatusPrefix.count() <= startIndex) {
+        startIndex = 0;
+    }
+    _flightStatusPrefix.resize(_visualItems->count() + 1);
+
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus startIndex:count" << startIndex << _visualItems->count();
 
     // If home position is valid we can calculate distances between all waypoints.
     // If home position is not valid we can only calculate distances between waypoints which are
     // both relative altitude.
 
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
-
-    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
-
-    _resetMissionFlightStatus();
-
     bool   linkStartToHome =            false;
     bool   foundRTL =                   false;
     double totalHorizontalDistance =    0;
+    double prevMinAMSLAltitude =        _minAMSLAltitude;
+    double prevMaxAMSLAltitude =        _maxAMSLAltitude;
+
+    if (startIndex == 0) {
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0);
+        lastFlyThroughVI->setAzimuth(0);
+        lastFlyThroughVI->setDistance(0);
+        lastFlyThroughVI->setDistanceFromStart(0);
+
+        _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
+
+        _resetMissionFlightStatus();
+    } else {
+        const FlightStatusPrefix_t& prefix = _flightStatusPrefix[startIndex];
+
+        _missionFlightStatus    = prefix.missionFlightStatus;
+        lastFlyThroughVI        = prefix.lastFlyThroughVI;
+        firstCoordinateItem     = prefix.firstCoordinateItem;
+        linkStartToHome         = prefix.linkStartToHome;
+        foundRTL                = prefix.foundRTL;
+        totalHorizontalDistance = prefix.totalHorizontalDistance;
+        _minAMSLAltitude        = prefix.minAMSLAltitude;
+        _maxAMSLAltitude        = prefix.maxAMSLAltitude;
+    }
+
+    for (int i=startIndex; i<=_visualItems->count(); i++) {
+        FlightStatusPrefix_t& prefix = _flightStatusPrefix[i];
+
+        prefix.missionFlightStatus      = _missionFlightStatus;
+        prefix.lastFlyThroughVI         = lastFlyThroughVI;
+        prefix.firstCoordinateItem      = firstCoordinateItem;
+        prefix.linkStartToHome          = linkStartToHome;
+        prefix.foundRTL                 = foundRTL;
+        prefix.totalHorizontalDistance  = totalHorizontalDistance;
+        prefix.minAMSLAltitude          = _minAMSLAltitude;
+        prefix.maxAMSLAltitude          = _maxAMSLAltitude;
+
+        if (i == _visualItems->count()) {
+            // Final entry is only used to save the state after the last item
+            break;
+        }
 
-    for (int i=0; i<_visualItems->count(); i++) {
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
@@ -1767,9 +1863,12 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
+    _flightStatusDirtyIndex = _visualItems->count();
+
+    // Walk the list again calculating altitude percentages. Items prior to the recalc start only need updating if the range changed.
+    bool altRangeChanged = !qFuzzyCompare(1.0 + prevMinAMSLAltitude, 1.0 + _minAMSLAltitude) || !qFuzzyCompare(1.0 + prevMaxAMSLAltitude, 1.0 + _maxAMSLAltitude);
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=altRangeChanged ? 0 : startIndex; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1908,6 +2007,7 @@ void MissionController::_initAllVisualItems(void)
 
     connect(_settingsItem, &MissionSettingsItem::coordinateChanged,     this, &MissionController::_recalcAll);
     connect(_settingsItem, &MissionSettingsItem::coordinateChanged,     this, &MissionController::plannedHomePositionChanged);
+    connect(_settingsItem, &MissionSettingsItem::coordinateChanged,     this, &MissionController::_itemFlightStatusChanged);
 
     for (int i=0; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
@@ -1919,10 +2019,14 @@ void MissionController::_initAllVisualItems(void)
         }
     }
 
+    // New set of items, nothing from the previous flight status calculation can be re-used
+    _invalidateFlightStatus();
     _recalcAll();
 
     connect(_visualItems, &QmlObjectListModel::dirtyChanged, this, &MissionController::_visualItemsDirtyChanged);
     connect(_visualItems, &QmlObjectListModel::countChanged, this, &MissionController::_updateContainsItems);
+    connect(_visualItems, &QmlObjectListModel::rowsInserted, this, &MissionController::_visualItemsRowsChanged);
+    connect(_visualItems, &QmlObjectListModel::rowsRemoved,  this, &MissionController::_visualItemsRowsChanged);
 
     emit visualItemsChanged();
     emit containsItemsChanged(containsItems());
@@ -1939,6 +2043,7 @@ void MissionController::_deinitAllVisualItems(void)
 {
     disconnect(_settingsItem, &MissionSettingsItem::coordinateChanged, this, &MissionController::_recalcAll);
     disconnect(_settingsItem, &MissionSettingsItem::coordinateChanged, this, &MissionController::plannedHomePositionChanged);
+    disconnect(_settingsItem, &MissionSettingsItem::coordinateChanged, this, &MissionController::_itemFlightStatusChanged);
 
     for (int i=0; i<_visualItems->count(); i++) {
         _deinitVisualItem(qobject_cast<VisualMissionItem*>(_visualItems->get(i)));
@@ -1946,26 +2051,31 @@ void MissionController::_deinitAllVisualItems(void)
 
     disconnect(_visualItems, &QmlObjectListModel::dirtyChanged, this, &MissionController::dirtyChanged);
     disconnect(_visualItems, &QmlObjectListModel::countChanged, this, &MissionController::_updateContainsItems);
+    disconnect(_visualItems, &QmlObjectListModel::rowsInserted, this, &MissionController::_visualItemsRowsChanged);
+    disconnect(_visualItems, &QmlObjectListModel::rowsRemoved,  this, &MissionController::_visualItemsRowsChanged);
 }
 
 void MissionController::_initVisualItem(VisualMissionItem* visualItem)
 {
     setDirty(false);
 
+    connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_itemFlightStatusChanged);
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_itemFlightStatusChanged);
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
+    connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_itemFlightStatusChanged);
 
     if (visualItem->isSimpleItem()) {
         // We need to track commandChanged on simple item since recalc has special handling for takeoff command
         SimpleMissionItem* simpleItem = qobject_cast<SimpleMissionItem*>(visualItem);
         if (simpleItem) {
+            connect(&simpleItem->missionItem()._commandFact, &Fact::valueChanged, this, [this, simpleItem]() { _invalidateFlightStatus(_visualItems->indexOf(simpleItem)); });
             connect(&simpleItem->missionItem()._commandFact, &Fact::valueChanged, this, &MissionController::_itemCommandChanged);
         } else {
             qWarning() << "isSimpleItem == true, yet not SimpleMissionItem";
@@ -1973,10 +2083,11 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_itemFlightStatusChanged);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -1996,6 +2107,27 @@ void MissionController::_itemCommandChanged(void)
     emit _recalcFlightPathSegmentsSignal();
 }
 
+/// Marks flight status as needing recalculation from the specified visual item index onwards.
+///     @param visualItemIndex -1 or 0 for the whole mission
+void MissionController::_invalidateFlightStatus(int visualItemIndex)
+{
+    _flightStatusDirtyIndex = qMin(_flightStatusDirtyIndex, qMax(visualItemIndex, 0));
+}
+
+/// Signalled by visual items whose values affect flight status. Anything which isn't a visual item in the list
+/// (vehicle type, default speeds, ascent/descent speeds, battery settings) invalidates the whole mission.
+void MissionController::_itemFlightStatusChanged(void)
+{
+    VisualMissionItem* visualItem = qobject_cast<VisualMissionItem*>(sender());
+    _invalidateFlightStatus(visualItem ? _visualItems->indexOf(visualItem) : 0);
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_visualItemsRowsChanged(const QModelIndex& /*parent*/, int first, int /*last*/)
+{
+    _invalidateFlightStatus(first);
+}
+
 void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
 {
     if (_managerVehicle) {
@@ -2021,9 +2153,21 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_itemFlightStatusChanged);
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_itemFlightStatusChanged);
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
+    connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::_itemFlightStatusChanged);
+
+    // The controller vehicle may be the manager vehicle, whose connections were just dropped above. Its type, speeds and
+    // firmware (battery data comes from the firmware plugin) are used by the flight status calculation.
+    connect(_controllerVehicle, &Vehicle::vehicleTypeChanged,           this, &MissionController::_itemFlightStatusChanged, Qt::UniqueConnection);
+    connect(_controllerVehicle, &Vehicle::firmwareTypeChanged,          this, &MissionController::_itemFlightStatusChanged, Qt::UniqueConnection);
+    connect(_controllerVehicle, &Vehicle::defaultCruiseSpeedChanged,    this, &MissionController::_itemFlightStatusChanged, Qt::UniqueConnection);
+    connect(_controllerVehicle, &Vehicle::defaultHoverSpeedChanged,     this, &MissionController::_itemFlightStatusChanged, Qt::UniqueConnection);
+
+    // The manager vehicle's vtol state is used by the flight status calculation
+    _invalidateFlightStatus();
+    emit _recalcMissionFlightStatusSignal();
 
     emit complexMissionItemNamesChanged();
     emit resumeMissionIndexChanged();
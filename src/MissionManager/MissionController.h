@@ -18,6 +18,7 @@
 #include "QGroundControlQmlGlobal.h"
 
 #include <QHash>
+#include <QVector>
 
 class FlightPathSegment;
 class VisualMissionItem;
@@ -40,6 +41,8 @@ class MissionController : public PlanElementController
 {
     Q_OBJECT
 
+    friend class MissionControllerTest; // Unit test
+
 public:
     MissionController(PlanMasterController* masterController, QObject* parent = nullptr);
     ~MissionController();
@@ -316,6 +319,8 @@ private slots:
     void _recalcAll                             (void);
     void _managerVehicleChanged                 (Vehicle* managerVehicle);
     void _takeoffItemNotRequiredChanged         (void);
+    void _itemFlightStatusChanged               (void);
+    void _visualItemsRowsChanged                (const QModelIndex& parent, int first, int last);
 
 private:
     void                    _init                               (void);
@@ -345,7 +350,7 @@ private:
     void                    _updateBatteryInfo                  (int waypointIndex);
     bool                    _loadItemsFromJson                  (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
     void                    _initLoadedVisualItems              (QmlObjectListModel* loadedVisualItems);
-    FlightPathSegment*      _addFlightPathSegment               (FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame);
+    FlightPathSegment*      _addFlightPathSegment               (FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame, QObjectList& segments);
     void                    _addTimeDistance                    (bool vtolInHover, double hoverTime, double cruiseTime, double extraTime, double distance, int seqNum);
     VisualMissionItem*      _insertSimpleMissionItemWorker      (QGeoCoordinate coordinate, MAV_CMD command, int visualItemIndex, bool makeCurrentItem);
     void                    _insertComplexMissionItemWorker     (const QGeoCoordinate& mapCenterCoordinate, ComplexMissionItem* complexItem, int visualItemIndex, bool makeCurrentItem);
@@ -354,8 +359,10 @@ private:
     FlightPathSegment*      _createFlightPathSegmentWorker      (VisualItemPair& pair, bool mavlinkTerrainFrame);
     void                    _allItemsRemoved                    (void);
     void                    _firstItemAdded                     (void);
+    void                    _invalidateFlightStatus             (int visualItemIndex = 0);
 
     static double           _calcDistanceToHome                 (VisualMissionItem* currentItem, VisualMissionItem* homeItem);
+    static void             _updateObjectListModel              (QmlObjectListModel& model, const QObjectList& newList);
     static double           _normalizeLat                       (double lat);
     static double           _normalizeLon                       (double lon);
     static bool             _convertToMissionItems              (QmlObjectListModel* visualMissionItems, QList<MissionItem*>& rgMissionItems, QObject* missionItemParent);
@@ -399,6 +406,21 @@ private:
     double                      _maxAMSLAltitude =              0;
     bool                        _missionContainsVTOLTakeoff =   false;
 
+    /// Flight status calculation state prior to processing a visual item. Index count() holds the state after the last item.
+    typedef struct {
+        MissionFlightStatus_t   missionFlightStatus;
+        VisualMissionItem*      lastFlyThroughVI;
+        bool                    firstCoordinateItem;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+        double                  totalHorizontalDistance;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+    } FlightStatusPrefix_t;
+
+    QVector<FlightStatusPrefix_t>   _flightStatusPrefix;
+    int                             _flightStatusDirtyIndex = 0;    ///< Items from this index on need flight status recalc
+
     QGroundControlQmlGlobal::AltMode _globalAltMode = QGroundControlQmlGlobal::AltitudeModeRelative;
 
     static const char*  _settingsGroup;
@@ -16,6 +16,8 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
+#include "FlightPathSegment.h"
+#include "TerrainQuery.h"
 
 MissionControllerTest::MissionControllerTest(void)
 {
@@ -229,6 +231,228 @@ void MissionControllerTest::_testVehicleYawRecalc(void)
     }
 }
 
+/// Adds a zig-zag pattern of waypoints to the mission
+void MissionControllerTest::_addSyntheticMission(int cWaypoints)
+{
+    QGeoCoordinate currentCoord(47.6, 8.5);
+    for (int i=1; i<=cWaypoints; i++) {
+        currentCoord = currentCoord.atDistanceAndAzimuth(100, i % 2 ? 45 : 135);
+        _missionController->insertSimpleMissionItem(currentCoord, i);
+    }
+    QTest::qWait(100); // Recalcs in MissionController are queued to remove dups. Allow return to main message loop.
+}
+
+void MissionControllerTest::_testIncrementalFlightStatus(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int cWaypoints = 50;
+    _addSyntheticMission(cWaypoints);
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QCOMPARE(visualItems->count(), cWaypoints + 1);
+    QObjectList segmentsBefore = *_missionController->simpleFlightPathSegments()->objectList();
+
+    // Move a waypoint in the middle of the mission, only items from there on should be recalculated
+    const int movedIndex = cWaypoints / 2;
+    SimpleMissionItem* movedItem = visualItems->value<SimpleMissionItem*>(movedIndex);
+    movedItem->setCoordinate(movedItem->coordinate().atDistanceAndAzimuth(500, 90));
+    QTest::qWait(100);
+    QCOMPARE(_missionController->_flightStatusDirtyIndex, visualItems->count());
+
+    double          incrementalDistance =       _missionController->missionDistance();
+    double          incrementalTime =           _missionController->missionTime();
+    QList<double>   incrementalFromStart;
+    for (int i=0; i<visualItems->count(); i++) {
+        incrementalFromStart.append(visualItems->value<VisualMissionItem*>(i)->distanceFromStart());
+    }
+
+    // Full recalc must come up with the same values
+    _missionController->_invalidateFlightStatus();
+    _missionController->_recalcMissionFlightStatus();
+    QCOMPARE(_missionController->missionDistance(), incrementalDistance);
+    QCOMPARE(_missionController->missionTime(), incrementalTime);
+    for (int i=0; i<visualItems->count(); i++) {
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->distanceFromStart(), incrementalFromStart[i]);
+    }
+
+    // Segments are re-used, not re-created
+    QVERIFY(*_missionController->simpleFlightPathSegments()->objectList() == segmentsBefore);
+
+    // Removing an item only replaces the segments around it
+    _missionController->removeVisualItem(movedIndex);
+    QTest::qWait(100);
+    const QObjectList& segmentsAfter = *_missionController->simpleFlightPathSegments()->objectList();
+    QCOMPARE(segmentsAfter.count(), segmentsBefore.count() - 1);
+    QCOMPARE(segmentsAfter.first(), segmentsBefore.first());
+    QCOMPARE(segmentsAfter.last(), segmentsBefore.last());
+}
+
+/// Lets the queued recalcs run, then checks the incremental flight status against a full recalculation
+void MissionControllerTest::_compareFlightStatusToFullRecalc(void)
+{
+    QTest::qWait(100);
+    QCOMPARE(_missionController->_flightStatusDirtyIndex, _missionController->visualItems()->count());
+
+    double  incrementalDistance =       _missionController->missionDistance();
+    double  incrementalTime =           _missionController->missionTime();
+    double  incrementalHoverTime =      _missionController->missionHoverTime();
+    double  incrementalCruiseTime =     _missionController->missionCruiseTime();
+    int     incrementalBatteries =      _missionController->batteriesRequired();
+
+    _missionController->_invalidateFlightStatus();
+    _missionController->_recalcMissionFlightStatus();
+    QCOMPARE(_missionController->missionDistance(), incrementalDistance);
+    QCOMPARE(_missionController->missionTime(), incrementalTime);
+    QCOMPARE(_missionController->missionHoverTime(), incrementalHoverTime);
+    QCOMPARE(_missionController->missionCruiseTime(), incrementalCruiseTime);
+    QCOMPARE(_missionController->batteriesRequired(), incrementalBatteries);
+}
+
+/// Changes which affect the whole mission must invalidate the saved flight status, not only item edits
+void MissionControllerTest::_testFlightStatusInvalidation(void)
+{
+    AppSettings*    appSettings =       qgcApp()->toolbox()->settingsManager()->appSettings();
+    QVariant        savedVehicleClass = appSettings->offlineEditingVehicleClass()->rawValue();
+    QVariant        savedAscentSpeed =  appSettings->offlineEditingAscentSpeed()->rawValue();
+    QVariant        savedDescentSpeed = appSettings->offlineEditingDescentSpeed()->rawValue();
+    QVariant        savedCruiseSpeed =  appSettings->offlineEditingCruiseSpeed()->rawValue();
+    QVariant        savedHoverSpeed =   appSettings->offlineEditingHoverSpeed()->rawValue();
+
+    appSettings->offlineEditingVehicleClass()->setRawValue(QGCMAVLink::VehicleClassMultiRotor);
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    // Takeoff uses the ascent speed and RTL the descent speed, so both need a valid home position
+    QGeoCoordinate homeCoord(47.6, 8.5);
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    visualItems->value<MissionSettingsItem*>(0)->setInitialHomePositionFromUser(homeCoord);
+    _missionController->insertTakeoffItem(homeCoord.atDistanceAndAzimuth(10, 0), 1);
+    const int cWaypoints = 20;
+    QGeoCoordinate currentCoord = homeCoord;
+    for (int i=0; i<cWaypoints; i++) {
+        currentCoord = currentCoord.atDistanceAndAzimuth(100, i % 2 ? 45 : 135);
+        _missionController->insertSimpleMissionItem(currentCoord, visualItems->count());
+    }
+    SimpleMissionItem* rtlItem = qobject_cast<SimpleMissionItem*>(_missionController->insertSimpleMissionItem(currentCoord, visualItems->count()));
+    QVERIFY(rtlItem);
+    rtlItem->setCommand(MAV_CMD_NAV_RETURN_TO_LAUNCH);
+    _compareFlightStatusToFullRecalc();
+
+    // Item edit
+    SimpleMissionItem* editedItem = visualItems->value<SimpleMissionItem*>(cWaypoints / 2);
+    editedItem->setCoordinate(editedItem->coordinate().atDistanceAndAzimuth(300, 90));
+    _compareFlightStatusToFullRecalc();
+
+    double previousTime = _missionController->missionTime();
+    appSettings->offlineEditingAscentSpeed()->setRawValue(appSettings->offlineEditingAscentSpeed()->rawValue().toDouble() * 2);
+    _compareFlightStatusToFullRecalc();
+    QVERIFY(_missionController->missionTime() < previousTime);
+
+    // The RTL landing is accounted as distance rather than time
+    previousTime = _missionController->missionTime();
+    double previousDistance = _missionController->missionDistance();
+    appSettings->offlineEditingDescentSpeed()->setRawValue(appSettings->offlineEditingDescentSpeed()->rawValue().toDouble() * 2);
+    _compareFlightStatusToFullRecalc();
+    QVERIFY(_missionController->missionTime() != previousTime || _missionController->missionDistance() != previousDistance);
+
+    previousTime = _missionController->missionTime();
+    appSettings->offlineEditingHoverSpeed()->setRawValue(appSettings->offlineEditingHoverSpeed()->rawValue().toDouble() * 2);
+    _compareFlightStatusToFullRecalc();
+    QVERIFY(_missionController->missionTime() < previousTime);
+
+    previousTime = _missionController->missionTime();
+    appSettings->offlineEditingVehicleClass()->setRawValue(QGCMAVLink::VehicleClassFixedWing);
+    _compareFlightStatusToFullRecalc();
+    QVERIFY(_missionController->missionTime() != previousTime);
+
+    previousTime = _missionController->missionTime();
+    appSettings->offlineEditingCruiseSpeed()->setRawValue(appSettings->offlineEditingCruiseSpeed()->rawValue().toDouble() * 2);
+    _compareFlightStatusToFullRecalc();
+    QVERIFY(_missionController->missionTime() < previousTime);
+
+    appSettings->offlineEditingVehicleClass()->setRawValue(savedVehicleClass);
+    appSettings->offlineEditingAscentSpeed()->setRawValue(savedAscentSpeed);
+    appSettings->offlineEditingDescentSpeed()->setRawValue(savedDescentSpeed);
+    appSettings->offlineEditingCruiseSpeed()->setRawValue(savedCruiseSpeed);
+    appSettings->offlineEditingHoverSpeed()->setRawValue(savedHoverSpeed);
+}
+
+void MissionControllerTest::_testSegmentTerrainBatch(void)
+{
+    // Both segments are over the flat 10m region, so they are resolved by a single batched terrain query
+    QGeoCoordinate coord1 = UnitTestTerrainQuery::pointNemo.atDistanceAndAzimuth(500, 135);
+    QGeoCoordinate coord2 = coord1.atDistanceAndAzimuth(1000, 135);
+    double terrainAlt = UnitTestTerrainQuery::Flat10Region::amslElevation;
+
+    FlightPathSegment belowTerrain(FlightPathSegment::SegmentTypeGeneric, coord1, terrainAlt - 5, coord2, terrainAlt - 5, true /* queryTerrainData */, nullptr);
+    FlightPathSegment aboveTerrain(FlightPathSegment::SegmentTypeGeneric, coord1, terrainAlt + 40, coord2, terrainAlt + 20, true /* queryTerrainData */, nullptr);
+
+    QCOMPARE(belowTerrain.amslTerrainHeights().count(), 0);
+    QVERIFY(qIsNaN(belowTerrain.minTerrainClearance()));
+
+    QTRY_VERIFY(belowTerrain.amslTerrainHeights().count() != 0 && aboveTerrain.amslTerrainHeights().count() != 0);
+    QCOMPARE(belowTerrain.amslTerrainHeights().count(), aboveTerrain.amslTerrainHeights().count());
+    QCOMPARE(belowTerrain.minAMSLTerrainHeight(), terrainAlt);
+    QCOMPARE(belowTerrain.maxAMSLTerrainHeight(), terrainAlt);
+
+    QCOMPARE(belowTerrain.terrainCollision(), true);
+    QVERIFY(qAbs(belowTerrain.minTerrainClearance() - -5) < 0.1);
+    QCOMPARE(aboveTerrain.terrainCollision(), false);
+    QVERIFY(qAbs(aboveTerrain.minTerrainClearance() - 20) < 0.1);
+
+    // Altitude changes are evaluated against the existing heights without a new query
+    aboveTerrain.setCoord2AMSLAlt(terrainAlt - 1);
+    QCOMPARE(aboveTerrain.terrainCollision(), true);
+    QVERIFY(aboveTerrain.minTerrainClearance() < 0);
+}
+
+void MissionControllerTest::_testSegmentTerrainBatchFallback(void)
+{
+    // The second segment is outside of all unit test terrain regions, which fails the batch it is part of
+    QGeoCoordinate coord1 = UnitTestTerrainQuery::pointNemo.atDistanceAndAzimuth(500, 135);
+    QGeoCoordinate coord2 = coord1.atDistanceAndAzimuth(1000, 135);
+    QGeoCoordinate noTerrainCoord1(0, 0);
+    QGeoCoordinate noTerrainCoord2 = noTerrainCoord1.atDistanceAndAzimuth(1000, 135);
+    double terrainAlt = UnitTestTerrainQuery::Flat10Region::amslElevation;
+
+    FlightPathSegment terrainSegment(FlightPathSegment::SegmentTypeGeneric, coord1, terrainAlt + 20, coord2, terrainAlt + 20, true /* queryTerrainData */, nullptr);
+    FlightPathSegment noTerrainSegment(FlightPathSegment::SegmentTypeGeneric, noTerrainCoord1, 50, noTerrainCoord2, 50, true /* queryTerrainData */, nullptr);
+
+    // Only the segment without terrain data goes without heights
+    QTRY_VERIFY(terrainSegment.amslTerrainHeights().count() != 0);
+    QCOMPARE(terrainSegment.minAMSLTerrainHeight(), terrainAlt);
+    QVERIFY(qAbs(terrainSegment.minTerrainClearance() - 20) < 0.1);
+    QTest::qWait(100);
+    QCOMPARE(noTerrainSegment.amslTerrainHeights().count(), 0);
+    QVERIFY(qIsNaN(noTerrainSegment.minTerrainClearance()));
+}
+
+void MissionControllerTest::_benchmarkFlightStatus_data(void)
+{
+    QTest::addColumn<bool>("fullRecalc");
+
+    QTest::newRow("Full") << true;
+    QTest::newRow("LastItemChanged") << false;
+}
+
+void MissionControllerTest::_benchmarkFlightStatus(void)
+{
+    QFETCH(bool, fullRecalc);
+
+    if (!qEnvironmentVariableIsSet("QGC_RUN_BENCHMARKS")) {
+        QSKIP("Set QGC_RUN_BENCHMARKS to run benchmarks");
+    }
+
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _addSyntheticMission(_cLargeMissionWaypoints);
+
+    int lastIndex = _missionController->visualItems()->count() - 1;
+    QBENCHMARK {
+        _missionController->_invalidateFlightStatus(fullRecalc ? 0 : lastIndex);
+        _missionController->_recalcMissionFlightStatus();
+    }
+}
+
 void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -38,6 +38,12 @@ private slots:
     void _testGlobalAltMode             (void);
     void _testGimbalRecalc              (void);
     void _testVehicleYawRecalc          (void);
+    void _testIncrementalFlightStatus   (void);
+    void _testFlightStatusInvalidation  (void);
+    void _testSegmentTerrainBatch       (void);
+    void _testSegmentTerrainBatchFallback(void);
+    void _benchmarkFlightStatus_data    (void);
+    void _benchmarkFlightStatus         (void);
 
 private:
 #if 0
@@ -53,6 +59,8 @@ private:
     void _testOfflineToOnlineWorker(MAV_AUTOPILOT firmwareType);
 #endif
     void _setupVisualItemSignals(VisualMissionItem* visualItem);
+    void _addSyntheticMission(int cWaypoints);
+    void _compareFlightStatusToFullRecalc(void);
 
     // MissiomItems signals
 
@@ -82,6 +90,8 @@ private:
     PlanMasterController*   _masterController           = nullptr;
     MissionController*      _missionController          = nullptr;
 
+    static const int    _cLargeMissionWaypoints = 2000;
+
     static const size_t _cVisualItemSignals = visualItemMaxSignalIndex;
     static const size_t _cMissionControllerSignals = missionControllerMaxSignalIndex;
 
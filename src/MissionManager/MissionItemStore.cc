@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MissionItemStore.h"
+#include "MissionItem.h"
+
+#include <cmath>
+
+void MissionItemStore::append(const MissionItem& missionItem)
+{
+    _items.append(fromMissionItem(missionItem));
+}
+
+void MissionItemStore::append(int sequenceNumber, MAV_CMD command, MAV_FRAME frame, double param1, double param2, double param3, double param4, double param5, double param6, double param7, bool autoContinue, bool isCurrentItem)
+{
+    Item_t item;
+
+    item.param1         = param1;
+    item.param2         = param2;
+    item.param3         = param3;
+    item.param4         = param4;
+    item.param5         = param5;
+    item.param6         = param6;
+    item.param7         = param7;
+    item.sequenceNumber = sequenceNumber;
+    item.command        = static_cast<uint16_t>(command);
+    item.frame          = static_cast<uint8_t>(frame);
+    item.autoContinue   = autoContinue;
+    item.isCurrentItem  = isCurrentItem;
+
+    _items.append(item);
+}
+
+QGeoCoordinate MissionItemStore::coordinate(int index) const
+{
+    const Item_t& item = _items[index];
+
+    if (!std::isfinite(item.param5) || !std::isfinite(item.param6)) {
+        return QGeoCoordinate();
+    }
+    return QGeoCoordinate(item.param5, item.param6, item.param7);
+}
+
+MissionItem* MissionItemStore::createMissionItem(int index, QObject* parent) const
+{
+    const Item_t& item = _items[index];
+
+    return new MissionItem(item.sequenceNumber,
+                           static_cast<MAV_CMD>(item.command),
+                           static_cast<MAV_FRAME>(item.frame),
+                           item.param1,
+                           item.param2,
+                           item.param3,
+                           item.param4,
+                           item.param5,
+                           item.param6,
+                           item.param7,
+                           item.autoContinue,
+                           item.isCurrentItem,
+                           parent);
+}
+
+void MissionItemStore::toMissionItem(int index, MissionItem& missionItem) const
+{
+    const Item_t& item = _items[index];
+
+    missionItem.setSequenceNumber(item.sequenceNumber);
+    missionItem.setCommand(static_cast<MAV_CMD>(item.command));
+    missionItem.setFrame(static_cast<MAV_FRAME>(item.frame));
+    missionItem.setAutoContinue(item.autoContinue);
+    missionItem.setIsCurrentItem(item.isCurrentItem);
+    missionItem.setParam1(item.param1);
+    missionItem.setParam2(item.param2);
+    missionItem.setParam3(item.param3);
+    missionItem.setParam4(item.param4);
+    missionItem.setParam5(item.param5);
+    missionItem.setParam6(item.param6);
+    missionItem.setParam7(item.param7);
+}
+
+MissionItemStore::Item_t MissionItemStore::fromMissionItem(const MissionItem& missionItem)
+{
+    Item_t item;
+
+    item.param1         = missionItem.param1();
+    item.param2         = missionItem.param2();
+    item.param3         = missionItem.param3();
+    item.param4         = missionItem.param4();
+    item.param5         = missionItem.param5();
+    item.param6         = missionItem.param6();
+    item.param7         = missionItem.param7();
+    item.sequenceNumber = missionItem.sequenceNumber();
+    item.command        = static_cast<uint16_t>(missionItem.command());
+    item.frame          = static_cast<uint8_t>(missionItem.frame());
+    item.autoContinue   = missionItem.autoContinue();
+    item.isCurrentItem  = missionItem.isCurrentItem();
+
+    return item;
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QVector>
+#include <QGeoCoordinate>
+
+class MissionItem;
+class QObject;
+
+/// Compact list of mission items. Items are held as plain structs in a single contiguous array so large plans don't
+/// allocate a MissionItem QObject and its Facts per item. Fact backed MissionItems are only created on request for
+/// the items which actually need them.
+class MissionItemStore
+{
+public:
+    typedef struct {
+        double      param1;
+        double      param2;
+        double      param3;
+        double      param4;
+        double      param5;         ///< Latitude for global frames
+        double      param6;         ///< Longitude for global frames
+        double      param7;         ///< Altitude for global frames
+        int         sequenceNumber;
+        uint16_t    command;        ///< MAV_CMD
+        uint8_t     frame;          ///< MAV_FRAME
+        bool        autoContinue;
+        bool        isCurrentItem;
+    } Item_t;
+
+    int     count   (void) const { return _items.count(); }
+    bool    isEmpty (void) const { return _items.isEmpty(); }
+    void    clear   (void) { _items.clear(); }
+    void    reserve (int count) { _items.reserve(count); }
+    void    append  (const Item_t& item) { _items.append(item); }
+    void    append  (const MissionItem& missionItem);
+    void    append  (int sequenceNumber, MAV_CMD command, MAV_FRAME frame, double param1, double param2, double param3, double param4, double param5, double param6, double param7, bool autoContinue, bool isCurrentItem);
+    void    removeAt(int index) { _items.remove(index); }
+
+    const Item_t&   operator[]  (int index) const { return _items[index]; }
+    Item_t&         operator[]  (int index) { return _items[index]; }
+    const Item_t&   at          (int index) const { return _items.at(index); }
+
+    MAV_CMD         command     (int index) const { return static_cast<MAV_CMD>(_items[index].command); }
+
+    /// @return Coordinate from param5-7, invalid if lat/lon are not finite
+    QGeoCoordinate  coordinate  (int index) const;
+
+    /// Creates a Fact backed MissionItem for editing the specified item. Caller is responsible for freeing it.
+    MissionItem*    createMissionItem(int index, QObject* parent = nullptr) const;
+
+    /// Copies the specified item into an existing MissionItem
+    void            toMissionItem(int index, MissionItem& missionItem) const;
+
+    static Item_t   fromMissionItem(const MissionItem& missionItem);
+
+private:
+    QVector<Item_t> _items;
+};
@@ -12,6 +12,7 @@
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
 #include "MissionItem.h"
+#include "MissionItemStore.h"
 #include "SimpleMissionItem.h"
 #include "QGCApplication.h"
 
@@ -487,6 +488,37 @@ void MissionItemTest::_testSaveToJson(void)
     _checkExpectedMissionItem(missionItem, true /* allNaNs */);
 }
 
+void MissionItemTest::_testStore(void)
+{
+    MissionItemStore    store;
+    QString             errorString;
+    MissionItem         missionItem;
+
+    QVERIFY(missionItem.load(_createV3Json(false /* allNaNs */), _seq, errorString));
+    store.append(missionItem);
+    QCOMPARE(store.count(), 1);
+    QCOMPARE(store.command(0), missionItem.command());
+    QCOMPARE(store.coordinate(0), missionItem.coordinate());
+
+    QScopedPointer<MissionItem> created(store.createMissionItem(0));
+    _checkExpectedMissionItem(*created, false /* allNaNs */);
+
+    MissionItem copied;
+    store.toMissionItem(0, copied);
+    _checkExpectedMissionItem(copied, false /* allNaNs */);
+
+    QVERIFY(missionItem.load(_createV3Json(true /* allNaNs */), _seq, errorString));
+    store.append(missionItem);
+    QCOMPARE(store.count(), 2);
+    QVERIFY(!store.coordinate(1).isValid());
+    created.reset(store.createMissionItem(1));
+    _checkExpectedMissionItem(*created, true /* allNaNs */);
+
+    store.removeAt(0);
+    QCOMPARE(store.count(), 1);
+    QVERIFY(qIsNaN(store[0].param1));
+}
+
 QJsonObject MissionItemTest::_createV1Json(void)
 {
     QJsonObject jsonObject;
@@ -87,8 +87,7 @@ void MissionManager::generateResumeMission(int resumeIndex)
     }
 
     for (int i=0; i<_missionItems.count(); i++) {
-        MissionItem* item = _missionItems[i];
-        if (item->command() == MAV_CMD_DO_JUMP) {
+        if (_missionItems.command(i) == MAV_CMD_DO_JUMP) {
             qgcApp()->showAppMessage(tr("Unable to generate resume mission due to MAV_CMD_DO_JUMP command."));
             return;
         }
@@ -98,11 +97,11 @@ void MissionManager::generateResumeMission(int resumeIndex)
     resumeIndex = qMax(0, qMin(resumeIndex, _missionItems.count() - 1));
 
     // Adjust resume index to be a location based command
-    const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), _missionItems[resumeIndex]->command());
+    const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), _missionItems.command(resumeIndex));
     if (!uiInfo || uiInfo->isStandaloneCoordinate() || !uiInfo->specifiesCoordinate()) {
         // We have to back up to the last command which the vehicle flies through
         while (--resumeIndex > 0) {
-            uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), _missionItems[resumeIndex]->command());
+            uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), _missionItems.command(resumeIndex));
             if (uiInfo && (uiInfo->specifiesCoordinate() && !uiInfo->isStandaloneCoordinate())) {
                 // Found it
                 break;
@@ -112,7 +111,7 @@ void MissionManager::generateResumeMission(int resumeIndex)
     }
     resumeIndex = qMax(0, resumeIndex);
 
-    QList<MissionItem*> resumeMission;
+    MissionItemStore resumeMission;
 
     QList<MAV_CMD> includedResumeCommands;
 
@@ -136,14 +135,14 @@ void MissionManager::generateResumeMission(int resumeIndex)
 
     int prefixCommandCount = 0;
     for (int i=0; i<_missionItems.count(); i++) {
-        MissionItem* oldItem = _missionItems[i];
-        const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), oldItem->command());
-        if ((i == 0 && addHomePosition) || i >= resumeIndex || includedResumeCommands.contains(oldItem->command()) || (uiInfo && uiInfo->isTakeoffCommand())) {
+        MAV_CMD command = _missionItems.command(i);
+        const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(_vehicle, _vehicle->vehicleClass(), command);
+        if ((i == 0 && addHomePosition) || i >= resumeIndex || includedResumeCommands.contains(command) || (uiInfo && uiInfo->isTakeoffCommand())) {
             if (i < resumeIndex) {
                 prefixCommandCount++;
             }
-            MissionItem* newItem = new MissionItem(*oldItem, this);
-            newItem->setIsCurrentItem(false);
+            MissionItemStore::Item_t newItem = _missionItems[i];
+            newItem.isCurrentItem = false;
             resumeMission.append(newItem);
         }
     }
@@ -155,8 +154,8 @@ void MissionManager::generateResumeMission(int resumeIndex)
     bool foundCameraStartStop = false;
     prefixCommandCount--;   // Change from count to array index
     while (prefixCommandCount >= 0) {
-        MissionItem* resumeItem = resumeMission[prefixCommandCount];
-        switch (resumeItem->command()) {
+        const MissionItemStore::Item_t& resumeItem = resumeMission[prefixCommandCount];
+        switch (resumeItem.command) {
         case MAV_CMD_SET_CAMERA_MODE:
             // Only keep the last one
             if (foundCameraSetMode) {
@@ -182,7 +181,7 @@ void MissionManager::generateResumeMission(int resumeIndex)
             foundCameraStartStop = true;
             break;
         case MAV_CMD_IMAGE_START_CAPTURE:
-            if (resumeItem->param3() != 0) {
+            if (resumeItem.param3 != 0) {
                 // Remove commands which do not trigger by time
                 resumeMission.removeAt(prefixCommandCount);
                 break;
@@ -203,16 +202,13 @@ void MissionManager::generateResumeMission(int resumeIndex)
     // Adjust sequence numbers and current item
     int seqNum = 0;
     for (int i=0; i<resumeMission.count(); i++) {
-        resumeMission[i]->setSequenceNumber(seqNum++);
+        resumeMission[i].sequenceNumber = seqNum++;
     }
     int setCurrentIndex = addHomePosition ? 1 : 0;
-    resumeMission[setCurrentIndex]->setIsCurrentItem(true);
+    resumeMission[setCurrentIndex].isCurrentItem = true;
 
     // Send to vehicle
-    _clearAndDeleteWriteMissionItems();
-    for (int i=0; i<resumeMission.count(); i++) {
-        _writeMissionItems.append(new MissionItem(*resumeMission[i], this));
-    }
+    _writeMissionItems = resumeMission;
     _resumeMission = true;
     _writeMissionItemsWorker();
 }
@@ -58,7 +58,12 @@ void MissionManagerTest::_writeItems(MockLinkMissionItemHandler::FailureMode_t f
     }
     
     // Send the items to the vehicle
-    _missionManager->writeMissionItems(missionItems);
+    MissionItemStore missionItemStore;
+    for (const MissionItem* missionItem: missionItems) {
+        missionItemStore.append(*missionItem);
+    }
+    qDeleteAll(missionItems);
+    _missionManager->writeMissionItems(missionItemStore);
     
     // writeMissionItems should emit these signals before returning:
     //      inProgressChanged
@@ -198,7 +203,7 @@ void MissionManagerTest::_roundTripItems(MockLinkMissionItemHandler::FailureMode
             expectedSequenceNumber++;
         }
 
-        MissionItem* actual = _missionManager->missionItems()[actualItemIndex];
+        QScopedPointer<MissionItem> actual(_missionManager->missionItems().createMissionItem(actualItemIndex));
         
         qDebug() << "Test case" << testCaseIndex;
         QCOMPARE(actual->sequenceNumber(),          expectedSequenceNumber);
@@ -62,38 +62,69 @@ void PlanManager::_writeMissionItemsWorker(void)
 }
 
 
-void PlanManager::writeMissionItems(const QList<MissionItem*>& missionItems)
+/// Clears the items being written in preparation for a new write
+///     @param[out] skipFirstItem true: first item is the home position, which is not sent to the vehicle
+/// @return false: A write can't be started
+bool PlanManager::_startWriteMissionItems(int count, bool& skipFirstItem)
 {
     if (_vehicle->isOfflineEditingVehicle()) {
-        return;
+        return false;
     }
 
     if (inProgress()) {
         qCDebug(PlanManagerLog) << QStringLiteral("writeMissionItems %1 called while transaction in progress").arg(_planTypeString());
-        return;
+        return false;
     }
 
-    _clearAndDeleteWriteMissionItems();
-
-    bool skipFirstItem = _planType == MAV_MISSION_TYPE_MISSION && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle();
+    _writeMissionItems.clear();
+    _writeMissionItems.reserve(count);
 
-    int firstIndex = skipFirstItem ? 1 : 0;
+    skipFirstItem = _planType == MAV_MISSION_TYPE_MISSION && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle();
 
-    for (int i=firstIndex; i<missionItems.count(); i++) {
-        MissionItem* item = missionItems[i];
-        _writeMissionItems.append(item); // PlanManager takes control of passed MissionItem
+    return true;
+}
 
-        item->setIsCurrentItem(i == firstIndex);
+/// Adds the item at the specified plan index to the items being written
+void PlanManager::_appendWriteMissionItem(MissionItemStore::Item_t item, int index, bool skipFirstItem)
+{
+    item.isCurrentItem = index == (skipFirstItem ? 1 : 0);
 
-        if (skipFirstItem) {
-            // Home is in sequence 0, remainder of items start at sequence 1
-            item->setSequenceNumber(item->sequenceNumber() - 1);
-            if (item->command() == MAV_CMD_DO_JUMP) {
-                item->setParam1((int)item->param1() - 1);
-            }
+    if (skipFirstItem) {
+        // Home is in sequence 0, remainder of items start at sequence 1
+        item.sequenceNumber--;
+        if (item.command == MAV_CMD_DO_JUMP) {
+            item.param1 = (int)item.param1 - 1;
         }
     }
 
+    _writeMissionItems.append(item);
+}
+
+void PlanManager::writeMissionItems(const MissionItemStore& missionItems)
+{
+    bool skipFirstItem;
+    if (!_startWriteMissionItems(missionItems.count(), skipFirstItem)) {
+        return;
+    }
+
+    for (int i=skipFirstItem ? 1 : 0; i<missionItems.count(); i++) {
+        _appendWriteMissionItem(missionItems[i], i, skipFirstItem);
+    }
+
+    _writeMissionItemsWorker();
+}
+
+void PlanManager::writeMissionItems(const QList<MissionItem*>& missionItems)
+{
+    bool skipFirstItem;
+    if (!_startWriteMissionItems(missionItems.count(), skipFirstItem)) {
+        return;
+    }
+
+    for (int i=skipFirstItem ? 1 : 0; i<missionItems.count(); i++) {
+        _appendWriteMissionItem(MissionItemStore::fromMissionItem(*missionItems[i]), i, skipFirstItem);
+    }
+
     _writeMissionItemsWorker();
 }
 
@@ -430,23 +461,24 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
 
-        MissionItem* item = new MissionItem(seq,
-                                            command,
-                                            frame,
-                                            param1,
-                                            param2,
-                                            param3,
-                                            param4,
-                                            param5,
-                                            param6,
-                                            param7,
-                                            autoContinue,
-                                            isCurrentItem,
-                                            this);
-
-        if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
+        MissionItemStore::Item_t item;
+
+        item.sequenceNumber = seq;
+        item.command        = command;
+        item.frame          = frame;
+        item.param1         = param1;
+        item.param2         = param2;
+        item.param3         = param3;
+        item.param4         = param4;
+        item.param5         = param5;
+        item.param6         = param6;
+        item.param7         = param7;
+        item.autoContinue   = autoContinue;
+        item.isCurrentItem  = isCurrentItem;
+
+        if (item.command == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
             // Home is in position 0
-            item->setParam1((int)item->param1() + 1);
+            item.param1 = (int)item.param1 + 1;
         }
 
         _missionItems.append(item);
@@ -470,7 +502,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
 void PlanManager::_clearMissionItems(void)
 {
     _itemIndicesToRead.clear();
-    _clearAndDeleteMissionItems();
+    _missionItems.clear();
 }
 
 void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
@@ -511,8 +543,8 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
         _itemIndicesToWrite.removeOne(missionRequestSeq);
     }
     
-    MissionItem* item = _writeMissionItems[missionRequestSeq];
-    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
+    const MissionItemStore::Item_t& item = _writeMissionItems[missionRequestSeq];
+    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item.command;
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -526,17 +558,17 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
                                                _vehicle->id(),
                                                MAV_COMP_ID_AUTOPILOT1,
                                                missionRequestSeq,
-                                               item->frame(),
-                                               item->command(),
+                                               item.frame,
+                                               item.command,
                                                missionRequestSeq == 0,
-                                               item->autoContinue(),
-                                               item->param1(),
-                                               item->param2(),
-                                               item->param3(),
-                                               item->param4(),
-                                               item->frame() == MAV_FRAME_MISSION ? item->param5() : item->param5() * 1e7,
-                                               item->frame() == MAV_FRAME_MISSION ? item->param6() : item->param6() * 1e7,
-                                               item->param7(),
+                                               item.autoContinue,
+                                               item.param1,
+                                               item.param2,
+                                               item.param3,
+                                               item.param4,
+                                               item.frame == MAV_FRAME_MISSION ? item.param5 : item.param5 * 1e7,
+                                               item.frame == MAV_FRAME_MISSION ? item.param6 : item.param6 * 1e7,
+                                               item.param7,
                                                _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), messageOut);
     }
@@ -685,37 +717,37 @@ QString PlanManager::_lastMissionReqestString(MAV_MISSION_RESULT result)
     QString postfix;
 
     if (_lastMissionRequest >= 0 && _lastMissionRequest < _writeMissionItems.count()) {
-        MissionItem* item = _writeMissionItems[_lastMissionRequest];
+        const MissionItemStore::Item_t& item = _writeMissionItems[_lastMissionRequest];
 
-        prefix = tr("Item #%1 Command: %2").arg(_lastMissionRequest).arg(_missionCommandTree->friendlyName(item->command()));
+        prefix = tr("Item #%1 Command: %2").arg(_lastMissionRequest).arg(_missionCommandTree->friendlyName(static_cast<MAV_CMD>(item.command)));
 
         switch (result) {
         case MAV_MISSION_UNSUPPORTED_FRAME:
-            postfix = tr("Frame: %1").arg(item->frame());
+            postfix = tr("Frame: %1").arg(item.frame);
             break;
         case MAV_MISSION_UNSUPPORTED:
             // All we need is the prefix
             break;
         case MAV_MISSION_INVALID_PARAM1:
-            postfix = tr("Value: %1").arg(item->param1());
+            postfix = tr("Value: %1").arg(item.param1);
             break;
         case MAV_MISSION_INVALID_PARAM2:
-            postfix = tr("Value: %1").arg(item->param2());
+            postfix = tr("Value: %1").arg(item.param2);
             break;
         case MAV_MISSION_INVALID_PARAM3:
-            postfix = tr("Value: %1").arg(item->param3());
+            postfix = tr("Value: %1").arg(item.param3);
             break;
         case MAV_MISSION_INVALID_PARAM4:
-            postfix = tr("Value: %1").arg(item->param4());
+            postfix = tr("Value: %1").arg(item.param4);
             break;
         case MAV_MISSION_INVALID_PARAM5_X:
-            postfix = tr("Value: %1").arg(item->param5());
+            postfix = tr("Value: %1").arg(item.param5);
             break;
         case MAV_MISSION_INVALID_PARAM6_Y:
-            postfix = tr("Value: %1").arg(item->param6());
+            postfix = tr("Value: %1").arg(item.param6);
             break;
         case MAV_MISSION_INVALID_PARAM7:
-            postfix = tr("Value: %1").arg(item->param7());
+            postfix = tr("Value: %1").arg(item.param7);
             break;
         case MAV_MISSION_INVALID_SEQUENCE:
             // All we need is the prefix
@@ -808,7 +840,7 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
     case TransactionRead:
         if (!success) {
             // Read from vehicle failed, clear partial list
-            _clearAndDeleteMissionItems();
+            _missionItems.clear();
         }
         emit newMissionItemsAvailable(false);
         break;
@@ -823,14 +855,11 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
                     emit currentIndexChanged(-1);
                     emit lastCurrentIndexChanged(-1);
                 }
-                _clearAndDeleteMissionItems();
-                for (int i=0; i<_writeMissionItems.count(); i++) {
-                    _missionItems.append(_writeMissionItems[i]);
-                }
+                _missionItems = _writeMissionItems;
                 _writeMissionItems.clear();
             } else {
                 // Write failed, throw out the write list
-                _clearAndDeleteWriteMissionItems();
+                _writeMissionItems.clear();
             }
             emit sendComplete(!success /* error */);
         }
@@ -890,7 +919,7 @@ void PlanManager::removeAll(void)
 
     qCDebug(PlanManagerLog) << QStringLiteral("removeAll %1").arg(_planTypeString());
 
-    _clearAndDeleteMissionItems();
+    _missionItems.clear();
 
     if (_planType == MAV_MISSION_TYPE_MISSION) {
         _currentMissionIndex = -1;
@@ -905,25 +934,6 @@ void PlanManager::removeAll(void)
     _removeAllWorker();
 }
 
-void PlanManager::_clearAndDeleteMissionItems(void)
-{
-    for (int i=0; i<_missionItems.count(); i++) {
-        // Using deleteLater here causes too much transient memory to stack up
-        delete _missionItems[i];
-    }
-    _missionItems.clear();
-}
-
-
-void PlanManager::_clearAndDeleteWriteMissionItems(void)
-{
-    for (int i=0; i<_writeMissionItems.count(); i++) {
-        // Using deleteLater here causes too much transient memory to stack up
-        delete _writeMissionItems[i];
-    }
-    _writeMissionItems.clear();
-}
-
 void PlanManager::_connectToMavlink(void)
 {
     connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &PlanManager::_mavlinkMessageReceived);
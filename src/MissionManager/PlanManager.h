@@ -14,6 +14,7 @@
 #include <QTimer>
 
 #include "MissionItem.h"
+#include "MissionItemStore.h"
 #include "QGCMAVLink.h"
 #include "QGCLoggingCategory.h"
 #include "LinkInterface.h"
@@ -34,7 +35,7 @@ public:
     ~PlanManager();
 
     bool inProgress(void) const;
-    const QList<MissionItem*>& missionItems(void) { return _missionItems; }
+    const MissionItemStore& missionItems(void) const { return _missionItems; }
 
     /// Current mission item as reported by MISSION_CURRENT
     int currentIndex(void) const { return _currentMissionIndex; }
@@ -47,7 +48,12 @@ public:
     void loadFromVehicle(void);
 
     /// Writes the specified set of mission items to the vehicle
-    /// IMPORTANT NOTE: PlanManager will take control of the MissionItem objects with the missionItems list. It will free them when done.
+    ///     @param missionItems Items to send to vehicle
+    ///     Signals sendComplete when done
+    void writeMissionItems(const MissionItemStore& missionItems);
+
+    /// Writes the specified set of mission items to the vehicle. The items are packed straight into the write store, the
+    /// caller keeps ownership of them.
     ///     @param missionItems Items to send to vehicle
     ///     Signals sendComplete when done
     void writeMissionItems(const QList<MissionItem*>& missionItems);
@@ -125,8 +131,8 @@ protected:
     void _requestList(void);
     void _writeMissionCount(void);
     void _writeMissionItemsWorker(void);
-    void _clearAndDeleteMissionItems(void);
-    void _clearAndDeleteWriteMissionItems(void);
+    bool _startWriteMissionItems(int count, bool& skipFirstItem);
+    void _appendWriteMissionItem(MissionItemStore::Item_t item, int index, bool skipFirstItem);
     QString _lastMissionReqestString(MAV_MISSION_RESULT result);
     void _removeAllWorker(void);
     void _connectToMavlink(void);
@@ -149,8 +155,8 @@ protected:
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
     int                 _missionItemCountToRead;///< Count of all mission items to read
 
-    QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
-    QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
+    MissionItemStore    _missionItems;          ///< Set of mission items on vehicle
+    MissionItemStore    _writeMissionItems;     ///< Set of mission items currently being written to vehicle
     int                 _currentMissionIndex;
     int                 _lastCurrentIndex;
 
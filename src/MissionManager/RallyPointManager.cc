@@ -43,23 +43,20 @@ void RallyPointManager::sendToVehicle(const QList<QGeoCoordinate>& rgPoints)
         _rgSendPoints.append(rallyPoint);
     }
 
-    QList<MissionItem*> rallyItems;
+    MissionItemStore rallyItems;
     for (int i=0; i<rgPoints.count(); i++) {
 
-        MissionItem* item = new MissionItem(0,
-                                            MAV_CMD_NAV_RALLY_POINT,
-                                            MAV_FRAME_GLOBAL_RELATIVE_ALT,
-                                            0, 0, 0, 0,                 // param 1-4 unused
-                                            rgPoints[i].latitude(),
-                                            rgPoints[i].longitude(),
-                                            rgPoints[i].altitude(),
-                                            false,                      // autocontinue
-                                            false,                      // isCurrentItem
-                                            this);                      // parent
-        rallyItems.append(item);
+        rallyItems.append(0,
+                          MAV_CMD_NAV_RALLY_POINT,
+                          MAV_FRAME_GLOBAL_RELATIVE_ALT,
+                          0, 0, 0, 0,                 // param 1-4 unused
+                          rgPoints[i].latitude(),
+                          rgPoints[i].longitude(),
+                          rgPoints[i].altitude(),
+                          false,                      // autocontinue
+                          false);                     // isCurrentItem
     }
 
-    // Plan manager takes control of MissionItems, so no need to delete
     writeMissionItems(rallyItems);
 }
 
@@ -80,17 +77,17 @@ void RallyPointManager::_planManagerLoadComplete(bool removeAllRequested)
 
     Q_UNUSED(removeAllRequested);
 
-    const QList<MissionItem*>& rallyItems = missionItems();
+    const MissionItemStore& rallyItems = missionItems();
 
     for (int i=0; i<rallyItems.count(); i++) {
-        MissionItem* item = rallyItems[i];
+        const MissionItemStore::Item_t& item = rallyItems[i];
 
-        MAV_CMD command = item->command();
+        MAV_CMD command = rallyItems.command(i);
 
         if (command == MAV_CMD_NAV_RALLY_POINT) {
-            _rgPoints.append(QGeoCoordinate(item->param5(), item->param6(), item->param7()));
+            _rgPoints.append(QGeoCoordinate(item.param5, item.param6, item.param7));
         } else {
-            qCDebug(RallyPointManagerLog) << "RallyPointManager load: Unsupported command %1" << item->command();
+            qCDebug(RallyPointManagerLog) << "RallyPointManager load: Unsupported command %1" << command;
             break;
         }
     }
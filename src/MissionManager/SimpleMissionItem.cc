@@ -58,13 +58,6 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact             (0, "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact                     (0, "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact          (0, "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData                   (FactMetaData::valueTypeDouble)
-    , _param2MetaData                   (FactMetaData::valueTypeDouble)
-    , _param3MetaData                   (FactMetaData::valueTypeDouble)
-    , _param4MetaData                   (FactMetaData::valueTypeDouble)
-    , _param5MetaData                   (FactMetaData::valueTypeDouble)
-    , _param6MetaData                   (FactMetaData::valueTypeDouble)
-    , _param7MetaData                   (FactMetaData::valueTypeDouble)
 {
     _editorQml = QStringLiteral("qrc:/qml/SimpleItemEditor.qml");
 
@@ -87,13 +80,23 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact     (0,         "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact             (0,         "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact  (0,         "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData           (FactMetaData::valueTypeDouble)
-    , _param2MetaData           (FactMetaData::valueTypeDouble)
-    , _param3MetaData           (FactMetaData::valueTypeDouble)
-    , _param4MetaData           (FactMetaData::valueTypeDouble)
-    , _param5MetaData           (FactMetaData::valueTypeDouble)
-    , _param6MetaData           (FactMetaData::valueTypeDouble)
-    , _param7MetaData           (FactMetaData::valueTypeDouble)
+{
+    _initFromMissionItem();
+}
+
+/// Creates the item straight from the compact store, without going through a temporary MissionItem
+SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, bool flyView, const MissionItemStore& missionItems, int index)
+    : VisualMissionItem         (masterController, flyView)
+    , _commandTree              (qgcApp()->toolbox()->missionCommandTree())
+    , _supportedCommandFact     (0,         "Command:",             FactMetaData::valueTypeUint32)
+    , _altitudeFact             (0,         "Altitude",             FactMetaData::valueTypeDouble)
+    , _amslAltAboveTerrainFact  (0,         "Alt above terrain",    FactMetaData::valueTypeDouble)
+{
+    missionItems.toMissionItem(index, _missionItem);
+    _initFromMissionItem();
+}
+
+void SimpleMissionItem::_initFromMissionItem(void)
 {
     _editorQml = QStringLiteral("qrc:/qml/SimpleItemEditor.qml");
 
@@ -110,13 +113,13 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     _altitudeMode = QGroundControlQmlGlobal::AltitudeModeRelative;
     for (size_t i=0; i<sizeof(rgMavFrame2AltMode)/sizeof(rgMavFrame2AltMode[0]); i++) {
         const MavFrame2AltMode_s& pMavFrame2AltMode = rgMavFrame2AltMode[i];
-        if (pMavFrame2AltMode.mavFrame == missionItem.frame()) {
+        if (pMavFrame2AltMode.mavFrame == _missionItem.frame()) {
             _altitudeMode = pMavFrame2AltMode.altMode;
             break;
         }
     }
 
-    _isCurrentItem = missionItem.isCurrentItem();
+    _isCurrentItem = _missionItem.isCurrentItem();
     _altitudeFact.setRawValue(specifiesAltitude() ? _missionItem._param7Fact.rawValue() : qQNaN());
     _amslAltAboveTerrainFact.setRawValue(qQNaN());
 
@@ -274,23 +277,30 @@ SimpleMissionItem::~SimpleMissionItem()
 
 void SimpleMissionItem::save(QJsonArray&  missionItems)
 {
-    QList<MissionItem*> items;
+    // The main simple item is saved straight from its facts along with the alt/terrain data
+    QJsonObject saveObject;
+    _missionItem.save(saveObject);
+    if (specifiesAltitude()) {
+        saveObject[_jsonAltitudeModeKey] =          _altitudeMode;
+        saveObject[_jsonAltitudeKey] =              _altitudeFact.rawValue().toDouble();
+        saveObject[_jsonAMSLAltAboveTerrainKey] =   _amslAltAboveTerrainFact.rawValue().toDouble();
+    }
+    missionItems.append(saveObject);
+
+    // Only items which have their sections created can have section items
+    if (!_cameraSection) {
+        return;
+    }
 
-    appendMissionItems(items, this);
+    QList<MissionItem*> sectionItems;
+    int                 seqNum = sequenceNumber() + 1;
 
-    for (int i=0; i<items.count(); i++) {
-        MissionItem* item = items[i];
-        QJsonObject saveObject;
-        item->save(saveObject);
-        if (i == 0) {
-            // This is the main simple item, save the alt/terrain data
-            if (specifiesAltitude()) {
-                saveObject[_jsonAltitudeModeKey] =          _altitudeMode;
-                saveObject[_jsonAltitudeKey] =              _altitudeFact.rawValue().toDouble();
-                saveObject[_jsonAMSLAltAboveTerrainKey] =   _amslAltAboveTerrainFact.rawValue().toDouble();
-            }
-        }
-        missionItems.append(saveObject);
+    _cameraSection->appendSectionItems(sectionItems, this, seqNum);
+    _speedSection->appendSectionItems(sectionItems, this, seqNum);
+    for (MissionItem* item: sectionItems) {
+        QJsonObject sectionObject;
+        item->save(sectionObject);
+        missionItems.append(sectionObject);
         item->deleteLater();
     }
 }
@@ -429,30 +439,30 @@ QString SimpleMissionItem::abbreviation() const
 
 void SimpleMissionItem::_rebuildTextFieldFacts(void)
 {
-    _textFieldFacts.clear();
+    _textFieldFacts->clear();
     
     if (rawEdit()) {
         _missionItem._param1Fact._setName("Param1");
         _missionItem._param1Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param1Fact);
+        _textFieldFacts->append(&_missionItem._param1Fact);
         _missionItem._param2Fact._setName("Param2");
         _missionItem._param2Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param2Fact);
+        _textFieldFacts->append(&_missionItem._param2Fact);
         _missionItem._param3Fact._setName("Param3");
         _missionItem._param3Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param3Fact);
+        _textFieldFacts->append(&_missionItem._param3Fact);
         _missionItem._param4Fact._setName("Param4");
         _missionItem._param4Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param4Fact);
+        _textFieldFacts->append(&_missionItem._param4Fact);
         _missionItem._param5Fact._setName("Lat/X");
         _missionItem._param5Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param5Fact);
+        _textFieldFacts->append(&_missionItem._param5Fact);
         _missionItem._param6Fact._setName("Lon/Y");
         _missionItem._param6Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param6Fact);
+        _textFieldFacts->append(&_missionItem._param6Fact);
         _missionItem._param7Fact._setName("Alt/Z");
         _missionItem._param7Fact.setMetaData(_defaultParamMetaData);
-        _textFieldFacts.append(&_missionItem._param7Fact);
+        _textFieldFacts->append(&_missionItem._param7Fact);
     } else {
         _ignoreDirtyChangeSignals = true;
 
@@ -464,7 +474,6 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, _previousVTOLMode, command);
 
@@ -475,13 +484,13 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
 
                 if (showUI && paramInfo && paramInfo->enumStrings().count() == 0 && !paramInfo->nanUnchanged()) {
                     Fact*               paramFact =     rgParamFacts[i-1];
-                    FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                    FactMetaData*       paramMetaData = _rgParamMetaData[i-1];
 
                     paramFact->_setName(paramInfo->label());
                     paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
                     paramMetaData->setRawUnits(paramInfo->units());
                     paramFact->setMetaData(paramMetaData);
-                    _textFieldFacts.append(paramFact);
+                    _textFieldFacts->append(paramFact);
                 }
             }
         }
@@ -492,7 +501,7 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
 
 void SimpleMissionItem::_rebuildNaNFacts(void)
 {
-    _nanFacts.clear();
+    _nanFacts->clear();
 
     if (!rawEdit()) {
         _ignoreDirtyChangeSignals = true;
@@ -505,7 +514,6 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, _previousVTOLMode, command);
 
@@ -523,13 +531,13 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
                     }
 
                     Fact*               paramFact =     rgParamFacts[i-1];
-                    FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                    FactMetaData*       paramMetaData = _rgParamMetaData[i-1];
 
                     paramFact->_setName(paramInfo->label());
                     paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
                     paramMetaData->setRawUnits(paramInfo->units());
                     paramFact->setMetaData(paramMetaData);
-                    _nanFacts.append(paramFact);
+                    _nanFacts->append(paramFact);
                 }
             }
         }
@@ -569,14 +577,13 @@ double SimpleMissionItem::loiterRadius() const
 
 void SimpleMissionItem::_rebuildComboBoxFacts(void)
 {
-    _comboboxFacts.clear();
+    _comboboxFacts->clear();
 
     if (rawEdit()) {
-        _comboboxFacts.append(&_missionItem._commandFact);
-        _comboboxFacts.append(&_missionItem._frameFact);
+        _comboboxFacts->append(&_missionItem._commandFact);
+        _comboboxFacts->append(&_missionItem._frameFact);
     } else {
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         MAV_CMD command;
         if (_homePositionSpecialCase) {
@@ -591,14 +598,14 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
             if (showUI && paramInfo && paramInfo->enumStrings().count() != 0) {
                 Fact*               paramFact =     rgParamFacts[i-1];
-                FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                FactMetaData*       paramMetaData = _rgParamMetaData[i-1];
 
                 paramFact->_setName(paramInfo->label());
                 paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
                 paramMetaData->setEnumInfo(paramInfo->enumStrings(), paramInfo->enumValues());
                 paramMetaData->setRawUnits(paramInfo->units());
                 paramFact->setMetaData(paramMetaData);
-                _comboboxFacts.append(paramFact);
+                _comboboxFacts->append(paramFact);
             }
         }
     }
@@ -606,11 +613,35 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
 void SimpleMissionItem::_rebuildFacts(void)
 {
+    if (!_textFieldFacts) {
+        // Editing ui state has not been created yet, it is built when first needed
+        return;
+    }
+
     _rebuildTextFieldFacts();
     _rebuildNaNFacts();
     _rebuildComboBoxFacts();
 }
 
+void SimpleMissionItem::_createEditFacts(void)
+{
+    if (_textFieldFacts) {
+        return;
+    }
+
+    _textFieldFacts =   new QmlObjectListModel(this);
+    _nanFacts =         new QmlObjectListModel(this);
+    _comboboxFacts =    new QmlObjectListModel(this);
+    for (int i=0; i<7; i++) {
+        _rgParamMetaData[i] = new FactMetaData(FactMetaData::valueTypeDouble, this);
+    }
+
+    // In flyView we skip building the editing facts to save memory
+    if (!_flyView) {
+        _rebuildFacts();
+    }
+}
+
 bool SimpleMissionItem::friendlyEditAllowed(void) const
 {
     const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, _previousVTOLMode, static_cast<MAV_CMD>(command()));
@@ -654,7 +685,7 @@ void SimpleMissionItem::setDirty(bool dirty)
 {
     if (!_homePositionSpecialCase || (_dirty != dirty)) {
         _dirty = dirty;
-        if (!dirty) {
+        if (!dirty && _cameraSection) {
             _cameraSection->setDirty(false);
             _speedSection->setDirty(false);
         }
@@ -876,7 +907,7 @@ void SimpleMissionItem::setSequenceNumber(int sequenceNumber)
 
 double SimpleMissionItem::specifiedFlightSpeed(void)
 {
-    if (_speedSection->specifyFlightSpeed()) {
+    if (_speedSection && _speedSection->specifyFlightSpeed()) {
         return _speedSection->flightSpeed()->rawValue().toDouble();
     } else {
         return missionItem().specifiedFlightSpeed();
@@ -885,12 +916,12 @@ double SimpleMissionItem::specifiedFlightSpeed(void)
 
 double SimpleMissionItem::specifiedGimbalYaw(void)
 {
-    return _cameraSection->available() ? _cameraSection->specifiedGimbalYaw() : missionItem().specifiedGimbalYaw();
+    return _cameraSection && _cameraSection->available() ? _cameraSection->specifiedGimbalYaw() : missionItem().specifiedGimbalYaw();
 }
 
 double SimpleMissionItem::specifiedGimbalPitch(void)
 {
-    return _cameraSection->available() ? _cameraSection->specifiedGimbalPitch() : missionItem().specifiedGimbalPitch();
+    return _cameraSection && _cameraSection->available() ? _cameraSection->specifiedGimbalPitch() : missionItem().specifiedGimbalPitch();
 }
 
 double SimpleMissionItem::specifiedVehicleYaw(void)
@@ -909,6 +940,18 @@ bool SimpleMissionItem::scanForSections(QmlObjectListModel* visualItems, int sca
 {
     bool sectionFound = false;
 
+    if (!_sectionsAvailable || scanIndex >= visualItems->count()) {
+        return false;
+    }
+
+    // Section settings are only made up of commands without a coordinate. Checking for one first means items followed
+    // by another waypoint, which is most of a large plan, never create their sections.
+    SimpleMissionItem* nextItem = visualItems->value<SimpleMissionItem*>(scanIndex);
+    if (!nextItem || nextItem->specifiesCoordinate()) {
+        return false;
+    }
+
+    _createSections();
     if (_cameraSection->available()) {
         sectionFound |= _cameraSection->scanForSection(visualItems, scanIndex);
     }
@@ -921,7 +964,7 @@ bool SimpleMissionItem::scanForSections(QmlObjectListModel* visualItems, int sca
 
 void SimpleMissionItem::_updateOptionalSections(void)
 {
-    // Remove previous sections
+    // Remove previous sections, new ones are created when they are next needed
     if (_cameraSection) {
         _cameraSection->deleteLater();
         _cameraSection = nullptr;
@@ -931,14 +974,28 @@ void SimpleMissionItem::_updateOptionalSections(void)
         _speedSection = nullptr;
     }
 
-    // Add new sections
+    _sectionsAvailable = static_cast<MAV_CMD>(command()) == MAV_CMD_NAV_WAYPOINT;
+
+    emit cameraSectionChanged(_cameraSection);
+    emit speedSectionChanged(_speedSection);
+    emit lastSequenceNumberChanged(lastSequenceNumber());
+}
+
+void SimpleMissionItem::_createSections(void)
+{
+    if (_cameraSection) {
+        return;
+    }
 
     _cameraSection = new CameraSection(_masterController, this);
     _speedSection = new SpeedSection(_masterController, this);
-    if (static_cast<MAV_CMD>(command()) == MAV_CMD_NAV_WAYPOINT) {
+    if (_sectionsAvailable) {
         _cameraSection->setAvailable(true);
         _speedSection->setAvailable(true);
+        _applyFlightStatusToSections();
     }
+    _cameraSection->setDirty(false);
+    _speedSection->setDirty(false);
 
     connect(_cameraSection, &CameraSection::dirtyChanged,                   this, &SimpleMissionItem::_sectionDirtyChanged);
     connect(_cameraSection, &CameraSection::itemCountChanged,               this, &SimpleMissionItem::_updateLastSequenceNumber);
@@ -950,10 +1007,6 @@ void SimpleMissionItem::_updateOptionalSections(void)
     connect(_speedSection,  &SpeedSection::dirtyChanged,                this, &SimpleMissionItem::_sectionDirtyChanged);
     connect(_speedSection,  &SpeedSection::itemCountChanged,            this, &SimpleMissionItem::_updateLastSequenceNumber);
     connect(_speedSection,  &SpeedSection::specifiedFlightSpeedChanged, this, &SimpleMissionItem::specifiedFlightSpeedChanged);
-
-    emit cameraSectionChanged(_cameraSection);
-    emit speedSectionChanged(_speedSection);
-    emit lastSequenceNumberChanged(lastSequenceNumber());
 }
 
 int SimpleMissionItem::lastSequenceNumber(void) const
@@ -980,8 +1033,10 @@ void SimpleMissionItem::appendMissionItems(QList<MissionItem*>& items, QObject*
     items.append(new MissionItem(missionItem(), missionItemParent));
     seqNum++;
 
-    _cameraSection->appendSectionItems(items, missionItemParent, seqNum);
-    _speedSection->appendSectionItems(items, missionItemParent, seqNum);
+    if (_cameraSection) {
+        _cameraSection->appendSectionItems(items, missionItemParent, seqNum);
+        _speedSection->appendSectionItems(items, missionItemParent, seqNum);
+    }
 }
 
 void SimpleMissionItem::applyNewAltitude(double newAltitude)
@@ -1006,16 +1061,26 @@ void SimpleMissionItem::setMissionFlightStatus(MissionController::MissionFlightS
 {
     VisualMissionItem::setMissionFlightStatus(missionFlightStatus);
 
+    _flightStatusVehicleSpeed = missionFlightStatus.vehicleSpeed;
+    _flightStatusGimbalYaw =    missionFlightStatus.gimbalYaw;
+    _flightStatusGimbalPitch =  missionFlightStatus.gimbalPitch;
+    if (_cameraSection) {
+        _applyFlightStatusToSections();
+    }
+}
+
+void SimpleMissionItem::_applyFlightStatusToSections(void)
+{
     // If speed and/or gimbal are not specifically set on this item. Then use the flight status values as initial defaults should a user turn them on.
-    if (_speedSection->available() && !_speedSection->specifyFlightSpeed() && !QGC::fuzzyCompare(_speedSection->flightSpeed()->rawValue().toDouble(), missionFlightStatus.vehicleSpeed)) {
-        _speedSection->flightSpeed()->setRawValue(missionFlightStatus.vehicleSpeed);
+    if (_speedSection->available() && !_speedSection->specifyFlightSpeed() && !qIsNaN(_flightStatusVehicleSpeed) && !QGC::fuzzyCompare(_speedSection->flightSpeed()->rawValue().toDouble(), _flightStatusVehicleSpeed)) {
+        _speedSection->flightSpeed()->setRawValue(_flightStatusVehicleSpeed);
     }
     if (_cameraSection->available() && !_cameraSection->specifyGimbal()) {
-        if (!qIsNaN(missionFlightStatus.gimbalYaw) && !QGC::fuzzyCompare(_cameraSection->gimbalYaw()->rawValue().toDouble(), missionFlightStatus.gimbalYaw)) {
-            _cameraSection->gimbalYaw()->setRawValue(missionFlightStatus.gimbalYaw);
+        if (!qIsNaN(_flightStatusGimbalYaw) && !QGC::fuzzyCompare(_cameraSection->gimbalYaw()->rawValue().toDouble(), _flightStatusGimbalYaw)) {
+            _cameraSection->gimbalYaw()->setRawValue(_flightStatusGimbalYaw);
         }
-        if (!qIsNaN(missionFlightStatus.gimbalPitch) && !QGC::fuzzyCompare(_cameraSection->gimbalPitch()->rawValue().toDouble(), missionFlightStatus.gimbalPitch)) {
-            _cameraSection->gimbalPitch()->setRawValue(missionFlightStatus.gimbalPitch);
+        if (!qIsNaN(_flightStatusGimbalPitch) && !QGC::fuzzyCompare(_cameraSection->gimbalPitch()->rawValue().toDouble(), _flightStatusGimbalPitch)) {
+            _cameraSection->gimbalPitch()->setRawValue(_flightStatusGimbalPitch);
         }
     }
 }
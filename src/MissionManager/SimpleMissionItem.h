@@ -13,19 +13,26 @@
 
 #include "VisualMissionItem.h"
 #include "MissionItem.h"
+#include "MissionItemStore.h"
 #include "MissionCommandTree.h"
 #include "CameraSection.h"
 #include "SpeedSection.h"
 #include "QGroundControlQmlGlobal.h"
 
 /// A SimpleMissionItem is used to represent a single MissionItem to the ui.
+///
+/// The editing ui state (per param meta data, the fact lists and the camera/speed sections) is only created once the
+/// item is selected or edited, so the bulk of the items in a large plan stay small.
 class SimpleMissionItem : public VisualMissionItem
 {
     Q_OBJECT
+
+    friend class SimpleMissionItemTest; // Unit test
     
 public:
     SimpleMissionItem(PlanMasterController* masterController, bool flyView, bool forLoad);
     SimpleMissionItem(PlanMasterController* masterController, bool flyView, const MissionItem& missionItem);
+    SimpleMissionItem(PlanMasterController* masterController, bool flyView, const MissionItemStore& missionItems, int index);
 
     ~SimpleMissionItem();
 
@@ -77,12 +84,12 @@ public:
     bool            showLoiterRadius    (void) const;
     double          loiterRadius        (void) const;
 
-    CameraSection*  cameraSection       (void) { return _cameraSection; }
-    SpeedSection*   speedSection        (void) { return _speedSection; }
+    CameraSection*  cameraSection       (void) { _createSections(); return _cameraSection; }
+    SpeedSection*   speedSection        (void) { _createSections(); return _speedSection; }
 
-    QmlObjectListModel* textFieldFacts  (void) { return &_textFieldFacts; }
-    QmlObjectListModel* nanFacts        (void) { return &_nanFacts; }
-    QmlObjectListModel* comboboxFacts   (void) { return &_comboboxFacts; }
+    QmlObjectListModel* textFieldFacts  (void) { _createEditFacts(); return _textFieldFacts; }
+    QmlObjectListModel* nanFacts        (void) { _createEditFacts(); return _nanFacts; }
+    QmlObjectListModel* comboboxFacts   (void) { _createEditFacts(); return _comboboxFacts; }
 
     void setRawEdit(bool rawEdit);
     void setAltitudeMode(QGroundControlQmlGlobal::AltMode altitudeMode);
@@ -167,19 +174,29 @@ private slots:
     void _possibleRadiusChanged                 (void);
 
 private:
-    void _connectSignals        (void);
-    void _setupMetaData         (void);
-    void _updateOptionalSections(void);
-    void _rebuildNaNFacts       (void);
-    void _rebuildComboBoxFacts  (void);
+    void _initFromMissionItem           (void);
+    void _connectSignals                (void);
+    void _setupMetaData                 (void);
+    void _updateOptionalSections        (void);
+    void _createSections                (void);
+    void _applyFlightStatusToSections   (void);
+    void _createEditFacts               (void);
+    void _rebuildNaNFacts               (void);
+    void _rebuildComboBoxFacts          (void);
 
     MissionItem     _missionItem;
     bool            _rawEdit =                  false;
     bool            _dirty =                    false;
     bool            _ignoreDirtyChangeSignals = false;
     QGeoCoordinate  _mapCenterHint;
-    SpeedSection*   _speedSection =             nullptr;
+    SpeedSection*   _speedSection =             nullptr;    ///< Created on first use, see _createSections
     CameraSection*  _cameraSection =             nullptr;
+    bool            _sectionsAvailable =        false;      ///< true: command supports the camera/speed sections
+
+    // Last flight status values, applied to the sections when they are created
+    double          _flightStatusVehicleSpeed = qQNaN();
+    double          _flightStatusGimbalYaw =    qQNaN();
+    double          _flightStatusGimbalPitch =  qQNaN();
 
     MissionCommandTree* _commandTree = nullptr;
     bool _syncingHeadingDegreesAndParam4 = false;   ///< true: already in a sync signal, prevents signal loop
@@ -190,9 +207,11 @@ private:
     Fact                                _altitudeFact;
     Fact                                _amslAltAboveTerrainFact;
 
-    QmlObjectListModel  _textFieldFacts;
-    QmlObjectListModel  _nanFacts;
-    QmlObjectListModel  _comboboxFacts;
+    // Editing ui state, created on first use by _createEditFacts
+    QmlObjectListModel* _textFieldFacts =       nullptr;
+    QmlObjectListModel* _nanFacts =             nullptr;
+    QmlObjectListModel* _comboboxFacts =        nullptr;
+    FactMetaData*       _rgParamMetaData[7] =   { };
     
     static FactMetaData*    _altitudeMetaData;
     static FactMetaData*    _commandMetaData;
@@ -201,14 +220,6 @@ private:
     static FactMetaData*    _latitudeMetaData;
     static FactMetaData*    _longitudeMetaData;
 
-    FactMetaData    _param1MetaData;
-    FactMetaData    _param2MetaData;
-    FactMetaData    _param3MetaData;
-    FactMetaData    _param4MetaData;
-    FactMetaData    _param5MetaData;
-    FactMetaData    _param6MetaData;
-    FactMetaData    _param7MetaData;
-
     static const char* _jsonAltitudeModeKey;
     static const char* _jsonAltitudeKey;
     static const char* _jsonAMSLAltAboveTerrainKey;
@@ -395,3 +395,32 @@ void SimpleMissionItemTest::_testAltitudePropogation(void)
     QCOMPARE(_simpleItem->altitude()->rawValue().toDouble(), _simpleItem->missionItem().param7());
     QCOMPARE(_simpleItem->missionItem().frame(), MAV_FRAME_GLOBAL);
 }
+
+void SimpleMissionItemTest::_testLazyEditState(void)
+{
+    MissionItemStore missionItems;
+    missionItems.append(1, MAV_CMD_NAV_WAYPOINT, MAV_FRAME_GLOBAL_RELATIVE_ALT, 0, 0, 0, 0, 47.6, -122.3, 50, true /* autoContinue */, false /* isCurrentItem */);
+
+    SimpleMissionItem simpleItem(_masterController, false /* flyView */, missionItems, 0);
+    QCOMPARE(simpleItem.command(), static_cast<int>(MAV_CMD_NAV_WAYPOINT));
+    QCOMPARE(simpleItem.sequenceNumber(), 1);
+    QCOMPARE(simpleItem.missionItem().param5(), 47.6);
+    QCOMPARE(simpleItem.missionItem().param6(), -122.3);
+    QCOMPARE(simpleItem.altitude()->rawValue().toDouble(), 50.0);
+
+    // Editing state is not created by construction or save
+    QJsonArray json;
+    simpleItem.save(json);
+    QCOMPARE(json.count(), 1);
+    QVERIFY(!simpleItem._cameraSection);
+    QVERIFY(!simpleItem._speedSection);
+    QVERIFY(!simpleItem._textFieldFacts);
+
+    // It is created as soon as the editing ui asks for it
+    QVERIFY(simpleItem.speedSection()->available());
+    QVERIFY(simpleItem.cameraSection()->available());
+    QVERIFY(simpleItem.textFieldFacts());
+    QVERIFY(simpleItem._nanFacts);
+    QVERIFY(simpleItem._comboboxFacts);
+    QVERIFY(!simpleItem.dirty());
+}
@@ -42,6 +42,13 @@ TakeoffMissionItem::TakeoffMissionItem(const MissionItem& missionItem, PlanMaste
     _init(forLoad);
 }
 
+TakeoffMissionItem::TakeoffMissionItem(const MissionItemStore& missionItems, int index, PlanMasterController* masterController, bool flyView, MissionSettingsItem* settingsItem, bool forLoad)
+    : SimpleMissionItem (masterController, flyView, missionItems, index)
+    , _settingsItem     (settingsItem)
+{
+    _init(forLoad);
+}
+
 TakeoffMissionItem::~TakeoffMissionItem()
 {
 
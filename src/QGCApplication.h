@@ -88,7 +88,7 @@ public:
     /// Is Internet available?
     bool isInternetAvailable();
 
-    FactGroup* gpsRtkFactGroup(void)  { return _gpsRtkFactGroup; }
+    GPSRTKFactGroup* gpsRtkFactGroup(void)  { return _gpsRtkFactGroup; }
 
     QTranslator& qgcJSONTranslator(void) { return _qgcTranslatorJSON; }
 
@@ -10,8 +10,12 @@
 #include "FlightPathSegment.h"
 #include "QGC.h"
 
+#include <cmath>
+
 QGC_LOGGING_CATEGORY(FlightPathSegmentLog, "FlightPathSegmentLog")
 
+Q_GLOBAL_STATIC(FlightPathSegmentTerrainBatchManager, _terrainBatchManager)
+
 FlightPathSegment::FlightPathSegment(SegmentType segmentType, const QGeoCoordinate& coord1, double amslCoord1Alt, const QGeoCoordinate& coord2, double amslCoord2Alt, bool queryTerrainData, QObject* parent)
     : QObject           (parent)
     , _coord1           (coord1)
@@ -21,14 +25,18 @@ FlightPathSegment::FlightPathSegment(SegmentType segmentType, const QGeoCoordina
     , _queryTerrainData (queryTerrainData)
     , _segmentType      (segmentType)
 {
-    _delayedTerrainPathQueryTimer.setSingleShot(true);
-    _delayedTerrainPathQueryTimer.setInterval(200);
-    _delayedTerrainPathQueryTimer.callOnTimeout(this, &FlightPathSegment::_sendTerrainPathQuery);
     _updateTotalDistance();
 
     qCDebug(FlightPathSegmentLog) << this << "new" << coord1 << coord2 << amslCoord1Alt << amslCoord2Alt << _totalDistance;
 
-    _sendTerrainPathQuery();
+    _queueTerrainQuery();
+}
+
+FlightPathSegment::~FlightPathSegment()
+{
+    if (_queryTerrainData && _terrainBatchManager.exists()) {
+        _terrainBatchManager->removeSegment(this);
+    }
 }
 
 void FlightPathSegment::setCoordinate1(const QGeoCoordinate &coordinate)
@@ -36,7 +44,7 @@ void FlightPathSegment::setCoordinate1(const QGeoCoordinate &coordinate)
     if (_coord1 != coordinate) {
         _coord1 = coordinate;
         emit coordinate1Changed(_coord1);
-        _delayedTerrainPathQueryTimer.start();
+        _queueTerrainQuery();
         _updateTotalDistance();
     }
 }
@@ -46,7 +54,7 @@ void FlightPathSegment::setCoordinate2(const QGeoCoordinate &coordinate)
     if (_coord2 != coordinate) {
         _coord2 = coordinate;
         emit coordinate2Changed(_coord2);
-        _delayedTerrainPathQueryTimer.start();
+        _queueTerrainQuery();
         _updateTotalDistance();
     }
 }
@@ -77,53 +85,48 @@ void FlightPathSegment::setSpecialVisual(bool specialVisual)
     }
 }
 
-void FlightPathSegment::_sendTerrainPathQuery(void)
+void FlightPathSegment::_queueTerrainQuery(void)
 {
-    if (_queryTerrainData && _coord1.isValid() && _coord2.isValid()) {
-        qCDebug(FlightPathSegmentLog) << this << "_sendTerrainPathQuery";
-        // Clear any previous query
-        if (_currentTerrainPathQuery) {
-            // We are already waiting on another query. We don't care about those results any more.
-            disconnect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-            _currentTerrainPathQuery = nullptr;
-        }
-
-        // Clear old terrain data
-        _amslTerrainHeights.clear();
-        _distanceBetween = 0;
-        _finalDistanceBetween = 0;
-        emit distanceBetweenChanged(0);
-        emit finalDistanceBetweenChanged(0);
-        emit amslTerrainHeightsChanged();
-
-        _currentTerrainPathQuery = new TerrainPathQuery(true /* autoDelete */);
-        connect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-        _currentTerrainPathQuery->requestData(_coord1, _coord2);
+    if (_queryTerrainData) {
+        _terrainBatchManager->addSegment(this);
     }
 }
 
-void FlightPathSegment::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
+void FlightPathSegment::_clearTerrainHeights(void)
 {
-    qCDebug(FlightPathSegmentLog) << this << "_terrainDataReceived" << success << pathHeightInfo.heights.count();
-    if (success) {
-        if (!QGC::fuzzyCompare(pathHeightInfo.distanceBetween, _distanceBetween)) {
-            _distanceBetween = pathHeightInfo.distanceBetween;
-            emit distanceBetweenChanged(_distanceBetween);
-        }
-        if (!QGC::fuzzyCompare(pathHeightInfo.finalDistanceBetween, _finalDistanceBetween)) {
-            _finalDistanceBetween = pathHeightInfo.finalDistanceBetween;
-            emit finalDistanceBetweenChanged(_finalDistanceBetween);
-        }
+    _amslTerrainHeights.clear();
+    _minAMSLTerrainHeight = qQNaN();
+    _maxAMSLTerrainHeight = qQNaN();
+    _distanceBetween = 0;
+    _finalDistanceBetween = 0;
+    emit distanceBetweenChanged(0);
+    emit finalDistanceBetweenChanged(0);
+    emit amslTerrainHeightsChanged();
+}
 
-        _amslTerrainHeights.clear();
-        for (const double& amslTerrainHeight: pathHeightInfo.heights) {
-            _amslTerrainHeights.append(amslTerrainHeight);
-        }
-        emit amslTerrainHeightsChanged();
+void FlightPathSegment::_setTerrainHeights(double distanceBetween, double finalDistanceBetween, const QList<double>& heights, int firstIndex, int cHeights)
+{
+    qCDebug(FlightPathSegmentLog) << this << "_setTerrainHeights" << cHeights;
+
+    if (!QGC::fuzzyCompare(distanceBetween, _distanceBetween)) {
+        _distanceBetween = distanceBetween;
+        emit distanceBetweenChanged(_distanceBetween);
+    }
+    if (!QGC::fuzzyCompare(finalDistanceBetween, _finalDistanceBetween)) {
+        _finalDistanceBetween = finalDistanceBetween;
+        emit finalDistanceBetweenChanged(_finalDistanceBetween);
     }
 
-    _currentTerrainPathQuery->deleteLater();
-    _currentTerrainPathQuery = nullptr;
+    _amslTerrainHeights.resize(cHeights);
+    _minAMSLTerrainHeight = qQNaN();
+    _maxAMSLTerrainHeight = qQNaN();
+    for (int i=0; i<cHeights; i++) {
+        double height = heights[firstIndex + i];
+        _amslTerrainHeights[i] = static_cast<float>(height);
+        _minAMSLTerrainHeight = std::fmin(_minAMSLTerrainHeight, height);
+        _maxAMSLTerrainHeight = std::fmax(_maxAMSLTerrainHeight, height);
+    }
+    emit amslTerrainHeightsChanged();
 
     _updateTerrainCollision();
 }
@@ -143,14 +146,21 @@ void FlightPathSegment::_updateTotalDistance(void)
 
 void FlightPathSegment::_updateTerrainCollision(void)
 {
-    bool newTerrainCollision = false;
+    bool    newTerrainCollision     = false;
+    double  newMinTerrainClearance  = qQNaN();
 
-    if (_segmentType != SegmentTypeTerrainFrame) {
+    if (_segmentType == SegmentTypeTerrainFrame) {
+        if (_amslTerrainHeights.count()) {
+            newMinTerrainClearance = _coord1AMSLAlt - _amslTerrainHeights.first();
+        }
+    } else {
         double slope =      (_coord2AMSLAlt - _coord1AMSLAlt) / _totalDistance;
         double yIntercept = _coord1AMSLAlt;
 
-        double x = 0;
-        for (int i=0; i<_amslTerrainHeights.count(); i++) {
+        const int       cHeights    = _amslTerrainHeights.count();
+        const float*    heights     = _amslTerrainHeights.constData();
+        double          x           = 0;
+        for (int i=0; i<cHeights; i++) {
             bool ignoreCollision = false;
             if (_segmentType == SegmentTypeTakeoff && x < _collisionIgnoreMeters) {
                 ignoreCollision = true;
@@ -159,14 +169,14 @@ void FlightPathSegment::_updateTerrainCollision(void)
             }
 
             if (!ignoreCollision) {
-                double y = _amslTerrainHeights[i].value<double>();
-                if (y > (slope * x) + yIntercept) {
+                double clearance = (slope * x) + yIntercept - heights[i];
+                if (clearance < 0) {
                     newTerrainCollision = true;
-                    break;
                 }
+                newMinTerrainClearance = std::fmin(newMinTerrainClearance, clearance);
             }
 
-            if (i == _amslTerrainHeights.count() - 2) {
+            if (i == cHeights - 2) {
                 x += _finalDistanceBetween;
             } else {
                 x += _distanceBetween;
@@ -174,10 +184,138 @@ void FlightPathSegment::_updateTerrainCollision(void)
         }
     }
 
-    qCDebug(FlightPathSegmentLog) << this << "_updateTerrainCollision new:old" << newTerrainCollision << _terrainCollision;
+    qCDebug(FlightPathSegmentLog) << this << "_updateTerrainCollision new:old" << newTerrainCollision << _terrainCollision << newMinTerrainClearance;
 
     if (newTerrainCollision != _terrainCollision) {
         _terrainCollision = newTerrainCollision;
         emit terrainCollisionChanged(_terrainCollision);
     }
+    if (!QGC::fuzzyCompare(newMinTerrainClearance, _minTerrainClearance)) {
+        _minTerrainClearance = newMinTerrainClearance;
+        emit minTerrainClearanceChanged(_minTerrainClearance);
+    }
+}
+
+FlightPathSegmentTerrainBatchManager::FlightPathSegmentTerrainBatchManager(void)
+{
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(_batchDelayMSecs);
+    connect(&_batchTimer,   &QTimer::timeout,                               this, &FlightPathSegmentTerrainBatchManager::_sendBatch);
+    connect(&_terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &FlightPathSegmentTerrainBatchManager::_coordinateHeights);
+}
+
+void FlightPathSegmentTerrainBatchManager::addSegment(FlightPathSegment* segment)
+{
+    // Any outstanding results for this segment are now stale. They are dropped when they come back since the segment is
+    // dirty again. Restarting the timer holds off the query while the user is still dragging things around.
+    _dirtySegments.insert(segment);
+    _fallbackSegments.removeAll(segment);
+    _batchTimer.start();
+}
+
+void FlightPathSegmentTerrainBatchManager::removeSegment(FlightPathSegment* segment)
+{
+    _dirtySegments.remove(segment);
+    _fallbackSegments.removeAll(segment);
+    for (SentSegmentInfo_t& sentSegmentInfo: _sentSegments) {
+        if (sentSegmentInfo.segment == segment) {
+            sentSegmentInfo.segment = nullptr;
+        }
+    }
+}
+
+void FlightPathSegmentTerrainBatchManager::_appendSentSegment(FlightPathSegment* segment, QList<QGeoCoordinate>& coords)
+{
+    if (!segment->coordinate1().isValid() || !segment->coordinate2().isValid()) {
+        return;
+    }
+
+    SentSegmentInfo_t sentSegmentInfo;
+    QList<QGeoCoordinate> pathCoords = TerrainTileManager::pathQueryToCoords(segment->coordinate1(), segment->coordinate2(), sentSegmentInfo.distanceBetween, sentSegmentInfo.finalDistanceBetween);
+    sentSegmentInfo.segment = segment;
+    sentSegmentInfo.cCoord  = pathCoords.count();
+    _sentSegments.append(sentSegmentInfo);
+    coords += pathCoords;
+
+    segment->_clearTerrainHeights();
+}
+
+void FlightPathSegmentTerrainBatchManager::_sendBatch(void)
+{
+    if (_querying) {
+        // Wait for the outstanding batch to complete
+        _batchTimer.start();
+        return;
+    }
+
+    QList<QGeoCoordinate> coords;
+
+    _sentSegments.clear();
+    if (_fallbackSegments.count()) {
+        // Finish querying the segments of a failed batch one at a time before starting a new batch
+        _appendSentSegment(_fallbackSegments.takeFirst(), coords);
+    } else {
+        for (FlightPathSegment* segment: _dirtySegments) {
+            _appendSentSegment(segment, coords);
+        }
+        _dirtySegments.clear();
+    }
+
+    qCDebug(FlightPathSegmentLog) << "FlightPathSegmentTerrainBatchManager::_sendBatch segments:coords" << _sentSegments.count() << coords.count();
+
+    if (coords.count()) {
+        _querying = true;
+        _terrainQuery.requestCoordinateHeights(coords);
+    } else {
+        _sendNext();
+    }
+}
+
+/// Queues the next query once the current one is complete
+void FlightPathSegmentTerrainBatchManager::_sendNext(void)
+{
+    if (_fallbackSegments.count()) {
+        // Queued rather than called directly since results from the tile cache may come back before the query returns
+        QTimer::singleShot(0, this, &FlightPathSegmentTerrainBatchManager::_sendBatch);
+    } else if (_dirtySegments.count() && !_batchTimer.isActive()) {
+        _batchTimer.start();
+    }
+}
+
+void FlightPathSegmentTerrainBatchManager::_coordinateHeights(bool success, QList<double> heights)
+{
+    qCDebug(FlightPathSegmentLog) << "FlightPathSegmentTerrainBatchManager::_coordinateHeights success:count" << success << heights.count();
+
+    _querying = false;
+
+    if (!success && _sentSegments.count() > 1) {
+        // Query the segments again one at a time so the ones which can be resolved still get their heights
+        for (const SentSegmentInfo_t& sentSegmentInfo: _sentSegments) {
+            if (sentSegmentInfo.segment && !_dirtySegments.contains(sentSegmentInfo.segment)) {
+                _fallbackSegments.append(sentSegmentInfo.segment);
+            }
+        }
+        _sentSegments.clear();
+        _sendNext();
+        return;
+    }
+
+    // Signalling a segment may delete or requery other segments, which nulls them out in _sentSegments or marks them
+    // dirty. So the list is walked by index and only cleared at the end.
+    int heightIndex = 0;
+    for (int i=0; i<_sentSegments.count(); i++) {
+        const SentSegmentInfo_t sentSegmentInfo = _sentSegments[i];
+        FlightPathSegment* segment = sentSegmentInfo.segment;
+        if (segment && !_dirtySegments.contains(segment)) {
+            if (success && heightIndex + sentSegmentInfo.cCoord <= heights.count()) {
+                segment->_setTerrainHeights(sentSegmentInfo.distanceBetween, sentSegmentInfo.finalDistanceBetween, heights, heightIndex, sentSegmentInfo.cCoord);
+            } else {
+                segment->_updateTerrainCollision();
+            }
+        }
+        heightIndex += sentSegmentInfo.cCoord;
+    }
+    _sentSegments.clear();
+
+    _sendNext();
 }
@@ -12,6 +12,8 @@
 #include <QObject>
 #include <QGeoCoordinate>
 #include <QTimer>
+#include <QVector>
+#include <QSet>
 
 #include "TerrainQuery.h"
 #include "QGCLoggingCategory.h"
@@ -33,29 +35,33 @@ public:
     Q_ENUM(SegmentType)
 
     FlightPathSegment(SegmentType segmentType, const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt, bool queryTerrainData, QObject* parent);
+    ~FlightPathSegment();
 
     Q_PROPERTY(QGeoCoordinate   coordinate1             MEMBER _coord1                                          NOTIFY coordinate1Changed)
     Q_PROPERTY(QGeoCoordinate   coordinate2             MEMBER _coord2                                          NOTIFY coordinate2Changed)
     Q_PROPERTY(double           coord1AMSLAlt           MEMBER _coord1AMSLAlt                                   NOTIFY coord1AMSLAltChanged)
     Q_PROPERTY(double           coord2AMSLAlt           MEMBER _coord2AMSLAlt                                   NOTIFY coord2AMSLAltChanged)
     Q_PROPERTY(bool             specialVisual           READ specialVisual              WRITE setSpecialVisual  NOTIFY specialVisualChanged)
-    Q_PROPERTY(QVariantList     amslTerrainHeights      MEMBER _amslTerrainHeights                              NOTIFY amslTerrainHeightsChanged)
     Q_PROPERTY(double           distanceBetween         MEMBER _distanceBetween                                 NOTIFY distanceBetweenChanged)
     Q_PROPERTY(double           finalDistanceBetween    MEMBER _finalDistanceBetween                            NOTIFY finalDistanceBetweenChanged)
     Q_PROPERTY(double           totalDistance           MEMBER _totalDistance                                   NOTIFY totalDistanceChanged)
     Q_PROPERTY(bool             terrainCollision        MEMBER _terrainCollision                                NOTIFY terrainCollisionChanged)
+    Q_PROPERTY(double           minTerrainClearance     MEMBER _minTerrainClearance                             NOTIFY minTerrainClearanceChanged)
     Q_PROPERTY(SegmentType      segmentType             MEMBER _segmentType                                     CONSTANT)
 
     QGeoCoordinate      coordinate1         (void) const { return _coord1; }
     QGeoCoordinate      coordinate2         (void) const { return _coord2; }
     double              coord1AMSLAlt       (void) const { return _coord1AMSLAlt; }
     double              coord2AMSLAlt       (void) const { return _coord2AMSLAlt; }
-    const QVariantList& amslTerrainHeights  (void) const { return _amslTerrainHeights; }
+    const QVector<float>& amslTerrainHeights(void) const { return _amslTerrainHeights; }
+    double              minAMSLTerrainHeight(void) const { return _minAMSLTerrainHeight; }  ///< NaN if no terrain heights
+    double              maxAMSLTerrainHeight(void) const { return _maxAMSLTerrainHeight; }  ///< NaN if no terrain heights
     double              distanceBetween     (void) const { return _distanceBetween; }
     double              finalDistanceBetween(void) const { return _finalDistanceBetween; }
     double              totalDistance       (void) const { return _totalDistance; }
     bool                specialVisual       (void) const { return _specialVisual; }
     bool                terrainCollision    (void) const { return _terrainCollision; }
+    double              minTerrainClearance (void) const { return _minTerrainClearance; }   ///< Lowest height of the flight path above terrain, NaN if unknown
     SegmentType         segmentType         (void) const { return _segmentType; }
 
     void setSpecialVisual(bool specialVisual);
@@ -77,14 +83,17 @@ signals:
     void finalDistanceBetweenChanged(double finalDistanceBetween);
     void totalDistanceChanged       (double totalDistance);
     void terrainCollisionChanged    (bool terrainCollision);
+    void minTerrainClearanceChanged (double minTerrainClearance);
 
 private slots:
-    void _sendTerrainPathQuery      (void);
-    void _terrainDataReceived       (bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
     void _updateTotalDistance       (void);
     void _updateTerrainCollision    (void);
 
 private:
+    void _queueTerrainQuery         (void);
+    void _clearTerrainHeights       (void);
+    void _setTerrainHeights         (double distanceBetween, double finalDistanceBetween, const QList<double>& heights, int firstIndex, int cHeights);
+
     QGeoCoordinate      _coord1;
     QGeoCoordinate      _coord2;
     double              _coord1AMSLAlt =                qQNaN();
@@ -92,13 +101,56 @@ private:
     bool                _queryTerrainData;
     bool                _terrainCollision =             false;
     bool                _specialVisual =                false;
-    QTimer              _delayedTerrainPathQueryTimer;
-    TerrainPathQuery*   _currentTerrainPathQuery =      nullptr;
-    QVariantList        _amslTerrainHeights;
+    QVector<float>      _amslTerrainHeights;
+    double              _minAMSLTerrainHeight =         qQNaN();
+    double              _maxAMSLTerrainHeight =         qQNaN();
+    double              _minTerrainClearance =          qQNaN();
     double              _distanceBetween =              0;
     double              _finalDistanceBetween =         0;
     double              _totalDistance =                0;
     SegmentType         _segmentType =                  SegmentTypeGeneric;
 
     static constexpr double _collisionIgnoreMeters =    10; // Distance to ignore for takeoff/land segments
+
+    friend class FlightPathSegmentTerrainBatchManager;
+};
+
+/// Used internally by FlightPathSegment to query terrain for all segments of a plan together. Segments which need new
+/// terrain heights are collected for a short delay, then the paths of all of them are sampled with a single coordinate
+/// query against the terrain tile cache and the heights are split back out to each segment. A batch fails as a whole if
+/// any of its tiles is missing, in which case its segments are queried again one at a time so only the segments over the
+/// missing tiles go without heights.
+class FlightPathSegmentTerrainBatchManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    FlightPathSegmentTerrainBatchManager(void);
+
+    void addSegment     (FlightPathSegment* segment);
+    void removeSegment  (FlightPathSegment* segment);
+
+private slots:
+    void _sendBatch         (void);
+    void _coordinateHeights (bool success, QList<double> heights);
+
+private:
+    void _appendSentSegment (FlightPathSegment* segment, QList<QGeoCoordinate>& coords);
+    void _sendNext          (void);
+
+    typedef struct {
+        FlightPathSegment*  segment;                ///< nullptr if segment was deleted or requeried while batch was outstanding
+        int                 cCoord;
+        double              distanceBetween;
+        double              finalDistanceBetween;
+    } SentSegmentInfo_t;
+
+    QSet<FlightPathSegment*>    _dirtySegments;
+    QList<FlightPathSegment*>   _fallbackSegments;      ///< Segments from a failed batch still to be queried one at a time
+    QList<SentSegmentInfo_t>    _sentSegments;
+    bool                        _querying = false;
+    QTimer                      _batchTimer;
+    TerrainOfflineAirMapQuery   _terrainQuery;
+
+    static const int _batchDelayMSecs = 200;
 };
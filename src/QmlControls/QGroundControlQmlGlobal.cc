@@ -9,8 +9,11 @@
 
 #include "QGroundControlQmlGlobal.h"
 #include "LinkManager.h"
+#include "TelemetryRecorder.h"
 
 #include <QSettings>
+#include <QDir>
+#include <QFileInfo>
 #include <QLineF>
 #include <QPointF>
 
@@ -205,6 +208,17 @@ bool QGroundControlQmlGlobal::apmFirmwareSupported()
     return _firmwarePluginManager->supportedFirmwareClasses().contains(QGCMAVLink::FirmwareClassArduPilot);
 }
 
+QString QGroundControlQmlGlobal::exportTelemetryRecordingToCsv(const QString& recordingFile)
+{
+    QFileInfo   recordingInfo(recordingFile);
+    QString     csvFile = recordingInfo.dir().absoluteFilePath(recordingInfo.completeBaseName() + QStringLiteral(".csv"));
+    QString     errorMsg;
+
+    TelemetryRecorder::exportCsv(recordingFile, csvFile, errorMsg);
+
+    return errorMsg;
+}
+
 bool QGroundControlQmlGlobal::linesIntersect(QPointF line1A, QPointF line1B, QPointF line2A, QPointF line2B)
 {
     QPointF intersectPoint;
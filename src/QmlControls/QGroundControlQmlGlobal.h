@@ -141,6 +141,10 @@ public:
     /// Updates the logging filter rules after settings have changed
     Q_INVOKABLE void updateLoggingFilterRules(void) { QGCLoggingCategoryRegister::instance()->setFilterRulesFromSettings(QString()); }
 
+    /// Converts a telemetry recording to a csv file with the same name next to it
+    /// @return Error message, empty if successful
+    Q_INVOKABLE QString exportTelemetryRecordingToCsv(const QString& recordingFile);
+
     Q_INVOKABLE bool linesIntersect(QPointF xLine1, QPointF yLine1, QPointF xLine2, QPointF yLine2);
 
     Q_INVOKABLE QString altitudeModeExtraUnits(AltMode altMode);        ///< String shown in the FactTextField.extraUnits ui
@@ -89,10 +89,8 @@ void TerrainProfile::_updateSegmentCounts(FlightPathSegment* segment, int& cFlig
         cMissingTerrainSegments += 1;
     } else {
         cTerrainProfilePoints += segment->amslTerrainHeights().count();
-        for (int i=0; i<segment->amslTerrainHeights().count(); i++) {
-            minTerrainHeight = std::fmin(minTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-            maxTerrainHeight = std::fmax(maxTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-        }
+        minTerrainHeight = std::fmin(minTerrainHeight, segment->minAMSLTerrainHeight());
+        maxTerrainHeight = std::fmax(maxTerrainHeight, segment->maxAMSLTerrainHeight());
     }
     if (segment->terrainCollision()) {
         cTerrainCollisionSegments++;
@@ -115,7 +113,7 @@ void TerrainProfile::_addTerrainProfileSegment(FlightPathSegment* segment, doubl
         }
 
         // Move along the y axis which is a view or terrain height as a percentage between the min/max AMSL altitude for all segments
-        double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>();
+        double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex];
         double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
 
         float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
@@ -162,7 +160,7 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
 
     if (segment->segmentType() == FlightPathSegment::SegmentTypeTerrainFrame) {
         double terrainDistance = 0;
-        double distanceToSurface = segment->coord1AMSLAlt() - segment->amslTerrainHeights().first().value<double>();
+        double distanceToSurface = segment->coord1AMSLAlt() - segment->amslTerrainHeights().first();
         for (int heightIndex=0; heightIndex<segment->amslTerrainHeights().count(); heightIndex++) {
             // Move along the x axis which is distance
             if (heightIndex == 0) {
@@ -182,7 +180,7 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
             }
 
             // Add second coord of segment (or very first one)
-            double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>() + distanceToSurface;
+            double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex] + distanceToSurface;
             double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
 
             float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
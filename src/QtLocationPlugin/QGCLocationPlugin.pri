@@ -16,6 +16,7 @@ HEADERS += \
     $$PWD/QGCMapEngineData.h \
     $$PWD/QGCMapTileSet.h \
     $$PWD/QGCMapUrlEngine.h \
+    $$PWD/QGCTileCacheReader.h \
     $$PWD/QGCTileCacheWorker.h \
     $$PWD/QGeoCodeReplyQGC.h \
     $$PWD/QGeoCodingManagerEngineQGC.h \
@@ -37,6 +38,7 @@ SOURCES += \
     $$PWD/QGCMapEngine.cpp \
     $$PWD/QGCMapTileSet.cpp \
     $$PWD/QGCMapUrlEngine.cpp \
+    $$PWD/QGCTileCacheReader.cpp \
     $$PWD/QGCTileCacheWorker.cpp \
     $$PWD/QGeoCodeReplyQGC.cpp \
     $$PWD/QGeoCodingManagerEngineQGC.cpp \
@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Map Tile Cache Reader Thread
+ *
+ */
+
+#include "QGCTileCacheReader.h"
+#include "QGCTileCacheWorker.h"
+#include "QGCMapEngine.h"
+
+#include <QVariant>
+#include <QSqlError>
+#include <QDebug>
+#include <QReadLocker>
+
+//-----------------------------------------------------------------------------
+QGCCacheReader::QGCCacheReader(QGCCacheWorker* worker, int id)
+    : _worker(worker)
+    , _session(QStringLiteral("QGeoTileReaderSession%1").arg(id))
+{
+}
+
+//-----------------------------------------------------------------------------
+QGCCacheReader::~QGCCacheReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::quit()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    while(_taskQueue.count()) {
+        QGCMapTask* task = _taskQueue.dequeue();
+        delete task;
+    }
+    lock.unlock();
+    if(this->isRunning()) {
+        _waitc.wakeAll();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::enqueueTask(QGCMapTask* task)
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    _taskQueue.enqueue(task);
+    lock.unlock();
+    if(this->isRunning()) {
+        _waitc.wakeAll();
+    } else {
+        this->start(QThread::HighPriority);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int
+QGCCacheReader::pendingCount()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    return _taskQueue.count();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::releaseDatabase()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    if(this->isRunning()) {
+        _waitc.wakeAll();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::run()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    while(true) {
+        if(_taskQueue.count()) {
+            lock.unlock();
+            _runTasks();
+            lock.relock();
+        } else {
+            //-- Wait a bit before shutting things down, unless the worker wants the database back
+            if(!_worker->_databaseReleaseRequested) {
+                unsigned long timeoutMilliseconds = 5000;
+                _waitc.wait(lock.mutex(), timeoutMilliseconds);
+            }
+            //-- If nothing to do, leave thread
+            if(!_taskQueue.count()) {
+                break;
+            }
+        }
+    }
+    lock.unlock();
+    //-- The connection belongs to this thread
+    _disconnectDB();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::_runTasks()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    while(_taskQueue.count()) {
+        if(_worker->_databaseReleaseRequested) {
+            //-- The worker is about to replace or reset the database. Let go of it, the next connect waits
+            //   for the worker to finish.
+            lock.unlock();
+            _disconnectDB();
+            lock.relock();
+        }
+        QGCMapTask* task = _taskQueue.dequeue();
+        lock.unlock();
+        if(_connectDB()) {
+            _getTile(task);
+        } else {
+            task->setError("No Cache Database");
+        }
+        task->deleteLater();
+        lock.relock();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::_getTile(QGCMapTask* mtask)
+{
+    bool found = false;
+    QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
+    quint64 tileID       = 0;
+    bool    lookupByHash = false;
+    {
+        QReadLocker indexLock(&_worker->_tileIndexLock);
+        lookupByHash = !_worker->_tileIndexValid;
+        tileID       = _worker->_indexedTileID(task->hash());
+    }
+    QSqlQuery* query = nullptr;
+    if(tileID) {
+        //-- The index holds every tile, so a miss doesn't need to touch the database at all
+        _selectTileByIDQuery->bindValue(0, tileID);
+        if(_selectTileByIDQuery->exec() && _selectTileByIDQuery->next()) {
+            query = _selectTileByIDQuery.data();
+        }
+    }
+    if(lookupByHash) {
+        _selectTileQuery->bindValue(0, task->hash());
+        if(_selectTileQuery->exec() && _selectTileQuery->next()) {
+            query = _selectTileQuery.data();
+        }
+    }
+    if(query) {
+        QByteArray ar   = query->value(0).toByteArray();
+        QString format  = query->value(1).toString();
+        QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query->value(2).toInt());
+        query->finish();
+        qCDebug(QGCTileCacheLog) << "_getTile() (Found in DB) HASH:" << task->hash();
+        QGCCacheTile* tile = new QGCCacheTile(task->hash(), ar, format, type);
+        task->setTileFetched(tile);
+        found = true;
+    }
+    if(!found) {
+        qCDebug(QGCTileCacheLog) << "_getTile() (NOT in DB) HASH:" << task->hash();
+        task->setError("Tile not in cache database");
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheReader::_connectDB()
+{
+    if(_db) {
+        return true;
+    }
+    //-- Held for as long as the connection is open, see _disconnectDB()
+    _worker->_databaseLock.lockForRead();
+    QString databasePath;
+    if(!_worker->_readerDatabase(databasePath)) {
+        _worker->_databaseLock.unlock();
+        return false;
+    }
+    _db.reset(new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", _session)));
+    _db->setDatabaseName(databasePath);
+    //-- Deliberately no shared cache, it would put us back under table level locking against the writer
+    if(!_db->open()) {
+        qCWarning(QGCTileCacheLog) << "Map Cache SQL error (reader open db):" << _db->lastError();
+        _disconnectDB();
+        return false;
+    }
+    _selectTileQuery.reset(new QSqlQuery(*_db));
+    _selectTileQuery->setForwardOnly(true);
+    _selectTileQuery->prepare("SELECT tile, format, type FROM Tiles WHERE hash = ?");
+    _selectTileByIDQuery.reset(new QSqlQuery(*_db));
+    _selectTileByIDQuery->setForwardOnly(true);
+    _selectTileByIDQuery->prepare("SELECT tile, format, type FROM Tiles WHERE tileID = ?");
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheReader::_disconnectDB()
+{
+    _selectTileQuery.reset();
+    _selectTileByIDQuery.reset();
+    if (_db) {
+        _db.reset();
+        QSqlDatabase::removeDatabase(_session);
+        _worker->_databaseLock.unlock();
+    }
+}
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Map Tile Cache Reader Thread
+ *
+ */
+
+#ifndef QGC_TILE_CACHE_READER_H
+#define QGC_TILE_CACHE_READER_H
+
+#include <QString>
+#include <QThread>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+class QGCMapTask;
+class QGCCacheWorker;
+
+//-----------------------------------------------------------------------------
+/// Serves tile fetches from its own read only connection to the cache database, so lookups aren't queued behind
+/// the writes, imports and exports running on the QGCCacheWorker thread. The connection and its prepared statements
+/// stay open until the thread goes idle or the worker asks for the database back.
+class QGCCacheReader : public QThread
+{
+    Q_OBJECT
+
+    friend class QGCTileCacheWorkerTest; // Unit test
+
+public:
+    QGCCacheReader  (QGCCacheWorker* worker, int id);
+    ~QGCCacheReader ();
+
+    void    quit            ();
+    void    enqueueTask     (QGCMapTask* task);
+    int     pendingCount    ();
+    void    releaseDatabase ();     ///< Wakes the thread so it closes its connection, see QGCCacheWorker::_releaseReaders()
+
+protected:
+    void    run             ();
+
+private:
+    void        _runTasks               ();
+    void        _getTile                (QGCMapTask* mtask);
+    bool        _connectDB              ();
+    void        _disconnectDB           ();
+
+private:
+    QGCCacheWorker*                 _worker;
+    QString                         _session;
+    QQueue<QGCMapTask*>             _taskQueue;
+    QMutex                          _taskQueueMutex;
+    QWaitCondition                  _waitc;
+    QScopedPointer<QSqlDatabase>    _db;
+    QScopedPointer<QSqlQuery>       _selectTileQuery;           ///< Tile by hash
+    QScopedPointer<QSqlQuery>       _selectTileByIDQuery;       ///< Tile by tileID
+};
+
+#endif // QGC_TILE_CACHE_READER_H
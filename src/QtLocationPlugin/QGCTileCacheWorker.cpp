@@ -18,6 +18,7 @@
 
 #include "QGCMapEngine.h"
 #include "QGCMapTileSet.h"
+#include "QGCTileCacheReader.h"
 
 #include <QVariant>
 #include <QtSql/QSqlQuery>
@@ -27,6 +28,7 @@
 #include <QApplication>
 #include <QFile>
 #include <QSettings>
+#include <QWriteLocker>
 
 #include "time.h"
 
@@ -54,18 +56,30 @@ QGCCacheWorker::QGCCacheWorker()
     , _lastUpdate(0)
     , _updateTimeout(SHORT_TIMEOUT)
     , _hostLookupID(0)
+    , _tileIndexValid(false)
+    , _databaseReleaseRequested(false)
 {
+    int readerCount = qBound(2, QThread::idealThreadCount() / 2, 4);
+    for(int i = 0; i < readerCount; i++) {
+        _readers.append(new QGCCacheReader(this, i));
+    }
 }
 
 //-----------------------------------------------------------------------------
 QGCCacheWorker::~QGCCacheWorker()
 {
+    for(QGCCacheReader* reader: _readers) {
+        reader->quit();
+        reader->wait();
+    }
+    qDeleteAll(_readers);
 }
 
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::setDatabaseFile(const QString& path)
 {
+    QMutexLocker lock(&_databasePathMutex);
     _databasePath = path;
 }
 
@@ -76,6 +90,9 @@ QGCCacheWorker::quit()
     if(_hostLookupID) {
         QHostInfo::abortHostLookup(_hostLookupID);
     }
+    for(QGCCacheReader* reader: _readers) {
+        reader->quit();
+    }
     QMutexLocker lock(&_taskQueueMutex);
     while(_taskQueue.count()) {
         QGCMapTask* task = _taskQueue.dequeue();
@@ -97,13 +114,27 @@ QGCCacheWorker::enqueueTask(QGCMapTask* task)
         task->deleteLater();
         return false;
     }
+    //-- Tile lookups go to the least busy reader so they never wait on writes
+    if(task->type() == QGCMapTask::taskFetchTile) {
+        QGCCacheReader* reader      = _readers.first();
+        int             readerCount = reader->pendingCount();
+        for(int i = 1; i < _readers.count() && readerCount; i++) {
+            int count = _readers[i]->pendingCount();
+            if(count < readerCount) {
+                reader      = _readers[i];
+                readerCount = count;
+            }
+        }
+        reader->enqueueTask(task);
+        return true;
+    }
     QMutexLocker lock(&_taskQueueMutex);
     _taskQueue.enqueue(task);
     lock.unlock(); // don't need to hold the mutex any more
     if(this->isRunning()) {
         _waitc.wakeAll();
     } else {
-        this->start(QThread::HighPriority);
+        this->start(QThread::LowPriority);
     }
     return true;
 }
@@ -117,6 +148,11 @@ QGCCacheWorker::run()
     }
     if(_valid) {
         _connectDB();
+        _prepareQueries();
+        //-- The index outlives the connection, it only needs loading the first time through
+        if(!_tileIndexValid) {
+            _loadTileIndex();
+        }
     }
     _deleteBingNoTileTiles();
     QMutexLocker lock(&_taskQueueMutex);
@@ -124,12 +160,25 @@ QGCCacheWorker::run()
         QGCMapTask* task;
         if(_taskQueue.count()) {
             task = _taskQueue.dequeue();
-
-            // Don't need the lock while running the task.
-            lock.unlock();
-            _runTask(task);
-            lock.relock();
-            task->deleteLater();
+            if(task->type() == QGCMapTask::taskCacheTile) {
+                //-- Coalesce consecutive tile saves into a single transaction
+                QList<QGCMapTask*> saveTasks { task };
+                while(_taskQueue.count() && saveTasks.count() < _maxSaveBatch && _taskQueue.head()->type() == QGCMapTask::taskCacheTile) {
+                    saveTasks.append(_taskQueue.dequeue());
+                }
+                lock.unlock();
+                _saveTiles(saveTasks);
+                lock.relock();
+                for(QGCMapTask* saveTask: saveTasks) {
+                    saveTask->deleteLater();
+                }
+            } else {
+                // Don't need the lock while running the task.
+                lock.unlock();
+                _runTask(task);
+                lock.relock();
+                task->deleteLater();
+            }
             //-- Check for update timeout
             size_t count = static_cast<size_t>(_taskQueue.count());
             if(count > 100) {
@@ -171,8 +220,8 @@ QGCCacheWorker::_runTask(QGCMapTask *task)
             _saveTile(task);
             return;
         case QGCMapTask::taskFetchTile:
-            _getTile(task);
-            return;
+            //-- Served by the reader threads, see enqueueTask()
+            break;
         case QGCMapTask::taskFetchTileSets:
             _getTileSets(task);
             return;
@@ -238,6 +287,7 @@ QGCCacheWorker::_deleteBingNoTileTiles()
         while(query.next()) {
             if (query.value(1).toByteArray() == noTileBytes) {
                 idsToDelete.append(query.value(0).toULongLong());
+                _removeFromTileIndex(query.value(2).toString());
                 qCDebug(QGCTileCacheLog) << "_deleteBingNoTileTiles HASH:" << query.value(2).toString();
             }
         }
@@ -290,26 +340,31 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 {
     if(_valid) {
         QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(mtask);
-        QSqlQuery query(*_db);
-        query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-        query.addBindValue(task->tile()->hash());
-        query.addBindValue(task->tile()->format());
-        query.addBindValue(task->tile()->img());
-        query.addBindValue(task->tile()->img().size());
-        query.addBindValue(task->tile()->type());
-        query.addBindValue(QDateTime::currentDateTime().toTime_t());
-        if(query.exec()) {
-            quint64 tileID = query.lastInsertId().toULongLong();
+        QString hash = task->tile()->hash();
+        if(_tileIndexValid && _indexedTileID(hash)) {
+            //-- Tile was already there.
+            //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
+            return;
+        }
+        QByteArray img = task->tile()->img();
+        _insertTileQuery->bindValue(0, hash);
+        _insertTileQuery->bindValue(1, task->tile()->format());
+        _insertTileQuery->bindValue(2, img);
+        _insertTileQuery->bindValue(3, img.size());
+        _insertTileQuery->bindValue(4, task->tile()->type());
+        _insertTileQuery->bindValue(5, QDateTime::currentDateTime().toTime_t());
+        if(_insertTileQuery->exec()) {
+            quint64 tileID = _insertTileQuery->lastInsertId().toULongLong();
             quint64 setID = task->tile()->set() == UINT64_MAX ? _getDefaultTileSet() : task->tile()->set();
-            QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-            query.prepare(s);
-            if(!query.exec()) {
-                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+            _addToTileIndex(hash, tileID);
+            _insertSetTileQuery->bindValue(0, tileID);
+            _insertSetTileQuery->bindValue(1, setID);
+            if(!_insertSetTileQuery->exec()) {
+                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << _insertSetTileQuery->lastError().text();
             }
-            qCDebug(QGCTileCacheLog) << "_saveTile() HASH:" << task->tile()->hash();
+            qCDebug(QGCTileCacheLog) << "_saveTile() HASH:" << hash;
         } else {
             //-- Tile was already there.
-            //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
         }
     } else {
         qWarning() << "Map Cache SQL error (saveTile() open db):" << _db->lastError();
@@ -318,29 +373,15 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 
 //-----------------------------------------------------------------------------
 void
-QGCCacheWorker::_getTile(QGCMapTask* mtask)
+QGCCacheWorker::_saveTiles(const QList<QGCMapTask*>& tasks)
 {
-    if(!_testTask(mtask)) {
-        return;
-    }
-    bool found = false;
-    QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
-    QSqlQuery query(*_db);
-    QString s = QString("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
-    if(query.exec(s)) {
-        if(query.next()) {
-            QByteArray ar   = query.value(0).toByteArray();
-            QString format  = query.value(1).toString();
-            QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query.value(2).toInt());
-            qCDebug(QGCTileCacheLog) << "_getTile() (Found in DB) HASH:" << task->hash();
-            QGCCacheTile* tile = new QGCCacheTile(task->hash(), ar, format, type);
-            task->setTileFetched(tile);
-            found = true;
-        }
+    //-- One transaction for the whole batch instead of one per Tiles and SetTiles insert
+    bool transaction = _valid && _db->transaction();
+    for(QGCMapTask* task: tasks) {
+        _saveTile(task);
     }
-    if(!found) {
-        qCDebug(QGCTileCacheLog) << "_getTile() (NOT in DB) HASH:" << task->hash();
-        task->setError("Tile not in cache database");
+    if(transaction && !_db->commit()) {
+        qWarning() << "Map Cache SQL error (commit tile batch):" << _db->lastError();
     }
 }
 
@@ -464,19 +505,105 @@ QGCCacheWorker::_updateTotals()
 }
 
 //-----------------------------------------------------------------------------
-quint64 QGCCacheWorker::_findTile(const QString hash)
+quint64 QGCCacheWorker::_findTile(const QString& hash)
 {
+    if(_tileIndexValid) {
+        return _indexedTileID(hash);
+    }
     quint64 tileID = 0;
-    QSqlQuery query(*_db);
-    QString s = QString("SELECT tileID FROM Tiles WHERE hash = \"%1\"").arg(hash);
-    if(query.exec(s)) {
-        if(query.next()) {
-            tileID = query.value(0).toULongLong();
+    _selectTileIDQuery->bindValue(0, hash);
+    if(_selectTileIDQuery->exec()) {
+        if(_selectTileIDQuery->next()) {
+            tileID = _selectTileIDQuery->value(0).toULongLong();
         }
+        _selectTileIDQuery->finish();
     }
     return tileID;
 }
 
+//-----------------------------------------------------------------------------
+quint64
+QGCCacheWorker::_tileIndexKey(const QString& hash)
+{
+    //-- 64 bit FNV-1a
+    quint64 key = 14695981039346656037ULL;
+    const ushort* data = hash.utf16();
+    for(int i = 0; i < hash.length(); i++) {
+        key ^= data[i];
+        key *= 1099511628211ULL;
+    }
+    return key;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_loadTileIndex()
+{
+    {
+        QWriteLocker indexLock(&_tileIndexLock);
+        _tileIDs.clear();
+        _tileIndexValid = false;
+    }
+    if(!_valid) {
+        return;
+    }
+    //-- Build it without holding the lock so readers can carry on using the database meanwhile
+    QMultiHash<quint64, TileIndexEntry_t> tileIDs;
+    QSqlQuery query(*_db);
+    query.setForwardOnly(true);
+    if(query.exec("SELECT COUNT(tileID) FROM Tiles") && query.next()) {
+        tileIDs.reserve(query.value(0).toInt());
+    }
+    if(!query.exec("SELECT tileID, hash FROM Tiles")) {
+        qCWarning(QGCTileCacheLog) << "Map Cache SQL error (load tile index):" << query.lastError().text();
+        return;
+    }
+    while(query.next()) {
+        QString hash = query.value(1).toString();
+        tileIDs.insert(_tileIndexKey(hash), { query.value(0).toULongLong(), hash });
+    }
+    QWriteLocker indexLock(&_tileIndexLock);
+    _tileIDs.swap(tileIDs);
+    _tileIndexValid = true;
+    qCDebug(QGCTileCacheLog) << "_loadTileIndex() tiles:" << _tileIDs.count();
+}
+
+//-----------------------------------------------------------------------------
+/// @return tileID from the index, 0 if not there. Callers off the worker thread must hold _tileIndexLock.
+quint64
+QGCCacheWorker::_indexedTileID(const QString& hash) const
+{
+    const quint64 key = _tileIndexKey(hash);
+    for(auto it = _tileIDs.constFind(key); it != _tileIDs.cend() && it.key() == key; ++it) {
+        if(it.value().hash == hash) {
+            return it.value().tileID;
+        }
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_addToTileIndex(const QString& hash, quint64 tileID)
+{
+    QWriteLocker indexLock(&_tileIndexLock);
+    _tileIDs.insert(_tileIndexKey(hash), { tileID, hash });
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_removeFromTileIndex(const QString& hash)
+{
+    const quint64 key = _tileIndexKey(hash);
+    QWriteLocker indexLock(&_tileIndexLock);
+    for(auto it = _tileIDs.find(key); it != _tileIDs.end() && it.key() == key; ++it) {
+        if(it.value().hash == hash) {
+            _tileIDs.erase(it);
+            return;
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
@@ -509,12 +636,14 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
             //-- Prepare Download List
             quint64 tileCount = 0;
             _db->transaction();
+            query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
             for(int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
                 QGCTileSet set = QGCMapEngine::getTileCount(z,
                     task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
                     task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
                 tileCount += set.tileCount;
-                QString type = task->tileSet()->type();
+                QString type    = task->tileSet()->type();
+                int     typeId  = getQGCMapEngine()->urlFactory()->getIdFromType(type);
                 for(int x = set.tileX0; x <= set.tileX1; x++) {
                     for(int y = set.tileY0; y <= set.tileY1; y++) {
                         //-- See if tile is already downloaded
@@ -522,26 +651,26 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
                         quint64 tileID = _findTile(hash);
                         if(!tileID) {
                             //-- Set to download
-                            query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
-                            query.addBindValue(setID);
-                            query.addBindValue(hash);
-                            query.addBindValue(getQGCMapEngine()->urlFactory()->getIdFromType(type));
-                            query.addBindValue(x);
-                            query.addBindValue(y);
-                            query.addBindValue(z);
-                            query.addBindValue(0);
+                            query.bindValue(0, setID);
+                            query.bindValue(1, hash);
+                            query.bindValue(2, typeId);
+                            query.bindValue(3, x);
+                            query.bindValue(4, y);
+                            query.bindValue(5, z);
+                            query.bindValue(6, 0);
                             if(!query.exec()) {
                                 qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
+                                _db->rollback();
                                 mtask->setError("Error creating tile set download list");
                                 return;
                             } else
                                 actual_count++;
                         } else {
                             //-- Tile already in the database. No need to dowload.
-                            QString s = QString("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-                            query.prepare(s);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+                            _insertSetTileQuery->bindValue(0, tileID);
+                            _insertSetTileQuery->bindValue(1, setID);
+                            if(!_insertSetTileQuery->exec()) {
+                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << _insertSetTileQuery->lastError().text();
                             }
                             qCDebug(QGCTileCacheLog) << "_createTileSet() Already Cached HASH:" << hash;
                         }
@@ -631,6 +760,7 @@ QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
         while(query.next() && amount >= 0) {
             tlist << query.value(0).toULongLong();
             amount -= query.value(1).toULongLong();
+            _removeFromTileIndex(query.value(2).toString());
             qCDebug(QGCTileCacheLog) << "_pruneCache() HASH:" << query.value(2).toString();
         }
         while(tlist.count()) {
@@ -662,7 +792,19 @@ QGCCacheWorker::_deleteTileSet(qulonglong id)
     QSqlQuery query(*_db);
     QString s;
     //-- Only delete tiles unique to this set
-    s = QString("DELETE FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1)").arg(id);
+    QString uniqueTiles = QString("SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1").arg(id);
+    if(_tileIndexValid) {
+        s = QString("SELECT hash FROM Tiles WHERE tileID IN (%1)").arg(uniqueTiles);
+        if(query.exec(s)) {
+            while(query.next()) {
+                _removeFromTileIndex(query.value(0).toString());
+            }
+        } else {
+            QWriteLocker indexLock(&_tileIndexLock);
+            _tileIndexValid = false;
+        }
+    }
+    s = QString("DELETE FROM Tiles WHERE tileID IN (%1)").arg(uniqueTiles);
     query.exec(s);
     s = QString("DELETE FROM TilesDownload WHERE setID = %1").arg(id);
     query.exec(s);
@@ -697,6 +839,12 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
         return;
     }
     QGCResetTask* task = static_cast<QGCResetTask*>(mtask);
+    //-- Wait for the readers to let go of the database
+    _releaseReaders();
+    QWriteLocker dbLock(&_databaseLock);
+    _databaseReleaseRequested = false;
+    //-- Prepared statements hold on to the tables being dropped
+    _resetQueries();
     QSqlQuery query(*_db);
     QString s;
     s = QString("DROP TABLE Tiles");
@@ -707,7 +855,10 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     query.exec(s);
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
+    _defaultSet = UINT64_MAX;
     _valid = _createDB(*_db);
+    _prepareQueries();
+    _loadTileIndex();
     task->setResetCompleted();
 }
 
@@ -721,18 +872,28 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
     QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
     //-- If replacing, simply copy over it
     if(task->replace()) {
+        //-- Wait for the readers to let go of the database
+        _releaseReaders();
+        QWriteLocker dbLock(&_databaseLock);
+        _databaseReleaseRequested = false;
         //-- Close and delete old database
         _disconnectDB();
         QFile file(_databasePath);
         file.remove();
+        //-- Don't let a stale write-ahead log get applied to the copied database
+        QFile::remove(_databasePath + "-wal");
+        QFile::remove(_databasePath + "-shm");
         //-- Copy given database
         QFile::copy(task->path(), _databasePath);
         task->setProgress(25);
+        _defaultSet = UINT64_MAX;
         _init();
         if(_valid) {
             task->setProgress(50);
             _connectDB();
+            _prepareQueries();
         }
+        _loadTileIndex();
         task->setProgress(100);
     } else {
         //-- Open imported set
@@ -835,10 +996,16 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                                 if(cQuery.exec()) {
                                     tilesSaved++;
                                     quint64 importTileID = cQuery.lastInsertId().toULongLong();
+                                    _addToTileIndex(hash, importTileID);
                                     QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(importTileID).arg(insertSetID);
                                     cQuery.prepare(s);
                                     cQuery.exec();
                                     currentCount++;
+                                    //-- Commit in chunks to keep the write-ahead log from growing without bound on large imports
+                                    if(tilesSaved % 1000 == 0) {
+                                        _db->commit();
+                                        _db->transaction();
+                                    }
                                     if(tileCount) {
                                         int progress = (int)((double)currentCount / (double)tileCount * 100.0);
                                         //-- Avoid calling this if (int) progress hasn't changed.
@@ -1043,9 +1210,45 @@ QGCCacheWorker::_connectDB()
     _db->setDatabaseName(_databasePath);
     _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     _valid = _db->open();
+    if(_valid) {
+        //-- Write-ahead logging lets tile reads proceed while a save transaction is committing and only
+        //   needs a sync at checkpoints. NORMAL is still crash safe in WAL mode, a power loss can only
+        //   drop the most recently cached tiles.
+        QSqlQuery query(*_db);
+        if(!query.exec("PRAGMA journal_mode=WAL")) {
+            qCWarning(QGCTileCacheLog) << "Map Cache SQL error (journal_mode):" << query.lastError().text();
+        }
+        query.exec("PRAGMA synchronous=NORMAL");
+    }
     return _valid;
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_prepareQueries()
+{
+    _resetQueries();
+    if(!_valid) {
+        return;
+    }
+    _selectTileIDQuery.reset(new QSqlQuery(*_db));
+    _selectTileIDQuery->setForwardOnly(true);
+    _selectTileIDQuery->prepare("SELECT tileID FROM Tiles WHERE hash = ?");
+    _insertTileQuery.reset(new QSqlQuery(*_db));
+    _insertTileQuery->prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
+    _insertSetTileQuery.reset(new QSqlQuery(*_db));
+    _insertSetTileQuery->prepare("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(?, ?)");
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_resetQueries()
+{
+    _selectTileIDQuery.reset();
+    _insertTileQuery.reset();
+    _insertSetTileQuery.reset();
+}
+
 //-----------------------------------------------------------------------------
 bool
 QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
@@ -1138,12 +1341,34 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
 void
 QGCCacheWorker::_disconnectDB()
 {
+    _resetQueries();
     if (_db) {
         _db.reset();
         QSqlDatabase::removeDatabase(kSession);
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_releaseReaders()
+{
+    //-- Readers keep their connection open between lookups. Have them close it so the database can be
+    //   replaced, they connect again once the write lock is released.
+    _databaseReleaseRequested = true;
+    for(QGCCacheReader* reader: _readers) {
+        reader->releaseDatabase();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_readerDatabase(QString& path)
+{
+    QMutexLocker lock(&_databasePathMutex);
+    path = _databasePath;
+    return _valid && !path.isEmpty();
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_testInternet()
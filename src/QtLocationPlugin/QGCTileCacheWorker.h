@@ -25,7 +25,10 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QMutexLocker>
+#include <QReadWriteLock>
+#include <QHash>
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 #include <QHostInfo>
 
 #include "QGCLoggingCategory.h"
@@ -34,11 +37,18 @@ Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheLog)
 
 class QGCMapTask;
 class QGCCachedTileSet;
+class QGCCacheReader;
 
 //-----------------------------------------------------------------------------
+/// Owns the tile cache database. Tile fetches are handed off to a small pool of QGCCacheReader threads, everything
+/// else (saves, tile sets, prune, import, export) runs on this thread at low priority.
 class QGCCacheWorker : public QThread
 {
     Q_OBJECT
+
+    friend class QGCCacheReader;
+    friend class QGCTileCacheWorkerTest; // Unit test
+
 public:
     QGCCacheWorker  ();
     ~QGCCacheWorker ();
@@ -57,7 +67,7 @@ private:
     void        _runTask                (QGCMapTask* task);
 
     void        _saveTile               (QGCMapTask* mtask);
-    void        _getTile                (QGCMapTask* mtask);
+    void        _saveTiles              (const QList<QGCMapTask*>& tasks);
     void        _getTileSets            (QGCMapTask* mtask);
     void        _createTileSet          (QGCMapTask* mtask);
     void        _getTileDownloadList    (QGCMapTask* mtask);
@@ -72,7 +82,13 @@ private:
     void        _testInternet           ();
     void        _deleteBingNoTileTiles  ();
 
-    quint64     _findTile               (const QString hash);
+    quint64     _findTile               (const QString& hash);
+    void        _prepareQueries         ();
+    void        _resetQueries           ();
+    void        _loadTileIndex          ();
+    quint64     _indexedTileID          (const QString& hash) const;
+    void        _addToTileIndex         (const QString& hash, quint64 tileID);
+    void        _removeFromTileIndex    (const QString& hash);
     bool        _findTileSetID          (const QString name, quint64& setID);
     void        _updateSetTotals        (QGCCachedTileSet* set);
     bool        _init                   ();
@@ -82,6 +98,10 @@ private:
     quint64     _getDefaultTileSet      ();
     void        _updateTotals           ();
     void        _deleteTileSet          (qulonglong id);
+    void        _releaseReaders         ();
+    bool        _readerDatabase         (QString& path);
+
+    static quint64 _tileIndexKey        (const QString& hash);
 
 signals:
     void        updateTotals            (quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
@@ -103,6 +123,30 @@ private:
     time_t                          _lastUpdate;
     int                             _updateTimeout;
     int                             _hostLookupID;
+
+    // Statements for the tile hot paths, prepared once per connection
+    QScopedPointer<QSqlQuery>       _selectTileIDQuery;         ///< tileID by hash
+    QScopedPointer<QSqlQuery>       _insertTileQuery;
+    QScopedPointer<QSqlQuery>       _insertSetTileQuery;
+
+    typedef struct {
+        quint64 tileID;
+        QString hash;
+    } TileIndexEntry_t;
+
+    /// Index of every tile in the database, keyed by a 64 bit hash of the tile hash string. The key only narrows the
+    /// search, entries are matched on the full hash string so colliding keys still find the right tile. Only modified
+    /// on the worker thread, readers must hold _tileIndexLock.
+    QMultiHash<quint64, TileIndexEntry_t> _tileIDs;
+    bool                            _tileIndexValid;            ///< false: _tileIDs is incomplete, go to the database
+    QReadWriteLock                  _tileIndexLock;
+
+    QList<QGCCacheReader*>          _readers;
+    QReadWriteLock                  _databaseLock;              ///< Held for reading while a reader has the database open
+    std::atomic_bool                _databaseReleaseRequested;  ///< Readers close their connections so the worker can take _databaseLock
+    QMutex                          _databasePathMutex;         ///< Guards _databasePath, readers pick it up when they connect
+
+    static const int                _maxSaveBatch = 256;        ///< Maximum number of tile saves coalesced into one transaction
 };
 
 #endif // QGC_TILE_CACHE_WORKER_H
@@ -0,0 +1,288 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCTileCacheWorker.h"
+#include "QGCTileCacheReader.h"
+#include "QGCMapEngineData.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <string.h>
+
+static const int        kBenchmarkTileCount     = 500000;   ///< Tiles pre-populated by the benchmark
+static const int        kBenchmarkFetchCount    = 20000;
+static const int        kTileByteCount          = 512;
+static const char*      kTileFormat             = "png";
+static const char*      kTileType               = "Test";
+
+QString QGCTileCacheWorkerTest::_tileHash(int tile)
+{
+    // Same layout as QGCMapEngine::getTileHash: type, x, y, zoom
+    return QString::asprintf("%010d%08d%08d%03d", 1, tile % 4096, tile / 4096, 19);
+}
+
+QByteArray QGCTileCacheWorkerTest::_tileBytes(int tile)
+{
+    QByteArray bytes(kTileByteCount, static_cast<char>(tile & 0xFF));
+    memcpy(bytes.data(), &tile, sizeof(tile));
+    return bytes;
+}
+
+bool QGCTileCacheWorkerTest::_openWorker(QGCCacheWorker& worker, const QString& databasePath)
+{
+    worker.setDatabaseFile(databasePath);
+    if (!worker._connectDB()) {
+        return false;
+    }
+    worker._valid = worker._createDB(*worker._db);
+    worker._prepareQueries();
+    worker._loadTileIndex();
+    return worker._valid && worker._tileIndexValid;
+}
+
+void QGCTileCacheWorkerTest::_saveTiles(QGCCacheWorker& worker, int firstTile, int count)
+{
+    QList<QGCMapTask*> tasks;
+    for (int tile=firstTile; tile<firstTile + count; tile++) {
+        tasks.append(new QGCSaveTileTask(new QGCCacheTile(_tileHash(tile), _tileBytes(tile), kTileFormat, kTileType)));
+        if (tasks.count() == QGCCacheWorker::_maxSaveBatch) {
+            worker._saveTiles(tasks);
+            qDeleteAll(tasks);
+            tasks.clear();
+        }
+    }
+    worker._saveTiles(tasks);
+    qDeleteAll(tasks);
+}
+
+bool QGCTileCacheWorkerTest::_fetchTile(QGCCacheReader& reader, int tile)
+{
+    bool                found = false;
+    QGCFetchTileTask    task(_tileHash(tile));
+
+    connect(&task, &QGCFetchTileTask::tileFetched, this, [&found, tile](QGCCacheTile* cacheTile) {
+        found = cacheTile->img() == _tileBytes(tile) && cacheTile->format() == kTileFormat;
+        delete cacheTile;
+    });
+    reader._getTile(&task);
+
+    return found;
+}
+
+void QGCTileCacheWorkerTest::_saveAndFetch_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString databasePath = tempDir.filePath("qgcMapCache.db");
+
+    {
+        QGCCacheWorker worker;
+        QGCCacheReader reader(&worker, 0);
+        QVERIFY(_openWorker(worker, databasePath));
+        QVERIFY(reader._connectDB());
+        _saveTiles(worker, 0, 1000);
+        QCOMPARE(worker._tileIDs.count(), 1000);
+        QVERIFY(_fetchTile(reader, 0));
+        QVERIFY(_fetchTile(reader, 999));
+        QVERIFY(!_fetchTile(reader, 1000));
+
+        // Saving a tile which is already cached is a no-op
+        _saveTiles(worker, 500, 10);
+        QCOMPARE(worker._tileIDs.count(), 1000);
+        QVERIFY(worker._indexedTileID(_tileHash(42)) != 0);
+        QCOMPARE(worker._findTile(_tileHash(42)), worker._indexedTileID(_tileHash(42)));
+        QCOMPARE(worker._findTile(_tileHash(1000)), static_cast<quint64>(0));
+
+        reader._disconnectDB();
+        worker._disconnectDB();
+    }
+
+    // The index is rebuilt from the database when it is opened again
+    QGCCacheWorker worker;
+    QGCCacheReader reader(&worker, 0);
+    QVERIFY(_openWorker(worker, databasePath));
+    QVERIFY(reader._connectDB());
+    QCOMPARE(worker._tileIDs.count(), 1000);
+    for (int tile=0; tile<1000; tile+=37) {
+        QVERIFY(_fetchTile(reader, tile));
+    }
+    QVERIFY(!_fetchTile(reader, 1001));
+
+    // Without the index everything must come from the database
+    worker._tileIndexValid = false;
+    QVERIFY(_fetchTile(reader, 123));
+    QVERIFY(!_fetchTile(reader, 1001));
+    QVERIFY(worker._findTile(_tileHash(123)) != 0);
+
+    // The reader holds on to its connection, and with it the database lock, until it is told to let go
+    QVERIFY(!worker._databaseLock.tryLockForWrite());
+    reader._disconnectDB();
+    QVERIFY(worker._databaseLock.tryLockForWrite());
+    worker._databaseLock.unlock();
+    worker._disconnectDB();
+}
+
+void QGCTileCacheWorkerTest::_deleteTileSet_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const quint64 setID = 100;
+
+    QGCCacheWorker worker;
+    QGCCacheReader reader(&worker, 0);
+    QVERIFY(_openWorker(worker, tempDir.filePath("qgcMapCache.db")));
+    QVERIFY(reader._connectDB());
+    _saveTiles(worker, 0, 10);
+    QList<QGCMapTask*> tasks;
+    for (int tile=10; tile<20; tile++) {
+        tasks.append(new QGCSaveTileTask(new QGCCacheTile(_tileHash(tile), _tileBytes(tile), kTileFormat, kTileType, setID)));
+    }
+    worker._saveTiles(tasks);
+    qDeleteAll(tasks);
+    QCOMPARE(worker._tileIDs.count(), 20);
+
+    // Tiles unique to the deleted set must be dropped from the index as well
+    worker._deleteTileSet(setID);
+    QVERIFY(worker._tileIndexValid);
+    QCOMPARE(worker._tileIDs.count(), 10);
+    QVERIFY(_fetchTile(reader, 5));
+    QVERIFY(!_fetchTile(reader, 15));
+
+    // ...so they can be cached again
+    _saveTiles(worker, 10, 10);
+    QVERIFY(_fetchTile(reader, 15));
+
+    reader._disconnectDB();
+    worker._disconnectDB();
+}
+
+void QGCTileCacheWorkerTest::_indexKeyCollision_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QGCCacheWorker worker;
+    QGCCacheReader reader(&worker, 0);
+    QVERIFY(_openWorker(worker, tempDir.filePath("qgcMapCache.db")));
+    QVERIFY(reader._connectDB());
+    _saveTiles(worker, 0, 2);
+    const quint64 tileID = worker._indexedTileID(_tileHash(0));
+    QVERIFY(tileID != 0);
+
+    // Pretend tile 1 was indexed under the key of tile 2. The key alone must never be taken as a match.
+    worker._tileIDs.insert(QGCCacheWorker::_tileIndexKey(_tileHash(2)), { worker._indexedTileID(_tileHash(1)), _tileHash(1) });
+    QCOMPARE(worker._findTile(_tileHash(2)), static_cast<quint64>(0));
+    QVERIFY(!_fetchTile(reader, 2));
+
+    // Saving the colliding tile stores it and both entries are found by their own hash
+    _saveTiles(worker, 2, 1);
+    QVERIFY(worker._findTile(_tileHash(2)) != 0);
+    QVERIFY(worker._findTile(_tileHash(2)) != worker._findTile(_tileHash(1)));
+    QVERIFY(_fetchTile(reader, 1));
+    QVERIFY(_fetchTile(reader, 2));
+
+    // Removing one entry leaves the other one with the same key in place
+    worker._removeFromTileIndex(_tileHash(2));
+    QCOMPARE(worker._indexedTileID(_tileHash(2)), static_cast<quint64>(0));
+    QVERIFY(worker._tileIDs.contains(QGCCacheWorker::_tileIndexKey(_tileHash(2))));
+    QCOMPARE(worker._indexedTileID(_tileHash(0)), tileID);
+
+    reader._disconnectDB();
+    worker._disconnectDB();
+}
+
+void QGCTileCacheWorkerTest::_readDuringWrite_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QGCCacheWorker worker;
+    QGCCacheReader reader(&worker, 0);
+    QVERIFY(_openWorker(worker, tempDir.filePath("qgcMapCache.db")));
+    QVERIFY(reader._connectDB());
+    _saveTiles(worker, 0, 100);
+
+    // Readers must not be blocked by an open write transaction on the worker connection, and must only see
+    // committed tiles
+    QVERIFY(worker._db->transaction());
+    QList<QGCMapTask*> tasks;
+    for (int tile=100; tile<200; tile++) {
+        tasks.append(new QGCSaveTileTask(new QGCCacheTile(_tileHash(tile), _tileBytes(tile), kTileFormat, kTileType)));
+        worker._saveTile(tasks.last());
+    }
+    QVERIFY(_fetchTile(reader, 50));
+    QVERIFY(!_fetchTile(reader, 150));
+    QVERIFY(worker._db->commit());
+    qDeleteAll(tasks);
+    QVERIFY(_fetchTile(reader, 150));
+
+    reader._disconnectDB();
+    worker._disconnectDB();
+}
+
+void QGCTileCacheWorkerTest::_cacheBenchmark_test(void)
+{
+    if (!qEnvironmentVariableIsSet("QGC_RUN_BENCHMARKS")) {
+        QSKIP("Set QGC_RUN_BENCHMARKS to run benchmarks");
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString databasePath = tempDir.filePath("qgcMapCache.db");
+
+    QElapsedTimer timer;
+
+    {
+        QGCCacheWorker worker;
+        QVERIFY(_openWorker(worker, databasePath));
+        timer.start();
+        _saveTiles(worker, 0, kBenchmarkTileCount);
+        qint64 saveElapsed = qMax(timer.elapsed(), static_cast<qint64>(1));
+        QCOMPARE(worker._tileIDs.count(), kBenchmarkTileCount);
+        qDebug() << "Saved" << kBenchmarkTileCount << "tiles:" << saveElapsed << "msecs" << (kBenchmarkTileCount * 1000.0) / saveElapsed << "tiles/sec";
+        worker._disconnectDB();
+    }
+
+    QGCCacheWorker worker;
+    QGCCacheReader reader(&worker, 0);
+    timer.restart();
+    QVERIFY(_openWorker(worker, databasePath));
+    qDebug() << "Opened cache and loaded tile index:" << timer.elapsed() << "msecs";
+    QVERIFY(reader._connectDB());
+
+    QRandomGenerator random(42);
+
+    timer.restart();
+    for (int i=0; i<kBenchmarkFetchCount; i++) {
+        QVERIFY(_fetchTile(reader, static_cast<int>(random.bounded(kBenchmarkTileCount))));
+    }
+    qint64 hitElapsed = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    timer.restart();
+    for (int i=0; i<kBenchmarkFetchCount; i++) {
+        QVERIFY(!_fetchTile(reader, kBenchmarkTileCount + static_cast<int>(random.bounded(kBenchmarkTileCount))));
+    }
+    qint64 missElapsed = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    timer.restart();
+    _saveTiles(worker, kBenchmarkTileCount, kBenchmarkFetchCount);
+    qint64 saveElapsed = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    qDebug() << "Cache with" << kBenchmarkTileCount << "tiles";
+    qDebug() << "  get (hit): " << (kBenchmarkFetchCount * 1000.0) / hitElapsed << "tiles/sec";
+    qDebug() << "  get (miss):" << (kBenchmarkFetchCount * 1000.0) / missElapsed << "tiles/sec";
+    qDebug() << "  save:      " << (kBenchmarkFetchCount * 1000.0) / saveElapsed << "tiles/sec";
+
+    reader._disconnectDB();
+    worker._disconnectDB();
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCCacheWorker;
+class QGCCacheReader;
+
+/// Unit test for the QGCCacheWorker/QGCCacheReader tile save/fetch paths. The threads are not started, the tasks are
+/// run directly on the test thread. The 500k tile benchmark only runs when QGC_RUN_BENCHMARKS is set.
+class QGCTileCacheWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _saveAndFetch_test     (void);
+    void _deleteTileSet_test    (void);
+    void _indexKeyCollision_test(void);
+    void _readDuringWrite_test  (void);
+    void _cacheBenchmark_test   (void);
+
+private:
+    bool    _openWorker (QGCCacheWorker& worker, const QString& databasePath);
+    void    _saveTiles  (QGCCacheWorker& worker, int firstTile, int count);
+    bool    _fetchTile  (QGCCacheReader& reader, int tile);
+
+    static QString      _tileHash   (int tile);
+    static QByteArray   _tileBytes  (int tile);
+};
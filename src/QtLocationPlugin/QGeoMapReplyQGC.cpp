@@ -228,6 +228,7 @@ QGeoTiledMapReplyQGC::cacheReply(QGCCacheTile* tile)
 {
     //-- Test for a specialized, elevation data (not map tile)
     if( getQGCMapEngine()->urlFactory()->isElevation(tileSpec().mapId())){
+        setCached(true);
         emit terrainDone(tile->img(), QNetworkReply::NoError);
     } else {
         //-- Regular map tile
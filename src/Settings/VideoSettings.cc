@@ -107,11 +107,15 @@ DECLARE_SETTINGSFACT(VideoSettings, gridLines)
 DECLARE_SETTINGSFACT(VideoSettings, showRecControl)
 DECLARE_SETTINGSFACT(VideoSettings, recordingFormat)
 DECLARE_SETTINGSFACT(VideoSettings, maxVideoSize)
+DECLARE_SETTINGSFACT(VideoSettings, recordingPreRoll)
+DECLARE_SETTINGSFACT(VideoSettings, recordingPreRollMaxSize)
 DECLARE_SETTINGSFACT(VideoSettings, enableStorageLimit)
 DECLARE_SETTINGSFACT(VideoSettings, rtspTimeout)
 DECLARE_SETTINGSFACT(VideoSettings, streamEnabled)
 DECLARE_SETTINGSFACT(VideoSettings, disableWhenDisarmed)
 DECLARE_SETTINGSFACT(VideoSettings, lowLatencyMode)
+DECLARE_SETTINGSFACT(VideoSettings, jitterBuffer)
+DECLARE_SETTINGSFACT(VideoSettings, maxFrameLatency)
 
 DECLARE_SETTINGSFACT_NO_FUNC(VideoSettings, videoSource)
 {
@@ -30,11 +30,15 @@ public:
     DEFINE_SETTINGFACT(showRecControl)
     DEFINE_SETTINGFACT(recordingFormat)
     DEFINE_SETTINGFACT(maxVideoSize)
+    DEFINE_SETTINGFACT(recordingPreRoll)
+    DEFINE_SETTINGFACT(recordingPreRollMaxSize)
     DEFINE_SETTINGFACT(enableStorageLimit)
     DEFINE_SETTINGFACT(rtspTimeout)
     DEFINE_SETTINGFACT(streamEnabled)
     DEFINE_SETTINGFACT(disableWhenDisarmed)
     DEFINE_SETTINGFACT(lowLatencyMode)
+    DEFINE_SETTINGFACT(jitterBuffer)
+    DEFINE_SETTINGFACT(maxFrameLatency)
     DEFINE_SETTINGFACT(forceVideoDecoder)
 
     enum VideoDecoderOptions {
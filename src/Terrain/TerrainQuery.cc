@@ -11,6 +11,7 @@
 #include "QGCMapEngine.h"
 #include "QGeoMapReplyQGC.h"
 #include "QGCApplication.h"
+#include "SettingsManager.h"
 
 #include <QUrl>
 #include <QUrlQuery>
@@ -32,6 +33,8 @@ QGC_LOGGING_CATEGORY(TerrainQueryVerboseLog, "TerrainQueryVerboseLog")
 Q_GLOBAL_STATIC(TerrainAtCoordinateBatchManager, _TerrainAtCoordinateBatchManager)
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
 
+const char* TerrainTileManager::_elevationMapType = "Airmap Elevation";
+
 TerrainAirMapQuery::TerrainAirMapQuery(QObject* parent)
     : TerrainQueryInterface(parent)
 {
@@ -330,8 +333,33 @@ void TerrainOfflineAirMapQuery::_signalCarpetHeights(bool success, double minHei
 }
 
 TerrainTileManager::TerrainTileManager(void)
+    : _maxConcurrentFetches(QGCMapEngine::concurrentDownloads(_elevationMapType))
+{
+    Fact* cacheBudgetFact = qgcApp()->toolbox()->settingsManager()->offlineMapsSettings()->maxTerrainTileCacheMB();
+    setCacheBudgetMB(cacheBudgetFact->rawValue().toInt());
+    connect(cacheBudgetFact, &Fact::rawValueChanged, this, &TerrainTileManager::_cacheBudgetSettingChanged);
+}
+
+TerrainTileManager::~TerrainTileManager()
+{
+    QSet<QueuedRequestInfo_t*> requests;
+    for (const QList<QueuedRequestInfo_t*>& waiters: _tileWaiters) {
+        for (QueuedRequestInfo_t* requestInfo: waiters) {
+            requests.insert(requestInfo);
+        }
+    }
+    qDeleteAll(requests);
+}
+
+void TerrainTileManager::setCacheBudgetMB(int budgetMB)
 {
+    QMutexLocker tilesLock(&_tilesMutex);
+    _tiles.setMaxCost(qMax(1, budgetMB) * 1024);
+}
 
+void TerrainTileManager::_cacheBudgetSettingChanged(QVariant value)
+{
+    setCacheBudgetMB(value.toInt());
 }
 
 void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQueryInterface, const QList<QGeoCoordinate>& coordinates)
@@ -339,24 +367,8 @@ void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQu
     qCDebug(TerrainQueryLog) << "TerrainTileManager::addCoordinateQuery count" << coordinates.count();
 
     if (coordinates.length() > 0) {
-        bool error;
-        QList<double> altitudes;
-
-        if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-            qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-            QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates };
-            _requestQueue.append(queuedRequestInfo);
-            return;
-        }
-
-        if (error) {
-            QList<double> noAltitudes;
-            qCWarning(TerrainQueryLog) << "addCoordinateQuery: signalling failure due to internal error";
-            terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-        } else {
-            qCDebug(TerrainQueryLog) << "addCoordinateQuery: All altitudes taken from cached data";
-            terrainQueryInterface->_signalCoordinateHeights(coordinates.count() == altitudes.count(), altitudes);
-        }
+        QueuedRequestInfo_t* requestInfo = new QueuedRequestInfo_t{ terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates, QSet<quint64>() };
+        _queueRequest(requestInfo);
     }
 }
 
@@ -400,22 +412,51 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
 
     coordinates = pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween);
 
-    bool error;
-    QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, coordinates };
-        _requestQueue.append(queuedRequestInfo);
+    QueuedRequestInfo_t* requestInfo = new QueuedRequestInfo_t{ terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, coordinates, QSet<quint64>() };
+    _queueRequest(requestInfo);
+}
+
+/// Signals the request immediately if all tiles are available, otherwise queues it on the missing tiles. Takes
+/// ownership of requestInfo.
+void TerrainTileManager::_queueRequest(QueuedRequestInfo_t* requestInfo)
+{
+    bool            error;
+    QList<double>   altitudes;
+
+    if (_getAltitudesFromCache(requestInfo->coordinates, altitudes, error, requestInfo->missingTiles)) {
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::_queueRequest: All altitudes taken from cached data";
+        _signalRequest(requestInfo, error, altitudes);
+        delete requestInfo;
         return;
     }
 
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::_queueRequest waiting on tile count" << requestInfo->missingTiles.count();
+    for (quint64 key: requestInfo->missingTiles) {
+        _tileWaiters[key].append(requestInfo);
+    }
+    _requestTiles(requestInfo->missingTiles);
+}
+
+void TerrainTileManager::_signalRequest(QueuedRequestInfo_t* requestInfo, bool error, const QList<double>& altitudes)
+{
+    QList<double> noAltitudes;
+
     if (error) {
-        QList<double> noAltitudes;
-        qCWarning(TerrainQueryLog) << "addPathQuery: signalling failure due to internal error";
-        terrainQueryInterface->_signalPathHeights(false, distanceBetween, finalDistanceBetween, noAltitudes);
-    } else {
-        qCDebug(TerrainQueryLog) << "addPathQuery: All altitudes taken from cached data";
-        terrainQueryInterface->_signalPathHeights(coordinates.count() == altitudes.count(), distanceBetween, finalDistanceBetween, altitudes);
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::_signalRequest: signalling failure";
+    }
+
+    if (requestInfo->queryMode == QueryMode::QueryModeCoordinates) {
+        if (error) {
+            requestInfo->terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
+        } else {
+            requestInfo->terrainQueryInterface->_signalCoordinateHeights(requestInfo->coordinates.count() == altitudes.count(), altitudes);
+        }
+    } else if (requestInfo->queryMode == QueryMode::QueryModePath) {
+        if (error) {
+            requestInfo->terrainQueryInterface->_signalPathHeights(false, requestInfo->distanceBetween, requestInfo->finalDistanceBetween, noAltitudes);
+        } else {
+            requestInfo->terrainQueryInterface->_signalPathHeights(requestInfo->coordinates.count() == altitudes.count(), requestInfo->distanceBetween, requestInfo->finalDistanceBetween, altitudes);
+        }
     }
 }
 
@@ -423,146 +464,214 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
 ///     @param[out] error true: altitude not returned due to error, false: altitudes returned
 /// @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
 bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error)
+{
+    QSet<quint64> missingTiles;
+
+    if (_getAltitudesFromCache(coordinates, altitudes, error, missingTiles)) {
+        return true;
+    }
+
+    _requestTiles(missingTiles);
+    return false;
+}
+
+/// Looks up the altitudes from the tile cache
+///     @param[out] error true: altitude not returned due to error, false: altitudes returned
+///     @param[out] missingTiles Keys for all the tiles which are not in the cache
+/// @return true: altitude returned (check error as well), false: tiles missing (altitudes not returned)
+bool TerrainTileManager::_getAltitudesFromCache(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error, QSet<quint64>& missingTiles)
 {
     error = false;
+    missingTiles.clear();
 
-    for (const QGeoCoordinate& coordinate: coordinates) {
-        QString tileHash = _getTileHash(coordinate);
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+    const int       count = coordinates.count();
+    QVector<double> latitudes(count);
+    QVector<double> longitudes(count);
+    QVector<double> elevations(count);
 
-        _tilesMutex.lock();
-        if (_tiles.contains(tileHash)) {
-            double elevation = _tiles[tileHash].elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
+    for (int i = 0; i < count; i++) {
+        latitudes[i]    = coordinates[i].latitude();
+        longitudes[i]   = coordinates[i].longitude();
+    }
+
+    QMutexLocker tilesLock(&_tilesMutex);
+
+    // Consecutive coordinates usually fall in the same tile. Each run of those is sampled in a single batch.
+    int             runStart    = 0;
+    quint64         runTileKey  = 0;
+    TerrainTile*    runTile     = nullptr;
+    for (int i = 0; i <= count; i++) {
+        int     tileX, tileY;
+        quint64 key = i < count ? _tileKey(coordinates[i], tileX, tileY) : 0;
+
+        if (i == count || i == runStart || key != runTileKey) {
+            if (runTile && missingTiles.isEmpty()) {
+                runTile->elevations(latitudes.constData() + runStart, longitudes.constData() + runStart, elevations.data() + runStart, i - runStart);
             }
-            altitudes.push_back(elevation);
-        } else {
-            if (_state != State::Downloading) {
-                QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL("Airmap Elevation", getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation",coordinate.longitude(), 1), getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1), 1, &_networkManager);
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates query from database" << request.url();
-                QGeoTileSpec spec;
-                spec.setX(getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1));
-                spec.setY(getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1));
-                spec.setZoom(1);
-                spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType("Airmap Elevation"));
-                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
-                connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
-                _state = State::Downloading;
+            if (i == count) {
+                break;
             }
-            _tilesMutex.unlock();
 
-            return false;
+            qCDebug(TerrainQueryVerboseLog) << "TerrainTileManager::_getAltitudesFromCache key:coordinate" << key << coordinates[i];
+            runStart    = i;
+            runTileKey  = key;
+            runTile     = missingTiles.contains(key) ? nullptr : _tiles.object(key);
+            if (!runTile) {
+                missingTiles.insert(key);
+            }
+        }
+
+        if (runTile) {
+            _cacheHits++;
+        } else {
+            _cacheMisses++;
         }
-        _tilesMutex.unlock();
     }
 
+    if (!missingTiles.isEmpty()) {
+        return false;
+    }
+
+    for (double elevation: elevations) {
+        if (qIsNaN(elevation)) {
+            error = true;
+            qCWarning(TerrainQueryLog) << "TerrainTileManager::_getAltitudesFromCache Internal Error: missing elevation in tile cache";
+            break;
+        }
+    }
+    altitudes.append(elevations.toList());
+
     return true;
 }
 
-void TerrainTileManager::_tileFailed(void)
+/// Queues the fetch of any of the specified tiles which are not already being fetched
+void TerrainTileManager::_requestTiles(const QSet<quint64>& tileKeys)
 {
-    QList<double>    noAltitudes;
-
-    for (const QueuedRequestInfo_t& requestInfo: _requestQueue) {
-        if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
-            requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-        } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
-            requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
+    for (quint64 key: tileKeys) {
+        if (!_tilesFetching.contains(key)) {
+            _tilesFetching.insert(key);
+            _tileFetchQueue.append(key);
         }
     }
-    _requestQueue.clear();
+    _startTileFetches();
+}
+
+void TerrainTileManager::_startTileFetches(void)
+{
+    while (_activeFetches < _maxConcurrentFetches && !_tileFetchQueue.isEmpty()) {
+        quint64 key = _tileFetchQueue.takeFirst();
+        _activeFetches++;
+        _fetchTile(tileXFromKey(key), tileYFromKey(key));
+    }
+}
+
+void TerrainTileManager::_fetchTile(int tileX, int tileY)
+{
+    QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(_elevationMapType, tileX, tileY, 1, &_networkManager);
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::_fetchTile query from database" << request.url();
+    QGeoTileSpec spec;
+    spec.setX(tileX);
+    spec.setY(tileY);
+    spec.setZoom(1);
+    spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType(_elevationMapType));
+    QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
+    connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
 }
 
 void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error)
 {
     QGeoTiledMapReplyQGC* reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
-    _state = State::Idle;
 
     if (!reply) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetched but invalid reply data type.";
         return;
     }
+    reply->deleteLater();
 
-    // remove from download queue
     QGeoTileSpec spec = reply->tileSpec();
-    QString hash = QGCMapEngine::getTileHash("Airmap Elevation", spec.x(), spec.y(), spec.zoom());
 
     // handle potential errors
     if (error != QNetworkReply::NoError) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetching returned error (" << error << ")";
-        _tileFailed();
-        reply->deleteLater();
-        return;
-    }
-    if (responseBytes.isEmpty()) {
+        responseBytes.clear();
+    } else if (responseBytes.isEmpty()) {
         qCWarning(TerrainQueryLog) << "Error in fetching elevation tile. Empty response.";
-        _tileFailed();
-        reply->deleteLater();
-        return;
+    } else {
+        qCDebug(TerrainQueryLog) << "Received some bytes of terrain data: " << responseBytes.size();
     }
 
-    qCDebug(TerrainQueryLog) << "Received some bytes of terrain data: " << responseBytes.size();
+    _tileFetchDone(spec.x(), spec.y(), responseBytes, reply->isCached());
+}
 
-    TerrainTile* terrainTile = new TerrainTile(responseBytes);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            _tiles.insert(hash, *terrainTile);
+void TerrainTileManager::_tileFetchDone(int tileX, int tileY, const QByteArray& tileBytes, bool fromDisk)
+{
+    quint64 key     = tileKey(tileX, tileY);
+    bool    success = false;
+
+    _activeFetches--;
+    _tilesFetching.remove(key);
+
+    if (!tileBytes.isEmpty()) {
+        TerrainTile* terrainTile = new TerrainTile(tileBytes);
+        if (terrainTile->isValid()) {
+            success = true;
+            _tilesMutex.lock();
+            if (!_tiles.contains(key)) {
+                if (fromDisk) {
+                    _tilesLoadedFromDisk++;
+                } else {
+                    _tilesDownloaded++;
+                }
+                _tiles.insert(key, terrainTile, qMax(1, terrainTile->memorySize() / 1024));
+                qCDebug(TerrainQueryLog) << "Terrain tile cache tiles:totalKB:maxKB:hits:misses:fromDisk:downloaded" << _tiles.count() << _tiles.totalCost() << _tiles.maxCost()
+                                         << _cacheHits << _cacheMisses << _tilesLoadedFromDisk << _tilesDownloaded;
+            } else {
+                delete terrainTile;
+            }
+            _tilesMutex.unlock();
         } else {
             delete terrainTile;
+            qCWarning(TerrainQueryLog) << "Received invalid tile";
         }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
-        qCWarning(TerrainQueryLog) << "Received invalid tile";
     }
-    reply->deleteLater();
 
-    // now try to query the data again
-    for (int i = _requestQueue.count() - 1; i >= 0; i--) {
-        bool error;
-        QList<double> altitudes;
-        QueuedRequestInfo_t& requestInfo = _requestQueue[i];
-
-        if (getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
-            if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
-                }
-            } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
+    // Only the requests waiting on this tile need to be looked at
+    const QList<QueuedRequestInfo_t*> waiters = _tileWaiters.take(key);
+    for (QueuedRequestInfo_t* requestInfo: waiters) {
+        requestInfo->missingTiles.remove(key);
+
+        if (!success) {
+            // Stop waiting on any other tiles as well
+            for (quint64 otherKey: requestInfo->missingTiles) {
+                auto otherWaiters = _tileWaiters.find(otherKey);
+                if (otherWaiters != _tileWaiters.end()) {
+                    otherWaiters->removeAll(requestInfo);
+                    if (otherWaiters->isEmpty()) {
+                        _tileWaiters.erase(otherWaiters);
+                    }
                 }
             }
-            _requestQueue.removeAt(i);
+            _signalRequest(requestInfo, true /* error */, QList<double>());
+            delete requestInfo;
+        } else if (requestInfo->missingTiles.isEmpty()) {
+            // May still miss if a tile was evicted while waiting on the others, in which case it is queued up again
+            _queueRequest(requestInfo);
         }
     }
+
+    _startTileFetches();
 }
 
-QString TerrainTileManager::_getTileHash(const QGeoCoordinate& coordinate)
+quint64 TerrainTileManager::_tileKey(const QGeoCoordinate& coordinate, int& tileX, int& tileY)
 {
-    QString ret = QGCMapEngine::getTileHash(
-        "Airmap Elevation",
-        getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1),
-        getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1),
-        1);
-    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << coordinate << ret;
+    // Resolve the provider once instead of looking it up by name for every coordinate
+    if (!_elevationProvider) {
+        _elevationProvider = getQGCMapEngine()->urlFactory()->getProviderTable().value(_elevationMapType);
+    }
+    tileX = _elevationProvider->long2tileX(coordinate.longitude(), 1);
+    tileY = _elevationProvider->lat2tileY(coordinate.latitude(), 1);
 
-    return ret;
+    return tileKey(tileX, tileY);
 }
 
 TerrainAtCoordinateBatchManager::TerrainAtCoordinateBatchManager(void)
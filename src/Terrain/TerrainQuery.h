@@ -19,12 +19,16 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QCache>
+#include <QMutex>
+#include <QSet>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryLog)
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryVerboseLog)
 
 class TerrainAtCoordinateQuery;
+class MapProvider;
 
 /// Base class for offline/online terrain queries
 class TerrainQueryInterface : public QObject
@@ -110,27 +114,56 @@ public:
 };
 
 /// Used internally by TerrainOfflineAirMapQuery to manage terrain tiles
+///
+/// Tiles are held in a memory bounded LRU cache keyed by the packed tile x/y. Every tile which comes in from the network
+/// is also written to the QGCMapEngine tile database by QGeoTiledMapReplyQGC, so a tile which is evicted from memory is
+/// reloaded from disk instead of being downloaded again.
+///
+/// All the tiles missing for a request are worked out up front and fetched in parallel, up to _maxConcurrentFetches at a
+/// time. Each missing tile keeps a list of the requests waiting on it, so a completed tile only revisits those requests.
 class TerrainTileManager : public QObject {
     Q_OBJECT
 
 public:
     TerrainTileManager(void);
+    ~TerrainTileManager();
 
     void addCoordinateQuery         (TerrainOfflineAirMapQuery* terrainQueryInterface, const QList<QGeoCoordinate>& coordinates);
     void addPathQuery               (TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint);
     bool getAltitudesForCoordinates (const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error);
 
+    /// Sets the maximum amount of memory used by cached tiles. Least recently used tiles are evicted to fit.
+    void setCacheBudgetMB           (int budgetMB);
+
+    quint64 cacheHits               (void) const { return _cacheHits; }     ///< Coordinate lookups satisfied from memory
+    quint64 cacheMisses             (void) const { return _cacheMisses; }   ///< Coordinate lookups which required a tile load
+    quint64 tilesLoadedFromDisk     (void) const { return _tilesLoadedFromDisk; }
+    quint64 tilesDownloaded         (void) const { return _tilesDownloaded; }
+
     static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween);
 
+    /// @return Cache key for the specified tile
+    static quint64 tileKey(int tileX, int tileY) { return (static_cast<quint64>(static_cast<quint32>(tileX)) << 32) | static_cast<quint32>(tileY); }
+
+    static int tileXFromKey(quint64 key) { return static_cast<int>(static_cast<quint32>(key >> 32)); }
+    static int tileYFromKey(quint64 key) { return static_cast<int>(static_cast<quint32>(key)); }
+
+protected:
+    /// Starts the fetch of a single tile. The fetch must be completed by calling _tileFetchDone.
+    virtual void _fetchTile         (int tileX, int tileY);
+
+    /// Adds the fetched tile to the cache and signals all requests which were waiting on it
+    ///     @param tileBytes Serialized tile data, empty if the fetch failed
+    ///     @param fromDisk true: tile was loaded from the map tile database
+    void _tileFetchDone             (int tileX, int tileY, const QByteArray& tileBytes, bool fromDisk);
+
+    int _maxConcurrentFetches;
+
 private slots:
-    void _terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error);
+    void _terrainDone               (QByteArray responseBytes, QNetworkReply::NetworkError error);
+    void _cacheBudgetSettingChanged (QVariant value);
 
 private:
-    enum class State {
-        Idle,
-        Downloading,
-    };
-
     enum QueryMode {
         QueryModeCoordinates,
         QueryModePath,
@@ -143,17 +176,31 @@ private:
         double                      distanceBetween;        // Distance between each returned height
         double                      finalDistanceBetween;   // Distance between for final height
         QList<QGeoCoordinate>       coordinates;
+        QSet<quint64>               missingTiles;           // Tiles the request is still waiting on
     } QueuedRequestInfo_t;
 
-    void    _tileFailed                         (void);
-    QString _getTileHash                        (const QGeoCoordinate& coordinate);
-
-    QList<QueuedRequestInfo_t>  _requestQueue;
-    State                       _state = State::Idle;
-    QNetworkAccessManager       _networkManager;
-
-    QMutex                      _tilesMutex;
-    QHash<QString, TerrainTile> _tiles;
+    bool    _getAltitudesFromCache              (const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error, QSet<quint64>& missingTiles);
+    void    _queueRequest                       (QueuedRequestInfo_t* requestInfo);
+    void    _signalRequest                      (QueuedRequestInfo_t* requestInfo, bool error, const QList<double>& altitudes);
+    void    _requestTiles                       (const QSet<quint64>& tileKeys);
+    void    _startTileFetches                   (void);
+    quint64 _tileKey                            (const QGeoCoordinate& coordinate, int& tileX, int& tileY);
+
+    QHash<quint64, QList<QueuedRequestInfo_t*>> _tileWaiters;       ///< Requests waiting on each missing tile
+    QList<quint64>                              _tileFetchQueue;    ///< Tiles waiting for a free fetch slot
+    QSet<quint64>                               _tilesFetching;     ///< Tiles queued or in flight
+    int                                         _activeFetches  = 0;
+    QNetworkAccessManager                       _networkManager;
+    MapProvider*                                _elevationProvider = nullptr;
+
+    QMutex                          _tilesMutex;
+    QCache<quint64, TerrainTile>    _tiles;                     ///< Cost is tile memory size in KB
+    quint64                         _cacheHits              = 0;
+    quint64                         _cacheMisses            = 0;
+    quint64                         _tilesLoadedFromDisk    = 0;
+    quint64                         _tilesDownloaded        = 0;
+
+    static const char*              _elevationMapType;
 };
 
 /// Used internally by TerrainAtCoordinateQuery to batch coordinate requests together
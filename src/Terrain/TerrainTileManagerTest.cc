@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileManagerTest.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QtMath>
+
+UnitTestTerrainTileManager::UnitTestTerrainTileManager(int maxConcurrentFetches)
+{
+    _maxConcurrentFetches = maxConcurrentFetches;
+}
+
+void UnitTestTerrainTileManager::_fetchTile(int tileX, int tileY)
+{
+    _inFlight.append(tileKey(tileX, tileY));
+    _maxInFlightCount = qMax(_maxInFlightCount, _inFlight.count());
+    _fetchCount++;
+}
+
+void UnitTestTerrainTileManager::completeFetches(quint64 failTileKey)
+{
+    QList<quint64> inFlight = _inFlight;
+    _inFlight.clear();
+
+    // Completing a fetch can start new ones, those stay in flight for the next call
+    for (quint64 key: inFlight) {
+        int tileX = tileXFromKey(key);
+        int tileY = tileYFromKey(key);
+        _tileFetchDone(tileX, tileY, key == failTileKey ? QByteArray() : tileBytes(tileX, tileY), false /* fromDisk */);
+    }
+}
+
+/// Builds a serialized tile the same way it would come back from the AirMap elevation api. Heights come from the
+/// UnitTestTerrainQuery regions, 0 outside of them.
+QByteArray UnitTestTerrainTileManager::tileBytes(int tileX, int tileY)
+{
+    const int   gridSize    = qRound(TerrainTile::tileSizeDegrees / TerrainTile::tileValueSpacingDegrees) + 1;
+    double      swLat       = (tileY * TerrainTile::tileSizeDegrees) - 90.0;
+    double      swLon       = (tileX * TerrainTile::tileSizeDegrees) - 180.0;
+    double      neLat       = swLat + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees);
+    double      neLon       = swLon + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees);
+
+    TerrainOfflineAirMapQuery   heightSource;
+    QList<double>               heights;
+    QObject::connect(&heightSource, &TerrainQueryInterface::coordinateHeightsReceived, [&heights](bool, QList<double> coordinateHeights) { heights = coordinateHeights; });
+
+    QJsonArray carpet;
+    for (int latIndex=0; latIndex<gridSize; latIndex++) {
+        QJsonArray row;
+        for (int lonIndex=0; lonIndex<gridSize; lonIndex++) {
+            QGeoCoordinate coord(swLat + (latIndex * TerrainTile::tileValueSpacingDegrees), swLon + (lonIndex * TerrainTile::tileValueSpacingDegrees));
+            UnitTestTerrainQuery(&heightSource).requestCoordinateHeights({ coord });
+            row.append(heights.count() ? heights[0] : 0.0);
+        }
+        carpet.append(row);
+    }
+
+    QJsonObject bounds;
+    bounds[QStringLiteral("sw")] = QJsonArray({ swLat, swLon });
+    bounds[QStringLiteral("ne")] = QJsonArray({ neLat, neLon });
+    QJsonObject stats;
+    stats[QStringLiteral("min")] = 0;
+    stats[QStringLiteral("max")] = 0;
+    stats[QStringLiteral("avg")] = 0;
+    QJsonObject data;
+    data[QStringLiteral("bounds")] = bounds;
+    data[QStringLiteral("stats")]  = stats;
+    data[QStringLiteral("carpet")] = carpet;
+    QJsonObject root;
+    root[QStringLiteral("status")] = QStringLiteral("success");
+    root[QStringLiteral("data")]   = data;
+
+    return TerrainTile::serializeFromAirMapJson(QJsonDocument(root).toJson());
+}
+
+void TerrainTileManagerTest::_completeAll(UnitTestTerrainTileManager& tileManager)
+{
+    while (tileManager.inFlightCount()) {
+        tileManager.completeFetches();
+    }
+}
+
+void TerrainTileManagerTest::_parallelFetch_test(void)
+{
+    const int                   maxConcurrentFetches = 4;
+    UnitTestTerrainTileManager  tileManager(maxConcurrentFetches);
+    TerrainOfflineAirMapQuery   terrainQuery;
+    QSignalSpy                  spyPathHeights(&terrainQuery, &TerrainQueryInterface::pathHeightsReceived);
+
+    // West to east through the middle of the flat region crosses around ten tiles
+    const QGeoRectangle& region = UnitTestTerrainQuery::flat10Region;
+    QGeoCoordinate fromCoord(region.center().latitude(), region.topLeft().longitude() + 0.005);
+    QGeoCoordinate toCoord  (region.center().latitude(), region.bottomRight().longitude() - 0.005);
+    tileManager.addPathQuery(&terrainQuery, fromCoord, toCoord);
+
+    // All missing tiles are known up front so the fetches go out in parallel up to the limit
+    QCOMPARE(tileManager.inFlightCount(), maxConcurrentFetches);
+    QCOMPARE(spyPathHeights.count(), 0);
+
+    _completeAll(tileManager);
+
+    QVERIFY(tileManager.fetchCount() >= 9);
+    QCOMPARE(tileManager.maxInFlightCount(), maxConcurrentFetches);
+    QCOMPARE(spyPathHeights.count(), 1);
+    QList<QVariant> arguments = spyPathHeights.takeFirst();
+    QCOMPARE(arguments[0].toBool(), true);
+    QList<double> heights = arguments[3].value<QList<double>>();
+    QVERIFY(heights.count() > 0);
+    for (double height: heights) {
+        QCOMPARE(height, UnitTestTerrainQuery::Flat10Region::amslElevation);
+    }
+
+    // Second time around everything comes from the cache
+    tileManager.addPathQuery(&terrainQuery, fromCoord, toCoord);
+    QCOMPARE(tileManager.inFlightCount(), 0);
+    QCOMPARE(spyPathHeights.count(), 1);
+}
+
+void TerrainTileManagerTest::_sharedTile_test(void)
+{
+    UnitTestTerrainTileManager  tileManager(4);
+    TerrainOfflineAirMapQuery   terrainQuery1;
+    TerrainOfflineAirMapQuery   terrainQuery2;
+    QSignalSpy                  spyHeights1(&terrainQuery1, &TerrainQueryInterface::coordinateHeightsReceived);
+    QSignalSpy                  spyHeights2(&terrainQuery2, &TerrainQueryInterface::coordinateHeightsReceived);
+
+    // Two requests waiting on the same tile only fetch it once and are both signalled when it arrives
+    QGeoCoordinate coord = UnitTestTerrainQuery::flat10Region.center();
+    tileManager.addCoordinateQuery(&terrainQuery1, { coord });
+    tileManager.addCoordinateQuery(&terrainQuery2, { coord.atDistanceAndAzimuth(10, 0) });
+    QCOMPARE(tileManager.inFlightCount(), 1);
+
+    _completeAll(tileManager);
+
+    QCOMPARE(tileManager.fetchCount(), 1);
+    QCOMPARE(spyHeights1.count(), 1);
+    QCOMPARE(spyHeights2.count(), 1);
+    QCOMPARE(spyHeights1.takeFirst()[0].toBool(), true);
+    QCOMPARE(spyHeights2.takeFirst()[0].toBool(), true);
+}
+
+void TerrainTileManagerTest::_tileFailure_test(void)
+{
+    UnitTestTerrainTileManager  tileManager(4);
+    TerrainOfflineAirMapQuery   terrainQuery1;
+    TerrainOfflineAirMapQuery   terrainQuery2;
+    QSignalSpy                  spyHeights1(&terrainQuery1, &TerrainQueryInterface::coordinateHeightsReceived);
+    QSignalSpy                  spyHeights2(&terrainQuery2, &TerrainQueryInterface::coordinateHeightsReceived);
+
+    // Request 1 spans two tiles, request 2 only the second. Failing the first tile must only fail request 1.
+    const QGeoRectangle&    region  = UnitTestTerrainQuery::flat10Region;
+    QGeoCoordinate          coord1(region.center().latitude(), region.topLeft().longitude() + 0.005);
+    QGeoCoordinate          coord2(region.center().latitude(), region.topLeft().longitude() + 0.025);
+    quint64                 failKey = TerrainTileManager::tileKey(qFloor((coord1.longitude() + 180.0) / TerrainTile::tileSizeDegrees),
+                                                                  qFloor((coord1.latitude() + 90.0) / TerrainTile::tileSizeDegrees));
+    tileManager.addCoordinateQuery(&terrainQuery1, { coord1, coord2 });
+    tileManager.addCoordinateQuery(&terrainQuery2, { coord2 });
+    QCOMPARE(tileManager.inFlightCount(), 2);
+
+    tileManager.completeFetches(failKey);
+
+    QCOMPARE(spyHeights1.count(), 1);
+    QCOMPARE(spyHeights1.takeFirst()[0].toBool(), false);
+    QCOMPARE(spyHeights2.count(), 1);
+    QList<QVariant> arguments = spyHeights2.takeFirst();
+    QCOMPARE(arguments[0].toBool(), true);
+    QCOMPARE(arguments[1].value<QList<double>>()[0], UnitTestTerrainQuery::Flat10Region::amslElevation);
+}
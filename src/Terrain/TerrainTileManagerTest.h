@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "TerrainQuery.h"
+
+/// TerrainTileManager which serves tiles generated from the UnitTestTerrainQuery regions instead of the network.
+/// Fetches are held until completeFetches is called so the test can look at what is in flight.
+class UnitTestTerrainTileManager : public TerrainTileManager
+{
+public:
+    UnitTestTerrainTileManager(int maxConcurrentFetches);
+
+    /// Completes all in flight fetches
+    ///     @param failTileKey Fetch for this tile fails
+    void completeFetches(quint64 failTileKey = 0);
+
+    int inFlightCount       (void) const { return _inFlight.count(); }
+    int maxInFlightCount    (void) const { return _maxInFlightCount; }
+    int fetchCount          (void) const { return _fetchCount; }
+
+    static QByteArray tileBytes(int tileX, int tileY);
+
+protected:
+    void _fetchTile(int tileX, int tileY) override;
+
+private:
+    QList<quint64>  _inFlight;
+    int             _maxInFlightCount   = 0;
+    int             _fetchCount         = 0;
+};
+
+class TerrainTileManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _parallelFetch_test    (void);
+    void _sharedTile_test       (void);
+    void _tileFailure_test      (void);
+
+private:
+    void _completeAll(UnitTestTerrainTileManager& tileManager);
+};
@@ -18,6 +18,9 @@
 #include <QDataStream>
 #include <QtMath>
 
+#include <algorithm>
+#include <string.h>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "TerrainTileLog");
 
 const char*  TerrainTile::_jsonStatusKey        = "status";
@@ -32,10 +35,11 @@ const char*  TerrainTile::_jsonAvgElevationKey  = "avg";
 const char*  TerrainTile::_jsonCarpetKey        = "carpet";
 
 TerrainTile::TerrainTile()
-    : _minElevation(-1.0)
+    : _southWestLat(0)
+    , _southWestLon(0)
+    , _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -43,22 +47,12 @@ TerrainTile::TerrainTile()
 
 }
 
-TerrainTile::~TerrainTile()
-{
-    if (_data) {
-        for (int i = 0; i < _gridSizeLat; i++) {
-            delete[] _data[i];
-        }
-        delete[] _data;
-        _data = nullptr;
-    }
-}
-
 TerrainTile::TerrainTile(QByteArray byteArray)
-    : _minElevation(-1.0)
+    : _southWestLat(0)
+    , _southWestLon(0)
+    , _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -76,6 +70,8 @@ TerrainTile::TerrainTile(QByteArray byteArray)
     _southWest.setLongitude(tileInfo->swLon);
     _northEast.setLatitude(tileInfo->neLat);
     _northEast.setLongitude(tileInfo->neLon);
+    _southWestLat = tileInfo->swLat;
+    _southWestLon = tileInfo->swLon;
     _minElevation = tileInfo->minElevation;
     _maxElevation = tileInfo->maxElevation;
     _avgElevation = tileInfo->avgElevation;
@@ -85,24 +81,19 @@ TerrainTile::TerrainTile(QByteArray byteArray)
     qCDebug(TerrainTileLog) << "Loading terrain tile: " << _southWest << " - " << _northEast;
     qCDebug(TerrainTileLog) << "min:max:avg:sizeLat:sizeLon" << _minElevation << _maxElevation << _avgElevation << _gridSizeLat << _gridSizeLon;
 
+    if (_gridSizeLat < 2 || _gridSizeLon < 2) {
+        qWarning() << "Terrain tile grid too small for interpolation";
+        return;
+    }
+
     int cTileDataBytes = static_cast<int>(sizeof(int16_t)) * _gridSizeLat * _gridSizeLon;
     if (cTileBytesAvailable < cTileHeaderBytes + cTileDataBytes) {
         qWarning() << "Terrain tile binary data too small for tile data";
         return;
     }
 
-    _data = new int16_t*[_gridSizeLat];
-    for (int k = 0; k < _gridSizeLat; k++) {
-        _data[k] = new int16_t[_gridSizeLon];
-    }
-
-    int valueIndex = 0;
-    const int16_t* pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _gridSizeLat; i++) {
-        for (int j = 0; j < _gridSizeLon; j++) {
-            _data[i][j] = pTileData[valueIndex++];
-        }
-    }
+    _data.resize(_gridSizeLat * _gridSizeLon);
+    memcpy(_data.data(), byteArray.constData() + cTileHeaderBytes, static_cast<size_t>(cTileDataBytes));
 
     _isValid = true;
 
@@ -111,39 +102,52 @@ TerrainTile::TerrainTile(QByteArray byteArray)
 
 double TerrainTile::elevation(const QGeoCoordinate& coordinate) const
 {
-    if (_isValid && _southWest.isValid() && _northEast.isValid()) {
-        qCDebug(TerrainTileLog) << "elevation: " << coordinate << " , in sw " << _southWest << " , ne " << _northEast;
+    qCDebug(TerrainTileLog) << "elevation: " << coordinate << " , in sw " << _southWest << " , ne " << _northEast;
 
+    double latitude     = coordinate.latitude();
+    double longitude    = coordinate.longitude();
+    double elevation;
+
+    elevations(&latitude, &longitude, &elevation, 1);
+    return elevation;
+}
+
+void TerrainTile::elevations(const double* latitudes, const double* longitudes, double* elevations, int count) const
+{
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << "elevations: Internal error - invalid tile";
+        std::fill(elevations, elevations + count, qQNaN());
+        return;
+    }
+
+    const int16_t*  data            = _data.constData();
+    const int       gridSizeLon     = _gridSizeLon;
+    const int       maxLatIndex     = _gridSizeLat - 2;
+    const int       maxLonIndex     = _gridSizeLon - 2;
+    const double    maxLatPosition  = _gridSizeLat - 1;
+    const double    maxLonPosition  = _gridSizeLon - 1;
+    const double    valuesPerDegree = 1.0 / tileValueSpacingDegrees;
+
+    // Keep the loop body branch free so the compiler can vectorize it
+    for (int i = 0; i < count; i++) {
         // The lat/lon values in _northEast and _southWest coordinates can have rounding errors such that the coordinate
         // request may be slightly outside the tile box specified by these values. So we clamp the incoming values to the
         // edges of the tile if needed.
+        double latPosition = std::min(std::max((latitudes[i] - _southWestLat) * valuesPerDegree, 0.0), maxLatPosition);
+        double lonPosition = std::min(std::max((longitudes[i] - _southWestLon) * valuesPerDegree, 0.0), maxLonPosition);
+
+        // Index of the southernmost and westernmost known value and how far along the requested point is from it
+        int     latIndex    = std::min(static_cast<int>(latPosition), maxLatIndex);
+        int     lonIndex    = std::min(static_cast<int>(lonPosition), maxLonIndex);
+        double  latFraction = latPosition - latIndex;
+        double  lonFraction = lonPosition - lonIndex;
+
+        const int16_t*  south       = data + (latIndex * gridSizeLon) + lonIndex;
+        const int16_t*  north       = south + gridSizeLon;
+        double          southValue  = south[0] + ((south[1] - south[0]) * lonFraction);
+        double          northValue  = north[0] + ((north[1] - north[0]) * lonFraction);
 
-        double clampedLon = qMax(coordinate.longitude(), _southWest.longitude());
-        double clampedLat = qMax(coordinate.latitude(), _southWest.latitude());
-
-        // Calc the index of the southernmost and westernmost index data value
-        int lonIndex = qFloor((clampedLon - _southWest.longitude()) / tileValueSpacingDegrees);
-        int latIndex = qFloor((clampedLat - _southWest.latitude()) / tileValueSpacingDegrees);
-
-        // Calc how far along in between the known values the requested lat/lon is fractionally
-        double lonIndexLongitude    = _southWest.longitude() + (static_cast<double>(lonIndex) * tileValueSpacingDegrees);
-        double lonFraction          = (clampedLon - lonIndexLongitude) / tileValueSpacingDegrees;
-        double latIndexLatitude     = _southWest.latitude() + (static_cast<double>(latIndex) * tileValueSpacingDegrees);
-        double latFraction          = (clampedLat - latIndexLatitude) / tileValueSpacingDegrees;
-
-        // Calc the elevation as the average across the four known points
-        double known00      = _data[latIndex][lonIndex];
-        double known01      = _data[latIndex][lonIndex+1];
-        double known10      = _data[latIndex+1][lonIndex];
-        double known11      = _data[latIndex+1][lonIndex+1];
-        double lonValue1    = known00 + ((known01 - known00) * lonFraction);
-        double lonValue2    = known10 + ((known11 - known10) * lonFraction);
-        double latValue     = lonValue1 + ((lonValue2 - lonValue1) * latFraction);
-
-        return latValue;
-    } else {
-        qCWarning(TerrainTileLog) << "elevation: Internal error - invalid tile";
-        return qQNaN();
+        elevations[i] = southValue + ((northValue - southValue) * latFraction);
     }
 }
 
@@ -152,6 +156,11 @@ QGeoCoordinate TerrainTile::centerCoordinate(void) const
     return _southWest.atDistanceAndAzimuth(_southWest.distanceTo(_northEast) / 2.0, _southWest.azimuthTo(_northEast));
 }
 
+int TerrainTile::memorySize(void) const
+{
+    return static_cast<int>(sizeof(TerrainTile)) + (_data.size() * static_cast<int>(sizeof(int16_t)));
+}
+
 QByteArray TerrainTile::serializeFromAirMapJson(QByteArray input)
 {
     QJsonParseError parseError;
@@ -4,6 +4,7 @@
 #include "QGCLoggingCategory.h"
 
 #include <QGeoCoordinate>
+#include <QVector>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileLog)
 
@@ -17,7 +18,6 @@ class TerrainTile
 {
 public:
     TerrainTile();
-    ~TerrainTile();
 
     /**
     * Constructor from serialized elevation data (either from file or web)
@@ -41,6 +41,17 @@ public:
     */
     double elevation(const QGeoCoordinate& coordinate) const;
 
+    /**
+    * Evaluates the elevations for a batch of coordinates using bilinear interpolation. The coordinates are passed
+    * as separate latitude and longitude arrays so the loop can be vectorized.
+    *
+    * @param latitudes Latitudes of coordinates to evaluate
+    * @param longitudes Longitudes of coordinates to evaluate
+    * @param elevations Returned elevations, NaN if the tile is not valid
+    * @param count Number of coordinates
+    */
+    void elevations(const double* latitudes, const double* longitudes, double* elevations, int count) const;
+
     /**
     * Accessor for the minimum elevation of the tile
     *
@@ -69,6 +80,13 @@ public:
     */
     QGeoCoordinate centerCoordinate(void) const;
 
+    /**
+    * Approximate heap memory used by the tile, used as the cost in the tile cache
+    *
+    * @return size in bytes
+    */
+    int memorySize(void) const;
+
     static QByteArray serializeFromAirMapJson(QByteArray input);
 
     static constexpr double tileSizeDegrees         = 0.01;         ///< Each terrain tile represents a square area .01 degrees in lat/lon
@@ -87,12 +105,14 @@ private:
 
     QGeoCoordinate      _southWest;                                     /// South west corner of the tile
     QGeoCoordinate      _northEast;                                     /// North east corner of the tile
+    double              _southWestLat;                                  /// _southWest latitude, cached for elevation lookups
+    double              _southWestLon;                                  /// _southWest longitude, cached for elevation lookups
 
     int16_t             _minElevation;                                  /// Minimum elevation in tile
     int16_t             _maxElevation;                                  /// Maximum elevation in tile
     double              _avgElevation;                                  /// Average elevation of the tile
 
-    int16_t**           _data;                                          /// 2D elevation data array
+    QVector<int16_t>    _data;                                          /// Elevation data, row major by latitude
     int16_t             _gridSizeLat;                                   /// data grid size in latitude direction
     int16_t             _gridSizeLon;                                   /// data grid size in longitude direction
     bool                _isValid;                                       /// data loaded is valid
@@ -29,52 +29,115 @@ FTPManager::FTPManager(Vehicle* vehicle)
     // Mock link responds immediately if at all, speed up unit tests with faster timoue
     _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
+
+    _transferState.reset();
     
     // Make sure we don't have bad structure packing
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
-bool FTPManager::download(const QString& fromURI, const QString& toDir)
+bool FTPManager::_setupOperation(Operation_t operation, const QString& uri, const StateFunctions_t* rgStateMachine, size_t cStates)
 {
-    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir;
-
     if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
+        qCDebug(FTPManagerLog) << "Cannot start operation. Already in another operation";
         return false;
     }
 
+    _transferState.reset();
+
+    if (!_parseURI(uri, _transferState.fullPathOnVehicle, _ftpCompId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    _transferState.operation = operation;
+    for (size_t i=0; i<cStates; i++) {
+        _rgStateMachine.append(rgStateMachine[i]);
+    }
+
+    return true;
+}
+
+bool FTPManager::download(const QString& fromURI, const QString& toDir, bool verifyCRC)
+{
+    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir;
+
     static const StateFunctions_t rgDownloadStateMachine[] = {
         { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
         { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
         { &FTPManager::_fillMissingBlocksBegin,     &FTPManager::_fillMissingBlocksAckOrNak,    &FTPManager::_fillMissingBlocksTimeout },
+        { &FTPManager::_calcFileCRC32Begin,         &FTPManager::_calcFileCRC32AckOrNak,        &FTPManager::_calcFileCRC32Timeout },
         { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
-        { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
     };
-    for (size_t i=0; i<sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]); i++) {
-        _rgStateMachine.append(rgDownloadStateMachine[i]);
-    }
-
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-
-    if (!_parseURI(fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
-        qCWarning(FTPManagerLog) << "_parseURI failed";
+    if (!_setupOperation(OperationDownload, fromURI, rgDownloadStateMachine, sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]))) {
         return false;
     }
 
+    _transferState.toDir.setPath(toDir);
+    _transferState.verifyCRC = verifyCRC;
+
     // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
     // routines because this path does not exist locally.
     int lastDirSlashIndex;
-    for (lastDirSlashIndex=_downloadState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
-        if (_downloadState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
+    for (lastDirSlashIndex=_transferState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
+        if (_transferState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
             break;
         }
     }
     lastDirSlashIndex++; // move past slash
 
-    _downloadState.fileName = _downloadState.fullPathOnVehicle.right(_downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
+    _transferState.fileName = _transferState.fullPathOnVehicle.right(_transferState.fullPathOnVehicle.size() - lastDirSlashIndex);
+
+    qCDebug(FTPManagerLog) << "_transferState.fullPathOnVehicle:_transferState.fileName" << _transferState.fullPathOnVehicle << _transferState.fileName;
+
+    _startStateMachine();
+
+    return true;
+}
+
+bool FTPManager::upload(const QString& fromFile, const QString& toURI, bool verifyCRC)
+{
+    qCDebug(FTPManagerLog) << "upload fromFile:" << fromFile << "to:" << toURI;
+
+    QFile file(fromFile);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(FTPManagerLog) << "Unable to open upload file" << fromFile << file.errorString();
+        return false;
+    }
+    QByteArray uploadData = file.readAll();
+    file.close();
+
+    static const StateFunctions_t rgUploadStateMachine[] = {
+        { &FTPManager::_createFileBegin,            &FTPManager::_createFileAckOrNak,           &FTPManager::_createFileTimeout },
+        { &FTPManager::_writeFileBegin,             &FTPManager::_writeFileAckOrNak,            &FTPManager::_writeFileTimeout },
+        { &FTPManager::_terminateSessionBegin,      &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
+        { &FTPManager::_calcFileCRC32Begin,         &FTPManager::_calcFileCRC32AckOrNak,        &FTPManager::_calcFileCRC32Timeout },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
+    };
+    if (!_setupOperation(OperationUpload, toURI, rgUploadStateMachine, sizeof(rgUploadStateMachine)/sizeof(rgUploadStateMachine[0]))) {
+        return false;
+    }
+
+    _transferState.uploadData   = uploadData;
+    _transferState.verifyCRC    = verifyCRC;
 
-    qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
+    _startStateMachine();
+
+    return true;
+}
+
+bool FTPManager::listDirectory(const QString& uri)
+{
+    qCDebug(FTPManagerLog) << "listDirectory uri:" << uri;
+
+    static const StateFunctions_t rgListStateMachine[] = {
+        { &FTPManager::_listDirectoryBegin,         &FTPManager::_listDirectoryAckOrNak,        &FTPManager::_listDirectoryTimeout },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
+    };
+    if (!_setupOperation(OperationList, uri, rgListStateMachine, sizeof(rgListStateMachine)/sizeof(rgListStateMachine[0]))) {
+        return false;
+    }
 
     _startStateMachine();
 
@@ -83,7 +146,11 @@ bool FTPManager::download(const QString& fromURI, const QString& toDir)
 
 void FTPManager::cancel()
 {
-    if (!_downloadState.inProgress()) {
+    if (_transferState.operation == OperationList) {
+        _operationComplete("Aborted");
+        return;
+    }
+    if (!_transferState.inProgress()) {
         return;
     }
 
@@ -96,14 +163,15 @@ void FTPManager::cancel()
     for (size_t i=0; i<sizeof(rgTerminateStateMachine)/sizeof(rgTerminateStateMachine[0]); i++) {
         _rgStateMachine.append(rgTerminateStateMachine[i]);
     }
-    _downloadState.retryCount = 0;
+    _transferState.pendingRequests.clear();
+    _transferState.retryCount = 0;
     _startStateMachine();
 }
 
 void FTPManager::_terminateSessionBegin(void)
 {
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = _transferState.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
     _sendRequestExpectAck(&request);
 }
@@ -126,12 +194,12 @@ void FTPManager::_terminateSessionAckOrNak(const MavlinkFTP::Request *ackOrNak)
 
 void FTPManager::_terminateSessionTimeout(void)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (++_transferState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(_operationFailedMsg());
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_transferState.retryCount);
         _terminateSessionBegin();
     }
 
@@ -139,29 +207,64 @@ void FTPManager::_terminateSessionTimeout(void)
 
 void FTPManager::_terminateComplete(void)
 {
-    _downloadComplete("Aborted");
+    _operationComplete("Aborted");
 }
 
-/// Closes out a download session by writing the file and doing cleanup.
+/// Closes out the current operation, signalling its completion.
 ///     @param errorMsg Error message, empty if no error
-void FTPManager::_downloadComplete(const QString& errorMsg)
+void FTPManager::_operationComplete(const QString& errorMsg)
 {
-    qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
+    qCDebug(FTPManagerLog) << QString("_operationComplete: errorMsg(%1)").arg(errorMsg);
     
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
+    Operation_t operation           = _transferState.operation;
+    QString     downloadFilePath    = _transferState.toDir.absoluteFilePath(_transferState.fileName);
+    QString     vehiclePath         = _transferState.fullPathOnVehicle;
+    QStringList dirList             = _transferState.dirList;
 
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
     _currentStateMachineIndex = -1;
-    if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
+    if (_transferState.file.isOpen()) {
+        _transferState.file.close();
         if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+            _transferState.file.remove();
         }
     }
+    _transferState.reset();
+
+    switch (operation) {
+    case OperationDownload:
+        emit downloadComplete(downloadFilePath, errorMsg);
+        break;
+    case OperationUpload:
+        emit uploadComplete(vehiclePath, errorMsg);
+        break;
+    case OperationList:
+        emit listDirectoryComplete(dirList, errorMsg);
+        break;
+    case OperationNone:
+        break;
+    }
+}
+
+QString FTPManager::_operationFailedMsg(void) const
+{
+    switch (_transferState.operation) {
+    case OperationUpload:
+        return tr("Upload failed");
+    case OperationList:
+        return tr("List directory failed");
+    default:
+        return tr("Download failed");
+    }
+}
 
-    emit downloadComplete(downloadFilePath, errorMsg);
+void FTPManager::_emitProgress(void)
+{
+    uint32_t totalBytes = _transferState.operation == OperationUpload ? static_cast<uint32_t>(_transferState.uploadData.size()) : _transferState.fileSize;
+    if (totalBytes != 0) {
+        emit commandProgress((float)(totalBytes - _transferState.missingData.byteCount()) / (float)totalBytes);
+    }
 }
 
 void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
@@ -187,7 +290,9 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
 
     // Ignore old/reordered packets (handle wrap-around properly)
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+    // Responses to pipelined requests which are still pending are expected to arrive behind the latest sequence number
+    bool pendingResponse = _transferState.pendingRequests.contains(static_cast<uint16_t>(actualIncomingSeqNumber - 1));
+    if (!pendingResponse && (uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
         qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
@@ -209,6 +314,7 @@ void FTPManager::_startStateMachine(void)
 
 void FTPManager::_advanceStateMachine(void)
 {
+    _transferState.retryCount = 0;
     _currentStateMachineIndex++;
     (this->*_rgStateMachine[_currentStateMachineIndex].beginFn)();
 }
@@ -248,14 +354,14 @@ void FTPManager::_openFileROBegin(void)
     request.hdr.opcode  = MavlinkFTP::kCmdOpenFileRO;
     request.hdr.offset  = 0;
     request.hdr.size    = 0;
-    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
+    _fillRequestDataWithString(&request, _transferState.fullPathOnVehicle);
     _sendRequestExpectAck(&request);
 }
 
 void FTPManager::_openFileROTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_openFileROTimeout";
-    _downloadComplete(tr("Download failed"));
+    _operationComplete(tr("Download failed"));
 }
 
 void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -277,39 +383,59 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
 
         if (ackOrNak->hdr.size != sizeof(uint32_t)) {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack ack->hdr.size != sizeof(uint32_t)" << ackOrNak->hdr.size << sizeof(uint32_t);
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
             return;
         }
 
-        _downloadState.sessionId        = ackOrNak->hdr.session;
-        _downloadState.fileSize         = ackOrNak->openFileLength;
-        _downloadState.expectedOffset   = 0;
+        _transferState.sessionId        = ackOrNak->hdr.session;
+        _transferState.fileSize         = ackOrNak->openFileLength;
+        _transferState.expectedOffset   = 0;
+        _transferState.missingData.reset(_transferState.fileSize);
 
-        _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
+        // Opened for read as well so the CRC can be calculated from the downloaded file
+        _transferState.file.setFileName(_transferState.toDir.filePath(_transferState.fileName));
+        if (_transferState.file.open(QFile::ReadWrite | QFile::Truncate)) {
             _advanceStateMachine();
         } else {
-            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
-            _downloadComplete(tr("Download failed"));
+            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _transferState.file open failed" << _transferState.file.errorString();
+            _operationComplete(tr("Download failed"));
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         qCDebug(FTPManagerLog) << "_handlOpenFileROAck: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(tr("Download failed"));
+    }
+}
+
+/// Writes received data to the download file if it is still missing
+/// @return false: write failed, operation has been completed with an error
+bool FTPManager::_writeDownloadData(uint32_t offset, const uint8_t* data, uint32_t size)
+{
+    uint32_t end = qMin(offset + size, _transferState.fileSize);
+    if (offset >= end || !_transferState.missingData.contains(offset, end)) {
+        return true;
+    }
+
+    if (!_transferState.file.seek(offset) || _transferState.file.write((const char*)data, end - offset) != end - offset) {
+        _operationComplete(tr("Download failed: Error saving file"));
+        return false;
     }
+    _transferState.missingData.remove(offset, end);
+
+    return true;
 }
 
 void FTPManager::_burstReadFileWorker(bool firstRequest)
 {
-    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _downloadState.expectedOffset << firstRequest << _downloadState.retryCount;
+    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _transferState.expectedOffset << firstRequest << _transferState.retryCount;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = _transferState.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-    request.hdr.offset  = _downloadState.expectedOffset;
+    request.hdr.offset  = _transferState.expectedOffset;
     request.hdr.size    = sizeof(request.data);
 
     if (firstRequest) {
-        _downloadState.retryCount = 0;
+        _transferState.retryCount = 0;
     } else {
         // Must used same sequence number as previous request
         _expectedIncomingSeqNumber -= 2;
@@ -331,8 +457,8 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+    if (ackOrNak->hdr.session != _transferState.sessionId) {
+        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _transferState.sessionId;
         return;
     }
 
@@ -346,30 +472,22 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
 
         qCDebug(FTPManagerLog) << QString("_burstReadFileAckOrNak: Ack offset(%1) size(%2) burstComplete(%3)").arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (ackOrNak->hdr.offset > _downloadState.expectedOffset) {
-                // There is a hole in our data, record it as missing and continue on
-                MissingData_t missingData;
-                missingData.offset          = _downloadState.expectedOffset;
-                missingData.cBytesMissing   = ackOrNak->hdr.offset - _downloadState.expectedOffset;
-                _downloadState.rgMissingData.append(missingData);
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: adding missing data offset:cBytesMissing" << missingData.offset << missingData.cBytesMissing;
+        if (ackOrNak->hdr.offset != _transferState.expectedOffset) {
+            if (ackOrNak->hdr.offset > _transferState.expectedOffset) {
+                // There is a hole in our data, it stays in the missing data set and is filled in after the burst
+                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: skipped missing data offset:cBytesMissing" << _transferState.expectedOffset << ackOrNak->hdr.offset - _transferState.expectedOffset;
             } else {
                 // Offset is past what we have already seen, disregard and wait for something usefule
                 _ackOrNakTimeoutTimer.start();
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << _downloadState.expectedOffset;
+                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << _transferState.expectedOffset;
                 return;
             }
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+        if (!_writeDownloadData(ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size)) {
             return;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-        _downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+        _transferState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
 
         if (ackOrNak->hdr.burstComplete) {
             // The current burst is done, request next one in offset sequence
@@ -382,9 +500,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         }
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
+        _emitProgress();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
             qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding Nak due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
@@ -399,148 +515,466 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
             _advanceStateMachine();
         } else {
             qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
         }
     }
 }
 
 void FTPManager::_burstReadFileTimeout(void)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (++_transferState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(tr("Download failed"));
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
+        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_transferState.retryCount).arg(_transferState.expectedOffset);
         _burstReadFileWorker(false /* firstReqeust */);
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
+/// Finds the next range of missing data which is not covered by a pending request
+///     @param maxSize  Maximum size of the range
+/// @return false: no range available
+bool FTPManager::_nextMissingRange(uint32_t maxSize, uint32_t& offset, uint32_t& size) const
 {
-    if (_downloadState.rgMissingData.count()) {
+    const QMap<uint32_t, uint32_t>& intervals = _transferState.missingData.intervals();
+
+    for (auto it = intervals.constBegin(); it != intervals.constEnd(); it++) {
+        uint32_t start  = it.key();
+        uint32_t end    = it.value();
+
+        while (start < end) {
+            bool pending = false;
+            for (const PendingRequest_t& pendingRequest: _transferState.pendingRequests) {
+                if (pendingRequest.offset <= start && start < pendingRequest.offset + pendingRequest.size) {
+                    start = pendingRequest.offset + pendingRequest.size;
+                    pending = true;
+                    break;
+                }
+            }
+            if (pending) {
+                continue;
+            }
+
+            offset  = start;
+            size    = qMin(end - start, maxSize);
+            for (const PendingRequest_t& pendingRequest: _transferState.pendingRequests) {
+                if (pendingRequest.offset > offset && pendingRequest.offset < offset + size) {
+                    size = pendingRequest.offset - offset;
+                }
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Keeps the window of pipelined read or write requests full. Moves on to the next state once nothing is missing.
+void FTPManager::_pipelineWorker(MavlinkFTP::OpCode_t opCode)
+{
+    if (_transferState.missingData.isEmpty()) {
+        _transferState.pendingRequests.clear();
+        _ackOrNakTimeoutTimer.stop();
+        _advanceStateMachine();
+        return;
+    }
+
+    while (_transferState.pendingRequests.count() < _transferState.window) {
         MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
+        uint32_t            offset;
+        uint32_t            size;
+
+        if (!_nextMissingRange(sizeof(request.data), offset, size)) {
+            break;
+        }
 
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
+        request.hdr.session = _transferState.sessionId;
+        request.hdr.opcode  = opCode;
+        request.hdr.offset  = offset;
+        request.hdr.size    = static_cast<uint8_t>(size);
+        if (opCode == MavlinkFTP::kCmdWriteFile) {
+            memcpy(request.data, _transferState.uploadData.constData() + offset, size);
+        }
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
+        qCDebug(FTPManagerLog) << "_pipelineWorker: opCode:offset:size:window" << MavlinkFTP::opCodeToString(opCode) << offset << size << _transferState.window;
+
+        uint16_t seqNumber = _sendRequest(&request);
+        _transferState.pendingRequests[seqNumber] = { offset, size };
+    }
 
-        request.hdr.session                 = _downloadState.sessionId;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
+    _ackOrNakTimeoutTimer.start();
+}
+
+/// Validates an ack for a pipelined request and adapts the window. The vehicle handles requests in order, so any
+/// requests sent before the acked one which are still pending were lost. Their data is still in the missing set and
+/// is requested again by the next _pipelineWorker call.
+///     @param pendingRequest Returns the request which was acked
+/// @return false: not an ack for a pending request
+bool FTPManager::_pipelineAck(const MavlinkFTP::Request* ackOrNak, MavlinkFTP::OpCode_t opCode, PendingRequest_t& pendingRequest)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != opCode) {
+        qCDebug(FTPManagerLog) << "_pipelineAck: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return false;
+    }
+    if (ackOrNak->hdr.session != _transferState.sessionId) {
+        qCDebug(FTPManagerLog) << "_pipelineAck: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _transferState.sessionId;
+        return false;
+    }
 
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
+    uint16_t requestSeqNumber = ackOrNak->hdr.seqNumber - 1;
+    auto pendingIt = _transferState.pendingRequests.find(requestSeqNumber);
+    if (pendingIt == _transferState.pendingRequests.end()) {
+        qCDebug(FTPManagerLog) << "_pipelineAck: Disregarding response to request which is no longer pending" << ackOrNak->hdr.seqNumber;
+        return false;
+    }
+    pendingRequest = pendingIt.value();
+    _transferState.pendingRequests.erase(pendingIt);
+
+    bool lostRequests = false;
+    for (auto it = _transferState.pendingRequests.begin(); it != _transferState.pendingRequests.end(); ) {
+        if (static_cast<uint16_t>(requestSeqNumber - it.key()) < std::numeric_limits<uint16_t>::max()/2) {
+            qCDebug(FTPManagerLog) << "_pipelineAck: lost request offset:size" << it.value().offset << it.value().size;
+            it = _transferState.pendingRequests.erase(it);
+            lostRequests = true;
         } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
+            it++;
         }
-        _downloadState.expectedOffset = request.hdr.offset;
+    }
 
-        _sendRequestExpectAck(&request);
-    } else {
-        // We should have the full file now
-        if (_downloadState.bytesWritten == _downloadState.fileSize) {
-            _advanceStateMachine();
-        } else {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
-            _downloadComplete(tr("Download failed"));
+    if (lostRequests) {
+        _transferState.window       = qMax(1, _transferState.window / 2);
+        _transferState.windowAcks   = 0;
+    } else if (++_transferState.windowAcks >= _transferState.window) {
+        _transferState.windowAcks = 0;
+        if (_transferState.window < _maxWindow) {
+            _transferState.window++;
         }
     }
+    _transferState.retryCount = 0;
+
+    return true;
+}
+
+/// Nothing came back for the timeout period, so all pending requests are lost. Starts over with a single request in flight.
+void FTPManager::_pipelineTimeout(MavlinkFTP::OpCode_t opCode)
+{
+    if (++_transferState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << "_pipelineTimeout retries exceeded" << MavlinkFTP::opCodeToString(opCode);
+        _operationComplete(_operationFailedMsg());
+        return;
+    }
+
+    qCDebug(FTPManagerLog) << QString("_pipelineTimeout: retrying - retryCount(%1) pending(%2)").arg(_transferState.retryCount).arg(_transferState.pendingRequests.count());
+    _transferState.pendingRequests.clear();
+    _transferState.window       = 1;
+    _transferState.windowAcks   = 0;
+    _pipelineWorker(opCode);
 }
 
 void FTPManager::_fillMissingBlocksBegin(void)
 {
-    _fillMissingBlocksWorker(true /* firstRequest */);
+    _pipelineWorker(MavlinkFTP::kCmdReadFile);
 }
 
 void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        if (ackOrNak->hdr.req_opcode != MavlinkFTP::kCmdReadFile || !_transferState.pendingRequests.contains(ackOrNak->hdr.seqNumber - 1)) {
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding Nak for request which is not pending" << ackOrNak->hdr.seqNumber;
+            return;
+        }
 
-    if (requestOpCode != MavlinkFTP::kCmdReadFile) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _operationComplete(tr("Download failed"));
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+
+    PendingRequest_t pendingRequest;
+    if (ackOrNak->hdr.opcode != MavlinkFTP::kRspAck || !_pipelineAck(ackOrNak, MavlinkFTP::kCmdReadFile, pendingRequest)) {
+        return;
+    }
+
+    qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
+
+    if (ackOrNak->hdr.size == 0) {
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack with no data";
+        _operationComplete(tr("Download failed"));
+        return;
+    }
+    if (ackOrNak->hdr.offset != pendingRequest.offset) {
+        // Data stays missing and is requested again
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset mismatch actual:expected" << ackOrNak->hdr.offset << pendingRequest.offset;
+    } else if (!_writeDownloadData(ackOrNak->hdr.offset, ackOrNak->data, qMin(static_cast<uint32_t>(ackOrNak->hdr.size), pendingRequest.size))) {
         return;
     }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+
+    _pipelineWorker(MavlinkFTP::kCmdReadFile);
+
+    // Emit progress last, as cancel could be called in there
+    _emitProgress();
+}
+
+void FTPManager::_fillMissingBlocksTimeout(void)
+{
+    _pipelineTimeout(MavlinkFTP::kCmdReadFile);
+}
+
+void FTPManager::_createFileBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCreateFile;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _transferState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_createFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCreateFile) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
         return;
     }
 
     _ackOrNakTimeoutTimer.stop();
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack - sessionId" << ackOrNak->hdr.session;
+        _transferState.sessionId    = ackOrNak->hdr.session;
+        _transferState.fileSize     = static_cast<uint32_t>(_transferState.uploadData.size());
+        _transferState.missingData.reset(_transferState.fileSize);
+        _advanceStateMachine();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _operationComplete(tr("Upload failed"));
+    }
+}
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
-                qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
-                _downloadComplete(tr("Download failed"));
-                return;
-            }
+void FTPManager::_createFileTimeout(void)
+{
+    qCDebug(FTPManagerLog) << "_createFileTimeout";
+    _operationComplete(tr("Upload failed"));
+}
+
+void FTPManager::_writeFileBegin(void)
+{
+    _pipelineWorker(MavlinkFTP::kCmdWriteFile);
+}
 
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
+void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        if (ackOrNak->hdr.req_opcode != MavlinkFTP::kCmdWriteFile || !_transferState.pendingRequests.contains(ackOrNak->hdr.seqNumber - 1)) {
+            qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding Nak for request which is not pending" << ackOrNak->hdr.seqNumber;
             return;
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
-            return;
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _operationComplete(tr("Upload failed"));
+        return;
+    }
+
+    PendingRequest_t pendingRequest;
+    if (ackOrNak->hdr.opcode != MavlinkFTP::kRspAck || !_pipelineAck(ackOrNak, MavlinkFTP::kCmdWriteFile, pendingRequest)) {
+        return;
+    }
+
+    qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Ack offset:size" << pendingRequest.offset << pendingRequest.size;
+    _transferState.missingData.remove(pendingRequest.offset, pendingRequest.offset + pendingRequest.size);
+
+    _pipelineWorker(MavlinkFTP::kCmdWriteFile);
+
+    // Emit progress last, as cancel could be called in there
+    _emitProgress();
+}
+
+void FTPManager::_writeFileTimeout(void)
+{
+    _pipelineTimeout(MavlinkFTP::kCmdWriteFile);
+}
+
+bool FTPManager::_localFileCRC32(quint32& crc)
+{
+    crc = 0;
+
+    if (_transferState.operation == OperationUpload) {
+        crc = QGC::crc32(reinterpret_cast<const quint8*>(_transferState.uploadData.constData()), static_cast<unsigned>(_transferState.uploadData.size()), crc);
+        return true;
+    }
+
+    if (!_transferState.file.flush() || !_transferState.file.seek(0)) {
+        return false;
+    }
+    while (!_transferState.file.atEnd()) {
+        QByteArray bytes = _transferState.file.read(64 * 1024);
+        if (bytes.isEmpty()) {
+            return false;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+        crc = QGC::crc32(reinterpret_cast<const quint8*>(bytes.constData()), static_cast<unsigned>(bytes.size()), crc);
+    }
+
+    return true;
+}
+
+void FTPManager::_calcFileCRC32Begin(void)
+{
+    if (!_transferState.verifyCRC) {
+        _advanceStateMachine();
+        return;
+    }
+
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCalcFileCRC32;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _transferState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_calcFileCRC32AckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCalcFileCRC32) {
+        qCDebug(FTPManagerLog) << "_calcFileCRC32AckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_calcFileCRC32AckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        if (ackOrNak->hdr.size != sizeof(uint32_t)) {
+            qCDebug(FTPManagerLog) << "_calcFileCRC32AckOrNak: Ack ack->hdr.size != sizeof(uint32_t)" << ackOrNak->hdr.size;
+            _operationComplete(_operationFailedMsg());
+            return;
         }
 
-        // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
+        quint32 vehicleCRC;
+        quint32 localCRC;
+        memcpy(&vehicleCRC, ackOrNak->data, sizeof(vehicleCRC));
+        if (!_localFileCRC32(localCRC)) {
+            _operationComplete(_operationFailedMsg());
+            return;
+        }
 
-        // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
+        qCDebug(FTPManagerLog) << "_calcFileCRC32AckOrNak: vehicle:local" << vehicleCRC << localCRC;
+        if (vehicleCRC != localCRC) {
+            _operationComplete(tr("%1: CRC32 mismatch").arg(_operationFailedMsg()));
+        } else {
+            _advanceStateMachine();
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
-        if (errorCode == MavlinkFTP::kErrEOF) {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.bytesWritten == _downloadState.fileSize) {
-                // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
-                return;
-            }
+        if (errorCode == MavlinkFTP::kErrUnknownCommand) {
+            qCWarning(FTPManagerLog) << "Vehicle does not support CRC32, file not verified" << _transferState.fullPathOnVehicle;
+            _advanceStateMachine();
+        } else {
+            qCDebug(FTPManagerLog) << "_calcFileCRC32AckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _operationComplete(_operationFailedMsg());
         }
+    }
+}
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed"));
+void FTPManager::_calcFileCRC32Timeout(void)
+{
+    if (++_transferState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_calcFileCRC32Timeout retries exceeded");
+        _operationComplete(_operationFailedMsg());
+    } else {
+        // Try again with the same sequence number
+        qCDebug(FTPManagerLog) << QString("_calcFileCRC32Timeout: retrying - retryCount(%1)").arg(_transferState.retryCount);
+        _expectedIncomingSeqNumber -= 2;
+        _calcFileCRC32Begin();
     }
+}
 
+void FTPManager::_listDirectoryBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
+    request.hdr.offset  = static_cast<uint32_t>(_transferState.dirEntryCount);
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _transferState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
 }
 
-void FTPManager::_fillMissingBlocksTimeout(void)
+void FTPManager::_listDirectoryAckOrNak(const MavlinkFTP::Request* ackOrNak)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdListDirectory) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        // Data is a sequence of null terminated entries: F<name>\t<size>, D<name> or S (skipped entry)
+        const char* data        = reinterpret_cast<const char*>(ackOrNak->data);
+        int         dataSize    = qMin(static_cast<int>(ackOrNak->hdr.size), static_cast<int>(sizeof(ackOrNak->data)));
+        int         entryCount  = 0;
+        int         index       = 0;
+        while (index < dataSize) {
+            int cchEntry = static_cast<int>(strnlen(&data[index], static_cast<size_t>(dataSize - index)));
+            if (cchEntry != 0) {
+                QString entry = QString::fromUtf8(&data[index], cchEntry);
+                if (!entry.startsWith('S')) {
+                    _transferState.dirList.append(entry);
+                }
+                entryCount++;
+            }
+            index += cchEntry + 1;
+        }
+
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Ack entryCount" << entryCount;
+        if (entryCount == 0) {
+            _advanceStateMachine();
+        } else {
+            // Ask for the entries following these
+            _transferState.dirEntryCount += entryCount;
+            _listDirectoryBegin();
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode == MavlinkFTP::kErrEOF) {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak EOF";
+            _advanceStateMachine();
+        } else {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _operationComplete(tr("List directory failed"));
+        }
+    }
+}
+
+void FTPManager::_listDirectoryTimeout(void)
+{
+    if (++_transferState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout retries exceeded");
+        _operationComplete(tr("List directory failed"));
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
+        // Try again with the same sequence number
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1)").arg(_transferState.retryCount);
+        _expectedIncomingSeqNumber -= 2;
+        _listDirectoryBegin();
     }
 }
 
@@ -572,14 +1006,14 @@ void FTPManager::_resetSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
         _advanceStateMachine();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(QString());
+        _operationComplete(QString());
     }
 }
 
 void FTPManager::_resetSessionsTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_resetSessionsTimeout";
-    _downloadComplete(QString());
+    _operationComplete(QString());
 }
 
 void FTPManager::_emitErrorMessage(const QString& msg)
@@ -591,18 +1025,24 @@ void FTPManager::_emitErrorMessage(const QString& msg)
 void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
     _ackOrNakTimeoutTimer.start();
-    
+    _sendRequest(request);
+}
+
+/// Sends a request without starting the ack timeout
+/// @return Sequence number of the request, the response will be one past it
+uint16_t FTPManager::_sendRequest(MavlinkFTP::Request* request)
+{
+    request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
+    _expectedIncomingSeqNumber += 2;
+
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
-        request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
-        _expectedIncomingSeqNumber += 2;
-
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -615,6 +1055,8 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
                                                      (uint8_t*)request);                                    // Payload
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
+
+    return request->hdr.seqNumber;
 }
 
 bool FTPManager::_parseURI(const QString& uri, QString& parsedURI, uint8_t& compId)
@@ -647,3 +1089,54 @@ bool FTPManager::_parseURI(const QString& uri, QString& parsedURI, uint8_t& comp
 
     return true;
 }
+
+void FTPManager::IntervalSet::reset(uint32_t size)
+{
+    _intervals.clear();
+    if (size) {
+        _intervals[0] = size;
+    }
+    _byteCount = size;
+}
+
+void FTPManager::IntervalSet::remove(uint32_t start, uint32_t end)
+{
+    if (start >= end) {
+        return;
+    }
+
+    // Start from the interval which contains start, if any
+    auto it = _intervals.upperBound(start);
+    if (it != _intervals.begin()) {
+        auto previous = it - 1;
+        if (previous.value() > start) {
+            it = previous;
+        }
+    }
+
+    while (it != _intervals.end() && it.key() < end) {
+        uint32_t intervalStart  = it.key();
+        uint32_t intervalEnd    = it.value();
+
+        it = _intervals.erase(it);
+        _byteCount -= intervalEnd - intervalStart;
+        if (intervalStart < start) {
+            _intervals.insert(intervalStart, start);
+            _byteCount += start - intervalStart;
+        }
+        if (intervalEnd > end) {
+            _intervals.insert(end, intervalEnd);
+            _byteCount += intervalEnd - end;
+            break;
+        }
+    }
+}
+
+bool FTPManager::IntervalSet::contains(uint32_t start, uint32_t end) const
+{
+    auto it = _intervals.upperBound(start);
+    if (it != _intervals.begin() && (it - 1).value() > start) {
+        return true;
+    }
+    return it != _intervals.end() && it.key() < end;
+}
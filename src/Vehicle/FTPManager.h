@@ -13,6 +13,8 @@
 #include <QDir>
 #include <QTimer>
 #include <QQueue>
+#include <QMap>
+#include <QStringList>
 
 #include "UASInterface.h"
 #include "QGCLoggingCategory.h"
@@ -35,18 +37,35 @@ public:
     ///     @param fromURI  File to download from vehicle, fully qualified path. May be in the format "mftp://[;comp=<id>]..." where the component id is specified.
     ///                     If component id is not specified MAV_COMP_ID_AUTOPILOT1 is used.
     ///     @param toDir    Local directory to download file to
+    ///     @param verifyCRC true: Compare the CRC32 of the downloaded file against the one calculated by the vehicle
     /// @return true: download has started, false: error, no download
     /// Signals downloadComplete, commandError, commandProgress
-    bool download(const QString& fromURI, const QString& toDir);
+    bool download(const QString& fromURI, const QString& toDir, bool verifyCRC = false);
+
+    /// Uploads the specified file.
+    ///     @param fromFile Local file to upload
+    ///     @param toURI    File to create on the vehicle, fully qualified path. Same format as download.
+    ///     @param verifyCRC true: Compare the CRC32 of the uploaded file as calculated by the vehicle against the local file
+    /// @return true: upload has started, false: error, no upload
+    /// Signals uploadComplete, commandError, commandProgress
+    bool upload(const QString& fromFile, const QString& toURI, bool verifyCRC = true);
+
+    /// Lists the contents of the specified directory.
+    ///     @param uri  Directory on the vehicle, fully qualified path. Same format as download.
+    /// @return true: list has started, false: error
+    /// Signals listDirectoryComplete. Entries are in the form F<name>\t<size> for files and D<name> for directories.
+    bool listDirectory(const QString& uri);
 
     /// Cancel the current operation
-    /// This will emit downloadComplete() when done, and if there's currently a download in progress
+    /// This will emit the completion signal of the operation when done, if there is an operation in progress
     void cancel();
 
     static const char* mavlinkFTPScheme;
 
 signals:
-    void downloadComplete(const QString& file, const QString& errorMsg);
+    void downloadComplete       (const QString& file, const QString& errorMsg);
+    void uploadComplete         (const QString& file, const QString& errorMsg);
+    void listDirectoryComplete  (const QStringList& dirList, const QString& errorMsg);
     
     // Signals associated with all commands
     
@@ -73,34 +92,72 @@ private:
         StateTimeoutFn  timeoutFn;
     };
 
-    struct MissingData_t {
+    typedef enum {
+        OperationNone,
+        OperationDownload,
+        OperationUpload,
+        OperationList,
+    } Operation_t;
+
+    /// Set of non-overlapping byte ranges, used to track the parts of a file which are still missing
+    class IntervalSet {
+    public:
+        void        reset       (uint32_t size);
+        void        remove      (uint32_t start, uint32_t end);
+        bool        contains    (uint32_t start, uint32_t end) const;    ///< true: some of the range is in the set
+        bool        isEmpty     (void) const { return _intervals.isEmpty(); }
+        uint32_t    byteCount   (void) const { return _byteCount; }
+
+        const QMap<uint32_t, uint32_t>& intervals(void) const { return _intervals; }
+
+    private:
+        QMap<uint32_t, uint32_t>    _intervals;     ///< start -> end (exclusive)
+        uint32_t                    _byteCount = 0;
+    };
+
+    /// Read or write request which has been sent and not yet acked
+    struct PendingRequest_t {
         uint32_t offset;
-        uint32_t cBytesMissing;
+        uint32_t size;
     };
 
-    struct DownloadState_t {
+    struct TransferState_t {
+        Operation_t             operation;
         uint8_t                 sessionId;
-        uint32_t                expectedOffset;         ///< offset which should be coming next
-        uint32_t                bytesWritten;
-        QList<MissingData_t>    rgMissingData;
+        uint32_t                expectedOffset;         ///< offset which should be coming next in a burst
+        IntervalSet             missingData;            ///< Download: not yet received, Upload: not yet acked
+        QMap<uint16_t, PendingRequest_t> pendingRequests; ///< Pipelined requests in flight, keyed by sequence number
+        int                     window;                 ///< Maximum number of pipelined requests in flight
+        int                     windowAcks;             ///< Acks received since the window last grew
         QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
-        uint32_t                fileSize;               ///< Size of file being downloaded
+        uint32_t                fileSize;               ///< Size of file being transferred
         QFile                   file;
+        QByteArray              uploadData;
+        bool                    verifyCRC;
+        QStringList             dirList;
+        int                     dirEntryCount;          ///< Number of entries listed so far, including skipped ones
         int                     retryCount;
 
         bool inProgress() const { return fileSize > 0; }
 
         void reset() {
+            operation       = OperationNone;
             sessionId       = 0;
             expectedOffset  = 0;
-            bytesWritten    = 0;
+            window          = _initialWindow;
+            windowAcks      = 0;
             retryCount      = 0;
             fileSize        = 0;
+            verifyCRC       = false;
+            dirEntryCount   = 0;
             fullPathOnVehicle.clear();
             fileName.clear();
-            rgMissingData.clear();
+            missingData.reset(0);
+            pendingRequests.clear();
+            uploadData.clear();
+            dirList.clear();
             file.close();
         }
     };
@@ -118,18 +175,39 @@ private:
     void    _fillMissingBlocksBegin     (void);
     void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
     void    _fillMissingBlocksTimeout   (void);
+    void    _createFileBegin            (void);
+    void    _createFileAckOrNak         (const MavlinkFTP::Request* ackOrNak);
+    void    _createFileTimeout          (void);
+    void    _writeFileBegin             (void);
+    void    _writeFileAckOrNak          (const MavlinkFTP::Request* ackOrNak);
+    void    _writeFileTimeout           (void);
+    void    _calcFileCRC32Begin         (void);
+    void    _calcFileCRC32AckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _calcFileCRC32Timeout       (void);
+    void    _listDirectoryBegin         (void);
+    void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _listDirectoryTimeout       (void);
     void    _resetSessionsBegin         (void);
     void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
+    uint16_t _sendRequest               (MavlinkFTP::Request* request);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
-    void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
-    void    _downloadComplete           (const QString& errorMsg);
+    void    _operationCompleteNoError   (void) { _operationComplete(QString()); }
+    void    _operationComplete          (const QString& errorMsg);
+    QString _operationFailedMsg         (void) const;
     void    _emitErrorMessage           (const QString& msg);
+    void    _emitProgress               (void);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
     void    _burstReadFileWorker        (bool firstRequest);
+    bool    _writeDownloadData          (uint32_t offset, const uint8_t* data, uint32_t size);
+    void    _pipelineWorker             (MavlinkFTP::OpCode_t opCode);
+    bool    _pipelineAck                (const MavlinkFTP::Request* ackOrNak, MavlinkFTP::OpCode_t opCode, PendingRequest_t& pendingRequest);
+    void    _pipelineTimeout            (MavlinkFTP::OpCode_t opCode);
+    bool    _nextMissingRange           (uint32_t maxSize, uint32_t& offset, uint32_t& size) const;
+    bool    _localFileCRC32             (quint32& crc);
     bool    _parseURI                   (const QString& uri, QString& parsedURI, uint8_t& compId);
+    bool    _setupOperation             (Operation_t operation, const QString& uri, const StateFunctions_t* rgStateMachine, size_t cStates);
 
     void    _terminateSessionBegin      (void);
     void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
@@ -139,12 +217,13 @@ private:
     Vehicle*                _vehicle;
     uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
     QList<StateFunctions_t> _rgStateMachine;
-    DownloadState_t         _downloadState;
+    TransferState_t         _transferState;
     QTimer                  _ackOrNakTimeoutTimer;
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
     
     static const int _ackOrNakTimeoutMsecs  = 1000;
     static const int _maxRetry              = 3;
+    static const int _initialWindow         = 4;    ///< Pipelined requests in flight at the start of a transfer
+    static const int _maxWindow             = 16;
 };
-
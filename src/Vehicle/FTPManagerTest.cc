@@ -120,6 +120,90 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testLossyPipelinedDownload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 16 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // Heavy loss leaves many holes after the burst, which are filled through pipelined reads
+    _mockLink->mockLinkFTP()->setRandomDropPercent(20);
+    QVERIFY(ftpManager->download(filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation), true /* verifyCRC */));
+
+    QCOMPARE(spyDownloadComplete.wait(30000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testUpload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    QByteArray uploadBytes;
+    for (int i=0; i<5000; i++) {
+        uploadBytes.append(static_cast<char>((i * 7) % 251));
+    }
+    QString localFile = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).filePath("FTPManagerTestUpload.bin");
+    QFile file(localFile);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write(uploadBytes);
+    file.close();
+
+    QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+
+    _mockLink->mockLinkFTP()->setRandomDropPercent(10);
+    QVERIFY(ftpManager->upload(localFile, "/upload.bin"));
+
+    QCOMPARE(spyUploadComplete.wait(30000), true);
+    QCOMPARE(spyUploadComplete.count(), 1);
+
+    // void uploadComplete     (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyUploadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(_mockLink->mockLinkFTP()->uploadData(), uploadBytes);
+
+    file.remove();
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testListDirectory(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QStringList fileList    = { "Ddir", "Ffile1.txt\t100", "Ffile2.bin\t2000" };
+
+    _mockLink->mockLinkFTP()->setFileList(fileList);
+
+    QSignalSpy spyListComplete(ftpManager, &FTPManager::listDirectoryComplete);
+
+    QVERIFY(ftpManager->listDirectory("/"));
+
+    QCOMPARE(spyListComplete.wait(10000), true);
+    QCOMPARE(spyListComplete.count(), 1);
+
+    // void listDirectoryComplete  (const QStringList& dirList, const QString& errorMsg);
+    QList<QVariant> arguments = spyListComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(arguments[0].toStringList(), fileList);
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
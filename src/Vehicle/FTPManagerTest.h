@@ -17,6 +17,9 @@ class FTPManagerTest : public UnitTest
 
 private slots:
     void _testLostPackets           (void);
+    void _testLossyPipelinedDownload(void);
+    void _testUpload                (void);
+    void _testListDirectory         (void);
 
     // Overrides from UnitTest
     void cleanup(void) override;
@@ -18,6 +18,7 @@ const char* GPSRTKFactGroup::_currentAltitudeFactName =          "currentAltitud
 const char* GPSRTKFactGroup::_validFactName =                    "valid";
 const char* GPSRTKFactGroup::_activeFactName =                   "active";
 const char* GPSRTKFactGroup::_numSatellitesFactName =            "numSatellites";
+const char* GPSRTKFactGroup::_rtcmFactGroupName =                "rtcm";
 
 GPSRTKFactGroup::GPSRTKFactGroup(QObject* parent)
     : FactGroup             (1000, ":/json/Vehicle/GPSRTKFact.json", parent)
@@ -40,5 +41,7 @@ GPSRTKFactGroup::GPSRTKFactGroup(QObject* parent)
     _addFact(&_valid,              _validFactName);
     _addFact(&_active,             _activeFactName);
     _addFact(&_numSatellites,      _numSatellitesFactName);
+
+    _addFactGroup(&_rtcmFactGroup, _rtcmFactGroupName);
 }
 
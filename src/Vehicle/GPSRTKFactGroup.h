@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Vehicle.h"
+#include "RTCMFactGroup.h"
 
 class GPSRTKFactGroup : public FactGroup
 {
@@ -28,6 +29,7 @@ public:
     Q_PROPERTY(Fact* valid                READ valid                CONSTANT)
     Q_PROPERTY(Fact* active               READ active               CONSTANT)
     Q_PROPERTY(Fact* numSatellites        READ numSatellites        CONSTANT)
+    Q_PROPERTY(FactGroup* rtcm            READ rtcm                 CONSTANT)
 
     Fact* connected         (void) { return &_connected; }
     Fact* currentDuration   (void) { return &_currentDuration; }
@@ -38,6 +40,7 @@ public:
     Fact* valid             (void) { return &_valid; }
     Fact* active            (void) { return &_active; }
     Fact* numSatellites     (void) { return &_numSatellites; }
+    RTCMFactGroup* rtcm     (void) { return &_rtcmFactGroup; }
 
     static const char* _connectedFactName;
     static const char* _currentDurationFactName;
@@ -48,6 +51,7 @@ public:
     static const char* _validFactName;
     static const char* _activeFactName;
     static const char* _numSatellitesFactName;
+    static const char* _rtcmFactGroupName;
 
 private:
     Fact _connected;        ///< is an RTK gps connected?
@@ -59,4 +63,6 @@ private:
     Fact _valid;            ///< survey-in complete?
     Fact _active;           ///< survey-in active?
     Fact _numSatellites;    ///< number of satellites
+
+    RTCMFactGroup _rtcmFactGroup;
 };
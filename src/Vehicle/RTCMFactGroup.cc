@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "RTCMFactGroup.h"
+
+const char* RTCMFactGroup::_inputRateFactName =      "inputRate";
+const char* RTCMFactGroup::_outputRateFactName =     "outputRate";
+const char* RTCMFactGroup::_messageCountFactName =   "messageCount";
+const char* RTCMFactGroup::_packetCountFactName =    "packetCount";
+const char* RTCMFactGroup::_droppedCountFactName =   "droppedCount";
+const char* RTCMFactGroup::_latencyFactName =        "latency";
+
+RTCMFactGroup::RTCMFactGroup(QObject* parent)
+    : FactGroup         (1000, ":/json/Vehicle/RTCMFact.json", parent)
+    , _inputRate        (0, _inputRateFactName,     FactMetaData::valueTypeDouble)
+    , _outputRate       (0, _outputRateFactName,    FactMetaData::valueTypeDouble)
+    , _messageCount     (0, _messageCountFactName,  FactMetaData::valueTypeUint32)
+    , _packetCount      (0, _packetCountFactName,   FactMetaData::valueTypeUint32)
+    , _droppedCount     (0, _droppedCountFactName,  FactMetaData::valueTypeUint32)
+    , _latency          (0, _latencyFactName,       FactMetaData::valueTypeDouble)
+{
+    _addFact(&_inputRate,       _inputRateFactName);
+    _addFact(&_outputRate,      _outputRateFactName);
+    _addFact(&_messageCount,    _messageCountFactName);
+    _addFact(&_packetCount,     _packetCountFactName);
+    _addFact(&_droppedCount,    _droppedCountFactName);
+    _addFact(&_latency,         _latencyFactName);
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "FactGroup.h"
+
+/// Statistics for the RTCM corrections sent to the vehicles
+class RTCMFactGroup : public FactGroup
+{
+    Q_OBJECT
+
+public:
+    RTCMFactGroup(QObject* parent = nullptr);
+
+    Q_PROPERTY(Fact* inputRate          READ inputRate          CONSTANT)
+    Q_PROPERTY(Fact* outputRate         READ outputRate         CONSTANT)
+    Q_PROPERTY(Fact* messageCount       READ messageCount       CONSTANT)
+    Q_PROPERTY(Fact* packetCount        READ packetCount        CONSTANT)
+    Q_PROPERTY(Fact* droppedCount       READ droppedCount       CONSTANT)
+    Q_PROPERTY(Fact* latency            READ latency            CONSTANT)
+
+    Fact* inputRate         (void) { return &_inputRate; }
+    Fact* outputRate        (void) { return &_outputRate; }
+    Fact* messageCount      (void) { return &_messageCount; }
+    Fact* packetCount       (void) { return &_packetCount; }
+    Fact* droppedCount      (void) { return &_droppedCount; }
+    Fact* latency           (void) { return &_latency; }
+
+    static const char* _inputRateFactName;
+    static const char* _outputRateFactName;
+    static const char* _messageCountFactName;
+    static const char* _packetCountFactName;
+    static const char* _droppedCountFactName;
+    static const char* _latencyFactName;
+
+private:
+    Fact _inputRate;        ///< RTCM data received from the base station in [kB/s]
+    Fact _outputRate;       ///< GPS_RTCM_DATA sent over all links in [kB/s]
+    Fact _messageCount;     ///< RTCM messages received
+    Fact _packetCount;      ///< GPS_RTCM_DATA packets sent
+    Fact _droppedCount;     ///< RTCM messages dropped because a newer one superseded them
+    Fact _latency;          ///< average time an RTCM message waited for link capacity in [ms]
+};
@@ -0,0 +1,401 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryRecorder.h"
+#include "Fact.h"
+#include "FactGroup.h"
+#include "QGCLoggingCategory.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TelemetryRecorderLog, "TelemetryRecorderLog")
+
+const char* TelemetryRecorder::_magic = "QTLM";
+
+TelemetryRecorder::TelemetryRecorder(QObject* parent)
+    : QThread(parent)
+{
+
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    stop();
+}
+
+void TelemetryRecorder::addFactGroup(const QString& name, FactGroup* factGroup)
+{
+    for (const QString& factName: factGroup->factNames()) {
+        addFact(QStringLiteral("%1.%2").arg(name, factName), factGroup->getFact(factName));
+    }
+}
+
+void TelemetryRecorder::addFact(const QString& name, Fact* fact)
+{
+    if (isRunning()) {
+        qCWarning(TelemetryRecorderLog) << "addFact called while recording" << name;
+        return;
+    }
+
+    int size = _columnSize(fact->type());
+    if (size == 0) {
+        qCDebug(TelemetryRecorderLog) << "Skipping fact with unsupported type" << name << FactMetaData::typeToString(fact->type());
+        return;
+    }
+
+    int column = _columns.count();
+    _columns.append({ fact, name, fact->rawUnits(), fact->type(), size });
+    _rowSize += size;
+
+    connect(fact, &Fact::rawValueChanged, this, [this, column](QVariant value) { _storeValue(column, value); });
+}
+
+bool TelemetryRecorder::start(const QString& fileName, double rateHz, bool compress)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    _file.setFileName(fileName);
+    if (!_file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(TelemetryRecorderLog) << "Unable to open recording file" << fileName << _file.errorString();
+        return false;
+    }
+
+    _rateHz     = rateHz;
+    _compress   = compress;
+    _values.reset(new std::atomic<quint64>[static_cast<size_t>(qMax(1, _columns.count()))]);
+    for (int i=0; i<_columns.count(); i++) {
+        _storeValue(i, _columns[i].fact->rawValue());
+    }
+
+    QDataStream stream(&_file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    stream.writeRawData(_magic, 4);
+    stream << _version << static_cast<quint16>(_compress ? _flagCompressed : 0) << QDateTime::currentMSecsSinceEpoch() << _rateHz << static_cast<quint32>(_columns.count());
+    for (const Column_t& column: _columns) {
+        QByteArray name     = column.name.toUtf8();
+        QByteArray units    = column.units.toUtf8();
+        stream << static_cast<quint8>(column.type);
+        stream << static_cast<quint16>(name.size());
+        stream.writeRawData(name.constData(), name.size());
+        stream << static_cast<quint16>(units.size());
+        stream.writeRawData(units.constData(), units.size());
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(TelemetryRecorderLog) << "Unable to write recording header" << fileName << _file.errorString();
+        _file.close();
+        return false;
+    }
+
+    qCDebug(TelemetryRecorderLog) << "Recording" << _columns.count() << "columns at" << _rateHz << "Hz to" << fileName;
+
+    _chunk.clear();
+    _chunk.reserve(_rowSize * _rowsPerChunk);
+    _chunkRows  = 0;
+    _stopThread = false;
+    QThread::start(QThread::LowPriority);
+
+    return true;
+}
+
+void TelemetryRecorder::stop(void)
+{
+    if (isRunning()) {
+        _stopThread = true;
+        wait();
+    }
+}
+
+void TelemetryRecorder::run(void)
+{
+    QElapsedTimer   timer;
+    const qint64    periodNsecs     = static_cast<qint64>(1000000000.0 / _rateHz);
+    const qint64    flushNsecs      = static_cast<qint64>(_flushIntervalMsecs) * 1000000;
+    qint64          nextSampleNsecs = 0;
+    qint64          nextFlushNsecs  = flushNsecs;
+
+    timer.start();
+
+    while (!_stopThread) {
+        qint64 nowNsecs = timer.nsecsElapsed();
+        if (nowNsecs < nextSampleNsecs) {
+            QThread::usleep(static_cast<unsigned long>((nextSampleNsecs - nowNsecs) / 1000));
+            continue;
+        }
+
+        _sampleRow(static_cast<quint64>(nowNsecs / 1000));
+
+        // If we fell behind, skip the missed samples instead of bursting to catch up
+        nextSampleNsecs += periodNsecs;
+        if (nextSampleNsecs <= nowNsecs) {
+            nextSampleNsecs = nowNsecs + periodNsecs;
+        }
+
+        if (_chunkRows >= _rowsPerChunk || nowNsecs >= nextFlushNsecs) {
+            if (!_writeChunk()) {
+                break;
+            }
+            nextFlushNsecs = nowNsecs + flushNsecs;
+        }
+    }
+
+    _writeChunk();
+    _file.close();
+}
+
+void TelemetryRecorder::_storeValue(int column, const QVariant& value)
+{
+    if (!_values) {
+        return;
+    }
+
+    quint64 bits = 0;
+
+    switch (_columns[column].type) {
+    case FactMetaData::valueTypeFloat:
+    {
+        float   floatValue = value.toFloat();
+        quint32 floatBits;
+        memcpy(&floatBits, &floatValue, sizeof(floatBits));
+        bits = floatBits;
+    }
+        break;
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+    {
+        double doubleValue = value.toDouble();
+        memcpy(&bits, &doubleValue, sizeof(bits));
+    }
+        break;
+    case FactMetaData::valueTypeUint64:
+        bits = value.toULongLong();
+        break;
+    case FactMetaData::valueTypeBool:
+        bits = value.toBool() ? 1 : 0;
+        break;
+    default:
+        bits = static_cast<quint64>(value.toLongLong());
+        break;
+    }
+
+    _values[column].store(bits, std::memory_order_relaxed);
+}
+
+void TelemetryRecorder::_sampleRow(quint64 usecs)
+{
+    quint64 littleEndian = qToLittleEndian(usecs);
+    _chunk.append(reinterpret_cast<const char*>(&littleEndian), sizeof(littleEndian));
+
+    // The low order bytes of the little endian bits are the value truncated to the column size
+    for (int i=0; i<_columns.count(); i++) {
+        littleEndian = qToLittleEndian(_values[i].load(std::memory_order_relaxed));
+        _chunk.append(reinterpret_cast<const char*>(&littleEndian), _columns[i].size);
+    }
+
+    _chunkRows++;
+}
+
+bool TelemetryRecorder::_writeChunk(void)
+{
+    if (_chunkRows == 0) {
+        return true;
+    }
+
+    QByteArray data = _compress ? qCompress(_chunk) : _chunk;
+
+    quint32 chunkHeader[2] = { qToLittleEndian(static_cast<quint32>(_chunkRows)), qToLittleEndian(static_cast<quint32>(data.size())) };
+    bool success = _file.write(reinterpret_cast<const char*>(chunkHeader), sizeof(chunkHeader)) == sizeof(chunkHeader) &&
+            _file.write(data) == data.size() &&
+            _file.flush();
+    if (!success) {
+        qCWarning(TelemetryRecorderLog) << "Recording write failed, recording stopped" << _file.fileName() << _file.errorString();
+    }
+
+    // resize keeps the reserved capacity, clear would release it
+    _chunk.resize(0);
+    _chunkRows = 0;
+
+    return success;
+}
+
+int TelemetryRecorder::_columnSize(FactMetaData::ValueType_t type)
+{
+    switch (type) {
+    case FactMetaData::valueTypeBool:
+        return 1;
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+        return sizeof(double);
+    case FactMetaData::valueTypeString:
+    case FactMetaData::valueTypeCustom:
+        return 0;
+    default:
+        return static_cast<int>(FactMetaData::typeToSize(type));
+    }
+}
+
+bool TelemetryRecorder::exportCsv(const QString& recordingFile, const QString& csvFile, QString& errorMsg)
+{
+    errorMsg.clear();
+
+    QFile inputFile(recordingFile);
+    if (!inputFile.open(QFile::ReadOnly)) {
+        errorMsg = tr("Unable to open recording: %1").arg(inputFile.errorString());
+        return false;
+    }
+
+    QDataStream inputStream(&inputFile);
+    inputStream.setByteOrder(QDataStream::LittleEndian);
+    inputStream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    char    magic[4];
+    quint16 version;
+    quint16 flags;
+    qint64  startMSecs;
+    double  rateHz;
+    quint32 columnCount;
+    if (inputStream.readRawData(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, _magic, sizeof(magic)) != 0) {
+        errorMsg = tr("File is not a telemetry recording");
+        return false;
+    }
+    inputStream >> version >> flags >> startMSecs >> rateHz >> columnCount;
+    if (inputStream.status() != QDataStream::Ok || version != _version) {
+        errorMsg = tr("Unsupported telemetry recording version");
+        return false;
+    }
+
+    QList<Column_t> columns;
+    QStringList     columnNames;
+    int             rowSize = sizeof(quint64);
+    for (quint32 i=0; i<columnCount; i++) {
+        quint8      type;
+        quint16     cchName;
+        quint16     cchUnits;
+        QByteArray  name;
+        QByteArray  units;
+
+        inputStream >> type >> cchName;
+        name.resize(cchName);
+        inputStream.readRawData(name.data(), cchName);
+        inputStream >> cchUnits;
+        units.resize(cchUnits);
+        inputStream.readRawData(units.data(), cchUnits);
+
+        FactMetaData::ValueType_t valueType = static_cast<FactMetaData::ValueType_t>(type);
+        int size = _columnSize(valueType);
+        if (inputStream.status() != QDataStream::Ok || size == 0) {
+            errorMsg = tr("Corrupt telemetry recording header");
+            return false;
+        }
+        columns.append({ nullptr, QString::fromUtf8(name), QString::fromUtf8(units), valueType, size });
+        columnNames.append(columns.last().name);
+        rowSize += size;
+    }
+
+    QFile outputFile(csvFile);
+    if (!outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+        errorMsg = tr("Unable to create csv file: %1").arg(outputFile.errorString());
+        return false;
+    }
+
+    QTextStream outputStream(&outputFile);
+    outputStream << "Timestamp," << columnNames.join(",") << "\n";
+
+    QStringList rowValues;
+    while (!inputStream.atEnd()) {
+        quint32 rowCount;
+        quint32 dataSize;
+
+        inputStream >> rowCount >> dataSize;
+        QByteArray data(static_cast<int>(dataSize), Qt::Uninitialized);
+        if (inputStream.status() != QDataStream::Ok || inputStream.readRawData(data.data(), data.size()) != data.size()) {
+            // Recording was cut off, keep what was converted so far
+            qCWarning(TelemetryRecorderLog) << "Truncated telemetry recording" << recordingFile;
+            break;
+        }
+        if (flags & _flagCompressed) {
+            data = qUncompress(data);
+        }
+        if (static_cast<quint64>(data.size()) != static_cast<quint64>(rowCount) * static_cast<quint64>(rowSize)) {
+            errorMsg = tr("Corrupt telemetry recording data");
+            return false;
+        }
+
+        const char* row = data.constData();
+        for (quint32 rowIndex=0; rowIndex<rowCount; rowIndex++) {
+            rowValues.clear();
+
+            quint64 usecs = qFromLittleEndian<quint64>(row);
+            rowValues.append(QDateTime::fromMSecsSinceEpoch(startMSecs + static_cast<qint64>(usecs / 1000)).toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")));
+
+            const char* value = row + sizeof(quint64);
+            for (const Column_t& column: columns) {
+                quint64 bits = 0;
+                memcpy(&bits, value, static_cast<size_t>(column.size));
+                bits = qFromLittleEndian(bits);
+                value += column.size;
+
+                switch (column.type) {
+                case FactMetaData::valueTypeUint8:
+                case FactMetaData::valueTypeUint16:
+                case FactMetaData::valueTypeUint32:
+                case FactMetaData::valueTypeUint64:
+                case FactMetaData::valueTypeBool:
+                    rowValues.append(QString::number(bits));
+                    break;
+                case FactMetaData::valueTypeInt8:
+                    rowValues.append(QString::number(static_cast<qint8>(bits)));
+                    break;
+                case FactMetaData::valueTypeInt16:
+                    rowValues.append(QString::number(static_cast<qint16>(bits)));
+                    break;
+                case FactMetaData::valueTypeInt32:
+                    rowValues.append(QString::number(static_cast<qint32>(bits)));
+                    break;
+                case FactMetaData::valueTypeInt64:
+                    rowValues.append(QString::number(static_cast<qint64>(bits)));
+                    break;
+                case FactMetaData::valueTypeFloat:
+                {
+                    quint32 floatBits = static_cast<quint32>(bits);
+                    float   floatValue;
+                    memcpy(&floatValue, &floatBits, sizeof(floatValue));
+                    rowValues.append(QString::number(static_cast<double>(floatValue), 'g', 9));
+                }
+                    break;
+                default:
+                {
+                    double doubleValue;
+                    memcpy(&doubleValue, &bits, sizeof(doubleValue));
+                    rowValues.append(QString::number(doubleValue, 'g', 15));
+                }
+                    break;
+                }
+            }
+
+            outputStream << rowValues.join(",") << "\n";
+            row += rowSize;
+        }
+    }
+
+    outputStream.flush();
+    if (outputFile.error() != QFile::NoError) {
+        errorMsg = tr("Unable to write csv file: %1").arg(outputFile.errorString());
+        return false;
+    }
+
+    return true;
+}
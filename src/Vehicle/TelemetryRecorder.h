@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "FactMetaData.h"
+
+#include <QThread>
+#include <QFile>
+#include <QList>
+#include <QLoggingCategory>
+
+#include <atomic>
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryRecorderLog)
+
+class Fact;
+class FactGroup;
+
+/// Records fact values to a column oriented binary file at a fixed rate. Fact changes are stored as raw bits into
+/// per column slots from the gui thread, sampling, compression and file writes happen on the recorder thread.
+///
+/// File layout (little endian):
+///     char[4]     magic "QTLM"
+///     quint16     version
+///     quint16     flags               - FlagCompressed: chunk data is qCompress'ed
+///     qint64      start time          - msecs since epoch
+///     double      sample rate Hz
+///     quint32     column count
+///     per column: quint8 type (FactMetaData::ValueType_t), quint16 + utf8 name, quint16 + utf8 raw units
+///     chunks:     quint32 row count, quint32 data size, data
+///
+/// Each row is a quint64 usecs since start followed by the fixed width raw value of each column. A chunk is written
+/// every _rowsPerChunk rows, or after _flushIntervalMsecs at low rates, so a crash loses only the last few seconds.
+class TelemetryRecorder : public QThread
+{
+    Q_OBJECT
+
+    friend class TelemetryRecorderTest; // Unit test
+
+public:
+    TelemetryRecorder(QObject* parent = nullptr);
+    ~TelemetryRecorder();
+
+    /// Adds a column for each fact of the group, named <name>.<factName>. Must be called before start.
+    void addFactGroup(const QString& name, FactGroup* factGroup);
+
+    /// Adds a single column. String and custom facts are not recorded. Must be called before start.
+    void addFact(const QString& name, Fact* fact);
+
+    /// Starts recording to the specified file
+    ///     @param rateHz   Sample rate
+    ///     @param compress true: zlib compress each chunk of rows
+    /// @return false: file could not be created
+    bool start(const QString& fileName, double rateHz, bool compress);
+
+    /// Stops recording and writes out remaining rows
+    void stop(void);
+
+    bool recording(void) const { return isRunning(); }
+
+    int columnCount(void) const { return _columns.count(); }
+
+    /// Converts a recording to a csv file with one line per sample
+    /// @return false: conversion failed, errorMsg set
+    static bool exportCsv(const QString& recordingFile, const QString& csvFile, QString& errorMsg);
+
+protected:
+    void run(void) final;
+
+private:
+    typedef struct {
+        Fact*                       fact;
+        QString                     name;
+        QString                     units;
+        FactMetaData::ValueType_t   type;
+        int                         size;
+    } Column_t;
+
+    void _storeValue    (int column, const QVariant& value);
+    void _sampleRow     (quint64 usecs);
+    bool _writeChunk    (void);
+
+    static int _columnSize(FactMetaData::ValueType_t type);
+
+    QList<Column_t>                         _columns;
+    std::unique_ptr<std::atomic<quint64>[]> _values;        ///< Current raw bits of each column, written from the gui thread
+    int                                     _rowSize        = sizeof(quint64);
+    QFile                                   _file;
+    double                                  _rateHz         = 10;
+    bool                                    _compress       = true;
+    QByteArray                              _chunk;
+    int                                     _chunkRows      = 0;
+    std::atomic<bool>                       _stopThread     {false};
+
+    static const char*      _magic;
+    static const quint16    _version            = 1;
+    static const quint16    _flagCompressed     = 0x0001;
+    static const int        _rowsPerChunk       = 512;
+    static const int        _flushIntervalMsecs = 2000;     ///< Longest time rows are held in memory before being written
+};
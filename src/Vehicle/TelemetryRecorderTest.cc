@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryRecorderTest.h"
+#include "TelemetryRecorder.h"
+#include "Fact.h"
+
+#include <QTemporaryDir>
+
+void TelemetryRecorderTest::_recordWorker(bool compress)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    Fact doubleFact (0, "double",   FactMetaData::valueTypeDouble);
+    Fact floatFact  (0, "float",    FactMetaData::valueTypeFloat);
+    Fact int16Fact  (0, "int16",    FactMetaData::valueTypeInt16);
+    Fact uint8Fact  (0, "uint8",    FactMetaData::valueTypeUint8);
+    Fact boolFact   (0, "bool",     FactMetaData::valueTypeBool);
+    Fact stringFact (0, "string",   FactMetaData::valueTypeString);
+
+    TelemetryRecorder recorder;
+    recorder.addFact("group.double",    &doubleFact);
+    recorder.addFact("group.float",     &floatFact);
+    recorder.addFact("group.int16",     &int16Fact);
+    recorder.addFact("group.uint8",     &uint8Fact);
+    recorder.addFact("group.bool",      &boolFact);
+    recorder.addFact("group.string",    &stringFact);
+
+    // String facts are not recorded
+    QCOMPARE(recorder.columnCount(), 5);
+
+    QString recordingFile   = tempDir.filePath("test.qtlm");
+    QString csvFile         = tempDir.filePath("test.csv");
+
+    QVERIFY(recorder.start(recordingFile, 50, compress));
+    QVERIFY(recorder.recording());
+
+    // Change values from the gui thread while the recorder is sampling
+    for (int i=0; i<10; i++) {
+        doubleFact.setRawValue(47.3977419 + i);
+        floatFact.setRawValue(1.5 * i);
+        int16Fact.setRawValue(-100 * i);
+        uint8Fact.setRawValue(200 + i);
+        boolFact.setRawValue((i % 2) == 1);
+        QTest::qWait(30);
+    }
+    QTest::qWait(100);
+    recorder.stop();
+    QVERIFY(!recorder.recording());
+
+    QString errorMsg;
+    QVERIFY(TelemetryRecorder::exportCsv(recordingFile, csvFile, errorMsg));
+    QVERIFY(errorMsg.isEmpty());
+
+    QFile file(csvFile);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QStringList lines = QString(file.readAll()).split("\n", Qt::SkipEmptyParts);
+
+    QCOMPARE(lines[0], QStringLiteral("Timestamp,group.double,group.float,group.int16,group.uint8,group.bool"));
+
+    // 50 Hz for around 400 msecs
+    QVERIFY(lines.count() > 10);
+
+    QStringList lastRow = lines.last().split(",");
+    QCOMPARE(lastRow.count(), 6);
+    QCOMPARE(lastRow[1].toDouble(), 47.3977419 + 9);
+    QCOMPARE(lastRow[2].toFloat(), 13.5f);
+    QCOMPARE(lastRow[3].toInt(), -900);
+    QCOMPARE(lastRow[4].toInt(), 209);
+    QCOMPARE(lastRow[5].toInt(), 1);
+}
+
+void TelemetryRecorderTest::_recordAndExport_test(void)
+{
+    _recordWorker(true /* compress */);
+}
+
+void TelemetryRecorderTest::_uncompressed_test(void)
+{
+    _recordWorker(false /* compress */);
+}
+
+void TelemetryRecorderTest::_badFile_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString badFile = tempDir.filePath("bad.qtlm");
+    QFile file(badFile);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write("not a recording");
+    file.close();
+
+    QString errorMsg;
+    QVERIFY(!TelemetryRecorder::exportCsv(badFile, tempDir.filePath("bad.csv"), errorMsg));
+    QVERIFY(!errorMsg.isEmpty());
+}
+
+void TelemetryRecorderTest::_timedFlush_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    Fact doubleFact(0, "double", FactMetaData::valueTypeDouble);
+
+    TelemetryRecorder recorder;
+    recorder.addFact("group.double", &doubleFact);
+
+    // At 10 Hz a full chunk takes far longer than the flush interval, rows must reach the file before the recording stops
+    QString recordingFile = tempDir.filePath("test.qtlm");
+    QVERIFY(recorder.start(recordingFile, 10, true /* compress */));
+    QTest::qWait(TelemetryRecorder::_flushIntervalMsecs + 500);
+    QVERIFY(recorder.recording());
+
+    QString errorMsg;
+    QString csvFile = tempDir.filePath("test.csv");
+    QVERIFY(TelemetryRecorder::exportCsv(recordingFile, csvFile, errorMsg));
+
+    QFile file(csvFile);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QStringList lines = QString(file.readAll()).split("\n", Qt::SkipEmptyParts);
+    QVERIFY(lines.count() > 10);
+
+    recorder.stop();
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for TelemetryRecorder
+class TelemetryRecorderTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _recordAndExport_test  (void);
+    void _uncompressed_test     (void);
+    void _badFile_test          (void);
+    void _timedFlush_test       (void);
+
+private:
+    void _recordWorker(bool compress);
+};
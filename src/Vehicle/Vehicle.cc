@@ -55,6 +55,7 @@
 #include "MockLink.h"
 #endif
 #include "Autotune.h"
+#include "TelemetryRecorder.h"
 
 #if defined(QGC_AIRMAP_ENABLED)
 #include "AirspaceVehicleManager.h"
@@ -180,7 +181,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    connect(_mavlink, &MAVLinkProtocol::messagesReceived,       this, &Vehicle::_mavlinkMessagesReceived);
     connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -259,9 +260,9 @@ Vehicle::Vehicle(LinkInterface*             link,
     _cameraManager = _firmwarePlugin->createCameraManager(this);
     emit cameraManagerChanged();
 
-    // Start csv logger
-    connect(&_csvLogTimer, &QTimer::timeout, this, &Vehicle::_writeCsvLine);
-    _csvLogTimer.start(1000);
+    // Telemetry recording starts once the vehicle is armed
+    connect(&_telemetryRecorderTimer, &QTimer::timeout, this, &Vehicle::_startTelemetryRecorder);
+    _telemetryRecorderTimer.start(1000);
 }
 
 // Disconnected Vehicle for offline editing
@@ -502,6 +503,9 @@ Vehicle::~Vehicle()
         _startJoystick(false);
     }
 
+    delete _telemetryRecorder;
+    _telemetryRecorder = nullptr;
+
 #if defined(QGC_AIRMAP_ENABLED)
     if (_airspaceVehicleManager) {
         delete _airspaceVehicleManager;
@@ -592,6 +596,13 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+void Vehicle::_mavlinkMessagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages)
+{
+    for (const mavlink_message_t& message: messages) {
+        _mavlinkMessageReceived(link, message);
+    }
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     // If the link is already running at Mavlink V2 set our max proto version to it.
@@ -3629,13 +3640,13 @@ void Vehicle::_updateDistanceHeadingToHome()
 void Vehicle::_updateHeadingToNextWP()
 {
     const int currentIndex = _missionManager->currentIndex();
-    QList<MissionItem*> llist = _missionManager->missionItems();
+    const MissionItemStore& llist = _missionManager->missionItems();
 
-    if(llist.size()>currentIndex && currentIndex!=-1
-            && llist[currentIndex]->coordinate().longitude()!=0.0
-            && coordinate().distanceTo(llist[currentIndex]->coordinate())>5.0 ){
+    if(llist.count()>currentIndex && currentIndex!=-1
+            && llist.coordinate(currentIndex).longitude()!=0.0
+            && coordinate().distanceTo(llist.coordinate(currentIndex))>5.0 ){
 
-        _headingToNextWPFact.setRawValue(coordinate().azimuthTo(llist[currentIndex]->coordinate()));
+        _headingToNextWPFact.setRawValue(coordinate().azimuthTo(llist.coordinate(currentIndex)));
     }
     else{
         _headingToNextWPFact.setRawValue(qQNaN());
@@ -3792,62 +3803,43 @@ bool Vehicle::isInitialConnectComplete() const
     return !_initialConnectStateMachine->active();
 }
 
-void Vehicle::_initializeCsv()
+void Vehicle::_startTelemetryRecorder()
 {
-    if(!_toolbox->settingsManager()->appSettings()->saveCsvTelemetry()->rawValue().toBool()){
+    AppSettings* appSettings = _toolbox->settingsManager()->appSettings();
+
+    // Only record after the the vehicle gets armed, unless "Save logs even if vehicle was not armed" is checked
+    if (!appSettings->saveCsvTelemetry()->rawValue().toBool() || !(_armed || appSettings->telemetrySaveNotArmed()->rawValue().toBool())) {
         return;
     }
-    QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd hh-mm-ss");
-    QString fileName = QString("%1 vehicle%2.csv").arg(now).arg(_id);
-    QDir saveDir(_toolbox->settingsManager()->appSettings()->telemetrySavePath());
-    _csvLogFile.setFileName(saveDir.absoluteFilePath(fileName));
 
-    if (!_csvLogFile.open(QIODevice::Append)) {
-        qCWarning(VehicleLog) << "unable to open file for csv logging, Stopping csv logging!";
-        return;
+    QStringList recordGroupNames = appSettings->telemetryRecordFactGroups()->rawValue().toString().split(QStringLiteral(","), Qt::SkipEmptyParts);
+    for (QString& groupName: recordGroupNames) {
+        groupName = groupName.trimmed();
     }
 
-    QTextStream stream(&_csvLogFile);
-    QStringList allFactNames;
-    allFactNames << factNames();
+    _telemetryRecorder = new TelemetryRecorder();
+    for (const QString& factName: factNames()) {
+        _telemetryRecorder->addFact(factName, getFact(factName));
+    }
     for (const QString& groupName: factGroupNames()) {
-        for(const QString& factName: getFactGroup(groupName)->factNames()){
-            allFactNames << QString("%1.%2").arg(groupName, factName);
+        if (recordGroupNames.isEmpty() || recordGroupNames.contains(groupName)) {
+            _telemetryRecorder->addFactGroup(groupName, getFactGroup(groupName));
         }
     }
-    qCDebug(VehicleLog) << "Facts logged to csv:" << allFactNames;
-    stream << "Timestamp," << allFactNames.join(",") << "\n";
-}
 
-void Vehicle::_writeCsvLine()
-{
-    // Only save the logs after the the vehicle gets armed, unless "Save logs even if vehicle was not armed" is checked
-    if(!_csvLogFile.isOpen() &&
-            (_armed || _toolbox->settingsManager()->appSettings()->telemetrySaveNotArmed()->rawValue().toBool())){
-        _initializeCsv();
-    }
+    QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd hh-mm-ss");
+    QString fileName = QString("%1 vehicle%2.%3").arg(now).arg(_id).arg(AppSettings::telemetryRecordingFileExtension);
+    QDir saveDir(appSettings->telemetrySavePath());
 
-    if(!_csvLogFile.isOpen()){
+    if (!_telemetryRecorder->start(saveDir.absoluteFilePath(fileName), appSettings->telemetryRecordRate()->rawValue().toDouble(), appSettings->telemetryRecordCompress()->rawValue().toBool())) {
+        qCWarning(VehicleLog) << "unable to open file for telemetry recording, retrying";
+        delete _telemetryRecorder;
+        _telemetryRecorder = nullptr;
         return;
     }
-
-    QStringList allFactValues;
-    QTextStream stream(&_csvLogFile);
-
-    // Write timestamp to csv file
-    allFactValues << QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz"));
-    // Write Vehicle's own facts
-    for (const QString& factName : factNames()) {
-        allFactValues << getFact(factName)->cookedValueString();
-    }
-    // write facts from Vehicle's FactGroups
-    for (const QString& groupName: factGroupNames()) {
-        for (const QString& factName : getFactGroup(groupName)->factNames()) {
-            allFactValues << getFactGroup(groupName)->getFact(factName)->cookedValueString();
-        }
-    }
-
-    stream << allFactValues.join(",") << "\n";
+    // Only stop retrying once recording has actually started
+    _telemetryRecorderTimer.stop();
+    qCDebug(VehicleLog) << "Telemetry recording columns:" << _telemetryRecorder->columnCount();
 }
 
 #if !defined(NO_ARDUPILOT_DIALECT)
@@ -72,6 +72,7 @@ class LinkInterface;
 class LinkManager;
 class InitialConnectStateMachine;
 class Autotune;
+class TelemetryRecorder;
 
 #if defined(QGC_AIRMAP_ENABLED)
 class AirspaceVehicleManager;
@@ -243,6 +244,7 @@ public:
     Q_PROPERTY(quint64              mavlinkReceivedCount        READ mavlinkReceivedCount                                           NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(quint64              mavlinkLossCount            READ mavlinkLossCount                                               NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(float                mavlinkLossPercent          READ mavlinkLossPercent                                             NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(quint64              telemetryLogDroppedCount    READ telemetryLogDroppedCount                                       NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(qreal                gimbalRoll                  READ gimbalRoll                                                     NOTIFY gimbalRollChanged)
     Q_PROPERTY(qreal                gimbalPitch                 READ gimbalPitch                                                    NOTIFY gimbalPitchChanged)
     Q_PROPERTY(qreal                gimbalYaw                   READ gimbalYaw                                                      NOTIFY gimbalYawChanged)
@@ -817,6 +819,7 @@ public:
     quint64     mavlinkReceivedCount    () const{ return _mavlinkReceivedCount; }    /// Total number of sucessful messages received
     quint64     mavlinkLossCount        () const{ return _mavlinkLossCount; }        /// Total number of lost messages
     float       mavlinkLossPercent      () const{ return _mavlinkLossPercent; }      /// Running loss rate
+    quint64     telemetryLogDroppedCount() const{ return _mavlink ? _mavlink->telemetryLogDroppedRecords() : 0; }  /// Messages missing from the telemetry log since the disk could not keep up
 
     qreal       gimbalRoll              () const{ return static_cast<qreal>(_curGimbalRoll);}
     qreal       gimbalPitch             () const{ return static_cast<qreal>(_curGimbalPitch); }
@@ -944,6 +947,7 @@ signals:
     void sensorsParametersResetAck      (bool success);
 
 private slots:
+    void _mavlinkMessagesReceived           (LinkInterface* link, const QVector<mavlink_message_t>& messages);
     void _mavlinkMessageReceived            (LinkInterface* link, mavlink_message_t message);
     void _sendMessageMultipleNext           ();
     void _parametersReady                   (bool parametersReady);
@@ -1023,8 +1027,7 @@ private:
     void _setCapabilities               (uint64_t capabilityBits);
     void _updateArmed                   (bool armed);
     bool _apmArmingNotRequired          ();
-    void _initializeCsv                 ();
-    void _writeCsvLine                  ();
+    void _startTelemetryRecorder        ();
     void _flightTimerStart              ();
     void _flightTimerStop               ();
     void _chunkedStatusTextTimeout      (void);
@@ -1048,8 +1051,8 @@ private:
     QGCToolbox*         _toolbox = nullptr;
     SettingsManager*    _settingsManager = nullptr;
 
-    QTimer              _csvLogTimer;
-    QFile               _csvLogFile;
+    QTimer              _telemetryRecorderTimer;
+    TelemetryRecorder*  _telemetryRecorder = nullptr;
 
     bool            _joystickEnabled = false;
 
@@ -140,6 +140,18 @@ Item {
             visible:            advancedSettings.checked
         }
         //-----------------------------------------------------------------
+        //-- Measured MANUAL_CONTROL output
+        QGCLabel {
+            text:               qsTr("Send rate / jitter / latency:")
+            Layout.alignment:   Qt.AlignVCenter
+            visible:            advancedSettings.checked
+        }
+        QGCLabel {
+            text:               qsTr("%1 Hz / %2 ms / %3 ms").arg(_activeJoystick.sendRateHz.toFixed(1)).arg(_activeJoystick.sendJitterMsecs.toFixed(1)).arg(_activeJoystick.sendLatencyMsecs.toFixed(1))
+            Layout.alignment:   Qt.AlignVCenter
+            visible:            advancedSettings.checked
+        }
+        //-----------------------------------------------------------------
         //-- Enable circle correction
         QGCLabel {
             text:               qsTr("Enable circle correction")
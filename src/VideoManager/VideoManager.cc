@@ -102,6 +102,10 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
    connect(_videoSettings->tcpUrl(),        &Fact::rawValueChanged, this, &VideoManager::_tcpUrlChanged);
    connect(_videoSettings->aspectRatio(),   &Fact::rawValueChanged, this, &VideoManager::_aspectRatioChanged);
    connect(_videoSettings->lowLatencyMode(),&Fact::rawValueChanged, this, &VideoManager::_lowLatencyModeChanged);
+   connect(_videoSettings->recordingPreRoll(),          &Fact::rawValueChanged, this, &VideoManager::_recordingPreRollChanged);
+   connect(_videoSettings->recordingPreRollMaxSize(),   &Fact::rawValueChanged, this, &VideoManager::_recordingPreRollChanged);
+   connect(_videoSettings->jitterBuffer(),              &Fact::rawValueChanged, this, &VideoManager::_jitterBufferChanged);
+   connect(_videoSettings->maxFrameLatency(),           &Fact::rawValueChanged, this, &VideoManager::_maxFrameLatencyChanged);
    MultiVehicleManager *pVehicleMgr = qgcApp()->toolbox()->multiVehicleManager();
    connect(pVehicleMgr, &MultiVehicleManager::activeVehicleChanged, this, &VideoManager::_setActiveVehicle);
 
@@ -168,6 +172,20 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
         emit videoSizeChanged();
     });
 
+    connect(_videoReceiver[0], &VideoReceiver::recordingBufferStatsChanged, this, [this](quint64 bytes, quint64 msecs, quint64 droppedBuffers){
+        if (bytes != _recordingBufferBytes || msecs != _recordingBufferMSecs || droppedBuffers != _recordingDroppedBuffers) {
+            _recordingBufferBytes       = bytes;
+            _recordingBufferMSecs       = msecs;
+            _recordingDroppedBuffers    = droppedBuffers;
+            emit recordingBufferStatsChanged();
+        }
+    });
+
+    connect(_videoReceiver[0], &VideoReceiver::latencyStatsChanged, this, [this](const QVariantMap& stats){
+        _latencyStats = stats;
+        emit latencyStatsChanged();
+    });
+
     //connect(_videoReceiver, &VideoReceiver::onTakeScreenshotComplete, this, [this](VideoReceiver::STATUS status){
     //    if (status == VideoReceiver::STATUS_OK) {
     //    }
@@ -196,6 +214,8 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
             _startReceiver(1);
         });
     }
+    _recordingPreRollChanged();
+    _maxFrameLatencyChanged();
 #endif
     _updateSettings(0);
     _updateSettings(1);
@@ -511,6 +531,40 @@ VideoManager::_lowLatencyModeChanged()
     _restartAllVideos();
 }
 
+//-----------------------------------------------------------------------------
+void
+VideoManager::_recordingPreRollChanged()
+{
+    const unsigned maxMSecs = _videoSettings->recordingPreRoll()->rawValue().toUInt() * 1000;
+    const unsigned maxBytes = _videoSettings->recordingPreRollMaxSize()->rawValue().toUInt() * 1024 * 1024;
+
+    for (VideoReceiver* videoReceiver: _videoReceiver) {
+        if (videoReceiver) {
+            videoReceiver->setRecordingPreRoll(maxBytes, maxMSecs);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoManager::_jitterBufferChanged()
+{
+    _restartAllVideos();
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoManager::_maxFrameLatencyChanged()
+{
+    const unsigned maxMSecs = _videoSettings->maxFrameLatency()->rawValue().toUInt();
+
+    for (VideoReceiver* videoReceiver: _videoReceiver) {
+        if (videoReceiver) {
+            videoReceiver->setMaxFrameLatency(maxMSecs);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool
 VideoManager::hasVideo()
@@ -618,9 +672,12 @@ VideoManager::_updateSettings(unsigned id)
 
     const bool lowLatencyStreaming  =_videoSettings->lowLatencyMode()->rawValue().toBool();
 
-    bool settingsChanged = _lowLatencyStreaming[id] != lowLatencyStreaming;
+    const int jitterBuffer          = _videoSettings->jitterBuffer()->rawValue().toInt();
+
+    bool settingsChanged = _lowLatencyStreaming[id] != lowLatencyStreaming || _jitterBuffer[id] != jitterBuffer;
 
     _lowLatencyStreaming[id] = lowLatencyStreaming;
+    _jitterBuffer[id] = jitterBuffer;
 
     //-- Auto discovery
 
@@ -747,13 +804,15 @@ VideoManager::_restartVideo(unsigned id)
 
 #if defined(QGC_GST_STREAMING)
     bool oldLowLatencyStreaming = _lowLatencyStreaming[id];
+    int oldJitterBuffer = _jitterBuffer[id];
     QString oldUri = _videoUri[id];
     _updateSettings(id);
     bool newLowLatencyStreaming = _lowLatencyStreaming[id];
+    int newJitterBuffer = _jitterBuffer[id];
     QString newUri = _videoUri[id];
 
     // FIXME: AV: use _updateSettings() result to check if settings were changed
-    if (oldUri == newUri && oldLowLatencyStreaming == newLowLatencyStreaming && _videoStarted[id]) {
+    if (oldUri == newUri && oldLowLatencyStreaming == newLowLatencyStreaming && oldJitterBuffer == newJitterBuffer && _videoStarted[id]) {
         qCDebug(VideoManagerLog) << "No sense to restart video streaming, skipped"  << id;
         return;
     }
@@ -787,7 +846,7 @@ VideoManager::_startReceiver(unsigned id)
         qCDebug(VideoManagerLog) << "Unsupported receiver id" << id;
     } else if (_videoReceiver[id] != nullptr/* && _videoSink[id] != nullptr*/) {
         if (!_videoUri[id].isEmpty()) {
-            _videoReceiver[id]->start(_videoUri[id], timeout, _lowLatencyStreaming[id] ? -1 : 0);
+            _videoReceiver[id]->start(_videoUri[id], timeout, _lowLatencyStreaming[id] ? -1 : _jitterBuffer[id]);
         }
     }
 #else
@@ -55,6 +55,10 @@ public:
     Q_PROPERTY(bool             decoding                READ    decoding                                    NOTIFY decodingChanged)
     Q_PROPERTY(bool             recording               READ    recording                                   NOTIFY recordingChanged)
     Q_PROPERTY(QSize            videoSize               READ    videoSize                                   NOTIFY videoSizeChanged)
+    Q_PROPERTY(quint64          recordingBufferBytes    READ    recordingBufferBytes                        NOTIFY recordingBufferStatsChanged)
+    Q_PROPERTY(quint64          recordingBufferMSecs    READ    recordingBufferMSecs                        NOTIFY recordingBufferStatsChanged)
+    Q_PROPERTY(quint64          recordingDroppedBuffers READ    recordingDroppedBuffers                     NOTIFY recordingBufferStatsChanged)
+    Q_PROPERTY(QVariantMap      latencyStats            READ    latencyStats                                NOTIFY latencyStatsChanged)
 
     virtual bool        hasVideo            ();
     virtual bool        isGStreamer         ();
@@ -86,6 +90,14 @@ public:
         return QSize((size >> 16) & 0xFFFF, size & 0xFFFF);
     }
 
+    // Encoded video held by the primary receiver for recording (pre-roll) and buffers it had to discard
+    quint64 recordingBufferBytes    (void) const { return _recordingBufferBytes; }
+    quint64 recordingBufferMSecs    (void) const { return _recordingBufferMSecs; }
+    quint64 recordingDroppedBuffers (void) const { return _recordingDroppedBuffers; }
+
+    // Per stage latency and throughput of the primary stream, see VideoReceiver::latencyStatsChanged
+    QVariantMap latencyStats        (void) const { return _latencyStats; }
+
 // FIXME: AV: they should be removed after finishing multiple video stream support
 // new arcitecture does not assume direct access to video receiver from QML side, even if it works for now
     virtual VideoReceiver*  videoReceiver           () { return _videoReceiver[0]; }
@@ -126,6 +138,8 @@ signals:
     void recordingChanged           ();
     void recordingStarted           ();
     void videoSizeChanged           ();
+    void recordingBufferStatsChanged();
+    void latencyStatsChanged        ();
 
 protected slots:
     void _videoSourceChanged        ();
@@ -133,6 +147,9 @@ protected slots:
     void _rtspUrlChanged            ();
     void _tcpUrlChanged             ();
     void _lowLatencyModeChanged     ();
+    void _recordingPreRollChanged   ();
+    void _jitterBufferChanged       ();
+    void _maxFrameLatencyChanged    ();
     void _updateUVC                 ();
     void _setActiveVehicle          (Vehicle* vehicle);
     void _aspectRatioChanged        ();
@@ -165,10 +182,15 @@ protected:
     // It works for now but...
     bool                    _videoStarted[2]        = { false, false };
     bool                    _lowLatencyStreaming[2] = { false, false };
+    int                     _jitterBuffer[2]        = { 0, 0 };
     QAtomicInteger<bool>    _streaming              = false;
     QAtomicInteger<bool>    _decoding               = false;
     QAtomicInteger<bool>    _recording              = false;
     QAtomicInteger<quint32> _videoSize              = 0;
+    quint64                 _recordingBufferBytes   = 0;
+    quint64                 _recordingBufferMSecs   = 0;
+    quint64                 _recordingDroppedBuffers = 0;
+    QVariantMap             _latencyStats;
     VideoSettings*          _videoSettings          = nullptr;
     QString                 _videoSourceID;
     bool                    _fullScreen             = false;
@@ -30,7 +30,15 @@ QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
 //              |
 // _source-->_tee
 //              |
-//              +-->queue-->_recorderValve[-->_fileSink]
+//              +-->_recorderQueue-->_recorderValve[-->_fileSink]
+//
+// With recording pre-roll enabled _recorderQueue is bounded by time and bytes. While not recording it is leaky and its
+// src pad is blocked, so the queue holds the most recent encoded buffers. These flow into the muxer as soon as the file
+// sink is linked and the pad unblocked, and from then on the queue no longer leaks.
+//
+// Buffer probes at the source bin input, the tee, the decoder output and the video sink input sample how long after
+// arrival each buffer passes that point. The samples are kept as per stage histograms and reported once a second by
+// the watchdog. With a maximum frame latency set, the video sink probe drops frames which arrive later than that.
 //
 
 GstVideoReceiver::GstVideoReceiver(QObject* parent)
@@ -43,6 +51,7 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _source(nullptr)
     , _tee(nullptr)
     , _decoderValve(nullptr)
+    , _recorderQueue(nullptr)
     , _recorderValve(nullptr)
     , _decoder(nullptr)
     , _videoSink(nullptr)
@@ -55,7 +64,18 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _udpReconnect_us(5000000)
     , _signalDepth(0)
     , _endOfStream(false)
+    , _preRollMaxBytes(0)
+    , _preRollMaxMSecs(0)
+    , _preRollProbeId(0)
+    , _recorderQueueLeaky(false)
+    , _recorderDroppedBuffers(0)
+    , _preRollDroppedAtBlock(0)
+    , _preRollDropFirstBuffer(false)
+    , _latencyLastReportTime(0)
+    , _maxFrameLatencyMSecs(0)
+    , _lastRenderedPts(GST_CLOCK_TIME_NONE)
 {
+    _resetLatencyStats();
     _slotHandler.start();
     connect(&_watchdogTimer, &QTimer::timeout, this, &GstVideoReceiver::_watchdog);
     _watchdogTimer.start(1000);
@@ -101,11 +121,12 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
     _endOfStream = false;
 
+    _resetLatencyStats();
+
     bool running    = false;
     bool pipelineUp = false;
 
     GstElement* decoderQueue = nullptr;
-    GstElement* recorderQueue = nullptr;
 
     do {
         if((_tee = gst_element_factory_make("tee", nullptr)) == nullptr)  {
@@ -138,7 +159,7 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         g_object_set(_decoderValve, "drop", TRUE, nullptr);
 
-        if((recorderQueue = gst_element_factory_make("queue", nullptr)) == nullptr)  {
+        if((_recorderQueue = gst_element_factory_make("queue", nullptr)) == nullptr)  {
             qCCritical(VideoReceiverLog) << "gst_element_factory_make('queue') failed";
             break;
         }
@@ -162,7 +183,7 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             break;
         }
 
-        gst_bin_add_many(GST_BIN(_pipeline), _source, _tee, decoderQueue, _decoderValve, recorderQueue, _recorderValve, nullptr);
+        gst_bin_add_many(GST_BIN(_pipeline), _source, _tee, decoderQueue, _decoderValve, _recorderQueue, _recorderValve, nullptr);
 
         pipelineUp = true;
 
@@ -196,11 +217,17 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             break;
         }
 
-        if(!gst_element_link_many(_tee, recorderQueue, _recorderValve, nullptr)) {
+        if(!gst_element_link_many(_tee, _recorderQueue, _recorderValve, nullptr)) {
             qCCritical(VideoReceiverLog) << "Unable to link recorder queue";
             break;
         }
 
+        _recorderDroppedBuffers = 0;
+
+        g_signal_connect(_recorderQueue, "overrun", G_CALLBACK(_onRecorderQueueOverrun), this);
+
+        _updateRecorderQueue();
+
         GstBus* bus = nullptr;
 
         if ((bus = gst_pipeline_get_bus(GST_PIPELINE(_pipeline))) != nullptr) {
@@ -224,6 +251,8 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             _pipeline = nullptr;
         }
 
+        _preRollProbeId = 0;
+
         // If we failed before adding items to the pipeline, then clean up
         if (!pipelineUp) {
             if (_recorderValve != nullptr) {
@@ -231,9 +260,9 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
                 _recorderValve = nullptr;
             }
 
-            if (recorderQueue != nullptr) {
-                gst_object_unref(recorderQueue);
-                recorderQueue = nullptr;
+            if (_recorderQueue != nullptr) {
+                gst_object_unref(_recorderQueue);
+                _recorderQueue = nullptr;
             }
 
             if (_decoderValve != nullptr) {
@@ -341,10 +370,13 @@ GstVideoReceiver::stop(void)
         _pipeline = nullptr;
 
         _recorderValve = nullptr;
+        _recorderQueue = nullptr;
         _decoderValve = nullptr;
         _tee = nullptr;
         _source = nullptr;
 
+        _preRollProbeId = 0;
+        _preRollDropFirstBuffer = false;
         _lastSourceFrameTime = 0;
 
         if (_streaming) {
@@ -414,6 +446,7 @@ GstVideoReceiver::startDecoding(void* sink)
 
     _lastVideoFrameTime = 0;
     _resetVideoSink = true;
+    _lastRenderedPts = GST_CLOCK_TIME_NONE;
 
     _videoSinkProbeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _videoSinkProbe, this, nullptr);
     gst_object_unref(pad);
@@ -558,6 +591,9 @@ GstVideoReceiver::startRecording(const QString& videoFile, FILE_FORMAT format)
 
     g_object_set(_recorderValve, "drop", FALSE, nullptr);
 
+    // Release the pre-roll held in the recorder queue into the file sink
+    _updateRecorderQueue();
+
     _recording = true;
     qCDebug(VideoReceiverLog) << "Recording started" << _uri;
     _dispatchSignal([this](){
@@ -594,6 +630,9 @@ GstVideoReceiver::stopRecording(void)
 
     bool ret = _unlinkBranch(_recorderValve);
 
+    // Start collecting pre-roll for the next recording
+    _updateRecorderQueue();
+
     // FIXME: AV: it is much better to emit onStopRecordingComplete() after recording is really stopped
     // (which happens later due to async design) but as for now it is also not so bad...
     _dispatchSignal([this, ret](){
@@ -618,12 +657,52 @@ GstVideoReceiver::takeScreenshot(const QString& imageFile)
     });
 }
 
+void
+GstVideoReceiver::setRecordingPreRoll(unsigned maxBytes, unsigned maxMSecs)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this, maxBytes, maxMSecs]() {
+            setRecordingPreRoll(maxBytes, maxMSecs);
+        });
+        return;
+    }
+
+    qCDebug(VideoReceiverLog) << "Recording pre-roll bytes:msecs" << maxBytes << maxMSecs;
+
+    _preRollMaxBytes = maxBytes;
+    _preRollMaxMSecs = maxMSecs;
+
+    if (_pipeline != nullptr) {
+        _updateRecorderQueue();
+    }
+}
+
+void
+GstVideoReceiver::setMaxFrameLatency(unsigned maxMSecs)
+{
+    qCDebug(VideoReceiverLog) << "Max frame latency msecs" << maxMSecs;
+
+    // Read from the video sink streaming thread, no need to dispatch
+    _maxFrameLatencyMSecs = maxMSecs;
+}
+
 const char* GstVideoReceiver::_kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN] = {
     "matroskamux",
     "qtmux",
     "mp4mux"
 };
 
+const unsigned GstVideoReceiver::_kLatencyBucketMSecs[_kLatencyBuckets - 1] = {
+    5, 10, 20, 40, 80, 120, 160, 240, 320
+};
+
+const char* GstVideoReceiver::_kLatencyStageNames[LATENCY_STAGE_MAX] = {
+    "source",
+    "depay",
+    "decode",
+    "sink"
+};
+
 void
 GstVideoReceiver::_watchdog(void)
 {
@@ -632,6 +711,9 @@ GstVideoReceiver::_watchdog(void)
             return;
         }
 
+        _noteRecordingBufferStats();
+        _noteLatencyStats();
+
         const qint64 now = QDateTime::currentSecsSinceEpoch();
 
         if (_lastSourceFrameTime == 0) {
@@ -791,6 +873,11 @@ GstVideoReceiver::_makeSource(const QString& uri)
                     break;
                 }
 
+                // buffer: 0 - keep the rtpjitterbuffer default latency, N - latency in ms
+                if (_buffer > 0) {
+                    g_object_set(static_cast<gpointer>(buffer), "latency", _buffer, nullptr);
+                }
+
                 gst_bin_add(GST_BIN(bin), buffer);
 
                 if (!gst_element_link_many(source, buffer, parser, nullptr)) {
@@ -809,6 +896,14 @@ GstVideoReceiver::_makeSource(const QString& uri)
 
         g_signal_connect(parser, "pad-added", G_CALLBACK(_wrapWithGhostPad), nullptr);
 
+        GstPad* probePad;
+
+        if ((probePad = gst_element_get_static_pad(buffer != nullptr ? buffer : parser, "sink")) != nullptr) {
+            gst_pad_add_probe(probePad, GST_PAD_PROBE_TYPE_BUFFER, _sourceProbe, this, nullptr);
+            gst_object_unref(probePad);
+            probePad = nullptr;
+        }
+
         source = tsdemux = buffer = parser = nullptr;
 
         srcbin = bin;
@@ -989,6 +1084,8 @@ GstVideoReceiver::_onNewDecoderPad(GstPad* pad)
 
     qCDebug(VideoReceiverLog) << "_onNewDecoderPad" << _uri;
 
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _decoderProbe, this, nullptr);
+
     if (!_addVideoSink(pad)) {
         qCCritical(VideoReceiverLog) << "_addVideoSink() failed";
     }
@@ -1267,6 +1364,298 @@ GstVideoReceiver::_shutdownRecordingBranch(void)
     GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-recording-stopped");
 }
 
+// Configures the recorder queue for the current pre-roll settings. While the recorder valve is closed and pre-roll is
+// enabled the queue src pad is kept blocked, so the leaky queue always holds the latest maxMSecs/maxBytes of video.
+// While recording the queue never leaks, a full queue holds up the tee instead of dropping video from the file.
+void
+GstVideoReceiver::_updateRecorderQueue(void)
+{
+    if (_recorderQueue == nullptr || _recorderValve == nullptr) {
+        return;
+    }
+
+    gboolean recorderValveClosed = TRUE;
+
+    g_object_get(_recorderValve, "drop", &recorderValveClosed, nullptr);
+
+    const bool preRoll  = _preRollMaxMSecs != 0 && _preRollMaxBytes != 0;
+    const bool block    = preRoll && recorderValveClosed;
+
+    // Set before the queue leaks so the overrun handler counts the drops
+    _recorderQueueLeaky = block;
+
+    if (preRoll) {
+        g_object_set(_recorderQueue,
+                     "max-size-buffers",    0,
+                     "max-size-bytes",      _preRollMaxBytes,
+                     "max-size-time",       static_cast<guint64>(_preRollMaxMSecs) * GST_MSECOND,
+                     "leaky",               block ? 2 /* downstream - drop oldest */ : 0 /* no */,
+                     nullptr);
+    } else {
+        // queue element defaults
+        g_object_set(_recorderQueue,
+                     "max-size-buffers",    200,
+                     "max-size-bytes",      10 * 1024 * 1024,
+                     "max-size-time",       static_cast<guint64>(GST_SECOND),
+                     "leaky",               0 /* no */,
+                     nullptr);
+    }
+
+    GstPad* pad;
+
+    if ((pad = gst_element_get_static_pad(_recorderQueue, "src")) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed";
+        return;
+    }
+
+    if (block && _preRollProbeId == 0) {
+        _preRollProbeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, _preRollBlock, this, nullptr);
+        _preRollDroppedAtBlock = _recorderDroppedBuffers;
+        qCDebug(VideoReceiverLog) << "Recording pre-roll started" << _uri;
+    } else if (!block && _preRollProbeId != 0) {
+        // The buffer held by the blocked pad is older than everything in the queue. If the queue leaked while blocked
+        // there is a gap after it, so it is not written to the file.
+        _preRollDropFirstBuffer = !recorderValveClosed && _recorderDroppedBuffers != _preRollDroppedAtBlock;
+        gst_pad_remove_probe(pad, _preRollProbeId);
+        _preRollProbeId = 0;
+        qCDebug(VideoReceiverLog) << "Recording pre-roll released" << _uri;
+    }
+
+    gst_object_unref(pad);
+    pad = nullptr;
+}
+
+void
+GstVideoReceiver::_noteRecordingBufferStats(void)
+{
+    if (_recorderQueue == nullptr) {
+        return;
+    }
+
+    guint   levelBytes  = 0;
+    guint64 levelTime   = 0;
+
+    g_object_get(_recorderQueue,
+                 "current-level-bytes", &levelBytes,
+                 "current-level-time",  &levelTime,
+                 nullptr);
+
+    const quint64 droppedBuffers    = _recorderDroppedBuffers;
+    const quint64 msecs             = levelTime / GST_MSECOND;
+
+    _dispatchSignal([this, levelBytes, msecs, droppedBuffers](){
+        emit recordingBufferStatsChanged(levelBytes, msecs, droppedBuffers);
+    });
+}
+
+void
+GstVideoReceiver::_resetLatencyStats(void)
+{
+    for (int i = 0; i < LATENCY_STAGE_MAX; i++) {
+        LatencyStage_t& stage = _latencyStages[i];
+
+        stage.buffers       = 0;
+        stage.bytes         = 0;
+        stage.samples       = 0;
+        stage.latencySumUs  = 0;
+        stage.latencyMaxUs  = 0;
+        stage.dropped       = 0;
+
+        for (int j = 0; j < _kLatencyBuckets; j++) {
+            stage.histogram[j] = 0;
+        }
+
+        _latencyLastReport[i] = { 0, 0, 0, 0 };
+    }
+
+    _latencyLastReportTime = QDateTime::currentMSecsSinceEpoch();
+}
+
+// Reports the latency stats through latencyStatsChanged:
+//      buffer          - buffer argument the stream was started with
+//      maxFrameLatency - late frame threshold in ms, 0 if frames are never dropped
+//      bounds          - upper bound in ms of each histogram bucket but the last, which is open ended
+//      stages          - one map per stage in stream order:
+//          name            - source, depay, decode or sink
+//          buffers, bytes  - totals since start
+//          bufferRate      - buffers/s since the last report
+//          bitrate         - kbit/s since the last report
+//          latency         - mean latency in ms since the last report
+//          maxLatency      - max latency in ms since the last report
+//          histogram       - buffer count per bucket since start
+//          dropped         - late frames dropped since start
+void
+GstVideoReceiver::_noteLatencyStats(void)
+{
+    const qint64 now        = QDateTime::currentMSecsSinceEpoch();
+    const qint64 elapsed    = qMax(now - _latencyLastReportTime, static_cast<qint64>(1));
+
+    _latencyLastReportTime = now;
+
+    QVariantList bounds;
+
+    for (int i = 0; i < _kLatencyBuckets - 1; i++) {
+        bounds.append(_kLatencyBucketMSecs[i]);
+    }
+
+    QVariantList stages;
+
+    for (int i = 0; i < LATENCY_STAGE_MAX; i++) {
+        LatencyStage_t&     stage       = _latencyStages[i];
+        LatencyReport_t&    lastReport  = _latencyLastReport[i];
+        LatencyReport_t     report      = { stage.buffers, stage.bytes, stage.samples, stage.latencySumUs };
+
+        const quint64 samples = report.samples - lastReport.samples;
+
+        QVariantList histogram;
+
+        for (int j = 0; j < _kLatencyBuckets; j++) {
+            histogram.append(static_cast<quint64>(stage.histogram[j]));
+        }
+
+        QVariantMap stageStats;
+
+        stageStats[QStringLiteral("name")]          = QString(_kLatencyStageNames[i]);
+        stageStats[QStringLiteral("buffers")]       = report.buffers;
+        stageStats[QStringLiteral("bytes")]         = report.bytes;
+        stageStats[QStringLiteral("bufferRate")]    = (report.buffers - lastReport.buffers) * 1000.0 / elapsed;
+        stageStats[QStringLiteral("bitrate")]       = (report.bytes - lastReport.bytes) * 8.0 / elapsed;
+        stageStats[QStringLiteral("latency")]       = samples > 0 ? (report.latencySumUs - lastReport.latencySumUs) / samples / 1000.0 : 0.0;
+        stageStats[QStringLiteral("maxLatency")]    = stage.latencyMaxUs.exchange(0) / 1000.0;
+        stageStats[QStringLiteral("histogram")]     = histogram;
+        stageStats[QStringLiteral("dropped")]       = static_cast<quint64>(stage.dropped);
+
+        stages.append(stageStats);
+
+        lastReport = report;
+    }
+
+    QVariantMap stats;
+
+    stats[QStringLiteral("buffer")]             = _buffer;
+    stats[QStringLiteral("maxFrameLatency")]    = static_cast<unsigned>(_maxFrameLatencyMSecs);
+    stats[QStringLiteral("bounds")]             = bounds;
+    stats[QStringLiteral("stages")]             = stages;
+
+    _dispatchSignal([this, stats](){
+        emit latencyStatsChanged(stats);
+    });
+}
+
+void
+GstVideoReceiver::_noteStageBuffer(LATENCY_STAGE stage, GstBuffer* buf, GstClockTimeDiff latency)
+{
+    LatencyStage_t& stats = _latencyStages[stage];
+
+    stats.buffers += 1;
+    stats.bytes += gst_buffer_get_size(buf);
+
+    if (!GST_CLOCK_STIME_IS_VALID(latency)) {
+        return;
+    }
+
+    const quint64 latencyUs = static_cast<quint64>(latency / GST_USECOND);
+    const quint64 latencyMs = latencyUs / 1000;
+
+    int bucket = 0;
+
+    while (bucket < _kLatencyBuckets - 1 && latencyMs >= _kLatencyBucketMSecs[bucket]) {
+        bucket++;
+    }
+
+    stats.samples += 1;
+    stats.latencySumUs += latencyUs;
+    stats.histogram[bucket] += 1;
+
+    quint64 latencyMaxUs = stats.latencyMaxUs;
+
+    while (latencyUs > latencyMaxUs && !stats.latencyMaxUs.compare_exchange_weak(latencyMaxUs, latencyUs)) {
+    }
+}
+
+// Frames reaching the sink later than the max frame latency are dropped rather than displayed behind the stream. The
+// decoder is sent a QoS event for each dropped frame, software decoders then skip decoding frames they can to catch up.
+bool
+GstVideoReceiver::_dropLateFrame(GstPad* pad, GstBuffer* buf, GstClockTimeDiff latency, GstClockTime runningTime)
+{
+    const GstClockTimeDiff  maxLatency  = static_cast<GstClockTimeDiff>(_maxFrameLatencyMSecs) * GST_MSECOND;
+    const GstClockTime      pts         = GST_BUFFER_PTS(buf);
+
+    if (maxLatency == 0 || !GST_CLOCK_STIME_IS_VALID(latency) || latency <= maxLatency) {
+        _lastRenderedPts = pts;
+        return false;
+    }
+
+    // Keep showing at least one frame a second if every frame is late, otherwise the decoder watchdog would restart the stream
+    if (!GST_CLOCK_TIME_IS_VALID(pts) || !GST_CLOCK_TIME_IS_VALID(_lastRenderedPts) || pts < _lastRenderedPts || pts - _lastRenderedPts >= GST_SECOND) {
+        _lastRenderedPts = pts;
+        return false;
+    }
+
+    _latencyStages[LATENCY_STAGE_SINK].dropped += 1;
+
+    if (GST_CLOCK_TIME_IS_VALID(runningTime)) {
+        gst_pad_push_event(pad, gst_event_new_qos(GST_QOS_TYPE_UNDERFLOW, 1.0, latency - maxLatency, runningTime));
+    }
+
+    return true;
+}
+
+// Time from the buffer timestamp to now in pipeline running time. Live sources timestamp buffers on arrival, so this
+// is the time since the buffer (or the first packet of the frame) was received.
+GstClockTimeDiff
+GstVideoReceiver::_bufferLatency(GstPad* pad, GstBuffer* buf, GstClockTime* runningTime)
+{
+    GstElement* element = GST_PAD_PARENT(pad);
+
+    if (element == nullptr || !GST_BUFFER_PTS_IS_VALID(buf)) {
+        return GST_CLOCK_STIME_NONE;
+    }
+
+    GstEvent* event;
+
+    if ((event = gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0)) == nullptr) {
+        return GST_CLOCK_STIME_NONE;
+    }
+
+    const GstSegment* segment = nullptr;
+
+    gst_event_parse_segment(event, &segment);
+
+    const GstClockTime bufferTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buf));
+
+    gst_event_unref(event);
+    event = nullptr;
+
+    if (!GST_CLOCK_TIME_IS_VALID(bufferTime)) {
+        return GST_CLOCK_STIME_NONE;
+    }
+
+    GstClock* clock;
+
+    if ((clock = gst_element_get_clock(element)) == nullptr) {
+        return GST_CLOCK_STIME_NONE;
+    }
+
+    const GstClockTime now = gst_clock_get_time(clock) - gst_element_get_base_time(element);
+
+    gst_object_unref(clock);
+    clock = nullptr;
+
+    const GstClockTimeDiff latency = GST_CLOCK_DIFF(bufferTime, now);
+
+    if (latency < 0) {
+        // Not a live timestamp
+        return GST_CLOCK_STIME_NONE;
+    }
+
+    if (runningTime != nullptr) {
+        *runningTime = bufferTime;
+    }
+
+    return latency;
+}
+
 bool
 GstVideoReceiver::_needDispatch(void)
 {
@@ -1448,23 +1837,49 @@ GstVideoReceiver::_padProbe(GstElement* element, GstPad* pad, gpointer user_data
 GstPadProbeReturn
 GstVideoReceiver::_teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
-    Q_UNUSED(pad)
-    Q_UNUSED(info)
-
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
         pThis->_noteTeeFrame();
+
+        GstBuffer* buf;
+
+        if (info != nullptr && (buf = gst_pad_probe_info_get_buffer(info)) != nullptr) {
+            pThis->_noteStageBuffer(LATENCY_STAGE_DEPAY, buf, _bufferLatency(pad, buf));
+        }
     }
 
     return GST_PAD_PROBE_OK;
 }
 
 GstPadProbeReturn
-GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+GstVideoReceiver::_sourceProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
-    Q_UNUSED(pad)
-    Q_UNUSED(info)
+    GstBuffer* buf;
+
+    if (user_data != nullptr && info != nullptr && (buf = gst_pad_probe_info_get_buffer(info)) != nullptr) {
+        GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+        pThis->_noteStageBuffer(LATENCY_STAGE_SOURCE, buf, _bufferLatency(pad, buf));
+    }
 
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_decoderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    GstBuffer* buf;
+
+    if (user_data != nullptr && info != nullptr && (buf = gst_pad_probe_info_get_buffer(info)) != nullptr) {
+        GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+        pThis->_noteStageBuffer(LATENCY_STAGE_DECODE, buf, _bufferLatency(pad, buf));
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
 
@@ -1495,6 +1910,19 @@ GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer u
 //            }
         }
 
+        GstBuffer* buf;
+
+        if (info != nullptr && (buf = gst_pad_probe_info_get_buffer(info)) != nullptr) {
+            GstClockTime runningTime = GST_CLOCK_TIME_NONE;
+            const GstClockTimeDiff latency = _bufferLatency(pad, buf, &runningTime);
+
+            pThis->_noteStageBuffer(LATENCY_STAGE_SINK, buf, latency);
+
+            if (pThis->_dropLateFrame(pad, buf, latency, runningTime)) {
+                return GST_PAD_PROBE_DROP;
+            }
+        }
+
         pThis->_noteVideoSinkFrame();
     }
 
@@ -1529,6 +1957,12 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
 
     GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
 
+    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+
+    if (pThis->_preRollDropFirstBuffer.exchange(false)) { // stale buffer which was held by the pre-roll block
+        return GST_PAD_PROBE_DROP;
+    }
+
     if (GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) { // wait for a keyframe
         return GST_PAD_PROBE_DROP;
     }
@@ -1536,8 +1970,6 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
     // set media file '0' offset to current timeline position - we don't want to touch other elements in the graph, except these which are downstream!
     gst_pad_set_offset(pad, -static_cast<gint64>(buf->pts));
 
-    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
-
     qCDebug(VideoReceiverLog) << "Got keyframe, stop dropping buffers";
 
     pThis->_dispatchSignal([pThis]() {
@@ -1546,3 +1978,29 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
 
     return GST_PAD_PROBE_REMOVE;
 }
+
+GstPadProbeReturn
+GstVideoReceiver::_preRollBlock(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(info)
+    Q_UNUSED(user_data)
+
+    // Keep the pad blocked, the recorder queue fills up behind it and leaks its oldest buffers
+    return GST_PAD_PROBE_OK;
+}
+
+// Emitted from the streaming thread each time a buffer arrives at the full recorder queue. A leaky queue then drops its
+// oldest buffer to make room, a non leaky one waits for space.
+void
+GstVideoReceiver::_onRecorderQueueOverrun(GstElement* queue, gpointer user_data)
+{
+    Q_UNUSED(queue)
+
+    if(user_data != nullptr) {
+        GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+        if (pThis->_recorderQueueLeaky) {
+            pThis->_recorderDroppedBuffers++;
+        }
+    }
+}
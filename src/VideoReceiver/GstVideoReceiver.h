@@ -27,6 +27,8 @@
 
 #include <gst/gst.h>
 
+#include <atomic>
+
 Q_DECLARE_LOGGING_CATEGORY(VideoReceiverLog)
 
 class Worker : public QThread
@@ -84,6 +86,8 @@ class GstVideoReceiver : public VideoReceiver
 {
     Q_OBJECT
 
+    friend class GstVideoReceiverTest; // Unit test
+
 public:
     explicit GstVideoReceiver(QObject* parent = nullptr);
     ~GstVideoReceiver(void);
@@ -96,12 +100,43 @@ public slots:
     virtual void startRecording(const QString& videoFile, FILE_FORMAT format);
     virtual void stopRecording(void);
     virtual void takeScreenshot(const QString& imageFile);
+    virtual void setRecordingPreRoll(unsigned maxBytes, unsigned maxMSecs);
+    virtual void setMaxFrameLatency(unsigned maxMSecs);
 
 protected slots:
     virtual void _watchdog(void);
     virtual void _handleEOS(void);
 
 protected:
+    // Points along the stream at which buffer latency is sampled. Latency is measured from the buffer timestamp, which
+    // live sources set on arrival, so each stage includes all the stages before it.
+    typedef enum {
+        LATENCY_STAGE_SOURCE = 0,   ///< Entering the jitter buffer or parser
+        LATENCY_STAGE_DEPAY,        ///< Leaving the source bin, depayloaded and parsed
+        LATENCY_STAGE_DECODE,       ///< Leaving the decoder
+        LATENCY_STAGE_SINK,         ///< Entering the video sink
+        LATENCY_STAGE_MAX
+    } LATENCY_STAGE;
+
+    static const int _kLatencyBuckets = 10;
+
+    typedef struct {
+        std::atomic<quint64>    buffers;
+        std::atomic<quint64>    bytes;
+        std::atomic<quint64>    samples;                        ///< Buffers with a measurable latency
+        std::atomic<quint64>    latencySumUs;
+        std::atomic<quint64>    latencyMaxUs;                   ///< Reset on each report
+        std::atomic<quint64>    dropped;                        ///< Late frames dropped (sink only)
+        std::atomic<quint64>    histogram[_kLatencyBuckets];
+    } LatencyStage_t;
+
+    typedef struct {
+        quint64 buffers;
+        quint64 bytes;
+        quint64 samples;
+        quint64 latencySumUs;
+    } LatencyReport_t;
+
     virtual GstElement* _makeSource(const QString& uri);
     virtual GstElement* _makeDecoder(GstCaps* caps = nullptr, GstElement* videoSink = nullptr);
     virtual GstElement* _makeFileSink(const QString& videoFile, FILE_FORMAT format);
@@ -116,6 +151,14 @@ protected:
     virtual bool _unlinkBranch(GstElement* from);
     virtual void _shutdownDecodingBranch (void);
     virtual void _shutdownRecordingBranch(void);
+    virtual void _updateRecorderQueue(void);
+    virtual void _noteRecordingBufferStats(void);
+    virtual void _resetLatencyStats(void);
+    virtual void _noteLatencyStats(void);
+    void _noteStageBuffer(LATENCY_STAGE stage, GstBuffer* buf, GstClockTimeDiff latency);
+    bool _dropLateFrame(GstPad* pad, GstBuffer* buf, GstClockTimeDiff latency, GstClockTime runningTime);
+
+    static GstClockTimeDiff _bufferLatency(GstPad* pad, GstBuffer* buf, GstClockTime* runningTime = nullptr);
 
     bool _needDispatch(void);
     void _dispatchSignal(std::function<void()> emitter);
@@ -126,9 +169,13 @@ protected:
     static void _linkPad(GstElement* element, GstPad* pad, gpointer data);
     static gboolean _padProbe(GstElement* element, GstPad* pad, gpointer user_data);
     static GstPadProbeReturn _teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _sourceProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _decoderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _preRollBlock(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void _onRecorderQueueOverrun(GstElement* queue, gpointer user_data);
 
     bool                _streaming;
     bool                _decoding;
@@ -138,6 +185,7 @@ protected:
     GstElement*         _source;
     GstElement*         _tee;
     GstElement*         _decoderValve;
+    GstElement*         _recorderQueue;
     GstElement*         _recorderValve;
     GstElement*         _decoder;
     GstElement*         _videoSink;
@@ -163,6 +211,25 @@ protected:
 
     bool                _endOfStream;
 
+    //-- Recording pre-roll: encoded buffers are held in _recorderQueue while its src pad is blocked
+    unsigned            _preRollMaxBytes;
+    unsigned            _preRollMaxMSecs;
+    gulong              _preRollProbeId;
+    std::atomic<bool>   _recorderQueueLeaky;                    ///< Only the leaky pre-roll queue drops on overrun
+    std::atomic<quint64> _recorderDroppedBuffers;               ///< Counted from the recorder queue overrun signal
+    quint64             _preRollDroppedAtBlock;
+    std::atomic<bool>   _preRollDropFirstBuffer;
+
+    //-- Latency instrumentation and late frame dropping
+    LatencyStage_t      _latencyStages[LATENCY_STAGE_MAX];
+    LatencyReport_t     _latencyLastReport[LATENCY_STAGE_MAX];
+    qint64              _latencyLastReportTime;
+    std::atomic<unsigned> _maxFrameLatencyMSecs;
+    GstClockTime        _lastRenderedPts;                       ///< Only touched from the video sink streaming thread
+
+    static const unsigned   _kLatencyBucketMSecs[_kLatencyBuckets - 1]; ///< Upper bucket bounds, the last bucket is open ended
+    static const char*      _kLatencyStageNames[LATENCY_STAGE_MAX];
+
     static const char*  _kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN];
 };
 
@@ -17,6 +17,7 @@
 
 #include <QObject>
 #include <QSize>
+#include <QVariantMap>
 
 class VideoReceiver : public QObject
 {
@@ -54,6 +55,10 @@ signals:
     void recordingChanged(bool active);
     void recordingStarted(void);
     void videoSizeChanged(QSize size);
+    // bytes/msecs - encoded video currently held for recording, droppedBuffers - total buffers the recording branch discarded
+    void recordingBufferStatsChanged(quint64 bytes, quint64 msecs, quint64 droppedBuffers);
+    // Per stage latency and throughput of the stream, emitted periodically while running. See GstVideoReceiver::_noteLatencyStats for the keys.
+    void latencyStatsChanged(const QVariantMap& stats);
 
     void onStartComplete(STATUS status);
     void onStopComplete(STATUS status);
@@ -75,4 +80,10 @@ public slots:
     virtual void startRecording(const QString& videoFile, FILE_FORMAT format) = 0;
     virtual void stopRecording(void) = 0;
     virtual void takeScreenshot(const QString& imageFile) = 0;
+    // Keeps up to maxMSecs (bounded by maxBytes) of encoded video while not recording, which is written out at the
+    // start of the next recording. maxMSecs == 0 disables pre-roll.
+    virtual void setRecordingPreRoll(unsigned maxBytes, unsigned maxMSecs) { Q_UNUSED(maxBytes) Q_UNUSED(maxMSecs) }
+    // Decoded frames which reach the video sink more than maxMSecs after they were received are dropped instead of
+    // being displayed late. maxMSecs == 0 disables dropping.
+    virtual void setMaxFrameLatency(unsigned maxMSecs) { Q_UNUSED(maxMSecs) }
 };
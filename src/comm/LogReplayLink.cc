@@ -10,13 +10,23 @@
 
 #include "LogReplayLink.h"
 #include "LinkManager.h"
+#include "MAVLinkFrameParser.h"
 #include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
 
 #include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
 #include <QtEndian>
 #include <QSignalSpy>
+#include <QPointer>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LogReplayLinkLog, "LogReplayLinkLog")
 
 const char*  LogReplayLinkConfiguration::_logFilenameKey = "logFilename";
+const char*  LogReplayLink::_indexFileExtension = "qgcindex";
 
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
     : LinkConfiguration(name)
@@ -65,6 +75,7 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     : LinkInterface              (config)
     , _logReplayConfig           (qobject_cast<LogReplayLinkConfiguration*>(config.get()))
     , _connected                 (false)
+    , _playing                   (false)
     , _mavlinkChannel            (0)
     , _logCurrentTimeUSecs       (0)
     , _logStartTimeUSecs         (0)
@@ -75,6 +86,7 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     , _playbackStartLogTimeUSecs (0)
     , _mavlink                   (nullptr)
     , _logFileSize               (0)
+    , _unlimitedSpeedChunksQueued(0)
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
@@ -88,6 +100,7 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     QObject::connect(this, &LogReplayLink::_playOnThread,               this, &LogReplayLink::_play);
     QObject::connect(this, &LogReplayLink::_pauseOnThread,              this, &LogReplayLink::_pause);
     QObject::connect(this, &LogReplayLink::_setPlaybackSpeedOnThread,   this, &LogReplayLink::_setPlaybackSpeed);
+    QObject::connect(this, &LogReplayLink::_chunkConsumedOnThread,      this, &LogReplayLink::_chunkConsumed);
     
     moveToThread(this);
 }
@@ -156,9 +169,9 @@ void LogReplayLink::_writeBytes(const QByteArray bytes)
 
 /// Parses a BigEndian quint64 timestamp
 /// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
+quint64 LogReplayLink::_parseTimestamp(const char* bytes)
 {
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
+    quint64 timestamp = qFromBigEndian<quint64>(bytes);
     quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
     
     // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
@@ -180,6 +193,17 @@ quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
 
     bytes.clear();
 
+    // Normally we are sitting on the start of a good frame, in which case we can read it whole
+    QByteArray  frame       = _logFile.peek(MAVLINK_MAX_PACKET_LEN);
+    const auto* frameData   = reinterpret_cast<const uint8_t*>(frame.constData());
+    int         frameLength = MAVLinkFrameParser::frameLength(frameData, frame.size());
+    if (frameLength > 0 && frameLength <= frame.size() && MAVLinkFrameParser::frameValid(frameData, frameLength)) {
+        bytes = _logFile.read(frameLength);
+        QByteArray rawTime = _logFile.read(cbTimestamp);
+        return rawTime.size() == cbTimestamp ? _parseTimestamp(rawTime) : 0;
+    }
+
+    // Otherwise resync byte by byte
     while (_logFile.getChar(&nextByte)) { // Loop over every byte
         mavlink_message_t message;
         bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
@@ -231,29 +255,169 @@ quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
     return 0;
 }
 
-quint64 LogReplayLink::_findLastTimestamp(void)
+/// Positions the log file on the first message at or after the specified time. Uses the index to get within
+/// _indexIntervalUSecs of the message and then walks forward record by record.
+/// @return Timestamp of the message the file is positioned on, 0 if the seek failed
+quint64 LogReplayLink::_seekToTimestamp(quint64 timestampUSecs)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
+    auto indexEntry = std::upper_bound(_logIndex.cbegin(), _logIndex.cend(), timestampUSecs,
+                                       [](quint64 timestamp, const LogIndexEntry_t& entry) { return timestamp < entry.timestampUSecs; });
+    qint64 filePos = indexEntry == _logIndex.cbegin() ? 0 : (indexEntry - 1)->filePos;
 
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
+    if (!_logFile.seek(filePos)) {
+        return 0;
+    }
+
+    qint64  lastRecordPos       = -1;
+    quint64 lastTimestampUSecs  = 0;
+    while (true) {
+        qint64      recordPos   = _logFile.pos();
+        QByteArray  record      = _logFile.peek(cbTimestamp + MAVLINK_MAX_PACKET_LEN);
+
+        const auto* frameData   = reinterpret_cast<const uint8_t*>(record.constData()) + cbTimestamp;
+        int         available   = record.size() - cbTimestamp;
+        int         frameLength = available > 0 ? MAVLinkFrameParser::frameLength(frameData, available) : -1;
+
+        if (available <= 0 || frameLength < 0 || frameLength > available) {
+            // End of log, stay on the last good message
+            if (lastRecordPos == -1 || !_logFile.seek(lastRecordPos + cbTimestamp)) {
+                return 0;
+            }
+            return lastTimestampUSecs;
+        }
 
+        if (frameLength == 0 || !MAVLinkFrameParser::frameValid(frameData, frameLength)) {
+            // Corrupt record, resync on the next good message and back up to its timestamp
+            mavlink_message_t dummy;
+            _logFile.seek(recordPos + 1);
+            if (_seekToNextMavlinkMessage(&dummy) == 0) {
+                return 0;
+            }
+            _logFile.seek(_logFile.pos() - cbTimestamp);
+            continue;
+        }
+
+        quint64 recordTimestampUSecs = _parseTimestamp(record.constData());
+        if (recordTimestampUSecs >= timestampUSecs) {
+            _logFile.seek(recordPos + cbTimestamp);
+            return recordTimestampUSecs;
+        }
+
+        lastRecordPos       = recordPos;
+        lastTimestampUSecs  = recordTimestampUSecs;
+        _logFile.seek(recordPos + cbTimestamp + frameLength);
+    }
+}
+
+/// Scans the whole log file building the timestamp index
+/// @return Last good timestamp in the log, 0 if none found
+quint64 LogReplayLink::_buildIndex(void)
+{
+    const int   readSize                = 1024 * 1024;
+    const int   maxRecordLength         = cbTimestamp + MAVLINK_MAX_PACKET_LEN;
+    QByteArray  buffer;
+    qint64      bufferFilePos           = 0;    // File position of buffer[0]
+    int         pos                     = 0;
+    quint64     lastTimestampUSecs      = 0;
+    quint64     nextIndexTimestampUSecs = 0;
+
+    _logIndex.clear();
     _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
 
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
+    while (true) {
+        if (buffer.size() - pos < maxRecordLength && !_logFile.atEnd()) {
+            buffer.remove(0, pos);
+            bufferFilePos += pos;
+            pos = 0;
+            buffer.append(_logFile.read(readSize));
+            continue;
+        }
+
+        const auto* record      = reinterpret_cast<const uint8_t*>(buffer.constData()) + pos;
+        int         available   = buffer.size() - pos - cbTimestamp;
+        int         frameLength = available > 0 ? MAVLinkFrameParser::frameLength(record + cbTimestamp, available) : -1;
 
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
+        if (frameLength < 0 || frameLength > available) {
+            // Truncated record at end of file
+            break;
         }
+        if (frameLength == 0 || !MAVLinkFrameParser::frameValid(record + cbTimestamp, frameLength)) {
+            pos++;
+            continue;
+        }
+
+        lastTimestampUSecs = _parseTimestamp(reinterpret_cast<const char*>(record));
+        if (_logIndex.isEmpty() || lastTimestampUSecs >= nextIndexTimestampUSecs) {
+            _logIndex.append({ lastTimestampUSecs, bufferFilePos + pos });
+            nextIndexTimestampUSecs = lastTimestampUSecs + _indexIntervalUSecs;
+        }
+        pos += cbTimestamp + frameLength;
+    }
+
+    qCDebug(LogReplayLinkLog) << "Built index" << _logIndex.count() << "entries";
+
+    return lastTimestampUSecs;
+}
+
+QString LogReplayLink::_indexFilename(void)
+{
+    return QStringLiteral("%1.%2").arg(_logFile.fileName()).arg(_indexFileExtension);
+}
+
+/// Loads the cached index from next to the log file. The index is only used if the log file hasn't changed since it
+/// was built.
+/// @return true: index loaded, _logEndTimeUSecs set
+bool LogReplayLink::_loadIndex(void)
+{
+    QFile indexFile(_indexFilename());
+    if (!indexFile.open(QFile::ReadOnly)) {
+        return false;
     }
 
-    return lastTimestamp;
+    QDataStream stream(&indexFile);
+    quint32     magic, version;
+    quint64     logFileSize, endTimeUSecs;
+    qint64      logFileModifiedMSecs;
+    quint32     entryCount;
+
+    stream >> magic >> version >> logFileSize >> logFileModifiedMSecs >> endTimeUSecs >> entryCount;
+    if (stream.status() != QDataStream::Ok || magic != _indexFileMagic || version != _indexFileVersion ||
+            logFileSize != _logFileSize || logFileModifiedMSecs != QFileInfo(_logFile).lastModified().toMSecsSinceEpoch() ||
+            entryCount == 0 || entryCount > _logFileSize) {
+        qCDebug(LogReplayLinkLog) << "Ignoring stale index" << indexFile.fileName();
+        return false;
+    }
+
+    QVector<LogIndexEntry_t> logIndex(static_cast<int>(entryCount));
+    for (LogIndexEntry_t& entry: logIndex) {
+        stream >> entry.timestampUSecs >> entry.filePos;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    _logIndex           = logIndex;
+    _logEndTimeUSecs    = endTimeUSecs;
+    qCDebug(LogReplayLinkLog) << "Loaded index" << indexFile.fileName() << _logIndex.count() << "entries";
+
+    return true;
+}
+
+void LogReplayLink::_saveIndex(void)
+{
+    // Failure to write the index is not an error, the log may just be on read-only media
+    QFile indexFile(_indexFilename());
+    if (!indexFile.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCDebug(LogReplayLinkLog) << "Unable to write index" << indexFile.fileName() << indexFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&indexFile);
+    stream << _indexFileMagic << _indexFileVersion << _logFileSize << QFileInfo(_logFile).lastModified().toMSecsSinceEpoch()
+           << _logEndTimeUSecs << static_cast<quint32>(_logIndex.count());
+    for (const LogIndexEntry_t& entry: _logIndex) {
+        stream << entry.timestampUSecs << entry.filePos;
+    }
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -279,7 +443,13 @@ bool LogReplayLink::_loadLogFile(void)
     _logFileSize = logFileInfo.size();
     
     startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
+    if (_loadIndex()) {
+        endTimeUSecs = _logEndTimeUSecs;
+    } else {
+        endTimeUSecs = _buildIndex();
+        _logEndTimeUSecs = endTimeUSecs;
+        _saveIndex();
+    }
 
     if (endTimeUSecs <= startTimeUSecs) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
@@ -315,6 +485,11 @@ Error:
 /// induce a static drift into the log file replay.
 void LogReplayLink::_readNextLogEntry(void)
 {
+    if (_playbackSpeed <= 0) {
+        _readNextLogChunk();
+        return;
+    }
+
     QByteArray bytes;
 
     // Now parse MAVLink messages, grabbing their timestamps as we go. We stop once we
@@ -353,6 +528,46 @@ void LogReplayLink::_readNextLogEntry(void)
     _readTickTimer.start(timeToNextExecutionMSecs);
 }
 
+/// Unpaced replay: sends the log through in large chunks as fast as the GUI thread consumes them
+void LogReplayLink::_readNextLogChunk(void)
+{
+    // Only allow a few chunks to be queued to the GUI thread at a time, otherwise we would just flood its event queue.
+    // Reading picks up again from _chunkConsumed.
+    if (_unlimitedSpeedChunksQueued >= _unlimitedSpeedChunksInFlight) {
+        return;
+    }
+
+    QByteArray chunk;
+    QByteArray bytes;
+    chunk.reserve(_unlimitedSpeedChunkBytes + MAVLINK_MAX_PACKET_LEN);
+    while (chunk.size() < _unlimitedSpeedChunkBytes && !_logFile.atEnd()) {
+        quint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
+        chunk.append(bytes);
+        if (nextTimeUSecs) {
+            _logCurrentTimeUSecs = nextTimeUSecs;
+        }
+    }
+    emit bytesReceived(this, chunk);
+    _unlimitedSpeedChunksQueued++;
+
+    // Queued behind the bytes above, so this runs once the GUI thread has processed them
+    QPointer<LogReplayLink> link(this);
+    QMetaObject::invokeMethod(qgcApp(), [link]() {
+        if (link) {
+            emit link->_chunkConsumedOnThread();
+        }
+    }, Qt::QueuedConnection);
+
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+    if (_logFile.atEnd()) {
+        _finishPlayback();
+        return;
+    }
+
+    _signalCurrentLogTimeSecs();
+    _readTickTimer.start(0);
+}
+
 void LogReplayLink::_play(void)
 {
     qgcApp()->toolbox()->linkManager()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
@@ -367,6 +582,7 @@ void LogReplayLink::_play(void)
     
     _playbackStartTimeMSecs = (quint64)QDateTime::currentMSecsSinceEpoch();
     _playbackStartLogTimeUSecs = _logCurrentTimeUSecs;
+    _playing = true;
     _readTickTimer.start(1);
     
     emit playbackStarted();
@@ -379,6 +595,7 @@ void LogReplayLink::_pause(void)
     qgcApp()->toolbox()->mavlinkProtocol()->suspendLogForReplay(false);
 #endif
     
+    _playing = false;
     _readTickTimer.stop();
     
     emit playbackPaused();
@@ -402,7 +619,7 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         _pauseOnThread();
         QSignalSpy waitForPause(this, SIGNAL(playbackPaused()));
         waitForPause.wait();
-        if (_readTickTimer.isActive()) {
+        if (_playing) {
             return;
         }
     }
@@ -414,45 +631,18 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         percentComplete = 100;
     }
     
-    qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
-
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
-    }
-
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    // Jump straight to the requested time using the index
+    quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.0) * _logDurationUSecs);
+    quint64 newTimeUSecs = _seekToTimestamp(desiredTimeUSecs);
+    if (newTimeUSecs == 0) {
         _replayError(tr("Unable to seek to new position"));
         return;
     }
-
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
+    _logCurrentTimeUSecs = newTimeUSecs;
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
+    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
     percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
     emit playbackPercentCompleteChanged(percentComplete);
 }
@@ -467,6 +657,17 @@ void LogReplayLink::_setPlaybackSpeed(qreal playbackSpeed)
     _readTickTimer.start(1);
 }
 
+/// Called on the link thread once the GUI thread has processed an unpaced replay chunk
+void LogReplayLink::_chunkConsumed(void)
+{
+    if (_unlimitedSpeedChunksQueued > 0) {
+        _unlimitedSpeedChunksQueued--;
+    }
+    if (_playing && _playbackSpeed <= 0 && !_readTickTimer.isActive()) {
+        _readTickTimer.start(0);
+    }
+}
+
 /// @brief Called when playback is complete
 void LogReplayLink::_finishPlayback(void)
 {
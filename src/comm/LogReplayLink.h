@@ -13,6 +13,12 @@
 
 #include <QTimer>
 #include <QFile>
+#include <QVector>
+#include <QLoggingCategory>
+
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(LogReplayLinkLog)
 
 class LinkManager;
 
@@ -52,12 +58,14 @@ class LogReplayLink : public LinkInterface
 {
     Q_OBJECT
 
+    friend class LogReplayLinkTest; // Unit test
+
 public:
     LogReplayLink(SharedLinkConfigurationPtr& config);
     virtual ~LogReplayLink();
 
     /// @return true: log is currently playing, false: log playback is paused
-    bool isPlaying(void) { return _readTickTimer.isActive(); }
+    bool isPlaying(void) { return _playing; }
 
     void play           (void) { emit _playOnThread(); }
     void pause          (void) { emit _pauseOnThread(); }
@@ -69,7 +77,8 @@ public:
     void disconnect (void) override;
 
 public slots:
-    /// Sets the acceleration factor: -100: 0.01X, 0: 1.0X, 100: 100.0X
+    /// Sets the playback speed multiplier: 1.0 is real time. A speed of 0 replays the log as fast as the vehicle stack
+    /// can consume it, with no pacing.
     void setPlaybackSpeed(qreal playbackSpeed) { emit _setPlaybackSpeedOnThread(playbackSpeed); }
 
 signals:
@@ -84,6 +93,7 @@ signals:
     void _playOnThread              (void);
     void _pauseOnThread             (void);
     void _setPlaybackSpeedOnThread  (qreal playbackSpeed);
+    void _chunkConsumedOnThread     (void);
 
 private slots:
     // LinkInterface overrides
@@ -93,17 +103,30 @@ private slots:
     void _play              (void);
     void _pause             (void);
     void _setPlaybackSpeed  (qreal playbackSpeed);
+    void _chunkConsumed     (void);
 
 private:
 
     // LinkInterface overrides
     bool _connect(void) override;
 
+    /// Sparse timestamp index into the log file, one entry every _indexIntervalUSecs
+    typedef struct {
+        quint64 timestampUSecs;
+        qint64  filePos;            ///< Position of the timestamp which precedes the message
+    } LogIndexEntry_t;
+
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
+    quint64 _parseTimestamp             (const char* bytes);
+    quint64 _parseTimestamp             (const QByteArray& bytes) { return _parseTimestamp(bytes.constData()); }
     quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
+    quint64 _seekToTimestamp            (quint64 timestampUSecs);
+    quint64 _buildIndex                 (void);
+    bool    _loadIndex                  (void);
+    void    _saveIndex                  (void);
+    QString _indexFilename              (void);
     quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    void    _readNextLogChunk           (void);
     bool    _loadLogFile                (void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
@@ -114,9 +137,10 @@ private:
 
     LogReplayLinkConfiguration* _logReplayConfig;
 
-    bool    _connected;
-    uint8_t _mavlinkChannel;
-    QTimer  _readTickTimer;      ///< Timer which signals a read of next log record
+    bool                _connected;
+    std::atomic<bool>   _playing;           ///< Written on the link thread, read from the GUI thread
+    uint8_t             _mavlinkChannel;
+    QTimer              _readTickTimer;     ///< Timer which signals a read of next log record
 
     QString _errorTitle; ///< Title for communicatorError signals
 
@@ -133,7 +157,16 @@ private:
     QFile               _logFile;
     quint64             _logFileSize;
 
-    static const int cbTimestamp = sizeof(quint64);
+    QVector<LogIndexEntry_t>    _logIndex;
+    int                         _unlimitedSpeedChunksQueued;    ///< Chunks sent to the GUI thread during unpaced replay which it hasn't processed yet
+
+    static const int        cbTimestamp = sizeof(quint64);
+    static const quint64    _indexIntervalUSecs             = 1000000;
+    static const quint32    _indexFileMagic                 = 0x51474958;   // "QGIX"
+    static const quint32    _indexFileVersion               = 1;
+    static const char*      _indexFileExtension;
+    static const int        _unlimitedSpeedChunkBytes       = 64 * 1024;
+    static const int        _unlimitedSpeedChunksInFlight   = 4;
 };
 
 class LogReplayLinkController : public QObject
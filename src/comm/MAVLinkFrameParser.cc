@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParser.h"
+
+#include <string.h>
+
+MAVLinkFrameParser::MAVLinkFrameParser(void)
+{
+    _pending.reserve(maxFrameLength * 2);
+}
+
+void MAVLinkFrameParser::reset(void)
+{
+    _pending.clear();
+    _framesReceived = 0;
+    _framesBadCRC   = 0;
+    _bytesSkipped   = 0;
+}
+
+int MAVLinkFrameParser::parse(uint8_t mavlinkChannel, const uint8_t* data, int size, QVector<mavlink_message_t>& messages)
+{
+    int startCount  = messages.count();
+    int position    = 0;
+
+    if (!_pending.isEmpty()) {
+        // Complete the frame left over from the previous buffer. Any frame which starts in the carry-over buffer
+        // must end within maxFrameLength bytes of new data, so that is all we ever need to copy.
+        int pendingCount    = _pending.size();
+        int copyCount       = qMin(size, maxFrameLength);
+        _pending.append(reinterpret_cast<const char*>(data), copyCount);
+
+        int consumed = _scan(mavlinkChannel, reinterpret_cast<const uint8_t*>(_pending.constData()), _pending.size(), messages);
+        if (copyCount == size) {
+            _pending.remove(0, consumed);
+            return messages.count() - startCount;
+        }
+
+        Q_ASSERT(consumed >= pendingCount);
+        position = qMax(0, consumed - pendingCount);
+        _pending.clear();
+    }
+
+    int consumed = _scan(mavlinkChannel, data + position, size - position, messages);
+    position += consumed;
+    if (position < size) {
+        _pending.append(reinterpret_cast<const char*>(data + position), size - position);
+    }
+
+    return messages.count() - startCount;
+}
+
+/// Decodes all complete frames in the buffer.
+/// @return Number of bytes consumed. Any remaining bytes are the start of an incomplete frame.
+int MAVLinkFrameParser::_scan(uint8_t mavlinkChannel, const uint8_t* buffer, int size, QVector<mavlink_message_t>& messages)
+{
+    mavlink_status_t*   mavlinkStatus   = mavlink_get_channel_status(mavlinkChannel);
+    int                 position        = 0;
+
+    while (position < size) {
+        uint8_t stx = buffer[position];
+        if (stx != MAVLINK_STX && stx != MAVLINK_STX_MAVLINK1) {
+            _bytesSkipped++;
+            position++;
+            continue;
+        }
+
+        int available   = size - position;
+        int frameLength = MAVLinkFrameParser::frameLength(buffer + position, available);
+        if (frameLength == 0) {
+            // Header is not a valid frame, resync on the next start marker
+            _bytesSkipped++;
+            position++;
+            continue;
+        }
+        if (frameLength < 0 || frameLength > available) {
+            // Incomplete frame, wait for more data
+            break;
+        }
+
+        messages.append(mavlink_message_t());
+        if (_decodeFrame(buffer + position, frameLength, &messages.last())) {
+            if (stx == MAVLINK_STX_MAVLINK1) {
+                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+            } else {
+                mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+            }
+            mavlinkStatus->current_rx_seq = messages.last().seq;
+            mavlinkStatus->packet_rx_success_count++;
+            _framesReceived++;
+            position += frameLength;
+        } else {
+            // Unlike the byte parser we only skip the start marker on a bad frame. That way a corrupted length
+            // byte can't swallow the valid frames which follow it.
+            messages.removeLast();
+            mavlinkStatus->packet_rx_drop_count++;
+            _framesBadCRC++;
+            position++;
+        }
+    }
+
+    return position;
+}
+
+int MAVLinkFrameParser::frameLength(const uint8_t* frame, int available)
+{
+    if (available < 3) {
+        return -1;
+    }
+
+    uint8_t payloadLength = frame[1];
+    if (frame[0] == MAVLINK_STX_MAVLINK1) {
+        return 1 + MAVLINK_CORE_HEADER_MAVLINK1_LEN + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+
+    uint8_t incompatFlags = frame[2];
+    if (incompatFlags & ~MAVLINK_IFLAG_MASK) {
+        // Message uses an incompatible feature we don't understand
+        return 0;
+    }
+
+    int frameLength = 1 + MAVLINK_CORE_HEADER_LEN + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (incompatFlags & MAVLINK_IFLAG_SIGNED) {
+        frameLength += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return frameLength;
+}
+
+bool MAVLinkFrameParser::frameValid(const uint8_t* frame, int frameLength)
+{
+    bool        mavlink1        = frame[0] == MAVLINK_STX_MAVLINK1;
+    int         headerLength    = 1 + (mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN);
+    uint8_t     payloadLength   = frame[1];
+    uint32_t    msgid           = mavlink1 ? frame[5] : (frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16));
+
+    if (frameLength < headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES) {
+        return false;
+    }
+
+    const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(msgid);
+    uint8_t crcExtra = msgEntry ? msgEntry->crc_extra : 0;
+
+    uint16_t crc;
+    crc_init(&crc);
+    crc_accumulate_buffer(&crc, reinterpret_cast<const char*>(frame + 1), static_cast<uint16_t>(headerLength - 1 + payloadLength));
+    crc_accumulate(crcExtra, &crc);
+
+    const uint8_t* ck = frame + headerLength + payloadLength;
+    return ck[0] == (crc & 0xFF) && ck[1] == (crc >> 8);
+}
+
+/// Validates the CRC over the frame and fills in the message the same way mavlink_parse_char would.
+bool MAVLinkFrameParser::_decodeFrame(const uint8_t* frame, int frameLength, mavlink_message_t* message)
+{
+    if (!frameValid(frame, frameLength)) {
+        return false;
+    }
+
+    bool    mavlink1        = frame[0] == MAVLINK_STX_MAVLINK1;
+    int     headerLength    = 1 + (mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN);
+    uint8_t payloadLength   = frame[1];
+
+    message->magic  = frame[0];
+    message->len    = payloadLength;
+    if (mavlink1) {
+        message->incompat_flags = 0;
+        message->compat_flags   = 0;
+        message->seq            = frame[2];
+        message->sysid          = frame[3];
+        message->compid         = frame[4];
+        message->msgid          = frame[5];
+    } else {
+        message->incompat_flags = frame[2];
+        message->compat_flags   = frame[3];
+        message->seq            = frame[4];
+        message->sysid          = frame[5];
+        message->compid         = frame[6];
+        message->msgid          = frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+    }
+
+    const uint8_t* ck   = frame + headerLength + payloadLength;
+    message->checksum   = static_cast<uint16_t>(ck[0] | (ck[1] << 8));
+    message->ck[0]      = ck[0];
+    message->ck[1]      = ck[1];
+
+    // Zero fill to cope with mavlink 2 payload truncation
+    const mavlink_msg_entry_t*  msgEntry    = mavlink_get_msg_entry(message->msgid);
+    uint8_t*                    payload     = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(message));
+    memcpy(payload, frame + headerLength, payloadLength);
+    if (msgEntry && payloadLength < msgEntry->max_msg_len) {
+        memset(payload + payloadLength, 0, msgEntry->max_msg_len - payloadLength);
+    }
+
+    if (!mavlink1 && (message->incompat_flags & MAVLINK_IFLAG_SIGNED)) {
+        memcpy(message->signature, ck + MAVLINK_NUM_CHECKSUM_BYTES, MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+
+    return true;
+}
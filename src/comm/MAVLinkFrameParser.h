@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include "QGCMAVLink.h"
+
+/// Framed MAVLink parser which works on a whole buffer at a time instead of byte by byte.
+///
+/// The parser scans the buffer for a start-of-frame marker, reads the frame length from the header and validates
+/// the CRC over the complete frame in place. Frames which are fully contained in the buffer are decoded straight
+/// from it. Only a frame which straddles two buffers (common on serial links) is copied into a small carry-over
+/// buffer which is completed by the next call. Each parser instance holds the state for a single mavlink channel.
+class MAVLinkFrameParser
+{
+public:
+    MAVLinkFrameParser(void);
+
+    /// Parse all complete frames from the specified buffer
+    ///     @param mavlinkChannel Channel whose mavlink_status_t flags/counters are updated
+    ///     @param data Buffer to parse
+    ///     @param size Number of bytes in buffer
+    ///     @param messages Decoded messages are appended to this list
+    /// @return Number of messages appended
+    int parse(uint8_t mavlinkChannel, const uint8_t* data, int size, QVector<mavlink_message_t>& messages);
+
+    /// Drops any partial frame and resets the counters
+    void reset(void);
+
+    uint64_t framesReceived (void) const { return _framesReceived; }
+    uint64_t framesBadCRC   (void) const { return _framesBadCRC; }
+    uint64_t bytesSkipped   (void) const { return _bytesSkipped; }
+    int      pendingBytes   (void) const { return _pending.size(); }
+
+    /// @return -1: not enough bytes to determine frame length, 0: not a valid frame header, otherwise full frame length
+    static int frameLength(const uint8_t* frame, int available);
+
+    /// @return true: CRC of the complete frame is valid
+    static bool frameValid(const uint8_t* frame, int frameLength);
+
+    static const int maxFrameLength = MAVLINK_MAX_PACKET_LEN;
+
+private:
+    int         _scan           (uint8_t mavlinkChannel, const uint8_t* buffer, int size, QVector<mavlink_message_t>& messages);
+    static bool _decodeFrame    (const uint8_t* frame, int frameLength, mavlink_message_t* message);
+
+    QByteArray  _pending;               ///< Start of a frame which was not complete at the end of the previous buffer
+    uint64_t    _framesReceived = 0;
+    uint64_t    _framesBadCRC   = 0;
+    uint64_t    _bytesSkipped   = 0;    ///< Bytes dropped while searching for a start-of-frame marker
+};
@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QElapsedTimer>
+#include <QtEndian>
+
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(MAVLinkLogWriterLog, "MAVLinkLogWriterLog")
+
+MAVLinkLogWriter::MAVLinkLogWriter(QObject* parent)
+    : QThread       (parent)
+    , _ring         (ringSize)
+    , _head         (0)
+    , _tail         (0)
+    , _stopRequested(false)
+    , _wakeRequested(false)
+    , _writeFailed  (false)
+    , _bytesWritten (0)
+{
+    static_assert((ringSize & (ringSize - 1)) == 0, "ringSize must be a power of two");
+    static_assert(ringSize % chunkSize == 0, "ringSize must be a multiple of chunkSize");
+}
+
+MAVLinkLogWriter::~MAVLinkLogWriter()
+{
+    stopLogging();
+}
+
+void MAVLinkLogWriter::startLogging(QFile* file)
+{
+    stopLogging();
+
+    _file           = file;
+    _droppedRecords = 0;
+    _head           = 0;
+    _tail           = 0;
+    _bytesWritten   = 0;
+    _stopRequested  = false;
+    _wakeRequested  = false;
+    _writeFailed    = false;
+
+    start(QThread::LowPriority);
+}
+
+void MAVLinkLogWriter::stopLogging(void)
+{
+    if (!_file) {
+        return;
+    }
+
+    _stopRequested = true;
+    {
+        QMutexLocker lock(&_wakeMutex);
+        _wakeCondition.wakeAll();
+    }
+    wait();
+
+    _file->flush();
+    if (_droppedRecords) {
+        qCWarning(MAVLinkLogWriterLog) << "Telemetry log writer could not keep up, dropped records:" << _droppedRecords << _file->fileName();
+    }
+    qCDebug(MAVLinkLogWriterLog) << "Stopped" << _file->fileName() << "bytes written" << _bytesWritten.load() << "dropped records" << _droppedRecords;
+    _file = nullptr;
+}
+
+bool MAVLinkLogWriter::write(quint64 timestampUSecs, const char* data, int length)
+{
+    if (!_file || _writeFailed) {
+        return false;
+    }
+
+    size_t recordLength = sizeof(quint64) + static_cast<size_t>(length);
+    size_t head         = _head.load(std::memory_order_relaxed);
+    size_t tail         = _tail.load(std::memory_order_acquire);
+
+    if (ringSize - (head - tail) < recordLength) {
+        _droppedRecords++;
+        return false;
+    }
+
+    uchar timestamp[sizeof(quint64)];
+    qToBigEndian(timestampUSecs, timestamp);
+    _copyIn(head, reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+    _copyIn(head + sizeof(timestamp), data, static_cast<size_t>(length));
+    _head.store(head + recordLength, std::memory_order_release);
+
+    // Only wake the writer once a full chunk is waiting, otherwise it picks things up on the flush interval
+    if (head + recordLength - tail >= chunkSize && !_wakeRequested.exchange(true)) {
+        QMutexLocker lock(&_wakeMutex);
+        _wakeCondition.wakeAll();
+    }
+
+    return true;
+}
+
+void MAVLinkLogWriter::_copyIn(size_t position, const char* data, size_t length)
+{
+    size_t offset       = position & (ringSize - 1);
+    size_t firstCopy    = qMin(length, ringSize - offset);
+
+    memcpy(&_ring[offset], data, firstCopy);
+    if (firstCopy < length) {
+        memcpy(&_ring[0], data + firstCopy, length - firstCopy);
+    }
+}
+
+/// Writes the outstanding data in the ring to the file
+///     @param wholeChunksOnly true: only write multiples of chunkSize, false: write everything
+/// @return false: write failed
+bool MAVLinkLogWriter::_writeAvailable(bool wholeChunksOnly)
+{
+    size_t tail     = _tail.load(std::memory_order_relaxed);
+    size_t head     = _head.load(std::memory_order_acquire);
+    size_t toWrite  = head - tail;
+
+    if (wholeChunksOnly) {
+        toWrite -= toWrite % chunkSize;
+    }
+
+    while (toWrite) {
+        size_t offset   = tail & (ringSize - 1);
+        size_t span     = qMin(toWrite, ringSize - offset);
+
+        if (_file->write(&_ring[offset], static_cast<qint64>(span)) != static_cast<qint64>(span)) {
+            _writeFailed = true;
+            emit writeError(_file->errorString());
+            return false;
+        }
+
+        tail    += span;
+        toWrite -= span;
+        _bytesWritten += span;
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    return true;
+}
+
+void MAVLinkLogWriter::run(void)
+{
+    QElapsedTimer flushTimer;
+    flushTimer.start();
+
+    while (!_stopRequested) {
+        {
+            QMutexLocker lock(&_wakeMutex);
+            if (!_wakeRequested && !_stopRequested) {
+                _wakeCondition.wait(&_wakeMutex, flushIntervalMSecs);
+            }
+            _wakeRequested = false;
+        }
+
+        bool flush = flushTimer.elapsed() >= flushIntervalMSecs;
+        if (!_writeAvailable(!flush)) {
+            return;
+        }
+        if (flush) {
+            _file->flush();
+            flushTimer.restart();
+        }
+    }
+
+    // Drain whatever is left before the file is closed
+    _writeAvailable(false);
+}
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QLoggingCategory>
+
+#include <atomic>
+#include <vector>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogWriterLog)
+
+/// Writes the telemetry log (.mavlink/.tlog) on a dedicated thread.
+///
+/// Records (big endian uint64 timestamp + mavlink packet) are encoded by the producer straight into a lock-free
+/// single producer/single consumer byte ring. The writer thread drains the ring to disk in large chunks. If the disk
+/// can't keep up and the ring fills, new records are dropped and counted instead of blocking the link.
+///
+/// Threading: write() must always be called from the same thread. startLogging/stopLogging are called from that same
+/// thread as well.
+class MAVLinkLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    MAVLinkLogWriter(QObject* parent = nullptr);
+    ~MAVLinkLogWriter();
+
+    /// Starts the writer thread on the specified open file. The caller must not touch the file until stopLogging returns.
+    void startLogging(QFile* file);
+
+    /// Writes out all outstanding records and stops the writer thread.
+    void stopLogging(void);
+
+    /// Queues a timestamp/data pair as a single record
+    ///     @param timestampUSecs Timestamp which is written big endian ahead of the data
+    /// @return false: record dropped since the ring is full or logging is not running
+    bool write(quint64 timestampUSecs, const char* data, int length);
+
+    bool    logging         (void) const { return _file != nullptr; }
+    quint64 droppedRecords  (void) const { return _droppedRecords; }
+    quint64 bytesWritten    (void) const { return _bytesWritten.load(); }
+
+    static const size_t ringSize            = 4 * 1024 * 1024;  ///< Must be a power of two and a multiple of chunkSize
+    static const size_t chunkSize           = 64 * 1024;        ///< Writes are issued in multiples of this size
+    static const int    flushIntervalMSecs  = 1000;             ///< Partial chunks are written out at least this often
+
+signals:
+    /// Emitted from the writer thread if the file write fails. Logging stops when this happens.
+    void writeError(QString errorString);
+
+protected:
+    void run(void) override;
+
+private:
+    void _copyIn        (size_t position, const char* data, size_t length);
+    bool _writeAvailable(bool wholeChunksOnly);
+
+    std::vector<char>   _ring;
+    std::atomic<size_t> _head;              ///< Producer position, only modified by producer
+    std::atomic<size_t> _tail;              ///< Consumer position, only modified by writer thread
+    std::atomic<bool>   _stopRequested;
+    std::atomic<bool>   _wakeRequested;
+    std::atomic<bool>   _writeFailed;
+    QMutex              _wakeMutex;
+    QWaitCondition      _wakeCondition;
+    QFile*              _file           = nullptr;
+    quint64             _droppedRecords = 0;
+    std::atomic<quint64> _bytesWritten;
+};
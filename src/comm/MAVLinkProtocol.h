@@ -15,10 +15,13 @@
 #include <QTimer>
 #include <QFile>
 #include <QMap>
+#include <QVector>
 #include <QByteArray>
 #include <QLoggingCategory>
 
 #include "LinkInterface.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkLogWriter.h"
 #include "QGCMAVLink.h"
 #include "QGC.h"
 #include "QGCTemporaryFile.h"
@@ -71,6 +74,9 @@ public:
     /// Suspend/Restart logging during replay.
     void suspendLogForReplay(bool suspend);
 
+    /// @return Number of records dropped from the current (or last) telemetry log because the writer could not keep up
+    quint64 telemetryLogDroppedRecords(void) const { return _logWriter.droppedRecords(); }
+
     /// Set protocol version
     void setVersion(unsigned version);
 
@@ -109,8 +115,8 @@ protected:
     uint64_t    totalLossCounter[MAVLINK_COMM_NUM_BUFFERS];     ///< Total messages lost during transmission.
     float       runningLossPercent[MAVLINK_COMM_NUM_BUFFERS];   ///< Loss rate
 
-    mavlink_message_t _message;
-    mavlink_status_t _status;
+    MAVLinkFrameParser              _frameParsers[MAVLINK_COMM_NUM_BUFFERS];   ///< Per channel framed parser
+    QVector<mavlink_message_t>      _messageBatch;                              ///< Reused storage for the messages parsed from a single buffer
 
     bool        versionMismatchIgnore;
     int         systemId;
@@ -121,8 +127,8 @@ signals:
     /// Heartbeat received on link
     void vehicleHeartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType);
 
-    /** @brief Message received and directly copied via signal */
-    void messageReceived(LinkInterface* link, mavlink_message_t message);
+    /// All messages parsed from a single buffer received on the link. Emitted once per receiveBytes call.
+    void messagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages);
     /** @brief Emitted if version check is enabled / disabled */
     void versionCheckChanged(bool enabled);
     /** @brief Emitted if a message from the protocol should reach the user */
@@ -154,6 +160,7 @@ signals:
 
 private slots:
     void _vehicleCountChanged(void);
+    void _logWriteError(QString errorString);
 
 private:
     bool _closeLogFile(void);
@@ -165,6 +172,7 @@ private:
     bool _vehicleWasArmed;      ///< true: Vehicle was armed during log sequence
 
     QGCTemporaryFile    _tempLogFile;            ///< File to log to
+    MAVLinkLogWriter    _logWriter;              ///< Writes _tempLogFile on its own thread
     static const char*  _tempLogFileTemplate;    ///< Template for temporary log file
     static const char*  _logFileExtension;       ///< Extension for log files
 
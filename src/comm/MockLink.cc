@@ -1583,16 +1583,20 @@ void MockLink::_logDownloadWorker(void)
 
             qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
 
-            mavlink_message_t responseMsg;
-            mavlink_msg_log_data_pack_chan(_vehicleSystemId,
-                                           _vehicleComponentId,
-                                           mavlinkChannel(),
-                                           &responseMsg,
-                                           _logDownloadLogId,
-                                           _logDownloadCurrentOffset,
-                                           bytesToRead,
-                                           &buffer[0]);
-            respondWithMavlinkMessage(responseMsg);
+            if (_logDownloadDropEveryN > 0 && (++_logDownloadPacketCount % _logDownloadDropEveryN) == 0) {
+                qCDebug(MockLinkLog) << "_logDownloadWorker dropping packet" << _logDownloadCurrentOffset;
+            } else {
+                mavlink_message_t responseMsg;
+                mavlink_msg_log_data_pack_chan(_vehicleSystemId,
+                                               _vehicleComponentId,
+                                               mavlinkChannel(),
+                                               &responseMsg,
+                                               _logDownloadLogId,
+                                               _logDownloadCurrentOffset,
+                                               bytesToRead,
+                                               &buffer[0]);
+                respondWithMavlinkMessage(responseMsg);
+            }
 
             _logDownloadCurrentOffset += bytesToRead;
             _logDownloadBytesRemaining -= bytesToRead;
@@ -152,6 +152,12 @@ public:
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
+    /// Sets the size of the simulated log file. Must be called before the log list is requested.
+    void setLogDownloadFileSize(uint32_t size) { _logDownloadFileSize = size; }
+
+    /// Drops every Nth LOG_DATA packet to simulate a lossy link, 0 to drop none
+    void setLogDownloadDropRate(int dropEveryN) { _logDownloadDropEveryN = dropEveryN; }
+
     Q_INVOKABLE void setCommLost                    (bool commLost)   { _commLost = commLost; }
     Q_INVOKABLE void simulateConnectionRemoved      (void);
     static MockLink* startPX4MockLink               (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
@@ -299,11 +305,13 @@ private:
     int _currentParamRequestListParamIndex;     // Current parameter index for param request list workflow
 
     static const uint16_t _logDownloadLogId = 0;        ///< Id of siumulated log file
-    static const uint32_t _logDownloadFileSize = 1000;  ///< Size of simulated log file
 
+    uint32_t    _logDownloadFileSize    = 1000; ///< Size of simulated log file
     QString     _logDownloadFilename;       ///< Filename for log download which is in progress
     uint32_t    _logDownloadCurrentOffset;  ///< Current offset we are sending from
     uint32_t    _logDownloadBytesRemaining; ///< Number of bytes still to send, 0 = send inactive
+    int         _logDownloadDropEveryN  = 0;
+    int         _logDownloadPacketCount = 0;
 
     QGeoCoordinate  _adsbVehicleCoordinate;
     double          _adsbAngle;
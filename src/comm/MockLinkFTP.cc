@@ -10,6 +10,7 @@
 
 #include "MockLinkFTP.h"
 #include "MockLink.h"
+#include "QGC.h"
 
 const MockLinkFTP::ErrorMode_t MockLinkFTP::rgFailureModes[] = {
     MockLinkFTP::errModeNoResponse,
@@ -113,19 +114,7 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
 
     _currentFile.close();
 
-    QString sizePrefix = sizeFilenamePrefix;
-    if (path.startsWith(sizePrefix)) {
-        QString sizeString = path.right(path.length() - sizePrefix.length());
-        tmpFilename = _createTestTempFile(sizeString.toInt());
-    } else if (path == "/general.json") {
-        tmpFilename = ":MockLink/General.MetaData.json";
-    } else if (path == "/general.json.xz") {
-        tmpFilename = ":MockLink/General.MetaData.json.xz";
-    } else if (path == "/parameter.json") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json";
-    } else if (path == "/parameter.json.xz") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json.xz";
-    }
+    tmpFilename = _localFileName(path);
 
     if (!tmpFilename.isEmpty()) {
         _currentFile.setFileName(tmpFilename);
@@ -149,6 +138,25 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
 }
 
+/// @return Local file which backs the specified vehicle path, empty if there is none
+QString MockLinkFTP::_localFileName(const QString& path)
+{
+    QString sizePrefix = sizeFilenamePrefix;
+    if (path.startsWith(sizePrefix)) {
+        QString sizeString = path.right(path.length() - sizePrefix.length());
+        return _createTestTempFile(sizeString.toInt());
+    } else if (path == "/general.json") {
+        return ":MockLink/General.MetaData.json";
+    } else if (path == "/general.json.xz") {
+        return ":MockLink/General.MetaData.json.xz";
+    } else if (path == "/parameter.json") {
+        return ":MockLink/Parameter.MetaData.json";
+    } else if (path == "/parameter.json.xz") {
+        return ":MockLink/Parameter.MetaData.json.xz";
+    }
+    return QString();
+}
+
 void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     MavlinkFTP::Request	response{};
@@ -239,6 +247,85 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     }
 }
 
+void MockLinkFTP::_createCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    ensureNullTemination(request);
+
+    _currentFile.close();
+    _uploadPath = (char *)request->data;
+    _uploadData.clear();
+
+    _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdCreateFile);
+}
+
+void MockLinkFTP::_writeCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    if (request->hdr.session != _sessionId) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdWriteFile);
+        return;
+    }
+
+    if (request->hdr.offset != 0) {
+        if (_errMode == errModeNakSecondResponse) {
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdWriteFile);
+            return;
+        } else if (_errMode == errModeNoSecondResponse) {
+            return;
+        }
+    }
+
+    uint32_t cBytes = qMin(static_cast<uint32_t>(request->hdr.size), static_cast<uint32_t>(sizeof(request->data)));
+    if (static_cast<uint32_t>(_uploadData.size()) < request->hdr.offset + cBytes) {
+        _uploadData.resize(static_cast<int>(request->hdr.offset + cBytes));
+    }
+    memcpy(_uploadData.data() + request->hdr.offset, request->data, cBytes);
+
+    response.hdr.session    = _sessionId;
+    response.hdr.size       = sizeof(uint32_t);
+    response.hdr.offset     = request->hdr.offset;
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdWriteFile;
+    response.writeFileLength = cBytes;
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
+void MockLinkFTP::_calcFileCRC32Command(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+    QByteArray          bytes;
+
+    ensureNullTemination(request);
+
+    QString path = (char *)request->data;
+    if (!_uploadPath.isEmpty() && path == _uploadPath) {
+        bytes = _uploadData;
+    } else {
+        QFile file(_localFileName(path));
+        if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly)) {
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+            return;
+        }
+        bytes = file.readAll();
+    }
+
+    quint32 crc = QGC::crc32(reinterpret_cast<const quint8*>(bytes.constData()), static_cast<unsigned>(bytes.size()), 0);
+
+    response.hdr.session    = 0;
+    response.hdr.size       = sizeof(uint32_t);
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdCalcFileCRC32;
+    memcpy(response.data, &crc, sizeof(crc));
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
 void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
@@ -281,9 +368,9 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
 
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&requestFTP.payload[0];
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.opcode != MavlinkFTP::kCmdResetSessions) {
-        if ((rand() % 5) == 0) {
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if (request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.opcode != MavlinkFTP::kCmdCreateFile && request->hdr.opcode != MavlinkFTP::kCmdResetSessions) {
+        if (_randomDrop()) {
             qDebug() << "MockLinkFTP: Random drop of incoming packet";
             return;
         }
@@ -336,6 +423,18 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
         _burstReadCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
 
+    case MavlinkFTP::kCmdCreateFile:
+        _createCommand(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
+    case MavlinkFTP::kCmdWriteFile:
+        _writeCommand(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
+    case MavlinkFTP::kCmdCalcFileCRC32:
+        _calcFileCRC32Command(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
     case MavlinkFTP::kCmdTerminateSession:
         _terminateCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
@@ -407,9 +506,9 @@ void MockLinkFTP::_sendResponse(uint8_t targetSystemId, uint8_t targetComponentI
                                                  targetComponentId,
                                                  (uint8_t*)request);            // Payload
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions) {
-        if ((rand() % 5) == 0) {
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if (request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.req_opcode != MavlinkFTP::kCmdCreateFile && request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions) {
+        if (_randomDrop()) {
             qDebug() << "MockLinkFTP: Random drop of outgoing packet";
             return;
         }
@@ -430,6 +529,11 @@ uint16_t MockLinkFTP::_nextSeqNumber(uint16_t seqNumber)
     return outgoingSeqNumber;
 }
 
+bool MockLinkFTP::_randomDrop(void)
+{
+    return _randomDropPercent > 0 && (rand() % 100) < _randomDropPercent;
+}
+
 QString MockLinkFTP::_createTestTempFile(int size)
 {
     QGCTemporaryFile tmpFile("MockLinkFTPTestCase");
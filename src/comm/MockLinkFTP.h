@@ -53,7 +53,13 @@ public:
     /// Called to handle an FTP message
     void mavlinkMessageReceived(const mavlink_message_t& message);
 
-    void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
+    void enableRandromDrops(bool enable) { setRandomDropPercent(enable ? 20 : 0); }
+
+    /// Drops the specified percentage of incoming and outgoing packets
+    void setRandomDropPercent(int percent) { _randomDropPercent = percent; }
+
+    /// @return Contents of the last file written through Create/Write
+    const QByteArray& uploadData(void) const { return _uploadData; }
 
     static const char* sizeFilenamePrefix;
 
@@ -73,10 +79,15 @@ private:
     void        _openCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _readCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _burstReadCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _createCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _writeCommand           (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _calcFileCRC32Command   (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _terminateCommand       (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _resetCommand           (uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
     uint16_t    _nextSeqNumber          (uint16_t seqNumber);
     QString     _createTestTempFile     (int size);
+    QString     _localFileName          (const QString& path);
+    bool        _randomDrop             (void);
     
     /// if request is a string, this ensures it's null-terminated
     static void ensureNullTemination(MavlinkFTP::Request* request);
@@ -91,7 +102,9 @@ private:
     bool                    _lastReplyValid     = false;
     uint16_t                _lastReplySequence  = 0;
     mavlink_message_t       _lastReply;
-    bool                    _randomDropsEnabled = false;
+    int                     _randomDropPercent  = 0;
+    QString                 _uploadPath;                        ///< Vehicle path of the file created through kCmdCreateFile
+    QByteArray              _uploadData;
 
     static const uint8_t    _sessionId          = 1;    ///< We only support a single fixed session
 };
@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPBatchSocket.h"
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+
+struct UDPBatchSocket::ReceiveHeaders_t {
+    struct mmsghdr      messages[kBatchSize];
+    struct iovec        iovecs  [kBatchSize];
+    struct sockaddr_in  senders [kBatchSize];
+};
+
+UDPBatchSocket::UDPBatchSocket(void)
+    : _fd       (-1)
+    , _headers  (nullptr)
+{
+
+}
+
+UDPBatchSocket::~UDPBatchSocket()
+{
+    close();
+}
+
+bool UDPBatchSocket::available(void)
+{
+    return !qEnvironmentVariableIsSet("QGC_UDP_DISABLE_BATCH_IO");
+}
+
+bool UDPBatchSocket::open(quint16 port, int sendBufferSize, int receiveBufferSize)
+{
+    close();
+
+    _fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd == -1) {
+        _errorString = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    ::setsockopt(_fd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+    ::setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port        = htons(port);
+
+    if (::bind(_fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1) {
+        _errorString = QString::fromLocal8Bit(strerror(errno));
+        close();
+        return false;
+    }
+
+    struct ip_mreq multicast;
+    memset(&multicast, 0, sizeof(multicast));
+    multicast.imr_multiaddr.s_addr  = inet_addr("224.0.0.1");
+    multicast.imr_interface.s_addr  = htonl(INADDR_ANY);
+    ::setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &multicast, sizeof(multicast));
+
+    // Everything receive needs is set up once here, receive itself only resets the lengths
+    _pool.resize(kBatchSize * kDatagramSize);
+    _headers = new ReceiveHeaders_t;
+    memset(_headers, 0, sizeof(ReceiveHeaders_t));
+    for (int i=0; i<kBatchSize; i++) {
+        _headers->iovecs[i].iov_base                = _pool.data() + (i * kDatagramSize);
+        _headers->iovecs[i].iov_len                 = kDatagramSize;
+        _headers->messages[i].msg_hdr.msg_iov       = &_headers->iovecs[i];
+        _headers->messages[i].msg_hdr.msg_iovlen    = 1;
+        _headers->messages[i].msg_hdr.msg_name      = &_headers->senders[i];
+    }
+
+    _errorString.clear();
+    return true;
+}
+
+void UDPBatchSocket::close(void)
+{
+    if (_fd != -1) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    delete _headers;
+    _headers = nullptr;
+    _pool.clear();
+}
+
+int UDPBatchSocket::receive(void)
+{
+    if (_fd == -1) {
+        return -1;
+    }
+
+    for (int i=0; i<kBatchSize; i++) {
+        _headers->messages[i].msg_hdr.msg_namelen  = sizeof(struct sockaddr_in);
+        _headers->messages[i].msg_hdr.msg_flags    = 0;
+        _headers->messages[i].msg_len              = 0;
+    }
+
+    int count;
+    do {
+        count = ::recvmmsg(_fd, _headers->messages, kBatchSize, MSG_DONTWAIT, nullptr);
+    } while (count == -1 && errno == EINTR);
+
+    if (count == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        _errorString = QString::fromLocal8Bit(strerror(errno));
+        return -1;
+    }
+
+    return count;
+}
+
+int UDPBatchSocket::size(int index) const
+{
+    return qMin(static_cast<int>(_headers->messages[index].msg_len), kDatagramSize);
+}
+
+quint32 UDPBatchSocket::senderAddress(int index) const
+{
+    return ntohl(_headers->senders[index].sin_addr.s_addr);
+}
+
+quint16 UDPBatchSocket::senderPort(int index) const
+{
+    return ntohs(_headers->senders[index].sin_port);
+}
+
+bool UDPBatchSocket::truncated(int index) const
+{
+    return _headers->messages[index].msg_hdr.msg_flags & MSG_TRUNC;
+}
+
+int UDPBatchSocket::sendToAll(const QByteArray& datagram, const Destination_t* destinations, int count, int& calls)
+{
+    calls = 0;
+
+    if (_fd == -1) {
+        return 0;
+    }
+
+    struct mmsghdr      messages    [kBatchSize];
+    struct sockaddr_in  addresses   [kBatchSize];
+    struct iovec        iov;
+
+    // Every message points at the same payload
+    iov.iov_base    = const_cast<char*>(datagram.constData());
+    iov.iov_len     = datagram.size();
+
+    memset(messages, 0, sizeof(messages));
+    memset(addresses, 0, sizeof(addresses));
+
+    int next = 0;
+    int sent = 0;
+    while (next < count) {
+        const int batchCount = qMin(count - next, kBatchSize);
+
+        for (int i=0; i<batchCount; i++) {
+            addresses[i].sin_family             = AF_INET;
+            addresses[i].sin_addr.s_addr        = htonl(destinations[next + i].address);
+            addresses[i].sin_port               = htons(destinations[next + i].port);
+            messages[i].msg_hdr.msg_name        = &addresses[i];
+            messages[i].msg_hdr.msg_namelen     = sizeof(struct sockaddr_in);
+            messages[i].msg_hdr.msg_iov         = &iov;
+            messages[i].msg_hdr.msg_iovlen      = 1;
+        }
+
+        int batchSent;
+        do {
+            batchSent = ::sendmmsg(_fd, messages, batchCount, 0);
+        } while (batchSent == -1 && errno == EINTR);
+        calls++;
+
+        if (batchSent == -1) {
+            // sendmmsg only fails if the first message could not be sent. Skip it so the others still go out.
+            _errorString = QString::fromLocal8Bit(strerror(errno));
+            next++;
+        } else {
+            sent += batchSent;
+            next += batchSent;
+        }
+    }
+
+    return sent;
+}
+
+#else
+
+UDPBatchSocket::UDPBatchSocket(void)
+    : _fd       (-1)
+    , _headers  (nullptr)
+{
+
+}
+
+UDPBatchSocket::~UDPBatchSocket()
+{
+
+}
+
+bool UDPBatchSocket::available(void)
+{
+    return false;
+}
+
+bool UDPBatchSocket::open(quint16 port, int sendBufferSize, int receiveBufferSize)
+{
+    Q_UNUSED(port)
+    Q_UNUSED(sendBufferSize)
+    Q_UNUSED(receiveBufferSize)
+    _errorString = QStringLiteral("Batched datagram I/O is not supported on this platform");
+    return false;
+}
+
+void UDPBatchSocket::close(void)
+{
+
+}
+
+int UDPBatchSocket::receive(void)
+{
+    return -1;
+}
+
+int UDPBatchSocket::size(int index) const
+{
+    Q_UNUSED(index)
+    return 0;
+}
+
+quint32 UDPBatchSocket::senderAddress(int index) const
+{
+    Q_UNUSED(index)
+    return 0;
+}
+
+quint16 UDPBatchSocket::senderPort(int index) const
+{
+    Q_UNUSED(index)
+    return 0;
+}
+
+bool UDPBatchSocket::truncated(int index) const
+{
+    Q_UNUSED(index)
+    return false;
+}
+
+int UDPBatchSocket::sendToAll(const QByteArray& datagram, const Destination_t* destinations, int count, int& calls)
+{
+    Q_UNUSED(datagram)
+    Q_UNUSED(destinations)
+    Q_UNUSED(count)
+    calls = 0;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+/// Non blocking IPv4 UDP socket which moves many datagrams per system call using recvmmsg/sendmmsg. Datagrams are
+/// received into a buffer pool which is allocated once when the socket is opened. Only available on Linux (and Android),
+/// elsewhere open() fails and callers fall back to QUdpSocket.
+class UDPBatchSocket
+{
+public:
+    UDPBatchSocket(void);
+    ~UDPBatchSocket();
+
+    static const int kBatchSize     = 32;    ///< Max datagrams per system call
+    static const int kDatagramSize  = 65507; ///< Size of each receive buffer, the largest possible IPv4 UDP payload
+
+    typedef struct {
+        quint32 address;                    ///< IPv4 address, host byte order
+        quint16 port;
+    } Destination_t;
+
+    /// @return true: batched datagram I/O is supported on this platform and not disabled through QGC_UDP_DISABLE_BATCH_IO
+    static bool available(void);
+
+    /// Binds to INADDR_ANY:port with address reuse and joins the 224.0.0.1 multicast group
+    /// @return false: socket could not be created or bound, errorString set
+    bool open(quint16 port, int sendBufferSize, int receiveBufferSize);
+    void close(void);
+
+    bool    isOpen              (void) const { return _fd != -1; }
+    int     socketDescriptor    (void) const { return _fd; }
+    QString errorString         (void) const { return _errorString; }
+
+    /// Reads up to kBatchSize pending datagrams with a single system call. The datagrams stay valid until the next call.
+    /// @return Number of datagrams read, 0 if none are pending, -1 on error
+    int receive(void);
+
+    /// Access to the datagrams read by the last receive call
+    const char* data            (int index) const { return _pool.constData() + (index * kDatagramSize); }
+    int         size            (int index) const;
+    quint32     senderAddress   (int index) const;  ///< IPv4 address, host byte order
+    quint16     senderPort      (int index) const;
+    bool        truncated       (int index) const;
+
+    /// Sends the same datagram to each destination, kBatchSize destinations per system call
+    ///     @param[out] calls Number of system calls made
+    /// @return Number of datagrams sent
+    int sendToAll(const QByteArray& datagram, const Destination_t* destinations, int count, int& calls);
+
+private:
+    struct ReceiveHeaders_t;
+
+    int                 _fd;
+    QByteArray          _pool;      ///< kBatchSize receive buffers of kDatagramSize
+    ReceiveHeaders_t*   _headers;   ///< Message headers and sender addresses for the receive buffers
+    QString             _errorString;
+};
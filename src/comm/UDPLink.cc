@@ -11,8 +11,8 @@
 #include <QTimer>
 #include <QList>
 #include <QDebug>
-#include <QMutexLocker>
 #include <QNetworkProxy>
+#include <QVarLengthArray>
 #include <QNetworkInterface>
 #include <iostream>
 #include <QHostInfo>
@@ -22,6 +22,9 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "AutoConnectSettings.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(UDPLinkLog, "UDPLinkLog")
 
 static const char* kZeroconfRegistration = "_qgroundcontrol._udp";
 
@@ -65,12 +68,34 @@ static bool contains_target(const QList<UDPCLient*> list, const QHostAddress& ad
     return false;
 }
 
+/// Hash key for a sender address and port. IPv4 addresses map directly, anything else is hashed into a separate range.
+static quint64 target_key(quint32 ipv4Address, quint16 port)
+{
+    return (static_cast<quint64>(ipv4Address) << 16) | port;
+}
+
+static quint64 target_key(const QHostAddress& address, quint16 port)
+{
+    bool    isIPv4      = false;
+    quint32 ipv4Address = address.toIPv4Address(&isIPv4);
+    if (isIPv4) {
+        return target_key(ipv4Address, port);
+    }
+    return (Q_UINT64_C(1) << 63) | (static_cast<quint64>(qHash(address)) << 16) | port;
+}
+
 UDPLink::UDPLink(SharedLinkConfigurationPtr& config)
     : LinkInterface     (config)
     , _running          (false)
     , _socket           (nullptr)
+    , _batchNotifier    (nullptr)
+    , _batchIO          (false)
     , _udpConfig        (qobject_cast<UDPConfiguration*>(config.get()))
     , _connectState     (false)
+    , _receivedDatagrams(0)
+    , _receiveCalls     (0)
+    , _sentDatagrams    (0)
+    , _sendCalls        (0)
 #if defined(QGC_ZEROCONF_ENABLED)
     , _dnssServiceRef   (nullptr)
 #endif
@@ -94,6 +119,7 @@ UDPLink::~UDPLink()
     // Clear client list
     qDeleteAll(_sessionTargets);
     _sessionTargets.clear();
+    _sessionTargetIndex.clear();
     quit();
     // Wait for it to exit
     wait();
@@ -109,6 +135,23 @@ void UDPLink::run()
         _deregisterZeroconf();
         _socket->close();
     }
+    if (_batchNotifier) {
+        // The notifier has to go away on the thread it was created on
+        _deregisterZeroconf();
+        delete _batchNotifier;
+        _batchNotifier = nullptr;
+        _batchSocket.close();
+    }
+}
+
+UDPLink::IOStats_t UDPLink::ioStats(void) const
+{
+    IOStats_t stats;
+    stats.receivedDatagrams = _receivedDatagrams;
+    stats.receiveCalls      = _receiveCalls;
+    stats.sentDatagrams     = _sentDatagrams;
+    stats.sendCalls         = _sendCalls;
+    return stats;
 }
 
 bool UDPLink::_isIpLocal(const QHostAddress& add)
@@ -139,18 +182,21 @@ bool UDPLink::_isIpLocal(const QHostAddress& add)
 
 void UDPLink::_writeBytes(const QByteArray data)
 {
+    if (_batchIO) {
+        emit bytesSent(this, data);
+        _writeBatch(data);
+        return;
+    }
     if (!_socket) {
         return;
     }
     emit bytesSent(this, data);
 
-    QMutexLocker locker(&_sessionTargetsMutex);
-
     // Send to all manually targeted systems
     for (int i=0; i<_udpConfig->targetHosts().count(); i++) {
         UDPCLient* target = _udpConfig->targetHosts()[i];
         // Skip it if it's part of the session clients below
-        if(!contains_target(_sessionTargets, target->address, target->port)) {
+        if(!_isSessionTarget(target)) {
             _writeDataGram(data, target);
         }
     }
@@ -160,16 +206,64 @@ void UDPLink::_writeBytes(const QByteArray data)
     }
 }
 
+/// Sends data to all targets with as few sendmmsg calls as possible
+void UDPLink::_writeBatch(const QByteArray& data)
+{
+    QVarLengthArray<UDPBatchSocket::Destination_t, UDPBatchSocket::kBatchSize> destinations;
+
+    auto addDestination = [&destinations](const UDPCLient* target) {
+        bool    isIPv4      = false;
+        quint32 ipv4Address = target->address.toIPv4Address(&isIPv4);
+        if (isIPv4) {
+            UDPBatchSocket::Destination_t destination = { ipv4Address, target->port };
+            destinations.append(destination);
+        } else {
+            qWarning() << "Error writing to" << target->address << target->port;
+        }
+    };
+
+    // Send to all manually targeted systems which are not part of the session clients
+    const QList<UDPCLient*> targetHosts = _udpConfig->targetHosts();
+    for (const UDPCLient* target: targetHosts) {
+        if (!_isSessionTarget(target)) {
+            addDestination(target);
+        }
+    }
+    // Send to all connected systems
+    for (const UDPCLient* target: _sessionTargets) {
+        addDestination(target);
+    }
+
+    if (destinations.isEmpty()) {
+        return;
+    }
+
+    int calls = 0;
+    int sent = _batchSocket.sendToAll(data, destinations.constData(), destinations.count(), calls);
+    if (sent != destinations.count()) {
+        qWarning() << "Error writing to" << destinations.count() - sent << "targets:" << _batchSocket.errorString();
+    }
+    _sentDatagrams += sent;
+    _sendCalls += calls;
+}
+
 void UDPLink::_writeDataGram(const QByteArray data, const UDPCLient* target)
 {
     //qDebug() << "UDP Out" << target->address << target->port;
+    _sendCalls++;
     if(_socket->writeDatagram(data, target->address, target->port) < 0) {
         qWarning() << "Error writing to" << target->address << target->port;
+    } else {
+        _sentDatagrams++;
     }
 }
 
 void UDPLink::readBytes()
 {
+    if (_batchIO) {
+        _readBatches();
+        return;
+    }
     if (!_socket) {
         return;
     }
@@ -186,27 +280,68 @@ void UDPLink::readBytes()
         if (slen == -1) {
             break;
         }
+        _receivedDatagrams++;
+        _receiveCalls++;
         databuffer.append(datagram);
         //-- Wait a bit before sending it over
         if (databuffer.size() > 10 * 1024) {
             emit bytesReceived(this, databuffer);
             databuffer.clear();
         }
-        // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
-        // added to the list and will start receiving datagrams from here. Even a port scanner
-        // would trigger this.
-        // Add host to broadcast list if not yet present, or update its port
-        QHostAddress asender = sender;
-        if(_isIpLocal(sender)) {
-            asender = QHostAddress(QString("127.0.0.1"));
+        _noteSender(sender, senderPort);
+    }
+    //-- Send whatever is left
+    if (databuffer.size()) {
+        emit bytesReceived(this, databuffer);
+    }
+}
+
+/// Drains the socket kBatchSize datagrams per recvmmsg call. Datagrams are read into the preallocated pool of the batch
+/// socket, the only allocation is the buffer handed to bytesReceived.
+void UDPLink::_readBatches(void)
+{
+    QByteArray  databuffer;
+    int         count;
+
+    while ((count = _batchSocket.receive()) > 0) {
+        _receivedDatagrams += count;
+        _receiveCalls++;
+
+        int batchBytes = 0;
+        for (int i=0; i<count; i++) {
+            batchBytes += _batchSocket.size(i);
+        }
+        databuffer.reserve(databuffer.size() + batchBytes);
+
+        for (int i=0; i<count; i++) {
+            if (_batchSocket.truncated(i)) {
+                // A partial datagram would corrupt the MAVLink stream
+                qWarning() << "UDP datagram larger than" << UDPBatchSocket::kDatagramSize << "bytes dropped";
+                continue;
+            }
+            databuffer.append(_batchSocket.data(i), _batchSocket.size(i));
+
+            const quint32 senderAddress = _batchSocket.senderAddress(i);
+            const quint16 senderPort    = _batchSocket.senderPort(i);
+            const quint64 senderKey     = target_key(senderAddress, senderPort);
+            if (!_sessionTargetIndex.contains(senderKey)) {
+                _addSessionTarget(senderKey, QHostAddress(senderAddress), senderPort);
+            }
+        }
+
+        //-- Wait a bit before sending it over
+        if (databuffer.size() > 10 * 1024) {
+            emit bytesReceived(this, databuffer);
+            databuffer.clear();
         }
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!contains_target(_sessionTargets, asender, senderPort)) {
-            qDebug() << "Adding target" << asender << senderPort;
-            UDPCLient* target = new UDPCLient(asender, senderPort);
-            _sessionTargets.append(target);
+
+        if (count < UDPBatchSocket::kBatchSize) {
+            // Socket is drained
+            break;
         }
-        locker.unlock();
+    }
+    if (count == -1) {
+        qWarning() << "Error reading UDP datagrams:" << _batchSocket.errorString();
     }
     //-- Send whatever is left
     if (databuffer.size()) {
@@ -214,6 +349,44 @@ void UDPLink::readBytes()
     }
 }
 
+void UDPLink::_noteSender(const QHostAddress& sender, quint16 senderPort)
+{
+    const quint64 senderKey = target_key(sender, senderPort);
+    if (!_sessionTargetIndex.contains(senderKey)) {
+        _addSessionTarget(senderKey, sender, senderPort);
+    }
+}
+
+/// Called for a sender which is not in the session target index yet
+void UDPLink::_addSessionTarget(quint64 senderKey, const QHostAddress& sender, quint16 senderPort)
+{
+    // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
+    // added to the list and will start receiving datagrams from here. Even a port scanner
+    // would trigger this.
+    // Add host to broadcast list if not yet present, or update its port
+    QHostAddress asender = sender;
+    if(_isIpLocal(sender)) {
+        asender = QHostAddress(QString("127.0.0.1"));
+    }
+    // Local senders share the loopback target. The index keeps both the sender and the target key, so the local
+    // address check above only runs once per sender.
+    const quint64 targetKey = target_key(asender, senderPort);
+    UDPCLient* target = _sessionTargetIndex.value(targetKey, nullptr);
+    if (!target) {
+        qDebug() << "Adding target" << asender << senderPort;
+        target = new UDPCLient(asender, senderPort);
+        _sessionTargets.append(target);
+        _sessionTargetIndex[targetKey] = target;
+    }
+    _sessionTargetIndex[senderKey] = target;
+}
+
+bool UDPLink::_isSessionTarget(const UDPCLient* target) const
+{
+    const UDPCLient* sessionTarget = _sessionTargetIndex.value(target_key(target->address, target->port), nullptr);
+    return sessionTarget && sessionTarget->address == target->address && sessionTarget->port == target->port;
+}
+
 void UDPLink::disconnect(void)
 {
     _running = false;
@@ -227,6 +400,14 @@ void UDPLink::disconnect(void)
         _socket = nullptr;
         emit disconnected();
     }
+    if (_batchIO) {
+        // Socket and notifier were released by the link thread on exit
+        _batchIO = false;
+        IOStats_t stats = ioStats();
+        qCDebug(UDPLinkLog) << "UDP datagrams per call received:" << (stats.receiveCalls ? double(stats.receivedDatagrams) / stats.receiveCalls : 0.0)
+                            << "sent:" << (stats.sendCalls ? double(stats.sentDatagrams) / stats.sendCalls : 0.0);
+        emit disconnected();
+    }
     _connectState = false;
 }
 
@@ -248,6 +429,27 @@ bool UDPLink::_hardwareConnect()
         delete _socket;
         _socket = nullptr;
     }
+#ifdef __mobile__
+    const int sendBufferSize    =  64 * 1024;
+    const int receiveBufferSize = 128 * 1024;
+#else
+    const int sendBufferSize    = 256 * 1024;
+    const int receiveBufferSize = 512 * 1024;
+#endif
+    //-- Linux: recvmmsg/sendmmsg on a plain socket, falls back to QUdpSocket if it can't be set up
+    if (UDPBatchSocket::available()) {
+        if (_batchSocket.open(_udpConfig->localPort(), sendBufferSize, receiveBufferSize)) {
+            _batchIO = true;
+            _connectState = true;
+            _batchNotifier = new QSocketNotifier(_batchSocket.socketDescriptor(), QSocketNotifier::Read, this);
+            // activated is overloaded and both overloads are private signals, so they can't be picked with QOverload
+            QObject::connect(_batchNotifier, SIGNAL(activated(QSocketDescriptor,QSocketNotifier::Type)), this, SLOT(readBytes()));
+            _registerZeroconf(_udpConfig->localPort(), kZeroconfRegistration);
+            emit connected();
+            return true;
+        }
+        qWarning() << "UDP batched I/O not available, using QUdpSocket:" << _batchSocket.errorString();
+    }
     QHostAddress host = QHostAddress::AnyIPv4;
     _socket = new QUdpSocket(this);
     _socket->setProxy(QNetworkProxy::NoProxy);
@@ -255,13 +457,8 @@ bool UDPLink::_hardwareConnect()
     if (_connectState) {
         _socket->joinMulticastGroup(QHostAddress("224.0.0.1"));
         //-- Make sure we have a large enough IO buffers
-#ifdef __mobile__
-        _socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,     64 * 1024);
-        _socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 128 * 1024);
-#else
-        _socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,    256 * 1024);
-        _socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 512 * 1024);
-#endif
+        _socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,    sendBufferSize);
+        _socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, receiveBufferSize);
         _registerZeroconf(_udpConfig->localPort(), kZeroconfRegistration);
         QObject::connect(_socket, &QUdpSocket::readyRead, this, &UDPLink::readBytes);
         emit connected();
@@ -12,11 +12,14 @@
 #include <QString>
 #include <QList>
 #include <QMap>
-#include <QMutex>
+#include <QHash>
 #include <QUdpSocket>
-#include <QMutex>
+#include <QSocketNotifier>
 #include <QQueue>
 #include <QByteArray>
+#include <QLoggingCategory>
+
+#include <atomic>
 
 #if defined(QGC_ZEROCONF_ENABLED)
 #include <dns_sd.h>
@@ -25,6 +28,9 @@
 #include "QGCConfig.h"
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "UDPBatchSocket.h"
+
+Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
 
 class LinkManager;
 
@@ -107,6 +113,19 @@ public:
     // QThread overrides
     void run(void) override;
 
+    typedef struct {
+        quint64 receivedDatagrams;
+        quint64 receiveCalls;       ///< System calls which returned datagrams
+        quint64 sentDatagrams;
+        quint64 sendCalls;
+    } IOStats_t;
+
+    /// Datagram and system call counts since the link was created, can be called from any thread
+    IOStats_t ioStats(void) const;
+
+    /// @return true: link uses recvmmsg/sendmmsg instead of QUdpSocket
+    bool batchIO(void) const { return _batchIO; }
+
 public slots:
     void readBytes(void);
 
@@ -124,14 +143,27 @@ private:
     void _registerZeroconf  (uint16_t port, const std::string& regType);
     void _deregisterZeroconf(void);
     void _writeDataGram     (const QByteArray data, const UDPCLient* target);
+    void _readBatches       (void);
+    void _writeBatch        (const QByteArray& data);
+    void _noteSender        (const QHostAddress& sender, quint16 senderPort);
+    void _addSessionTarget  (quint64 senderKey, const QHostAddress& sender, quint16 senderPort);
+    bool _isSessionTarget   (const UDPCLient* target) const;
 
     bool                _running;
     QUdpSocket*         _socket;
+    UDPBatchSocket      _batchSocket;
+    QSocketNotifier*    _batchNotifier;
+    bool                _batchIO;
     UDPConfiguration*   _udpConfig;
     bool                _connectState;
-    QList<UDPCLient*>   _sessionTargets;
-    QMutex              _sessionTargetsMutex;
+    // Session targets are only used from the link thread: reads and writes (through writeBytesThreadSafe) both run there
+    QList<UDPCLient*>           _sessionTargets;
+    QHash<quint64, UDPCLient*>  _sessionTargetIndex;    ///< Sender address/port key to session target
     QList<QHostAddress> _localAddresses;
+    std::atomic<quint64>    _receivedDatagrams;
+    std::atomic<quint64>    _receiveCalls;
+    std::atomic<quint64>    _sentDatagrams;
+    std::atomic<quint64>    _sendCalls;
 #if defined(QGC_ZEROCONF_ENABLED)
     DNSServiceRef       _dnssServiceRef;
 #endif
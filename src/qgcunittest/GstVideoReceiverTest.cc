@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#if defined(QGC_GST_STREAMING)
+
+#include "GstVideoReceiverTest.h"
+#include "GstVideoReceiver.h"
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <atomic>
+
+namespace {
+
+/// GstVideoReceiver fed by a local encoded test pattern instead of a network source
+class TestPatternReceiver : public GstVideoReceiver
+{
+public:
+    TestPatternReceiver(void)
+        : GstVideoReceiver(nullptr)
+        , firstRecordedPts(GST_CLOCK_TIME_NONE)
+    {
+    }
+
+    bool streaming(void) const { return _streaming; }
+    quint64 droppedBuffers(void) const { return _recorderDroppedBuffers; }
+
+    /// Current pipeline running time, the same time base as the live source buffer timestamps
+    GstClockTime runningTime(void)
+    {
+        GstClock* clock = _pipeline ? gst_element_get_clock(_pipeline) : nullptr;
+        if (clock == nullptr) {
+            return GST_CLOCK_TIME_NONE;
+        }
+        const GstClockTime now = gst_clock_get_time(clock);
+        gst_object_unref(clock);
+        return now - gst_element_get_base_time(_pipeline);
+    }
+
+    void recorderQueueLevel(guint& bytes, guint64& time)
+    {
+        bytes = 0;
+        time = 0;
+        if (_recorderQueue) {
+            g_object_get(_recorderQueue, "current-level-bytes", &bytes, "current-level-time", &time, nullptr);
+        }
+    }
+
+    std::atomic<quint64> firstRecordedPts;  ///< Timestamp of the first buffer written to the file sink
+
+protected:
+    GstElement* _makeSource(const QString& /*uri*/) override
+    {
+        GError* error = nullptr;
+        GstElement* source = gst_parse_bin_from_description(
+            "videotestsrc is-live=true pattern=ball ! video/x-raw,width=320,height=240,framerate=30/1 ! "
+            "x264enc tune=zerolatency bitrate=256 key-int-max=15 ! h264parse",
+            TRUE, &error);
+        if (error) {
+            qWarning() << "gst_parse_bin_from_description() failed" << error->message;
+            g_error_free(error);
+        }
+        return source;
+    }
+
+    GstElement* _makeFileSink(const QString& videoFile, FILE_FORMAT format) override
+    {
+        GstElement* bin = GstVideoReceiver::_makeFileSink(videoFile, format);
+        if (bin) {
+            GstPad* pad = gst_element_get_static_pad(bin, "sink");
+            if (pad) {
+                gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _firstRecordedBuffer, this, nullptr);
+                gst_object_unref(pad);
+            }
+        }
+        return bin;
+    }
+
+private:
+    static GstPadProbeReturn _firstRecordedBuffer(GstPad* /*pad*/, GstPadProbeInfo* info, gpointer user_data)
+    {
+        TestPatternReceiver* receiver = static_cast<TestPatternReceiver*>(user_data);
+        receiver->firstRecordedPts = GST_BUFFER_PTS(gst_pad_probe_info_get_buffer(info));
+        return GST_PAD_PROBE_REMOVE;
+    }
+};
+
+}
+
+bool GstVideoReceiverTest::_havePlugins(void)
+{
+    for (const char* name : { "videotestsrc", "x264enc", "h264parse", "matroskamux" }) {
+        GstElementFactory* factory = gst_element_factory_find(name);
+        if (factory == nullptr) {
+            qWarning() << "GStreamer element not available:" << name;
+            return false;
+        }
+        gst_object_unref(factory);
+    }
+    return true;
+}
+
+/// Histogram buckets, mean and max latency reported through latencyStatsChanged
+void GstVideoReceiverTest::_latencyStats_test(void)
+{
+    const int buckets = GstVideoReceiver::_kLatencyBuckets;
+
+    GstVideoReceiver receiver;
+
+    QSignalSpy spy(&receiver, &VideoReceiver::latencyStatsChanged);
+
+    // Each buffer is 100 bytes, the last one has no measurable latency
+    const GstClockTimeDiff rgLatency[] = { 2 * GST_MSECOND, 5 * GST_MSECOND, 15 * GST_MSECOND, 500 * GST_MSECOND, GST_CLOCK_STIME_NONE };
+
+    for (const GstClockTimeDiff latency : rgLatency) {
+        GstBuffer* buf = gst_buffer_new_allocate(nullptr, 100, nullptr);
+        receiver._noteStageBuffer(GstVideoReceiver::LATENCY_STAGE_SINK, buf, latency);
+        gst_buffer_unref(buf);
+    }
+
+    receiver._noteLatencyStats();
+    QCOMPARE(spy.count(), 1);
+
+    QVariantMap stats = spy.takeFirst()[0].toMap();
+    QCOMPARE(stats[QStringLiteral("bounds")].toList().count(), buckets - 1);
+
+    QVariantList stages = stats[QStringLiteral("stages")].toList();
+    QCOMPARE(stages.count(), static_cast<int>(GstVideoReceiver::LATENCY_STAGE_MAX));
+    QCOMPARE(stages[GstVideoReceiver::LATENCY_STAGE_SOURCE].toMap()[QStringLiteral("buffers")].toULongLong(), 0ull);
+
+    QVariantMap sink = stages[GstVideoReceiver::LATENCY_STAGE_SINK].toMap();
+    QCOMPARE(sink[QStringLiteral("name")].toString(), QStringLiteral("sink"));
+    QCOMPARE(sink[QStringLiteral("buffers")].toULongLong(), 5ull);
+    QCOMPARE(sink[QStringLiteral("bytes")].toULongLong(), 500ull);
+    QCOMPARE(sink[QStringLiteral("latency")].toDouble(), (2.0 + 5.0 + 15.0 + 500.0) / 4);
+    QCOMPARE(sink[QStringLiteral("maxLatency")].toDouble(), 500.0);
+
+    // Bucket upper bounds are exclusive: 2ms -> [0,5), 5ms -> [5,10), 15ms -> [10,20), 500ms -> open ended last bucket
+    const quint64 rgExpectedHistogram[buckets] = { 1, 1, 1, 0, 0, 0, 0, 0, 0, 1 };
+    QVariantList histogram = sink[QStringLiteral("histogram")].toList();
+    QCOMPARE(histogram.count(), buckets);
+    for (int i = 0; i < buckets; i++) {
+        QCOMPARE(histogram[i].toULongLong(), rgExpectedHistogram[i]);
+    }
+
+    // Mean and max only cover the time since the last report, the histogram is cumulative
+    receiver._noteLatencyStats();
+    QCOMPARE(spy.count(), 1);
+
+    sink = spy.takeFirst()[0].toMap()[QStringLiteral("stages")].toList()[GstVideoReceiver::LATENCY_STAGE_SINK].toMap();
+    QCOMPARE(sink[QStringLiteral("buffers")].toULongLong(), 5ull);
+    QCOMPARE(sink[QStringLiteral("latency")].toDouble(), 0.0);
+    QCOMPARE(sink[QStringLiteral("maxLatency")].toDouble(), 0.0);
+    QCOMPARE(sink[QStringLiteral("histogram")].toList()[buckets - 1].toULongLong(), 1ull);
+}
+
+/// Late frame threshold, including the one frame a second kept when every frame is late
+void GstVideoReceiverTest::_dropLateFrame_test(void)
+{
+    GstVideoReceiver receiver;
+
+    GstBuffer* buf = gst_buffer_new();
+
+    auto dropLateFrame = [&receiver, buf](GstClockTime pts, GstClockTimeDiff latency) {
+        GST_BUFFER_PTS(buf) = pts;
+        return receiver._dropLateFrame(nullptr, buf, latency, GST_CLOCK_TIME_NONE);
+    };
+
+    // Dropping is off by default
+    QCOMPARE(dropLateFrame(0, 10 * GST_SECOND), false);
+
+    receiver.setMaxFrameLatency(100);
+
+    QCOMPARE(dropLateFrame(1 * GST_SECOND, 50 * GST_MSECOND), false);
+    QCOMPARE(dropLateFrame(1 * GST_SECOND + 33 * GST_MSECOND, 100 * GST_MSECOND), false);
+    QCOMPARE(dropLateFrame(1 * GST_SECOND + 66 * GST_MSECOND, 101 * GST_MSECOND), true);
+    QCOMPARE(dropLateFrame(1 * GST_SECOND + 100 * GST_MSECOND, GST_CLOCK_STIME_NONE), false);
+    QCOMPARE(static_cast<quint64>(receiver._latencyStages[GstVideoReceiver::LATENCY_STAGE_SINK].dropped), 1ull);
+
+    // Every frame late: frames are dropped until a second has passed since the last rendered one
+    const GstClockTime lastRendered = 1 * GST_SECOND + 100 * GST_MSECOND;
+    for (GstClockTime pts = lastRendered + 33 * GST_MSECOND; pts < lastRendered + GST_SECOND; pts += 33 * GST_MSECOND) {
+        QCOMPARE(dropLateFrame(pts, 200 * GST_MSECOND), true);
+    }
+    QCOMPARE(dropLateFrame(lastRendered + GST_SECOND, 200 * GST_MSECOND), false);
+
+    // Timestamps going backwards, or missing, are rendered
+    QCOMPARE(dropLateFrame(0, 200 * GST_MSECOND), false);
+    QCOMPARE(dropLateFrame(GST_CLOCK_TIME_NONE, 200 * GST_MSECOND), false);
+
+    gst_buffer_unref(buf);
+}
+
+/// Recording started after the stream has been running must begin with frames from before startRecording
+void GstVideoReceiverTest::_preRollRecording_test(void)
+{
+    if (!_havePlugins()) {
+        QSKIP("Required GStreamer plugins not installed");
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    TestPatternReceiver receiver;
+    receiver.setRecordingPreRoll(4 * 1024 * 1024, 3000);
+    receiver.start(QStringLiteral("videotestsrc://"), 10);
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.streaming(), 5000);
+    QTest::qWait(1500);
+
+    const GstClockTime recordingStart = receiver.runningTime();
+    QVERIFY(GST_CLOCK_TIME_IS_VALID(recordingStart));
+    receiver.startRecording(tempDir.filePath(QStringLiteral("preroll.mkv")), VideoReceiver::FILE_FORMAT_MKV);
+
+    QTRY_VERIFY_WITH_TIMEOUT(GST_CLOCK_TIME_IS_VALID(receiver.firstRecordedPts.load()), 5000);
+    QVERIFY2(receiver.firstRecordedPts + 500 * GST_MSECOND < recordingStart,
+             qPrintable(QStringLiteral("first recorded pts %1 ms, recording started at %2 ms")
+                        .arg(receiver.firstRecordedPts / GST_MSECOND).arg(recordingStart / GST_MSECOND)));
+
+    receiver.stopRecording();
+    receiver.stop();
+    QTest::qWait(500);
+}
+
+void GstVideoReceiverTest::_preRollBound(unsigned maxBytes, unsigned maxMSecs)
+{
+    // The queue leaks before it enqueues, so the level may overshoot by one buffer
+    const guint     byteSlack   = 16 * 1024;
+    const guint64   timeSlack   = 100 * GST_MSECOND;
+
+    TestPatternReceiver receiver;
+    receiver.setRecordingPreRoll(maxBytes, maxMSecs);
+    receiver.start(QStringLiteral("videotestsrc://"), 10);
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.streaming(), 5000);
+
+    for (int i = 0; i < 20; i++) {
+        QTest::qWait(100);
+
+        guint   levelBytes;
+        guint64 levelTime;
+        receiver.recorderQueueLevel(levelBytes, levelTime);
+        QVERIFY2(levelBytes <= maxBytes + byteSlack, qPrintable(QString::number(levelBytes)));
+        QVERIFY2(levelTime <= maxMSecs * GST_MSECOND + timeSlack, qPrintable(QString::number(levelTime / GST_MSECOND)));
+    }
+
+    QVERIFY(receiver.droppedBuffers() > 0);
+
+    receiver.stop();
+    QTest::qWait(500);
+}
+
+/// The pre-roll queue must stay within recordingPreRollMaxSize by dropping the oldest buffers
+void GstVideoReceiverTest::_preRollBound_test(void)
+{
+    if (!_havePlugins()) {
+        QSKIP("Required GStreamer plugins not installed");
+    }
+
+    // Byte limited
+    _preRollBound(32 * 1024, 10000);
+    // Time limited
+    _preRollBound(64 * 1024 * 1024, 500);
+}
+
+#endif
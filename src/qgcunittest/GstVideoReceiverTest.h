@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#if defined(QGC_GST_STREAMING)
+
+#include "UnitTest.h"
+
+/// Unit test for GstVideoReceiver. The latency stats and late frame tests feed buffers straight to the receiver without a
+/// pipeline. The recording pre-roll tests use a live videotestsrc/x264enc pipeline in place of the vehicle stream and are
+/// skipped if the required GStreamer plugins are not installed.
+class GstVideoReceiverTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _latencyStats_test     (void);
+    void _dropLateFrame_test    (void);
+    void _preRollRecording_test (void);
+    void _preRollBound_test     (void);
+
+private:
+    bool _havePlugins           (void);
+    void _preRollBound          (unsigned maxBytes, unsigned maxMSecs);
+};
+
+#endif
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayLinkTest.h"
+#include "LogReplayLink.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+#include "QGCTemporaryFile.h"
+
+#include <QDateTime>
+#include <QtEndian>
+
+void LogReplayLinkTest::init(void)
+{
+    UnitTest::init();
+
+    _packChannel = qgcApp()->toolbox()->linkManager()->allocateMavlinkChannel();
+    QVERIFY(_packChannel != LinkManager::invalidMavlinkChannel());
+}
+
+void LogReplayLinkTest::cleanup(void)
+{
+    qgcApp()->toolbox()->linkManager()->freeMavlinkChannel(_packChannel);
+
+    UnitTest::cleanup();
+}
+
+/// Writes a telemetry log of _logSeconds at _messagesPerSecond and records where each record starts
+void LogReplayLinkTest::_writeLog(QFile& logFile, QVector<Record_t>& records)
+{
+    // Timestamps in the future are treated as little endian by the replay, so start in the past
+    const quint64 startUSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() - (60 * 60 * 1000)) * 1000;
+
+    for (int i=0; i<_logSeconds * _messagesPerSecond; i++) {
+        mavlink_message_t message;
+        if (i % 2) {
+            mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, static_cast<uint32_t>(i), 0.1f * i, 0.2f, 0.3f, 0, 0, 0);
+        } else {
+            mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+        }
+
+        uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+        int     frameLength = mavlink_msg_to_send_buffer(frame, &message);
+        uchar   timestamp[sizeof(quint64)];
+        quint64 timestampUSecs = startUSecs + static_cast<quint64>(i) * (1000000 / _messagesPerSecond);
+
+        qToBigEndian(timestampUSecs, timestamp);
+        records.append({ timestampUSecs, logFile.pos() });
+        logFile.write(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+        logFile.write(reinterpret_cast<const char*>(frame), frameLength);
+    }
+    logFile.flush();
+}
+
+void LogReplayLinkTest::_indexBuildAndSeek_test(void)
+{
+    QGCTemporaryFile logFile("LogReplayLinkTestXXXXXX.mavlink");
+    QVERIFY(logFile.open());
+
+    QVector<Record_t> records;
+    _writeLog(logFile, records);
+    logFile.close();
+
+    LogReplayLinkConfiguration* config = new LogReplayLinkConfiguration(QStringLiteral("LogReplayLinkTest"));
+    config->setLogFilename(logFile.fileName());
+    SharedLinkConfigurationPtr sharedConfig(config);
+
+    // Opening the log builds the index and saves it next to the log
+    QVector<LogReplayLink::LogIndexEntry_t> builtIndex;
+    QString                                 indexFilename;
+    {
+        LogReplayLink link(sharedConfig);
+        QVERIFY(link._loadLogFile());
+        QCOMPARE(link._logStartTimeUSecs, records.first().timestampUSecs);
+        QCOMPARE(link._logEndTimeUSecs, records.last().timestampUSecs);
+
+        // One entry per second of log time, each pointing at the record with that timestamp
+        builtIndex      = link._logIndex;
+        indexFilename   = link._indexFilename();
+        QCOMPARE(builtIndex.count(), _logSeconds);
+        for (int i=0; i<builtIndex.count(); i++) {
+            const Record_t& record = records[i * _messagesPerSecond];
+            QCOMPARE(builtIndex[i].timestampUSecs, record.timestampUSecs);
+            QCOMPARE(builtIndex[i].filePos, record.filePos);
+        }
+        QVERIFY(QFile::exists(indexFilename));
+    }
+
+    // A second link picks the index up from disk
+    LogReplayLink link(sharedConfig);
+    link._logFile.setFileName(logFile.fileName());
+    QVERIFY(link._logFile.open(QFile::ReadOnly));
+    link._logFileSize = static_cast<quint64>(link._logFile.size());
+    QVERIFY(link._loadIndex());
+    QCOMPARE(link._logEndTimeUSecs, records.last().timestampUSecs);
+    QCOMPARE(link._logIndex.count(), builtIndex.count());
+    for (int i=0; i<builtIndex.count(); i++) {
+        QCOMPARE(link._logIndex[i].timestampUSecs, builtIndex[i].timestampUSecs);
+        QCOMPARE(link._logIndex[i].filePos, builtIndex[i].filePos);
+    }
+
+    // Seeks land on the first message at or after the requested time, positioned just past its timestamp
+    const quint64 halfInterval = (1000000 / _messagesPerSecond) / 2;
+    QList<QPair<quint64, int>> seeks = {
+        { records.first().timestampUSecs,                   0 },
+        { records[37].timestampUSecs,                       37 },
+        { records[37].timestampUSecs + halfInterval,        38 },
+        { records[10].timestampUSecs - 1,                   10 },
+        { records.last().timestampUSecs,                    records.count() - 1 },
+        { records.last().timestampUSecs + 1000000,          records.count() - 1 },   // Past the end stays on the last message
+        { records[5].timestampUSecs,                        5 },                     // Backwards
+    };
+    for (const auto& seek: seeks) {
+        const Record_t& expected = records[seek.second];
+        QCOMPARE(link._seekToTimestamp(seek.first), expected.timestampUSecs);
+        QCOMPARE(link._logFile.pos(), expected.filePos + static_cast<qint64>(sizeof(quint64)));
+    }
+    link._logFile.close();
+
+    // Once the log changes the saved index no longer matches and is ignored
+    QFile appendFile(logFile.fileName());
+    QVERIFY(appendFile.open(QIODevice::Append));
+    QVector<Record_t> moreRecords;
+    _writeLog(appendFile, moreRecords);
+    appendFile.close();
+
+    LogReplayLink staleLink(sharedConfig);
+    staleLink._logFile.setFileName(logFile.fileName());
+    QVERIFY(staleLink._logFile.open(QFile::ReadOnly));
+    staleLink._logFileSize = static_cast<quint64>(staleLink._logFile.size());
+    QVERIFY(!staleLink._loadIndex());
+    staleLink._logFile.close();
+
+    QFile::remove(indexFilename);
+    logFile.remove();
+}
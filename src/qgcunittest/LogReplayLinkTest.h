@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+#include <QFile>
+
+/// Unit test for the LogReplayLink timestamp index: build, save/reload and seeking
+class LogReplayLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _indexBuildAndSeek_test(void);
+
+private:
+    typedef struct {
+        quint64 timestampUSecs;
+        qint64  filePos;
+    } Record_t;
+
+    void _writeLog(QFile& logFile, QVector<Record_t>& records);
+
+    uint8_t _packChannel = 0;
+
+    static const int _logSeconds        = 20;
+    static const int _messagesPerSecond = 10;
+};
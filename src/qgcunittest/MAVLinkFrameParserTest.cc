@@ -0,0 +1,238 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParserTest.h"
+#include "MAVLinkFrameParser.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+void MAVLinkFrameParserTest::init(void)
+{
+    UnitTest::init();
+
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    _packChannel    = linkManager->allocateMavlinkChannel();
+    _byteChannel    = linkManager->allocateMavlinkChannel();
+    _frameChannel   = linkManager->allocateMavlinkChannel();
+    QVERIFY(_packChannel != LinkManager::invalidMavlinkChannel());
+    QVERIFY(_byteChannel != LinkManager::invalidMavlinkChannel());
+    QVERIFY(_frameChannel != LinkManager::invalidMavlinkChannel());
+}
+
+void MAVLinkFrameParserTest::cleanup(void)
+{
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    linkManager->freeMavlinkChannel(_packChannel);
+    linkManager->freeMavlinkChannel(_byteChannel);
+    linkManager->freeMavlinkChannel(_frameChannel);
+
+    UnitTest::cleanup();
+}
+
+/// Builds a stream with a mix of mavlink 1/2 messages, including truncated mavlink 2 payloads
+QByteArray MAVLinkFrameParserTest::_buildStream(int messageCount, QList<mavlink_message_t>* sentMessages)
+{
+    QByteArray          stream;
+    mavlink_status_t*   packStatus = mavlink_get_channel_status(_packChannel);
+
+    for (int i=0; i<messageCount; i++) {
+        mavlink_message_t message;
+
+        if (i % 7 == 0) {
+            packStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        } else {
+            packStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
+
+        switch (i % 3) {
+        case 0:
+            mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, static_cast<uint32_t>(i), MAV_STATE_ACTIVE);
+            break;
+        case 1:
+            // Trailing zero fields are truncated by mavlink 2
+            mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, static_cast<uint32_t>(i), 0.1f * i, 0, 0, 0, 0, 0);
+            break;
+        default:
+            mavlink_msg_param_value_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message, "TEST_PARAM", static_cast<float>(i), MAV_PARAM_TYPE_REAL32, static_cast<uint16_t>(messageCount), static_cast<uint16_t>(i));
+            break;
+        }
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int len = mavlink_msg_to_send_buffer(buffer, &message);
+        stream.append(reinterpret_cast<const char*>(buffer), len);
+        if (sentMessages) {
+            sentMessages->append(message);
+        }
+    }
+    packStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    return stream;
+}
+
+void MAVLinkFrameParserTest::_compareMessage(const mavlink_message_t& actual, const mavlink_message_t& expected)
+{
+    QCOMPARE(actual.magic,  expected.magic);
+    QCOMPARE(actual.len,    expected.len);
+    QCOMPARE(actual.seq,    expected.seq);
+    QCOMPARE(actual.sysid,  expected.sysid);
+    QCOMPARE(actual.compid, expected.compid);
+    QCOMPARE(actual.msgid,  expected.msgid);
+    QCOMPARE(memcmp(_MAV_PAYLOAD(&actual), _MAV_PAYLOAD(&expected), actual.len), 0);
+}
+
+void MAVLinkFrameParserTest::_parseMatchesByteParser_test(void)
+{
+    QList<mavlink_message_t>    sentMessages;
+    QByteArray                  stream = _buildStream(600, &sentMessages);
+
+    // Byte by byte parser is the reference
+    QList<mavlink_message_t> byteMessages;
+    for (int i=0; i<stream.size(); i++) {
+        mavlink_message_t   message;
+        mavlink_status_t    status;
+        if (mavlink_parse_char(_byteChannel, static_cast<uint8_t>(stream[i]), &message, &status)) {
+            byteMessages.append(message);
+        }
+    }
+    QCOMPARE(byteMessages.count(), sentMessages.count());
+
+    // Feed the framed parser random sized chunks so frames straddle buffer boundaries
+    QRandomGenerator            randomGenerator(42);
+    MAVLinkFrameParser          parser;
+    QVector<mavlink_message_t>  frameMessages;
+    int                         position = 0;
+    while (position < stream.size()) {
+        int chunkSize = qMin(static_cast<int>(randomGenerator.bounded(1, 400)), stream.size() - position);
+        parser.parse(_frameChannel, reinterpret_cast<const uint8_t*>(stream.constData() + position), chunkSize, frameMessages);
+        position += chunkSize;
+    }
+
+    QCOMPARE(frameMessages.count(), byteMessages.count());
+    QCOMPARE(parser.pendingBytes(), 0);
+    QCOMPARE(parser.framesBadCRC(), static_cast<uint64_t>(0));
+    for (int i=0; i<frameMessages.count(); i++) {
+        _compareMessage(frameMessages[i], byteMessages[i]);
+    }
+}
+
+void MAVLinkFrameParserTest::_resyncAfterGarbage_test(void)
+{
+    QList<mavlink_message_t>    sentMessages;
+    QByteArray                  stream = _buildStream(30, &sentMessages);
+
+    // Insert junk including bogus start markers between every few frames
+    QByteArray  corruptStream;
+    QByteArray  junk("\x01\xFD\x05\x00\xFE\x02\x03", 7);
+    int         position = 0;
+    for (int i=0; i<sentMessages.count(); i++) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int frameLength = mavlink_msg_to_send_buffer(buffer, &sentMessages[i]);
+        corruptStream.append(stream.mid(position, frameLength));
+        position += frameLength;
+        if (i % 4 == 0) {
+            corruptStream.append(junk);
+        }
+    }
+
+    MAVLinkFrameParser          parser;
+    QVector<mavlink_message_t>  messages;
+    parser.parse(_frameChannel, reinterpret_cast<const uint8_t*>(corruptStream.constData()), corruptStream.size(), messages);
+
+    QVERIFY(parser.bytesSkipped() > 0);
+    QCOMPARE(messages.count(), sentMessages.count());
+    for (int i=0; i<messages.count(); i++) {
+        _compareMessage(messages[i], sentMessages[i]);
+    }
+}
+
+void MAVLinkFrameParserTest::_tlogReplayBenchmark_test(void)
+{
+    if (!qEnvironmentVariableIsSet("QGC_RUN_BENCHMARKS")) {
+        QSKIP("Set QGC_RUN_BENCHMARKS to run benchmarks");
+    }
+
+    QByteArray  stream;
+    QString     tlogFile = qgetenv("QGC_BENCHMARK_TLOG");
+    if (tlogFile.isEmpty()) {
+        stream = _buildStream(100000, nullptr);
+    } else {
+        QFile file(tlogFile);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        stream = file.readAll();
+    }
+
+    // Replay in buffers similar in size to what the links deliver
+    const int       chunkSize = 2048;
+    QElapsedTimer   timer;
+
+    // Previous receiveBytes path: byte by byte parser and one signal per message
+    int byteMessageCount    = 0;
+    int byteSignalCount     = 0;
+    QMetaObject::Connection byteConnection = connect(this, &MAVLinkFrameParserTest::_messageParsed, this, [&byteSignalCount](mavlink_message_t) {
+        byteSignalCount++;
+    });
+    timer.start();
+    for (int position=0; position<stream.size(); position+=chunkSize) {
+        const int end = qMin(position + chunkSize, stream.size());
+        for (int i=position; i<end; i++) {
+            mavlink_message_t   message;
+            mavlink_status_t    status;
+            if (mavlink_parse_char(_byteChannel, static_cast<uint8_t>(stream[i]), &message, &status)) {
+                byteMessageCount++;
+                emit _messageParsed(message);
+            }
+        }
+    }
+    qint64 byteElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+    disconnect(byteConnection);
+
+    // Current receiveBytes path: framed parser and one signal per buffer
+    MAVLinkFrameParser          parser;
+    QVector<mavlink_message_t>  messages;
+    int                         frameMessageCount   = 0;
+    int                         frameSignalCount    = 0;
+    int                         frameBatchCount     = 0;
+    int                         reallocations       = 0;
+    int                         lastCapacity        = messages.capacity();
+    QMetaObject::Connection frameConnection = connect(this, &MAVLinkFrameParserTest::_messagesParsed, this, [&frameSignalCount, &frameBatchCount](const QVector<mavlink_message_t>& batch) {
+        frameSignalCount++;
+        frameBatchCount += batch.count();
+    });
+    timer.restart();
+    for (int position=0; position<stream.size(); position+=chunkSize) {
+        messages.clear();
+        frameMessageCount += parser.parse(_frameChannel, reinterpret_cast<const uint8_t*>(stream.constData() + position), qMin(chunkSize, stream.size() - position), messages);
+        if (!messages.isEmpty()) {
+            emit _messagesParsed(messages);
+        }
+        if (messages.capacity() != lastCapacity) {
+            lastCapacity = messages.capacity();
+            reallocations++;
+        }
+    }
+    qint64 frameElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+    disconnect(frameConnection);
+
+    qDebug() << "Replayed" << stream.size() << "bytes" << (tlogFile.isEmpty() ? QStringLiteral("synthetic stream") : tlogFile);
+    qDebug() << "  mavlink_parse_char + messageReceived:" << byteMessageCount << "messages" << byteSignalCount << "signals"
+             << (byteMessageCount * 1e9) / byteElapsed << "messages/sec";
+    qDebug() << "  MAVLinkFrameParser + messagesReceived:" << frameMessageCount << "messages" << frameSignalCount << "signals"
+             << (frameMessageCount * 1e9) / frameElapsed << "messages/sec"
+             << "batch reallocations" << reallocations << "carry-over bytes pending" << parser.pendingBytes();
+    qDebug() << "  speedup" << static_cast<double>(byteElapsed) / frameElapsed;
+
+    QCOMPARE(byteSignalCount, byteMessageCount);
+    QCOMPARE(frameBatchCount, frameMessageCount);
+
+    // Framed parser resyncs more aggressively so it can only find more messages, never less
+    QVERIFY(frameMessageCount >= byteMessageCount);
+}
@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for MAVLinkFrameParser. Also includes a replay benchmark which compares the previous receiveBytes path
+/// (mavlink_parse_char with a signal per message) against the framed parser with a signal per buffer. The benchmark
+/// only runs when QGC_RUN_BENCHMARKS is set. Set QGC_BENCHMARK_TLOG to a .mavlink telemetry log to replay it,
+/// otherwise a synthetic stream is used.
+class MAVLinkFrameParserTest : public UnitTest
+{
+    Q_OBJECT
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+signals:
+    void _messageParsed (mavlink_message_t message);
+    void _messagesParsed(const QVector<mavlink_message_t>& messages);
+
+private slots:
+    void _parseMatchesByteParser_test   (void);
+    void _resyncAfterGarbage_test       (void);
+    void _tlogReplayBenchmark_test      (void);
+
+private:
+    QByteArray  _buildStream    (int messageCount, QList<mavlink_message_t>* sentMessages);
+    void        _compareMessage (const mavlink_message_t& actual, const mavlink_message_t& expected);
+
+    uint8_t _packChannel    = 0;
+    uint8_t _byteChannel    = 0;
+    uint8_t _frameChannel   = 0;
+};
@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriterTest.h"
+#include "MAVLinkLogWriter.h"
+#include "QGCTemporaryFile.h"
+
+#include <QtEndian>
+
+void MAVLinkLogWriterTest::_recordsWritten_test(void)
+{
+    QGCTemporaryFile logFile("MAVLinkLogWriterTestXXXXXX.mavlink");
+    QVERIFY(logFile.open());
+
+    // Enough records to wrap the ring several times
+    const int   recordCount     = 200000;
+    const int   payloadLength   = 40;
+    QByteArray  expected;
+    QByteArray  payload(payloadLength, 0);
+
+    MAVLinkLogWriter writer;
+    writer.startLogging(&logFile);
+    QVERIFY(writer.logging());
+    for (int i=0; i<recordCount; i++) {
+        payload.fill(static_cast<char>(i & 0xFF));
+        quint64 timestamp = static_cast<quint64>(i) * 1000;
+        if (writer.write(timestamp, payload.constData(), payload.size())) {
+            uchar timestampBytes[sizeof(quint64)];
+            qToBigEndian(timestamp, timestampBytes);
+            expected.append(reinterpret_cast<const char*>(timestampBytes), sizeof(timestampBytes));
+            expected.append(payload);
+        } else {
+            // Writer fell behind, give it a chance to catch up
+            QThread::msleep(5);
+        }
+    }
+    writer.stopLogging();
+    QVERIFY(!writer.logging());
+
+    QCOMPARE(writer.bytesWritten(), static_cast<quint64>(expected.size()));
+    QVERIFY(logFile.seek(0));
+    QCOMPARE(logFile.readAll(), expected);
+
+    logFile.close();
+    logFile.remove();
+}
+
+void MAVLinkLogWriterTest::_notLogging_test(void)
+{
+    MAVLinkLogWriter writer;
+    QByteArray payload(10, 0);
+
+    QVERIFY(!writer.logging());
+    QVERIFY(!writer.write(0, payload.constData(), payload.size()));
+    QCOMPARE(writer.droppedRecords(), static_cast<quint64>(0));
+}
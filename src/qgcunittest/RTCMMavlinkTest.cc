@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "RTCMMavlinkTest.h"
+#include "RTCMMavlink.h"
+#include "QGCApplication.h"
+
+static const int kMaxPayload = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
+
+void RTCMMavlinkTest::init(void)
+{
+    UnitTest::init();
+    _connectMockLinkNoInitialConnectSequence();
+}
+
+void RTCMMavlinkTest::cleanup(void)
+{
+    _disconnectMockLink();
+    UnitTest::cleanup();
+}
+
+/// Bytes a GPS_RTCM_DATA packet with the specified payload costs on the link
+int RTCMMavlinkTest::_packetBytes(int payloadLength)
+{
+    return MAVLINK_NUM_NON_PAYLOAD_BYTES + 2 + payloadLength;
+}
+
+void RTCMMavlinkTest::_queueMessage(RTCMMavlink& rtcm, int size)
+{
+    rtcm.RTCMDataUpdate(QByteArray(size, 'r'));
+    rtcm._sendTimer.stop();
+}
+
+/// Sends everything queued with no rate limit
+/// @return Number of link bytes used
+int RTCMMavlinkTest::_sendUnlimited(RTCMMavlink& rtcm)
+{
+    RTCMMavlink::LinkQueue_t& linkQueue = rtcm._linkQueues.first();
+    linkQueue.rateBytesPerSecond    = 1000000;
+    linkQueue.tokens                = linkQueue.rateBytesPerSecond * RTCMMavlink::_burstMsecs / 1000.0;
+
+    double tokens = linkQueue.tokens;
+    rtcm._sendOnLink(linkQueue, linkQueue.lastRefillMsecs);
+    return static_cast<int>(tokens - linkQueue.tokens);
+}
+
+void RTCMMavlinkTest::_fragment_test(void)
+{
+    RTCMMavlink rtcm(*qgcApp()->toolbox());
+
+    // Messages which fill the payload exactly are packed into a single packet
+    _queueMessage(rtcm, kMaxPayload - 1);
+    _queueMessage(rtcm, 1);
+    QCOMPARE(rtcm._linkQueues.count(), 1);
+    QCOMPARE(_sendUnlimited(rtcm), _packetBytes(kMaxPayload));
+    QCOMPARE(rtcm._packetCount, 1u);
+    QVERIFY(rtcm._linkQueues.first().queue.isEmpty());
+
+    // One more byte and they go out separately
+    _queueMessage(rtcm, kMaxPayload - 1);
+    _queueMessage(rtcm, 2);
+    QCOMPARE(_sendUnlimited(rtcm), _packetBytes(kMaxPayload - 1) + _packetBytes(2));
+    QCOMPARE(rtcm._packetCount, 3u);
+
+    // A message the size of the payload is sent as a single fragment
+    _queueMessage(rtcm, kMaxPayload);
+    QCOMPARE(_sendUnlimited(rtcm), _packetBytes(kMaxPayload));
+    QCOMPARE(rtcm._packetCount, 4u);
+
+    // One byte over needs a second fragment
+    _queueMessage(rtcm, kMaxPayload + 1);
+    QCOMPARE(_sendUnlimited(rtcm), _packetBytes(kMaxPayload) + _packetBytes(1));
+    QCOMPARE(rtcm._packetCount, 6u);
+    QCOMPARE(rtcm._linkQueues.first().fragmentOffset, 0);
+    QVERIFY(rtcm._linkQueues.first().queue.isEmpty());
+
+    // Each completed message, packed or fragmented, uses up a sequence id
+    QCOMPARE(rtcm._linkQueues.first().sequenceId, static_cast<uint8_t>(5));
+}
+
+void RTCMMavlinkTest::_rateLimit_test(void)
+{
+    RTCMMavlink rtcm(*qgcApp()->toolbox());
+
+    const int messageSize   = 100;  // Too large for two to be packed together
+    const int messageCount  = 20;
+    for (int i=0; i<messageCount; i++) {
+        _queueMessage(rtcm, messageSize);
+    }
+
+    RTCMMavlink::LinkQueue_t&   linkQueue   = rtcm._linkQueues.first();
+    const qint64                startMsecs  = linkQueue.lastRefillMsecs;
+    linkQueue.rateBytesPerSecond    = 1000;
+    linkQueue.tokens                = 0;
+
+    // No tokens, nothing goes out
+    rtcm._sendOnLink(linkQueue, startMsecs);
+    QCOMPARE(rtcm._packetCount, 0u);
+    QCOMPARE(linkQueue.queue.count(), messageCount);
+
+    // 100 msecs at 1000 bytes/sec isn't enough for a single packet
+    rtcm._sendOnLink(linkQueue, startMsecs + 100);
+    QCOMPARE(rtcm._packetCount, 0u);
+
+    // The bucket fills up to its depth, which is at least one full packet, no matter how long the link was idle
+    const int burstBytes = MAVLINK_MAX_PACKET_LEN;
+    rtcm._sendOnLink(linkQueue, startMsecs + 500);
+    const quint32 burstPackets = static_cast<quint32>(burstBytes / _packetBytes(messageSize));
+    QCOMPARE(rtcm._packetCount, burstPackets);
+    QCOMPARE(linkQueue.queue.count(), messageCount - static_cast<int>(burstPackets));
+    QVERIFY(linkQueue.tokens >= 0);
+    QVERIFY(linkQueue.tokens < _packetBytes(messageSize));
+
+    // From then on the link rate limits the output
+    const double    tokens  = linkQueue.tokens;
+    const quint32   packets = rtcm._packetCount;
+    rtcm._sendOnLink(linkQueue, startMsecs + 500 + 150);
+    QCOMPARE(rtcm._packetCount - packets, static_cast<quint32>((tokens + 150) / _packetBytes(messageSize)));
+}
+
+void RTCMMavlinkTest::_staleDrop_test(void)
+{
+    RTCMMavlink rtcm(*qgcApp()->toolbox());
+
+    for (int i=0; i<3; i++) {
+        _queueMessage(rtcm, 50);
+    }
+
+    // A link with no bandwidth left, so the messages sit in the queue
+    RTCMMavlink::LinkQueue_t&   linkQueue       = rtcm._linkQueues.first();
+    linkQueue.rateBytesPerSecond    = 0;
+    linkQueue.tokens                = 0;
+
+    // Nothing is dropped within the age limit
+    rtcm._sendOnLink(linkQueue, linkQueue.queue.first().receivedMsecs + RTCMMavlink::_maxMessageAgeMsecs);
+    QCOMPARE(linkQueue.queue.count(), 3);
+    QCOMPARE(rtcm._droppedCount, 0u);
+
+    // Past it only the newest message is kept
+    rtcm._sendOnLink(linkQueue, linkQueue.queue.last().receivedMsecs + RTCMMavlink::_maxMessageAgeMsecs + 1);
+    QCOMPARE(linkQueue.queue.count(), 1);
+    QCOMPARE(rtcm._droppedCount, 2u);
+
+    // A message which is partially sent is finished, even when it is stale
+    _queueMessage(rtcm, 50);
+    _queueMessage(rtcm, 50);
+    QCOMPARE(linkQueue.queue.count(), 3);
+    linkQueue.fragmentOffset = 10;
+    rtcm._sendOnLink(linkQueue, linkQueue.queue.last().receivedMsecs + RTCMMavlink::_maxMessageAgeMsecs + 1);
+    QCOMPARE(linkQueue.queue.count(), 2);
+    QCOMPARE(linkQueue.fragmentOffset, 10);
+    QCOMPARE(rtcm._droppedCount, 3u);
+}
+
+void RTCMMavlinkTest::_staleDropMultiLink_test(void)
+{
+    RTCMMavlink rtcm(*qgcApp()->toolbox());
+
+    for (int i=0; i<3; i++) {
+        _queueMessage(rtcm, 50);
+    }
+
+    // A second link queue holding the same messages, neither link has bandwidth left
+    RTCMMavlink::LinkQueue_t& linkQueue = rtcm._linkQueues.first();
+    linkQueue.rateBytesPerSecond    = 0;
+    linkQueue.tokens                = 0;
+    rtcm._linkQueues[reinterpret_cast<LinkInterface*>(&rtcm)] = linkQueue;
+
+    const qint64 nowMsecs = linkQueue.queue.last().receivedMsecs + RTCMMavlink::_maxMessageAgeMsecs + 1;
+    for (RTCMMavlink::LinkQueue_t& queue: rtcm._linkQueues) {
+        rtcm._sendOnLink(queue, nowMsecs);
+        QCOMPARE(queue.queue.count(), 1);
+    }
+
+    // Each message dropped from both links is counted once
+    QCOMPARE(rtcm._droppedCount, 2u);
+}
@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class RTCMMavlink;
+
+/// Unit test for the RTCMMavlink per link scheduler: token bucket rate limiting, packing and fragmenting around the
+/// GPS_RTCM_DATA payload size, and dropping stale messages. The send timer is kept stopped and the scheduler is
+/// driven with explicit timestamps, so the tests don't depend on timing.
+class RTCMMavlinkTest : public UnitTest
+{
+    Q_OBJECT
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _fragment_test             (void);
+    void _rateLimit_test            (void);
+    void _staleDrop_test            (void);
+    void _staleDropMultiLink_test   (void);
+
+private:
+    void    _queueMessage   (RTCMMavlink& rtcm, int size);
+    int     _sendUnlimited  (RTCMMavlink& rtcm);
+
+    static int _packetBytes(int payloadLength);
+};
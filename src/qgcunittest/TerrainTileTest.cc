@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileTest.h"
+#include "TerrainTile.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QVector>
+
+// South west corner of the test tile
+static const double kSwLat = 47.39;
+static const double kSwLon = 8.54;
+
+/// Terrain which is a tilted plane, so bilinear interpolation should reproduce it up to the integer rounding of the values
+double TerrainTileTest::_planeElevation(double latitude, double longitude)
+{
+    return 100.0 + ((latitude - kSwLat) * 20000.0) + ((longitude - kSwLon) * 30000.0);
+}
+
+QByteArray TerrainTileTest::_planeTileBytes(void)
+{
+    const int gridSize = qRound(TerrainTile::tileSizeDegrees / TerrainTile::tileValueSpacingDegrees) + 1;
+
+    QJsonArray carpet;
+    for (int latIndex=0; latIndex<gridSize; latIndex++) {
+        QJsonArray row;
+        for (int lonIndex=0; lonIndex<gridSize; lonIndex++) {
+            row.append(qRound(_planeElevation(kSwLat + (latIndex * TerrainTile::tileValueSpacingDegrees), kSwLon + (lonIndex * TerrainTile::tileValueSpacingDegrees))));
+        }
+        carpet.append(row);
+    }
+
+    QJsonObject bounds;
+    bounds[QStringLiteral("sw")] = QJsonArray({ kSwLat, kSwLon });
+    bounds[QStringLiteral("ne")] = QJsonArray({ kSwLat + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees), kSwLon + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees) });
+    QJsonObject stats;
+    stats[QStringLiteral("min")] = 100;
+    stats[QStringLiteral("max")] = 600;
+    stats[QStringLiteral("avg")] = 350;
+    QJsonObject data;
+    data[QStringLiteral("bounds")] = bounds;
+    data[QStringLiteral("stats")]  = stats;
+    data[QStringLiteral("carpet")] = carpet;
+    QJsonObject root;
+    root[QStringLiteral("status")] = QStringLiteral("success");
+    root[QStringLiteral("data")]   = data;
+
+    return TerrainTile::serializeFromAirMapJson(QJsonDocument(root).toJson());
+}
+
+void TerrainTileTest::_elevation_test(void)
+{
+    TerrainTile tile(_planeTileBytes());
+    QVERIFY(tile.isValid());
+
+    // Interior, grid points, and the edges/corners (which used to index past the end of the grid)
+    const double size = TerrainTile::tileSizeDegrees;
+    QList<QGeoCoordinate> coords = {
+        { kSwLat + (size / 3), kSwLon + (size / 7) },
+        { kSwLat + (10 * TerrainTile::tileValueSpacingDegrees), kSwLon + (20 * TerrainTile::tileValueSpacingDegrees) },
+        { kSwLat, kSwLon },
+        { kSwLat + size, kSwLon + size },
+        { kSwLat + size, kSwLon },
+        { kSwLat - 1e-9, kSwLon + size + 1e-9 },
+    };
+    for (const QGeoCoordinate& coord: coords) {
+        double elevation = tile.elevation(coord);
+        QVERIFY(qAbs(elevation - _planeElevation(qBound(kSwLat, coord.latitude(), kSwLat + size), qBound(kSwLon, coord.longitude(), kSwLon + size))) <= 1.0);
+    }
+
+    TerrainTile invalidTile;
+    QVERIFY(qIsNaN(invalidTile.elevation(coords[0])));
+}
+
+void TerrainTileTest::_bulkMatchesSingle_test(void)
+{
+    TerrainTile         tile(_planeTileBytes());
+    QRandomGenerator    randomGenerator(7);
+    const int           count = 1000;
+    QVector<double>     latitudes(count);
+    QVector<double>     longitudes(count);
+    QVector<double>     elevations(count);
+
+    for (int i=0; i<count; i++) {
+        latitudes[i]    = kSwLat + randomGenerator.bounded(TerrainTile::tileSizeDegrees);
+        longitudes[i]   = kSwLon + randomGenerator.bounded(TerrainTile::tileSizeDegrees);
+    }
+    tile.elevations(latitudes.constData(), longitudes.constData(), elevations.data(), count);
+
+    for (int i=0; i<count; i++) {
+        QCOMPARE(elevations[i], tile.elevation(QGeoCoordinate(latitudes[i], longitudes[i])));
+    }
+}
+
+/// Samples a 1 m grid over the tile (~1.1 km square) one coordinate at a time and in bulk
+void TerrainTileTest::_bulkElevationBenchmark_test(void)
+{
+    if (!qEnvironmentVariableIsSet("QGC_RUN_BENCHMARKS")) {
+        QSKIP("Set QGC_RUN_BENCHMARKS to run benchmarks");
+    }
+
+    TerrainTile     tile(_planeTileBytes());
+    const double    spacingDegrees  = TerrainTile::tileValueSpacingDegrees / TerrainTile::tileValueSpacingMeters;
+    const int       gridSize        = static_cast<int>(TerrainTile::tileSizeDegrees / spacingDegrees);
+    const int       count           = gridSize * gridSize;
+
+    QList<QGeoCoordinate>   coords;
+    QVector<double>         latitudes(count);
+    QVector<double>         longitudes(count);
+    QVector<double>         elevations(count);
+    coords.reserve(count);
+    for (int i=0; i<gridSize; i++) {
+        for (int j=0; j<gridSize; j++) {
+            int index = (i * gridSize) + j;
+            latitudes[index]    = kSwLat + (i * spacingDegrees);
+            longitudes[index]   = kSwLon + (j * spacingDegrees);
+            coords.append(QGeoCoordinate(latitudes[index], longitudes[index]));
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<double> singleElevations;
+    for (const QGeoCoordinate& coord: coords) {
+        singleElevations.append(tile.elevation(coord));
+    }
+    qint64 singleElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+
+    timer.restart();
+    tile.elevations(latitudes.constData(), longitudes.constData(), elevations.data(), count);
+    qint64 bulkElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+
+    qDebug() << "Sampled" << count << "points";
+    qDebug() << "  elevation(QGeoCoordinate):" << singleElapsed / 1000000.0 << "msecs" << static_cast<double>(singleElapsed) / count << "nsecs/point";
+    qDebug() << "  elevations(lat[], lon[]):  " << bulkElapsed / 1000000.0 << "msecs" << static_cast<double>(bulkElapsed) / count << "nsecs/point";
+
+    QCOMPARE(singleElevations.count(), count);
+    QCOMPARE(singleElevations.last(), elevations.last());
+}
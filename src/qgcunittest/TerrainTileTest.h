@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for TerrainTile elevation sampling. The bulk sampling benchmark only runs when QGC_RUN_BENCHMARKS is set.
+class TerrainTileTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _elevation_test                (void);
+    void _bulkMatchesSingle_test        (void);
+    void _bulkElevationBenchmark_test   (void);
+
+private:
+    QByteArray  _planeTileBytes (void);
+    double      _planeElevation (double latitude, double longitude);
+};
@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPLinkTest.h"
+#include "UDPLink.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+
+#include <QElapsedTimer>
+#include <QUdpSocket>
+
+void UDPLinkTest::init(void)
+{
+    UnitTest::init();
+
+    _packChannel = _linkManager->allocateMavlinkChannel();
+    QVERIFY(_packChannel != LinkManager::invalidMavlinkChannel());
+}
+
+void UDPLinkTest::cleanup(void)
+{
+    _linkManager->freeMavlinkChannel(_packChannel);
+    qunsetenv("QGC_UDP_DISABLE_BATCH_IO");
+
+    UnitTest::cleanup();
+}
+
+UDPLink* UDPLinkTest::_connectLink(quint16 localPort, bool batchIO)
+{
+    if (batchIO) {
+        qunsetenv("QGC_UDP_DISABLE_BATCH_IO");
+    } else {
+        qputenv("QGC_UDP_DISABLE_BATCH_IO", "1");
+    }
+
+    UDPConfiguration* udpConfig = new UDPConfiguration(QStringLiteral("UDPLinkTest"));
+    udpConfig->setLocalPort(localPort);
+
+    SharedLinkConfigurationPtr config(udpConfig);
+    if (!_linkManager->createConnectedLink(config)) {
+        return nullptr;
+    }
+
+    UDPLink* link = qobject_cast<UDPLink*>(config->link());
+    if (!link || !QTest::qWaitFor([link]() { return link->isConnected(); }, 5000)) {
+        return nullptr;
+    }
+
+    _receivedBytes = 0;
+    connect(link, &LinkInterface::bytesReceived, this, [this](LinkInterface*, QByteArray bytes) {
+        _receivedBytes += bytes.size();
+    });
+
+    return link;
+}
+
+void UDPLinkTest::_disconnectLink(void)
+{
+    _linkManager->disconnectAll();
+    QTRY_VERIFY(_linkManager->links().isEmpty());
+}
+
+/// Attitude and position messages as sent by a vehicle, one message per datagram
+QByteArray UDPLinkTest::_telemetryDatagram(int vehicle, int sequence)
+{
+    mavlink_message_t   message;
+    const uint8_t       systemId = static_cast<uint8_t>(vehicle + 1);
+
+    if (sequence % 2) {
+        mavlink_msg_global_position_int_pack_chan(systemId, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message,
+                                                  static_cast<uint32_t>(sequence * 20), 473977420 + sequence, 85455940 + vehicle, 488000, 10000, 100, -50, 0, 9000);
+    } else {
+        mavlink_msg_attitude_pack_chan(systemId, MAV_COMP_ID_AUTOPILOT1, _packChannel, &message,
+                                       static_cast<uint32_t>(sequence * 20), 0.01f * sequence, -0.02f, 1.5f, 0.1f, 0.2f, 0.3f);
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &message);
+    return QByteArray(reinterpret_cast<const char*>(buffer), len);
+}
+
+void UDPLinkTest::_sessionTargets_test(void)
+{
+    UDPLink* link = _connectLink(_linkPort, true);
+    QVERIFY(link);
+
+    QUdpSocket vehicle;
+    QVERIFY(vehicle.bind(QHostAddress::LocalHost, 0));
+
+    // The link learns the vehicle as a session target from its datagrams, only once
+    QByteArray datagram = _telemetryDatagram(0, 0);
+    for (int i=0; i<3; i++) {
+        QVERIFY(vehicle.writeDatagram(datagram, QHostAddress::LocalHost, _linkPort) == datagram.size());
+    }
+    QTRY_COMPARE(_receivedBytes, static_cast<qint64>(3 * datagram.size()));
+
+    QByteArray command = _telemetryDatagram(254, 1);
+    link->writeBytesThreadSafe(command.constData(), command.size());
+
+    QVERIFY(vehicle.waitForReadyRead(5000));
+    QByteArray reply(static_cast<int>(vehicle.pendingDatagramSize()), 0);
+    QCOMPARE(vehicle.readDatagram(reply.data(), reply.size()), static_cast<qint64>(command.size()));
+    QCOMPARE(reply, command);
+
+    QTest::qWait(100);
+    QVERIFY(!vehicle.hasPendingDatagrams());
+
+    UDPLink::IOStats_t stats = link->ioStats();
+    QCOMPARE(stats.receivedDatagrams, static_cast<quint64>(3));
+    QCOMPARE(stats.sentDatagrams, static_cast<quint64>(1));
+
+    _disconnectLink();
+}
+
+/// Datagrams up to the largest IPv4 UDP payload must arrive intact with batched I/O
+void UDPLinkTest::_largeDatagram_test(void)
+{
+    UDPLink* link = _connectLink(_linkPort, true);
+    QVERIFY(link);
+
+    QUdpSocket vehicle;
+    QVERIFY(vehicle.bind(QHostAddress::LocalHost, 0));
+
+    QByteArray datagram;
+    for (int i=0; i<4; i++) {
+        datagram += _telemetryDatagram(0, i);
+    }
+    while (datagram.size() < 16 * 1024) {
+        datagram += datagram;
+    }
+    QVERIFY(vehicle.writeDatagram(datagram, QHostAddress::LocalHost, _linkPort) == datagram.size());
+    QTRY_COMPARE(_receivedBytes, static_cast<qint64>(datagram.size()));
+
+    _disconnectLink();
+}
+
+void UDPLinkTest::_runBenchmark(bool batchIO)
+{
+    UDPLink* link = _connectLink(_linkPort, batchIO);
+    QVERIFY(link);
+    if (batchIO && !link->batchIO()) {
+        qDebug() << "Batched datagram I/O not available on this platform, skipped";
+        _disconnectLink();
+        return;
+    }
+
+    QList<QUdpSocket*> vehicles;
+    for (int i=0; i<_vehicleCount; i++) {
+        QUdpSocket* vehicle = new QUdpSocket(this);
+        QVERIFY(vehicle->bind(QHostAddress::LocalHost, 0));
+        vehicles.append(vehicle);
+    }
+
+    // Build the telemetry up front so only the link is measured
+    QVector<QByteArray> datagrams;
+    qint64              totalBytes = 0;
+    datagrams.reserve(_datagramCount);
+    for (int i=0; i<_datagramCount; i++) {
+        datagrams.append(_telemetryDatagram(i % _vehicleCount, i / _vehicleCount));
+        totalBytes += datagrams.last().size();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<_datagramCount; i++) {
+        QVERIFY(vehicles[i % _vehicleCount]->writeDatagram(datagrams[i], QHostAddress::LocalHost, _linkPort) > 0);
+        if ((i + 1) % _burstSize == 0) {
+            // Let the link catch up so the receive buffer never overflows
+            const quint64 sent = static_cast<quint64>(i + 1);
+            QVERIFY(QTest::qWaitFor([link, sent]() { return link->ioStats().receivedDatagrams >= sent; }, 5000));
+        }
+    }
+    QVERIFY(QTest::qWaitFor([link]() { return link->ioStats().receivedDatagrams >= static_cast<quint64>(_datagramCount); }, 5000));
+    qint64 receiveElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+    UDPLink::IOStats_t receiveStats = link->ioStats();
+
+    QTRY_COMPARE(_receivedBytes, totalBytes);
+
+    // All vehicles are session targets now, each write goes out to every one of them
+    const int   writeCount      = 2000;
+    QByteArray  command         = _telemetryDatagram(254, 0);
+    timer.restart();
+    for (int i=0; i<writeCount; i++) {
+        link->writeBytesThreadSafe(command.constData(), command.size());
+    }
+    const quint64 expectedSent = receiveStats.sentDatagrams + static_cast<quint64>(writeCount * _vehicleCount);
+    QVERIFY(QTest::qWaitFor([link, expectedSent]() { return link->ioStats().sentDatagrams >= expectedSent; }, 10000));
+    qint64 sendElapsed = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+    UDPLink::IOStats_t sendStats = link->ioStats();
+
+    const quint64 sentDatagrams = sendStats.sentDatagrams - receiveStats.sentDatagrams;
+    const quint64 sendCalls     = sendStats.sendCalls - receiveStats.sendCalls;
+
+    qDebug() << (batchIO ? "recvmmsg/sendmmsg:" : "QUdpSocket:");
+    qDebug() << "  received" << receiveStats.receivedDatagrams << "datagrams" << (receiveStats.receivedDatagrams * 1e9) / receiveElapsed << "datagrams/sec"
+             << static_cast<double>(receiveStats.receivedDatagrams) / qMax(receiveStats.receiveCalls, static_cast<quint64>(1)) << "datagrams/call";
+    qDebug() << "  sent" << sentDatagrams << "datagrams to" << _vehicleCount << "targets" << (sentDatagrams * 1e9) / sendElapsed << "datagrams/sec"
+             << static_cast<double>(sentDatagrams) / qMax(sendCalls, static_cast<quint64>(1)) << "datagrams/call";
+
+    if (batchIO) {
+        // Every write is a single sendmmsg call for all targets
+        QCOMPARE(sendCalls, static_cast<quint64>(writeCount));
+    }
+
+    qDeleteAll(vehicles);
+    _disconnectLink();
+}
+
+void UDPLinkTest::_loopbackBenchmark_test(void)
+{
+    if (!qEnvironmentVariableIsSet("QGC_RUN_BENCHMARKS")) {
+        QSKIP("Set QGC_RUN_BENCHMARKS to run benchmarks");
+    }
+
+    _runBenchmark(true);
+    _runBenchmark(false);
+}
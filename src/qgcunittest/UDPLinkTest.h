@@ -0,0 +1,46 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+class UDPLink;
+
+/// Unit test for UDPLink session targets and datagram sizes. The loopback benchmark blasts synthetic MAVLink telemetry
+/// from a set of simulated vehicles at the link, once with batched datagram I/O (Linux only) and once with QUdpSocket,
+/// and reports datagrams/sec and datagrams per system call for both. It only runs when QGC_RUN_BENCHMARKS is set.
+class UDPLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _sessionTargets_test       (void);
+    void _largeDatagram_test        (void);
+    void _loopbackBenchmark_test    (void);
+
+private:
+    UDPLink*    _connectLink        (quint16 localPort, bool batchIO);
+    void        _disconnectLink     (void);
+    QByteArray  _telemetryDatagram  (int vehicle, int sequence);
+    void        _runBenchmark       (bool batchIO);
+
+    uint8_t     _packChannel        = 0;
+    qint64      _receivedBytes      = 0;
+
+    static const quint16    _linkPort           = 14580;
+    static const int        _vehicleCount       = 8;
+    static const int        _datagramCount      = 40000;
+    static const int        _burstSize          = 200;
+};
@@ -11,6 +11,8 @@
 // We keep the list of all unit tests in a global location so it's easier to see which
 // ones are enabled/disabled
 
+#include "ADSBVehicleManagerTest.h"
+#include "CompiledParameterMetaDataTest.h"
 #include "ComponentInformationCacheTest.h"
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
@@ -26,9 +28,10 @@
 #include "MavlinkLogTest.h"
 //#include "MainWindowTest.h"
 //#include "FileManagerTest.h"
+#include "ParameterCacheTest.h"
 #include "ParameterManagerTest.h"
 #include "MissionCommandTreeTest.h"
-//#include "LogDownloadTest.h"
+#include "LogDownloadTest.h"
 #include "SendMavCommandWithSignallingTest.h"
 #include "SendMavCommandWithHandlerTest.h"
 #include "VisualMissionItemTest.h"
@@ -46,22 +49,53 @@
 #include "FWLandingPatternTest.h"
 #include "RequestMessageTest.h"
 #include "FTPManagerTest.h"
+#include "TelemetryRecorderTest.h"
 #include "MissionCommandTreeEditorTest.h"
 #include "VehicleLinkManagerTest.h"
 #include "LandingComplexItemTest.h"
 #include "InitialConnectTest.h"
+#include "ExifParserTest.h"
+#include "LogReplayLinkTest.h"
+#include "MAVLinkFrameParserTest.h"
+#include "MAVLinkLogWriterTest.h"
+#include "QGCTileCacheWorkerTest.h"
+#include "RTCMMavlinkTest.h"
+#include "TerrainTileManagerTest.h"
+#include "TerrainTileTest.h"
+#include "UDPLinkTest.h"
+#include "ULogParserTest.h"
 
+#if defined(QGC_GST_STREAMING)
+#include "GstVideoReceiverTest.h"
+#endif
+
+UT_REGISTER_TEST(ADSBVehicleManagerTest)
+UT_REGISTER_TEST(CompiledParameterMetaDataTest)
 UT_REGISTER_TEST(ComponentInformationCacheTest)
+UT_REGISTER_TEST(ExifParserTest)
 UT_REGISTER_TEST(FactSystemTestGeneric)
 UT_REGISTER_TEST(FactSystemTestPX4)
 //UT_REGISTER_TEST(FileDialogTest)
 UT_REGISTER_TEST(GeoTest)
+#if defined(QGC_GST_STREAMING)
+UT_REGISTER_TEST(GstVideoReceiverTest)
+#endif
+UT_REGISTER_TEST(LogReplayLinkTest)
+UT_REGISTER_TEST(MAVLinkFrameParserTest)
+UT_REGISTER_TEST(MAVLinkLogWriterTest)
+UT_REGISTER_TEST(QGCTileCacheWorkerTest)
+UT_REGISTER_TEST(RTCMMavlinkTest)
+UT_REGISTER_TEST(TerrainTileManagerTest)
+UT_REGISTER_TEST(TerrainTileTest)
+UT_REGISTER_TEST(UDPLinkTest)
+UT_REGISTER_TEST(ULogParserTest)
 UT_REGISTER_TEST(VehicleLinkManagerTest)
 //UT_REGISTER_TEST(MessageBoxTest)
 UT_REGISTER_TEST(SendMavCommandWithSignallingTest)
 UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
 UT_REGISTER_TEST(RequestMessageTest)
 UT_REGISTER_TEST(FTPManagerTest)
+UT_REGISTER_TEST(TelemetryRecorderTest)
 UT_REGISTER_TEST(InitialConnectTest)
 UT_REGISTER_TEST(MissionItemTest)
 UT_REGISTER_TEST(SimpleMissionItemTest)
@@ -69,9 +103,10 @@ UT_REGISTER_TEST(MissionControllerTest)
 UT_REGISTER_TEST(MissionManagerTest)
 //UT_REGISTER_TEST(RadioConfigTest)
 //UT_REGISTER_TEST(FileManagerTest)
+UT_REGISTER_TEST(ParameterCacheTest)
 UT_REGISTER_TEST(ParameterManagerTest)
 UT_REGISTER_TEST(MissionCommandTreeTest)
-//UT_REGISTER_TEST(LogDownloadTest)
+UT_REGISTER_TEST(LogDownloadTest)
 UT_REGISTER_TEST(SurveyComplexItemTest)
 UT_REGISTER_TEST(CameraSectionTest)
 UT_REGISTER_TEST(SpeedSectionTest)
@@ -309,6 +309,17 @@ Rectangle {
                                     visible:                videoFileFormatLabel.visible
                                 }
 
+                                QGCLabel {
+                                    id:         videoPreRollLabel
+                                    text:       qsTr("Recording Pre-Roll")
+                                    visible:    _showSaveVideoSettings && _isGst && _videoSettings.recordingPreRoll.visible
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _videoSettings.recordingPreRoll
+                                    visible:                videoPreRollLabel.visible
+                                }
+
                                 QGCLabel {
                                     id:         maxSavedVideoStorageLabel
                                     text:       qsTr("Max Storage Usage")
@@ -347,6 +358,28 @@ Rectangle {
                                     visible:    !_videoAutoStreamConfig && _isGst && fact.visible
                                 }
 
+                                QGCLabel {
+                                    id:         jitterBufferLabel
+                                    text:       qsTr("Jitter Buffer")
+                                    visible:    _isGst && _videoSettings.jitterBuffer.visible && !_videoSettings.lowLatencyMode.rawValue
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _videoSettings.jitterBuffer
+                                    visible:                jitterBufferLabel.visible
+                                }
+
+                                QGCLabel {
+                                    id:         maxFrameLatencyLabel
+                                    text:       qsTr("Max Frame Latency")
+                                    visible:    _isGst && _videoSettings.maxFrameLatency.visible
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _videoSettings.maxFrameLatency
+                                    visible:                maxFrameLatencyLabel.visible
+                                }
+
                                 Item { width: 1; height: 1}
                                 FactCheckBox {
                                     text:       qsTr("Auto-Delete Saved Recordings")
@@ -723,12 +756,41 @@ Rectangle {
                             }
                             FactCheckBox {
                                 id:         promptSaveCsv
-                                text:       qsTr("Save CSV log of telemetry data")
+                                text:       qsTr("Save recording of telemetry data")
                                 fact:       _saveCsvTelemetry
                                 visible:    _saveCsvTelemetry.visible
                                 enabled:    !_disableAllDataPersistence
                                 property Fact _saveCsvTelemetry: QGroundControl.settingsManager.appSettings.saveCsvTelemetry
                             }
+                            RowLayout {
+                                spacing:    _margins
+                                visible:    promptSaveCsv.visible
+
+                                QGCLabel { text: qsTr("Recording rate") }
+                                FactTextField {
+                                    Layout.preferredWidth:  _valueFieldWidth
+                                    fact:                   QGroundControl.settingsManager.appSettings.telemetryRecordRate
+                                    enabled:                promptSaveCsv.checked
+                                }
+                                QGCButton {
+                                    text:       qsTr("Export to CSV...")
+                                    onClicked:  recordingBrowseDialog.openForLoad()
+                                    QGCFileDialog {
+                                        id:             recordingBrowseDialog
+                                        title:          qsTr("Select Telemetry Recording")
+                                        nameFilters:    [ qsTr("Telemetry Recordings (*.%1)").arg(QGroundControl.settingsManager.appSettings.telemetryRecordingFileExtension), qsTr("All Files (*)") ]
+                                        selectExisting: true
+                                        folder:         QGroundControl.settingsManager.appSettings.telemetrySavePath
+                                        onAcceptedForLoad: {
+                                            close()
+                                            var errorMsg = QGroundControl.exportTelemetryRecordingToCsv(file)
+                                            if (errorMsg !== "") {
+                                                mainWindow.showMessageDialog(qsTr("Export to CSV"), errorMsg)
+                                            }
+                                        }
+                                    }
+                                }
+                            }
                         }
                     }
 
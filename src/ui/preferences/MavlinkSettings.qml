@@ -360,6 +360,22 @@ Rectangle {
                             anchors.verticalCenter: parent.verticalCenter
                         }
                     }
+                    //-----------------------------------------------------------------
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Telemetry log dropped messages:")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               globals.activeVehicle ? globals.activeVehicle.telemetryLogDroppedCount : qsTr("Not Connected")
+                            color:              globals.activeVehicle && globals.activeVehicle.telemetryLogDroppedCount > 0 ? qgcPal.warningText : qgcPal.text
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
                 }
             }
             //-----------------------------------------------------------------
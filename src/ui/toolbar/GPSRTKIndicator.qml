@@ -76,6 +76,22 @@ Item {
                         }
                     QGCLabel { text: qsTr("Satellites:") }
                     QGCLabel { text: QGroundControl.gpsRtk.numSatellites.value }
+                    QGCLabel {
+                        text: qsTr("Corrections:")
+                        visible: !QGroundControl.gpsRtk.active.value
+                        }
+                    QGCLabel {
+                        text: QGroundControl.gpsRtk.rtcm.outputRate.valueString + " " + QGroundControl.gpsRtk.rtcm.outputRate.units
+                        visible: !QGroundControl.gpsRtk.active.value
+                        }
+                    QGCLabel {
+                        text: qsTr("Dropped:")
+                        visible: QGroundControl.gpsRtk.rtcm.droppedCount.value > 0
+                        }
+                    QGCLabel {
+                        text: QGroundControl.gpsRtk.rtcm.droppedCount.valueString
+                        visible: QGroundControl.gpsRtk.rtcm.droppedCount.value > 0
+                        }
                 }
             }
         }